@@ -399,6 +399,7 @@ int LIBEASY_API if_getstats(const char *ifname, struct if_stats *s)
 	s->rx_dropped = rtnl_link_get_stat(link, RTNL_LINK_RX_DROPPED);
 	s->tx_dropped = rtnl_link_get_stat(link, RTNL_LINK_TX_DROPPED);
 	s->rx_errors_crc = rtnl_link_get_stat(link, RTNL_LINK_RX_CRC_ERR);
+	s->rx_multicast = rtnl_link_get_stat(link, RTNL_LINK_MULTICAST);
 
 	if_closelink(sk, link);
 
@@ -110,6 +110,7 @@ struct if_stats {
 	uint64_t rx_dropped;
 	uint64_t tx_dropped;
 	uint64_t rx_errors_crc;
+	uint64_t rx_multicast;
 };
 
 int if_getstats(const char *ifname, struct if_stats *s);
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <time.h>
 #include <linux/types.h>
 
 #ifdef __cplusplus
@@ -148,6 +149,37 @@ extern int get_ifoperstatus(const char *ifname, ifopstatus_t *opstatus);
 #define max(x, y)	(x) < (y) ? (y) : (x)
 #endif
 
+/** Get CLOCK_MONOTONIC time in msecs */
+static inline uint64_t time_monotonic_msecs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/** Get increment of a counter between two samples
+ *
+ * A counter which went back is taken to have wrapped once if it is read
+ * from a 32-bit source; else it is taken to have been reset, e.g. on a
+ * driver reload, and its current value is the increment.
+ *
+ * @param[in] prev previous sample of the counter.
+ * @param[in] cur current sample of the counter.
+ * @param[in] bits width of the source counter, 32 or 64.
+ * @return increment of the counter.
+ */
+static inline uint64_t counter_delta(uint64_t prev, uint64_t cur, int bits)
+{
+	if (cur >= prev)
+		return cur - prev;
+
+	if (bits == 32 && prev <= UINT32_MAX && cur <= UINT32_MAX)
+		return (UINT32_MAX - prev) + cur + 1;
+
+	return cur;
+}
+
 
 /* install a signal handler */
 extern int set_sighandler(int sig, void (*handler)(int));
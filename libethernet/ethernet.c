@@ -155,6 +155,42 @@ int eth_get_stats(const char *ifname, struct eth_stats *s)
 	return -1;
 }
 
+int eth_get_stats_snapshot(const char *ifname, struct eth_stats_snapshot *s)
+{
+	int ret;
+
+	memset(s, 0, sizeof(*s));
+	ret = eth_get_stats(ifname, &s->stats);
+	s->tstamp = time_monotonic_msecs();
+
+	return ret;
+}
+
+/* Get per-second rates of the counters between two samples; tstamp of
+ * 'rate' is set to the interval between the samples.
+ */
+int eth_stats_delta(const struct eth_stats_snapshot *prev,
+		    const struct eth_stats_snapshot *cur,
+		    struct eth_stats_snapshot *rate)
+{
+	const uint64_t *p = (const uint64_t *)&prev->stats;
+	const uint64_t *c = (const uint64_t *)&cur->stats;
+	uint64_t *r = (uint64_t *)&rate->stats;
+	uint64_t interval;
+	size_t i;
+
+	if (cur->tstamp <= prev->tstamp)
+		return -1;
+
+	/* struct eth_stats has only uint64_t counters */
+	interval = cur->tstamp - prev->tstamp;
+	for (i = 0; i < sizeof(struct eth_stats) / sizeof(uint64_t); i++)
+		r[i] = counter_delta(p[i], c[i], 64) * 1000 / interval;
+
+	rate->tstamp = interval;
+	return 0;
+}
+
 int eth_get_rmon_stats(const char *ifname, struct eth_rmon_stats *rmon)
 {
 	const struct eth_ops *eth = get_eth_driver(ifname);
@@ -127,6 +127,12 @@ struct eth_stats {
 	uint64_t rx_unknown_packets;        /* unknown protocol packets */
 };
 
+/* struct eth_stats_snapshot - timestamped sample of eth_stats */
+struct eth_stats_snapshot {
+	uint64_t tstamp;                    /* CLOCK_MONOTONIC msecs */
+	struct eth_stats stats;
+};
+
 /* struct eth_vlan - vlan over eth_link */
 struct eth_vlan {
 	ifopstatus_t status;
@@ -220,6 +226,10 @@ int eth_set_operstate(const char *ifname, ifopstatus_t s);
 int eth_get_stats(const char *ifname, struct eth_stats *c);
 int eth_get_info(const char *ifname, struct eth_info *info);
 int eth_get_rmon_stats(const char *ifname, struct eth_rmon_stats *rmon);
+int eth_get_stats_snapshot(const char *ifname, struct eth_stats_snapshot *s);
+int eth_stats_delta(const struct eth_stats_snapshot *prev,
+		    const struct eth_stats_snapshot *cur,
+		    struct eth_stats_snapshot *rate);
 
 int eth_reset_phy(const char *ifname, int phy_id);
 int eth_poweroff_phy(const char *ifname, struct eth_phy p);
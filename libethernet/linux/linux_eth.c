@@ -96,9 +96,7 @@ struct ethnic_stats {
     uint32_t   cmd;
     uint32_t   n_stats;
     uint64_t   data[STATS_END];
-} stat;
-
-static struct eth_stats ifstats;
+};
 
 static int get_ifstats(const char *ifname, struct eth_stats *s)
 {
@@ -134,12 +132,12 @@ static int get_ifstats(const char *ifname, struct eth_stats *s)
     return 0;
 }
 
-int get_ethtool_stats(const char *ifname)
+static int get_ethtool_stats(const char *ifname, struct ethnic_stats *stat)
 {
     int ret = 0;
 
-    stat.cmd = ETHTOOL_GSTATS;
-    if (0 != eth_ioctl(ifname, SIOCETHTOOL, &stat, sizeof(struct ethnic_stats)))
+    stat->cmd = ETHTOOL_GSTATS;
+    if (0 != eth_ioctl(ifname, SIOCETHTOOL, stat, sizeof(struct ethnic_stats)))
         ret = -1;
 
     if (ret)
@@ -148,16 +146,20 @@ int get_ethtool_stats(const char *ifname)
     return ret;
 }
 
-int get_stats(const char *ifname)
+/* Stats are collected into the caller's buffers, so that concurrent callers
+ * don't share any state.
+ */
+static int get_stats(const char *ifname, struct eth_stats *ifstats,
+		     struct ethnic_stats *stat)
 {
-    memset(&ifstats, 0, sizeof(struct eth_stats));
-    memset(&stat, 0, sizeof(struct ethnic_stats));
+    memset(ifstats, 0, sizeof(struct eth_stats));
+    memset(stat, 0, sizeof(struct ethnic_stats));
 
     syslog(LOG_INFO, "%s(%d): ifname is %s", __FUNCTION__, __LINE__, ifname);
 
-    if (get_ifstats(ifname, &ifstats) < 0)
+    if (get_ifstats(ifname, ifstats) < 0)
         return -1;
-    if (get_ethtool_stats(ifname) < 0)
+    if (get_ethtool_stats(ifname, stat) < 0)
 	return -1;
 
     return 0;
@@ -166,10 +168,13 @@ int get_stats(const char *ifname)
 
 int linux_eth_get_stats(const char *ifname, struct eth_stats *s)
 {
+    struct ethnic_stats stat;
+    struct eth_stats ifstats;
+
     if (!s)
 	return -1;
 
-    if (get_stats(ifname) < 0)
+    if (get_stats(ifname, &ifstats, &stat) < 0)
 	return -1;
 
     s->tx_bytes = ifstats.tx_bytes;
@@ -194,9 +199,11 @@ int linux_eth_get_stats(const char *ifname, struct eth_stats *s)
 
 int linux_eth_get_rmon_stats(const char *ifname, struct eth_rmon_stats *rmon)
 {
+    struct ethnic_stats stat;
+    struct eth_stats ifstats;
     int ret = 0;
 
-    if (get_stats(ifname) < 0)
+    if (get_stats(ifname, &ifstats, &stat) < 0)
 	ret = -1;
     rmon->tx.packets = stat.data[tx_packets];
     rmon->tx.bytes = stat.data[tx_bytes];
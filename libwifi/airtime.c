@@ -0,0 +1,210 @@
+/*
+ * airtime.c - per-sta airtime accounting from Tx/Rx duration counters
+ *
+ * Drivers report the total Tx and Rx airtime of a sta as ever increasing
+ * duration counters. The deltas of these counters between two consecutive
+ * samples of a sta give its airtime over that interval, which is summed
+ * up per BSS and per radio.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+/* samples older than this are not accounted in the BSS airtime */
+#define AIRTIME_MAX_AGE		10000	/* msecs */
+
+struct airtime_entry {
+	char ifname[16];
+	uint8_t macaddr[6];
+
+	/* last sample */
+	uint64_t tstamp;	/* msecs */
+	uint64_t tx_duration;	/* usecs */
+	uint64_t rx_duration;	/* usecs */
+
+	/* last interval */
+	uint32_t interval;	/* msecs */
+	uint64_t tx_delta;	/* usecs */
+	uint64_t rx_delta;	/* usecs */
+
+	struct airtime_entry *next;
+};
+
+static struct airtime_entry *airtime_list;
+static pthread_mutex_t airtime_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct airtime_entry *airtime_lookup(const char *ifname,
+					    uint8_t *macaddr)
+{
+	struct airtime_entry *e;
+
+	for (e = airtime_list; e; e = e->next) {
+		if (!memcmp(e->macaddr, macaddr, 6) &&
+		    !strncmp(e->ifname, ifname, sizeof(e->ifname)))
+			return e;
+	}
+
+	return NULL;
+}
+
+/* Update the airtime tracked for 'sta' with its duration counters sampled
+ * at time 'now' (msecs), and fill in its airtime over the last interval.
+ */
+static void airtime_update(const char *ifname, struct wifi_sta *sta,
+			   uint64_t now)
+{
+	struct airtime_entry *e;
+	uint64_t interval;
+
+	if (!sta->tx_duration && !sta->rx_duration)
+		return;
+
+	e = airtime_lookup(ifname, sta->macaddr);
+	if (!e) {
+		e = calloc(1, sizeof(*e));
+		if (!e)
+			return;
+
+		strncpy(e->ifname, ifname, sizeof(e->ifname) - 1);
+		memcpy(e->macaddr, sta->macaddr, 6);
+		e->next = airtime_list;
+		airtime_list = e;
+		goto out;
+	}
+
+	if (now <= e->tstamp)
+		return;
+
+	if (sta->tx_duration < e->tx_duration ||
+	    sta->rx_duration < e->rx_duration) {
+		/* counters restarted, i.e. sta has reassociated */
+		e->interval = 0;
+		e->tx_delta = e->rx_delta = 0;
+		goto out;
+	}
+
+	interval = now - e->tstamp;
+	e->interval = (uint32_t)interval;
+	e->tx_delta = sta->tx_duration - e->tx_duration;
+	e->rx_delta = sta->rx_duration - e->rx_duration;
+
+	/* usecs per msec of interval is msecs per second */
+	sta->tx_airtime = e->tx_delta / interval;
+	sta->rx_airtime = e->rx_delta / interval;
+	sta->airtime = (sta->tx_airtime + sta->rx_airtime) >= 1000 ? 100 :
+			(int8_t)((sta->tx_airtime + sta->rx_airtime) / 10);
+
+out:
+	e->tstamp = now;
+	e->tx_duration = sta->tx_duration;
+	e->rx_duration = sta->rx_duration;
+}
+
+void wifi_airtime_update(const char *ifname, struct wifi_sta *sta,
+			 uint64_t now)
+{
+	pthread_mutex_lock(&airtime_lock);
+	airtime_update(ifname, sta, now);
+	pthread_mutex_unlock(&airtime_lock);
+}
+
+/* Forget the stas of 'ifname' which are not in the 'stas' list */
+void wifi_airtime_expire(const char *ifname, struct wifi_sta *stas, int num)
+{
+	struct airtime_entry *e, **pe;
+	int i;
+
+	pthread_mutex_lock(&airtime_lock);
+	for (pe = &airtime_list; (e = *pe);) {
+		if (strncmp(e->ifname, ifname, sizeof(e->ifname))) {
+			pe = &e->next;
+			continue;
+		}
+
+		for (i = 0; i < num; i++) {
+			if (!memcmp(e->macaddr, stas[i].macaddr, 6))
+				break;
+		}
+
+		if (i == num) {
+			*pe = e->next;
+			free(e);
+			continue;
+		}
+
+		pe = &e->next;
+	}
+	pthread_mutex_unlock(&airtime_lock);
+}
+
+/* msecs of airtime per second, at most all of it */
+static uint32_t airtime_per_sec(uint64_t delta, uint32_t interval)
+{
+	uint64_t t = delta / interval;
+
+	return t > 1000 ? 1000 : (uint32_t)t;
+}
+
+/* Sum up the last interval's airtime of the stas of 'ifname' */
+void wifi_airtime_get_bss(const char *ifname, struct wifi_airtime *a,
+			  uint64_t now)
+{
+	struct airtime_entry *e;
+	uint32_t total;
+
+	memset(a, 0, sizeof(*a));
+	pthread_mutex_lock(&airtime_lock);
+	for (e = airtime_list; e; e = e->next) {
+		if (strncmp(e->ifname, ifname, sizeof(e->ifname)))
+			continue;
+
+		if (!e->interval || now - e->tstamp > AIRTIME_MAX_AGE)
+			continue;
+
+		a->tx_airtime += airtime_per_sec(e->tx_delta, e->interval);
+		a->rx_airtime += airtime_per_sec(e->rx_delta, e->interval);
+		if (e->interval > a->interval)
+			a->interval = e->interval;
+
+		a->num_stas++;
+	}
+	pthread_mutex_unlock(&airtime_lock);
+
+	total = a->tx_airtime + a->rx_airtime;
+	a->airtime = total >= 1000 ? 100 : (uint8_t)(total / 10);
+}
+
+void wifi_airtime_flush(void)
+{
+	struct airtime_entry *e;
+
+	pthread_mutex_lock(&airtime_lock);
+	while ((e = airtime_list)) {
+		airtime_list = e->next;
+		free(e);
+	}
+	pthread_mutex_unlock(&airtime_lock);
+}
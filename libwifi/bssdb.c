@@ -0,0 +1,476 @@
+/*
+ * bssdb.c - neighbor BSSs seen in the scan results of all radios
+ *
+ * Every scan result got through libwifi, or reported by the caller, updates
+ * the BSS's entry, which is found by its BSSID in a hash table and is also
+ * kept in a list per band and channel. Entries not seen for longer than the
+ * TTL are dropped, and the number of entries is bounded; the least recently
+ * seen BSS makes room for a new one.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+#define BSSDB_TTL		60000	/* msecs */
+#define BSSDB_MAX_ENTRIES	1024
+#define BSSDB_ALPHA		25	/* % weight of a new rssi sample */
+
+/* scan results of a radio are got again if older than this */
+#define BSSDB_REFRESH		10000	/* msecs */
+
+#define BSSDB_HASH_SIZE		256	/* power of 2 */
+#define BSSDB_NUM_BANDS		4
+#define BSSDB_NUM_CHANNELS	256
+
+/* EWMA values are kept scaled up for precision */
+#define EWMA_SCALE		16
+
+struct bssdb_entry {
+	struct wifi_bssdb_entry e;
+	int32_t rssi_ewma;
+	int band;				/* index in channel lists, or -1 */
+	struct bssdb_entry *hnext;		/* in hash bucket */
+	struct bssdb_entry *cprev, *cnext;	/* in channel list */
+	struct bssdb_entry *prev, *next;	/* in age list, oldest first */
+};
+
+struct bssdb_radio {
+	char name[16];
+	uint64_t updated;	/* last got all scan results, 0 if stale */
+	struct bssdb_radio *next;
+};
+
+static struct {
+	uint32_t ttl;
+	int max_entries;
+	int alpha;
+	int num;
+	struct bssdb_entry *hash[BSSDB_HASH_SIZE];
+	struct bssdb_entry *chan[BSSDB_NUM_BANDS][BSSDB_NUM_CHANNELS];
+	uint16_t chan_num[BSSDB_NUM_BANDS][BSSDB_NUM_CHANNELS];
+	int band_num[BSSDB_NUM_BANDS];
+	struct bssdb_entry *oldest, *newest;
+	struct bssdb_radio *radios;
+} bssdb = {
+	.ttl = BSSDB_TTL,
+	.max_entries = BSSDB_MAX_ENTRIES,
+	.alpha = BSSDB_ALPHA,
+};
+
+static pthread_mutex_t bssdb_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int bssdb_hash(const uint8_t *bssid)
+{
+	return (bssid[3] ^ bssid[4] ^ (bssid[5] << 1) ^ (bssid[5] >> 7)) &
+	       (BSSDB_HASH_SIZE - 1);
+}
+
+static int bssdb_band(enum wifi_band band)
+{
+	switch (band) {
+	case BAND_2:
+		return 0;
+	case BAND_5:
+		return 1;
+	case BAND_6:
+		return 2;
+	case BAND_60:
+		return 3;
+	default:
+		return -1;
+	}
+}
+
+static struct bssdb_entry *bssdb_lookup(const uint8_t *bssid)
+{
+	struct bssdb_entry *b;
+
+	for (b = bssdb.hash[bssdb_hash(bssid)]; b; b = b->hnext) {
+		if (!memcmp(b->e.bss.bssid, bssid, 6))
+			return b;
+	}
+
+	return NULL;
+}
+
+static void bssdb_chan_unlink(struct bssdb_entry *b)
+{
+	uint8_t ch = b->e.bss.channel;
+
+	if (b->band < 0)
+		return;
+
+	if (b->cprev)
+		b->cprev->cnext = b->cnext;
+	else
+		bssdb.chan[b->band][ch] = b->cnext;
+
+	if (b->cnext)
+		b->cnext->cprev = b->cprev;
+
+	bssdb.chan_num[b->band][ch]--;
+	bssdb.band_num[b->band]--;
+	b->cprev = b->cnext = NULL;
+}
+
+static void bssdb_chan_link(struct bssdb_entry *b)
+{
+	uint8_t ch = b->e.bss.channel;
+
+	b->band = bssdb_band(b->e.bss.band);
+	if (b->band < 0)
+		return;
+
+	b->cprev = NULL;
+	b->cnext = bssdb.chan[b->band][ch];
+	if (b->cnext)
+		b->cnext->cprev = b;
+
+	bssdb.chan[b->band][ch] = b;
+	bssdb.chan_num[b->band][ch]++;
+	bssdb.band_num[b->band]++;
+}
+
+static void bssdb_age_unlink(struct bssdb_entry *b)
+{
+	if (b->prev)
+		b->prev->next = b->next;
+	else
+		bssdb.oldest = b->next;
+
+	if (b->next)
+		b->next->prev = b->prev;
+	else
+		bssdb.newest = b->prev;
+
+	b->prev = b->next = NULL;
+}
+
+/* Keep the age list ordered by last seen time; updates come in order, but
+ * for the few which race another
+ */
+static void bssdb_age_link(struct bssdb_entry *b)
+{
+	struct bssdb_entry *prev = bssdb.newest;
+
+	while (prev && prev->e.last_seen > b->e.last_seen)
+		prev = prev->prev;
+
+	b->prev = prev;
+	b->next = prev ? prev->next : bssdb.oldest;
+	if (b->next)
+		b->next->prev = b;
+	else
+		bssdb.newest = b;
+
+	if (prev)
+		prev->next = b;
+	else
+		bssdb.oldest = b;
+}
+
+static void bssdb_del(struct bssdb_entry *del)
+{
+	struct bssdb_entry *b, **pb;
+
+	for (pb = &bssdb.hash[bssdb_hash(del->e.bss.bssid)]; (b = *pb);
+	     pb = &b->hnext) {
+		if (b == del) {
+			*pb = b->hnext;
+			break;
+		}
+	}
+
+	bssdb_chan_unlink(del);
+	bssdb_age_unlink(del);
+	bssdb.num--;
+	free(del);
+}
+
+/* Drop entries not seen within the TTL; the oldest are at the head */
+static void bssdb_expire(uint64_t now)
+{
+	while (bssdb.oldest && bssdb.oldest->e.last_seen + bssdb.ttl < now)
+		bssdb_del(bssdb.oldest);
+}
+
+static struct bssdb_radio *bssdb_radio(const char *name, bool create)
+{
+	struct bssdb_radio *r;
+
+	for (r = bssdb.radios; r; r = r->next) {
+		if (!strncmp(r->name, name, sizeof(r->name)))
+			return r;
+	}
+
+	if (!create)
+		return NULL;
+
+	r = calloc(1, sizeof(*r));
+	if (!r)
+		return NULL;
+
+	strncpy(r->name, name, sizeof(r->name) - 1);
+	r->next = bssdb.radios;
+	bssdb.radios = r;
+
+	return r;
+}
+
+static int32_t ewma(int32_t avg, int v, int alpha, bool first)
+{
+	v *= EWMA_SCALE;
+	if (first)
+		return v;
+
+	return avg + (v - avg) * alpha / 100;
+}
+
+/* Round a scaled EWMA value to nearest */
+static int ewma_get(int32_t avg)
+{
+	return (avg + (avg < 0 ? -EWMA_SCALE / 2 : EWMA_SCALE / 2)) / EWMA_SCALE;
+}
+
+static void bssdb_record(const char *ifname, struct wifi_bss *bss,
+			 uint64_t now)
+{
+	struct wifi_bssdb_entry *e;
+	struct bssdb_entry *b;
+	unsigned int h;
+
+	b = bssdb_lookup(bss->bssid);
+	if (!b) {
+		if (bssdb.num >= bssdb.max_entries && bssdb.oldest)
+			bssdb_del(bssdb.oldest);
+
+		b = calloc(1, sizeof(*b));
+		if (!b)
+			return;
+
+		h = bssdb_hash(bss->bssid);
+		b->hnext = bssdb.hash[h];
+		bssdb.hash[h] = b;
+		b->band = -1;
+		b->e.first_seen = now;
+		bssdb.num++;
+	} else {
+		bssdb_chan_unlink(b);
+		bssdb_age_unlink(b);
+	}
+
+	e = &b->e;
+	if (!e->num_channel || e->channel[0] != bss->channel) {
+		memmove(&e->channel[1], &e->channel[0],
+			sizeof(e->channel) - sizeof(e->channel[0]));
+		e->channel[0] = bss->channel;
+		if (e->num_channel < WIFI_BSSDB_CHAN_HISTORY)
+			e->num_channel++;
+	}
+
+	b->rssi_ewma = ewma(b->rssi_ewma, bss->rssi, bssdb.alpha,
+			    e->num_seen == 0);
+	e->rssi_ewma = ewma_get(b->rssi_ewma);
+	memcpy(&e->bss, bss, sizeof(*bss));
+	memset(e->ifname, 0, sizeof(e->ifname));
+	strncpy(e->ifname, ifname, sizeof(e->ifname) - 1);
+	if (now > e->last_seen)
+		e->last_seen = now;
+
+	e->num_seen++;
+
+	bssdb_chan_link(b);
+	bssdb_age_link(b);
+}
+
+void wifi_bssdb_update(const char *ifname, struct wifi_bss *bss, int num,
+		       bool all, uint64_t now)
+{
+	struct bssdb_radio *r;
+	int i;
+
+	pthread_mutex_lock(&bssdb_lock);
+	bssdb_expire(now);
+	for (i = 0; i < num; i++)
+		bssdb_record(ifname, &bss[i], now);
+
+	if (all) {
+		r = bssdb_radio(ifname, true);
+		if (r)
+			r->updated = now;
+	}
+	pthread_mutex_unlock(&bssdb_lock);
+}
+
+/* New scan results are due on the radio, e.g. as it was asked to scan */
+void wifi_bssdb_stale(const char *name)
+{
+	struct bssdb_radio *r;
+
+	pthread_mutex_lock(&bssdb_lock);
+	r = bssdb_radio(name, false);
+	if (r)
+		r->updated = 0;
+	pthread_mutex_unlock(&bssdb_lock);
+}
+
+bool wifi_bssdb_need_refresh(const char *name, uint64_t now)
+{
+	struct bssdb_radio *r;
+	bool ret;
+
+	pthread_mutex_lock(&bssdb_lock);
+	r = bssdb_radio(name, false);
+	ret = !r || !r->updated || r->updated + BSSDB_REFRESH <= now;
+	pthread_mutex_unlock(&bssdb_lock);
+
+	return ret;
+}
+
+/* Number of BSSs on a channel of a band; on all channels of it if 0 */
+int wifi_bssdb_count(enum wifi_band band, uint8_t channel)
+{
+	int idx = bssdb_band(band);
+	int ret;
+
+	if (idx < 0)
+		return 0;
+
+	pthread_mutex_lock(&bssdb_lock);
+	bssdb_expire(time_monotonic_msecs());
+	ret = channel ? bssdb.chan_num[idx][channel] : bssdb.band_num[idx];
+	pthread_mutex_unlock(&bssdb_lock);
+
+	return ret;
+}
+
+/* Number of BSSs on each channel of a band, by channel number; returns the
+ * number on all its channels
+ */
+int wifi_bssdb_count_channels(enum wifi_band band, uint16_t *count)
+{
+	int idx = bssdb_band(band);
+	int ret;
+
+	if (idx < 0) {
+		memset(count, 0, BSSDB_NUM_CHANNELS * sizeof(*count));
+		return 0;
+	}
+
+	pthread_mutex_lock(&bssdb_lock);
+	bssdb_expire(time_monotonic_msecs());
+	memcpy(count, bssdb.chan_num[idx], BSSDB_NUM_CHANNELS * sizeof(*count));
+	ret = bssdb.band_num[idx];
+	pthread_mutex_unlock(&bssdb_lock);
+
+	return ret;
+}
+
+int wifi_bssdb_add(const char *ifname, struct wifi_bss *bss, int num)
+{
+	if (!ifname || !bss || num < 0)
+		return -EINVAL;
+
+	wifi_bssdb_update(ifname, bss, num, false, time_monotonic_msecs());
+	return 0;
+}
+
+int wifi_bssdb_lookup(uint8_t *bssid, struct wifi_bssdb_entry *e)
+{
+	struct bssdb_entry *b;
+
+	if (!bssid || !e)
+		return -EINVAL;
+
+	pthread_mutex_lock(&bssdb_lock);
+	bssdb_expire(time_monotonic_msecs());
+	b = bssdb_lookup(bssid);
+	if (!b) {
+		pthread_mutex_unlock(&bssdb_lock);
+		return -ENOENT;
+	}
+
+	memcpy(e, &b->e, sizeof(*e));
+	pthread_mutex_unlock(&bssdb_lock);
+	return 0;
+}
+
+int wifi_bssdb_get_channel(enum wifi_band band, uint8_t channel,
+			   struct wifi_bssdb_entry *e, int *num)
+{
+	int idx = bssdb_band(band);
+	struct bssdb_entry *b;
+	int n = 0;
+
+	if (!e || !num || *num < 0 || idx < 0)
+		return -EINVAL;
+
+	pthread_mutex_lock(&bssdb_lock);
+	bssdb_expire(time_monotonic_msecs());
+	for (b = bssdb.chan[idx][channel]; b && n < *num; b = b->cnext)
+		memcpy(&e[n++], &b->e, sizeof(*e));
+
+	pthread_mutex_unlock(&bssdb_lock);
+	*num = n;
+	return 0;
+}
+
+int wifi_bssdb_config(uint32_t ttl, int max_entries, int alpha)
+{
+	if (!ttl || max_entries <= 0 || alpha <= 0 || alpha > 100)
+		return -EINVAL;
+
+	pthread_mutex_lock(&bssdb_lock);
+	bssdb.ttl = ttl;
+	bssdb.max_entries = max_entries;
+	bssdb.alpha = alpha;
+	while (bssdb.num > bssdb.max_entries && bssdb.oldest)
+		bssdb_del(bssdb.oldest);
+
+	bssdb_expire(time_monotonic_msecs());
+	pthread_mutex_unlock(&bssdb_lock);
+	return 0;
+}
+
+void wifi_bssdb_flush(const char *ifname)
+{
+	struct bssdb_entry *b, *next;
+	struct bssdb_radio *r;
+
+	pthread_mutex_lock(&bssdb_lock);
+	for (b = bssdb.oldest; b; b = next) {
+		next = b->next;
+		if (!ifname || !strncmp(b->e.ifname, ifname, sizeof(b->e.ifname)))
+			bssdb_del(b);
+	}
+
+	for (r = bssdb.radios; r; r = r->next) {
+		if (!ifname || !strncmp(r->name, ifname, sizeof(r->name)))
+			r->updated = 0;
+	}
+	pthread_mutex_unlock(&bssdb_lock);
+}
@@ -4,7 +4,8 @@
  * Valid channels are dependant on a number of parameters -
  * regulatory domain, country, dfs, bandwidth.
  * The API wifi_get_valid_channels() returns valid channels for any
- * combination of these parameters.
+ * combination of these parameters, from the regulatory rules of the
+ * radio's driver if it gives them, else from the static country tables.
  *
  * Copyright (C) 2018 Inteno Broadband Technology AB. All rights reserved.
  *
@@ -28,6 +29,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <pthread.h>
 
 #include "easy.h"
 #include "wifi.h"
@@ -40,7 +43,7 @@ struct chlist {
 
 struct region_to_chlist {
 	int reg;
-	struct chlist *list;
+	const struct chlist *list;
 };
 
 /* channel filter criteria */
@@ -56,39 +59,39 @@ struct region_to_chlist {
 #define G_REG_6                  6	/* 3-9 */
 #define G_REG_7                  7	/* 5-13 */
 
-struct chlist g_reg0_chlist[] = {
+static const struct chlist g_reg0_chlist[] = {
 	{1, 11}, {0, 0}
 };
 
-struct chlist g_reg1_chlist[] = {
+static const struct chlist g_reg1_chlist[] = {
 	{1, 13}, {0, 0}
 };
 
-struct chlist g_reg2_chlist[] = {
+static const struct chlist g_reg2_chlist[] = {
 	{10, 2}, {0, 0}
 };
 
-struct chlist g_reg3_chlist[] = {
+static const struct chlist g_reg3_chlist[] = {
 	{10, 4}, {0, 0}
 };
 
-struct chlist g_reg4_chlist[] = {
+static const struct chlist g_reg4_chlist[] = {
 	{14, 1}, {0, 0}
 };
 
-struct chlist g_reg5_chlist[] = {
+static const struct chlist g_reg5_chlist[] = {
 	{1, 14}, {0, 0}
 };
 
-struct chlist g_reg6_chlist[] = {
+static const struct chlist g_reg6_chlist[] = {
 	{3, 7}, {0, 0}
 };
 
-struct chlist g_reg7_chlist[] = {
+static const struct chlist g_reg7_chlist[] = {
 	{5, 9}, {0, 0}
 };
 
-static struct region_to_chlist g_region_chlist[] = {
+static const struct region_to_chlist g_region_chlist[] = {
 	{0, g_reg0_chlist},
 	{1, g_reg1_chlist},
 	{2, g_reg2_chlist},
@@ -148,52 +151,52 @@ static struct region_to_chlist g_region_chlist[] = {
 #define A_REG_14                  14
 
 
-struct chlist a_reg0_chlist[] = {
+static const struct chlist a_reg0_chlist[] = {
 	{36, 8}, {149, 5}, {0, 0}
 };
 
-struct chlist a_reg1_chlist[] = {
+static const struct chlist a_reg1_chlist[] = {
 	{36, 8}, {100, 11}, {0, 0}
 };
 
-struct chlist a_reg2_chlist[] = {
+static const struct chlist a_reg2_chlist[] = {
 	{36, 8}, {0, 0}
 };
 
-struct chlist a_reg3_chlist[] = {
+static const struct chlist a_reg3_chlist[] = {
 	{52, 4}, {149, 4}, {0, 0}
 };
 
-struct chlist a_reg4_chlist[] = {
+static const struct chlist a_reg4_chlist[] = {
 	{149, 5}, {0, 0}
 };
 
-struct chlist a_reg5_chlist[] = {
+static const struct chlist a_reg5_chlist[] = {
 	{149, 4}, {0, 0}
 };
 
-struct chlist a_reg6_chlist[] = {
+static const struct chlist a_reg6_chlist[] = {
 	{36, 4}, {0, 0}
 };
 
-struct chlist a_reg7_chlist[] = {
+static const struct chlist a_reg7_chlist[] = {
 	{36, 8}, {100, 11}, {149, 7}, {0, 0}
 };
 
-struct chlist a_reg8_chlist[] = {
+static const struct chlist a_reg8_chlist[] = {
 	{52, 4}, {0, 0}
 };
 
-struct chlist a_reg9_chlist[] = {
+static const struct chlist a_reg9_chlist[] = {
 	{36, 8}, {100, 5}, {132, 8}, {0, 0}
 };
 
-struct chlist a_reg10_chlist[] = {
+static const struct chlist a_reg10_chlist[] = {
 	{36, 4}, {149, 5}, {0, 0}
 };
 
 
-static struct region_to_chlist a_region_chlist[] = {
+static const struct region_to_chlist a_region_chlist[] = {
 	{0, a_reg0_chlist},
 	{1, a_reg1_chlist},
 	{2, a_reg2_chlist},
@@ -368,13 +371,13 @@ int get_valid_channels(const char *ifname, int band, int bw, const char *cc,
 				uint32_t *chs, int *n, uint32_t filter)
 {
 	int region = 0;
-	struct chlist *cx;
+	const struct chlist *cx;
 	int i = 0;
 	int nr = 0;
 	int idx = 0;
 	struct channelx chanlist[32] = {0};
 	int bw_factor = bw / 20;
-	int rem = 0;
+	int num = 0;
 	int grp = 0;
 	int grp120 = -1, grp124 = -1, grp128 = -1;
 
@@ -420,9 +423,9 @@ int get_valid_channels(const char *ifname, int band, int bw, const char *cc,
 	while (a_region_chlist[region].list[idx].start) {
 		i = 0;
 		cx = a_region_chlist[region].list + idx;
-		rem = cx->num % bw_factor;
-		cx->num -= rem;
-		for (i = 0; i < cx->num; i++) {
+		/* whole channel groups of 'bw' only */
+		num = cx->num - cx->num % bw_factor;
+		for (i = 0; i < num; i++) {
 			chanlist[nr].ch = cx->start + i * 4;
 			if (i % bw_factor == 0)
 				grp++;
@@ -461,6 +464,63 @@ int get_valid_channels(const char *ifname, int band, int bw, const char *cc,
 	return 0;
 }
 
+/* Valid channels as per the regulatory rules the radio's driver enforces,
+ * if it gives them for country 'cc'
+ */
+static int get_reg_channels(const char *ifname, enum wifi_band b,
+			    enum wifi_bw bw, const char *cc, uint32_t *chs,
+			    int *n, uint32_t filter)
+{
+	bool valid[ARRAY_SIZE(def_chlist_6)];
+	const uint32_t *cands;
+	const int *chans;
+	int num;
+	int ret;
+	int i;
+
+	switch (b) {
+	case BAND_2:
+		cands = def_chlist_g;
+		num = def_chlist_g_num;
+		break;
+	case BAND_5:
+		cands = def_chlist_a;
+		num = def_chlist_a_num;
+		break;
+	case BAND_6:
+		cands = def_chlist_6;
+		num = def_chlist_6_num;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	ret = wifi_regdb_check_channels(ifname, cc, b, bw, cands, num, valid);
+	if (ret)
+		return ret;
+
+	*n = 0;
+	for (i = 0; i < num; i++) {
+		if (!valid[i])
+			continue;
+
+		/* exclude tdwr channel groups */
+		if (b == BAND_5 && (filter & FILTER_TDWR)) {
+			chans = chan2list((int)cands[i], 20 << bw);
+			while (chans && *chans && (*chans < 120 || *chans > 128))
+				chans++;
+
+			if (chans && *chans)
+				continue;
+		}
+
+		chs[*n] = cands[i];
+		*n += 1;
+	}
+
+	return 0;
+}
+
 // FIXME: enum band and bw
 int wifi_get_valid_channels(const char *ifname, enum wifi_band b,
 				enum wifi_bw bw, const char *cc,
@@ -492,6 +552,9 @@ int wifi_get_valid_channels(const char *ifname, enum wifi_band b,
 		return -1;	// TODO: handle 8080 and auto
 	}
 
+	if (!get_reg_channels(ifname, b, bw, cc, chlist, n, filter))
+		return 0;
+
 	ret = get_valid_channels(ifname, band, bandwidth, cc, chlist, n, filter);
 	if (ret < 0) {
 		if (band == 5) {
@@ -515,7 +578,7 @@ int wifi_get_valid_channels(const char *ifname, enum wifi_band b,
 ////// opclass related /////////////////////////////////////
 // TODO: move to separate file
 
-static struct wifi_opclass wifi_opclass_global[] = {
+static const struct wifi_opclass wifi_opclass_global[] = {
 	{ 81, 81, BAND_2, BW20, EXTCH_NONE, {20, 13, {{1, {1}},
 						      {2, {2}},
 						      {3, {3}},
@@ -764,7 +827,7 @@ static struct wifi_opclass wifi_opclass_global[] = {
 #define wifi_opclass_global_size	\
 	sizeof(wifi_opclass_global)/sizeof(wifi_opclass_global[0])
 
-static struct wifi_opclass wifi_opclass_eu[] = {
+static const struct wifi_opclass wifi_opclass_eu[] = {
 	{ 1, 115, BAND_5, BW20, EXTCH_NONE, {23, 4, {{36}, {40}, {44}, {48}}}},
 	{ 2, 118, BAND_5, BW20, EXTCH_NONE, {23, 4, {{52}, {56}, {60}, {64}}}},
 	{ 3, 121, BAND_5, BW20, EXTCH_NONE, {30, 11, {{100}, {104}, {108}, {112}, {116}, {120}, {124}, \
@@ -788,7 +851,7 @@ static struct wifi_opclass wifi_opclass_eu[] = {
 		sizeof(wifi_opclass_eu)/sizeof(wifi_opclass_eu[0])
 
 
-static struct wifi_opclass wifi_opclass_us[] = {
+static const struct wifi_opclass wifi_opclass_us[] = {
 	{ 1, 115, BAND_5, BW20, EXTCH_NONE, {23, 4, {{36}, {40}, {44}, {48}}}},
 	{ 2, 118, BAND_5, BW20, EXTCH_NONE, {23, 4, {{52}, {56}, {60}, {64}}}},
 	{ 3, 124, BAND_5, BW20, EXTCH_NONE, {36, 6, {{149}, {153}, {157}, {161}}}},
@@ -840,7 +903,7 @@ struct country_regdomain {
 #define jp_countries	"JP"
 #define cn_countries	"CN"
 
-static struct country_regdomain creglist[] = {
+static const struct country_regdomain creglist[] = {
 	[REG_EU] = {{eu_countries, NULL}},
 	[REG_US] = {{us_countries, NULL}},
 	[REG_JP] = {{jp_countries, NULL}},
@@ -872,16 +935,16 @@ int wifi_get_opclass_internal(enum wifi_regdomain reg, enum wifi_band b,
 			struct wifi_opclass *o)
 {
 	int i, j;
-	struct wifi_opclass *tab;
+	const struct wifi_opclass *tab;
 	int tabsize;
 
 	switch (reg) {
 	case REG_EU:
-		tab = (struct wifi_opclass *)wifi_opclass_eu;
+		tab = wifi_opclass_eu;
 		tabsize = wifi_opclass_eu_size;
 		break;
 	case REG_US:
-		tab = (struct wifi_opclass *)wifi_opclass_us;
+		tab = wifi_opclass_us;
 		tabsize = wifi_opclass_us_size;
 		break;
 	case REG_JP:
@@ -896,7 +959,7 @@ int wifi_get_opclass_internal(enum wifi_regdomain reg, enum wifi_band b,
 		break;
 	case REG_GLOBAL:
 	default:
-		tab = (struct wifi_opclass *)wifi_opclass_global;
+		tab = wifi_opclass_global;
 		tabsize = wifi_opclass_global_size;
 		break;
 	}
@@ -905,7 +968,7 @@ int wifi_get_opclass_internal(enum wifi_regdomain reg, enum wifi_band b,
 		return -1;
 
 	for (i = 0; i < tabsize; i++) {
-		struct wifi_opclass *ptr = tab + i;
+		const struct wifi_opclass *ptr = tab + i;
 
 		if (ptr->band == b && ptr->bw == bw) {
 			for (j = 0; j < ptr->opchannel.num; j++) {
@@ -979,15 +1042,15 @@ int wifi_get_opclass(const char *name, struct wifi_opclass *o)
 
 int wifi_opclass_to_channels(uint32_t opclass, int *num, uint32_t *channels)
 {
-	struct wifi_opclass *tab;
-	struct wifi_opclass *ptr;
+	const struct wifi_opclass *tab;
+	const struct wifi_opclass *ptr;
 	int tabsize;
 	int i;
 
 	if (!num || !channels)
 		return -1;
 
-	tab = (struct wifi_opclass *)wifi_opclass_global;
+	tab = wifi_opclass_global;
 	tabsize = wifi_opclass_global_size;
 
 	for (i = 0; i < tabsize; i++) {
@@ -1022,17 +1085,17 @@ int wifi_get_supported_opclass_internal(enum wifi_regdomain reg,
 				uint32_t bands, enum wifi_bw bw,
 				int *num, struct wifi_opclass *o)
 {
-	struct wifi_opclass *tab;
+	const struct wifi_opclass *tab;
 	int tabsize;
 	int i;
 
 	switch (reg) {
 	case REG_EU:
-		tab = (struct wifi_opclass *)wifi_opclass_eu;
+		tab = wifi_opclass_eu;
 		tabsize = wifi_opclass_eu_size;
 		break;
 	case REG_US:
-		tab = (struct wifi_opclass *)wifi_opclass_us;
+		tab = wifi_opclass_us;
 		tabsize = wifi_opclass_us_size;
 		break;
 	case REG_JP:
@@ -1047,7 +1110,7 @@ int wifi_get_supported_opclass_internal(enum wifi_regdomain reg,
 		break;
 	case REG_GLOBAL:
 	default:
-		tab = (struct wifi_opclass *)wifi_opclass_global;
+		tab = wifi_opclass_global;
 		tabsize = wifi_opclass_global_size;
 		break;
 	}
@@ -1058,7 +1121,7 @@ int wifi_get_supported_opclass_internal(enum wifi_regdomain reg,
 	*num = 0;
 
 	for (i = 0; i < tabsize; i++) {
-		struct wifi_opclass *ptr = tab + i;
+		const struct wifi_opclass *ptr = tab + i;
 
 		if (ptr->band & bands) {
 			memcpy(o + *num, ptr, sizeof(struct wifi_opclass));
@@ -1134,11 +1197,184 @@ int wifi_get_sideband(const char *name, enum wifi_chan_ext *sideband)
 	return 0;
 }
 
+/* Per-radio storage for the channels and opclass tables the channel
+ * preference is worked out in. It is grown to what the driver reports and
+ * kept for the next call; its lock serializes the calls of a radio.
+ */
+struct radio_arena {
+	char name[16];
+	pthread_mutex_t lock;
+	struct chan_entry *chan;
+	int chan_max;
+	struct wifi_opclass *opclass;
+	int opclass_max;
+	struct chscore score;
+	struct radio_arena *next;
+};
+
+#define RADIO_ARENA_CHANNELS		64
+#define RADIO_ARENA_MAX_CHANNELS	1024
+
+static struct radio_arena *radio_arenas;
+static pthread_mutex_t radio_arenas_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Get the arena of a radio locked; unlock it with radio_arena_put() */
+static struct radio_arena *radio_arena_get(const char *name)
+{
+	struct radio_arena *a;
+
+	pthread_mutex_lock(&radio_arenas_lock);
+	for (a = radio_arenas; a; a = a->next) {
+		if (!strncmp(a->name, name, sizeof(a->name)))
+			break;
+	}
+
+	if (!a) {
+		a = calloc(1, sizeof(*a));
+		if (!a) {
+			pthread_mutex_unlock(&radio_arenas_lock);
+			return NULL;
+		}
+
+		strncpy(a->name, name, sizeof(a->name) - 1);
+		pthread_mutex_init(&a->lock, NULL);
+		a->next = radio_arenas;
+		radio_arenas = a;
+	}
+	pthread_mutex_unlock(&radio_arenas_lock);
+
+	pthread_mutex_lock(&a->lock);
+	return a;
+}
+
+static void radio_arena_put(struct radio_arena *a)
+{
+	pthread_mutex_unlock(&a->lock);
+}
+
+static void *radio_arena_grow(void *p, int *max, int num, size_t size)
+{
+	void *n;
+
+	if (num <= *max)
+		return p;
+
+	n = realloc(p, (size_t)num * size);
+	if (!n)
+		return NULL;
+
+	*max = num;
+	return n;
+}
+
+static int radio_channels_info(const char *name, struct chan_entry *channel, int *num);
+
+/* Get all channels of the radio into its arena; a driver which filled it
+ * may have more, so it is asked again with twice the room.
+ */
+static int radio_arena_channels(const char *name, struct radio_arena *a,
+				int *num)
+{
+	struct chan_entry *chan;
+	int max = a->chan_max ? a->chan_max : RADIO_ARENA_CHANNELS;
+	int ret;
+
+	for (;;) {
+		chan = radio_arena_grow(a->chan, &a->chan_max, max, sizeof(*chan));
+		if (!chan)
+			return -ENOMEM;
+
+		a->chan = chan;
+		*num = a->chan_max;
+		ret = radio_channels_info(name, a->chan, num);
+		if (ret || *num < a->chan_max ||
+		    a->chan_max >= RADIO_ARENA_MAX_CHANNELS)
+			return ret;
+
+		max = a->chan_max * 2;
+	}
+}
+
+/* Get room for 'num' opclasses in the arena */
+static struct wifi_opclass *radio_arena_opclass(struct radio_arena *a, int num)
+{
+	struct wifi_opclass *o;
+
+	o = radio_arena_grow(a->opclass, &a->opclass_max, num, sizeof(*o));
+	if (!o)
+		return NULL;
+
+	a->opclass = o;
+	memset(o, 0, (size_t)num * sizeof(*o));
+	return o;
+}
+
+/* Get channels of the radio, cached until its regulatory, DFS or channel
+ * state changes, with the DFS state as tracked from its DFS events.
+ */
+static int radio_channels_info(const char *name, struct chan_entry *channel, int *num)
+{
+	int max = *num;
+	uint32_t ticket;
+	int ret;
+	int err;
+
+	ret = wifi_opclass_cache_get(name, OPCLASS_CACHE_CHANNELS, channel, num,
+				     sizeof(*channel), &ticket);
+	if (ret) {
+		*num = max;
+		err = wifi_channels_info(name, channel, num);
+		if (err)
+			return err;
+
+		if (ret == -ENOENT)
+			wifi_opclass_cache_put(name, OPCLASS_CACHE_CHANNELS,
+					       ticket, channel, *num, max,
+					       sizeof(*channel));
+	}
+
+	wifi_dfs_update_channels(name, channel, *num);
+	return 0;
+}
+
+/* Get an opclass table of the radio through its cache */
+static int radio_opclass_cached(const char *name, enum opclass_cache_type type,
+				int *num_opclass, struct wifi_opclass *o,
+				int (*get)(const char *name, int *num_opclass,
+					   struct wifi_opclass *o))
+{
+	uint32_t ticket;
+	int max;
+	int ret;
+	int err;
+
+	if (WARN_ON(!num_opclass))
+		return -1;
+
+	max = *num_opclass;
+	ret = wifi_opclass_cache_get(name, type, o, num_opclass, sizeof(*o),
+				     &ticket);
+	if (!ret)
+		return 0;
+
+	*num_opclass = max;
+	err = get(name, num_opclass, o);
+	if (err)
+		return err;
+
+	if (ret == -ENOENT)
+		wifi_opclass_cache_put(name, type, ticket, o, *num_opclass, max,
+				       sizeof(*o));
+
+	return 0;
+}
+
 bool wifi_is_dfs_channel(const char *name, int channel, int bandwidth)
 {
-	struct chan_entry channels[64] = {};
-	int channels_num = ARRAY_SIZE(channels);
+	struct radio_arena *a;
+	int channels_num;
 	const int *chans;
+	bool dfs = false;
 	int i;
 
 	libwifi_dbg("[%s] %s called\n", name, __func__);
@@ -1146,21 +1382,29 @@ bool wifi_is_dfs_channel(const char *name, int channel, int bandwidth)
 	if (channel <= 14)
 		return false;
 
-	if (WARN_ON(wifi_channels_info(name, channels, &channels_num)))
+	a = radio_arena_get(name);
+	if (WARN_ON(!a))
 		return false;
 
+	if (WARN_ON(radio_arena_channels(name, a, &channels_num)))
+		goto out;
+
 	/* Check if at least one DFS channel */
 	chans = chan2list(channel, bandwidth);
 
-	while (chans && *chans) {
+	while (!dfs && chans && *chans) {
 		for (i = 0; i < channels_num; i++) {
-			if (channels[i].channel == *chans && channels[i].dfs)
-				return true;
+			if (a->chan[i].channel == *chans && a->chan[i].dfs) {
+				dfs = true;
+				break;
+			}
 		}
 		chans++;
 	}
 
-	return false;
+out:
+	radio_arena_put(a);
+	return dfs;
 }
 
 struct chanlist {
@@ -1517,148 +1761,84 @@ static uint32_t radio_dfs_nop_time(const char *name, int channel, enum wifi_bw b
 }
 
 static int radio_opclass_recalc_noise(const char *name, int channel, enum wifi_bw bw,
-				      enum wifi_chan_ext sideband, struct chan_entry *chan,
-				      int chan_num)
+				      enum wifi_chan_ext sideband, struct chscore *cs)
 {
-	int noise = -255;
 	const int *channels;
 	int bandwidth;
-	int i;
+	int noise;
 
 	/* Get adjacent channels we should care */
 	bandwidth = wifi_bw_enum2MHz(bw);
 	channels = radio_chan2list(channel, bandwidth, sideband);
 
 	/* Get worst (highest) noise value */
-	while (channels && *channels) {
-		for (i = 0; i < chan_num; i++) {
-			if (chan[i].channel != *channels)
-				continue;
-
-			if (chan[i].noise > noise)
-				noise = chan[i].noise;
-			break;
-		}
-		channels++;
-	}
+	noise = wifi_chscore_noise(cs, channels);
 
 	libwifi_dbg("[%s] score chan %d/%d new noise %d\n", name, channel, bandwidth, noise);
 	return noise;
 }
 
 static uint8_t radio_opclass_recalc_busy(const char *name, int channel, enum wifi_bw bw,
-					 enum wifi_chan_ext sideband, struct chan_entry *chan,
-					 int chan_num)
+					 enum wifi_chan_ext sideband, struct chscore *cs)
 {
 	const int *channels;
 	int bandwidth;
-	int busy = 0;
-	int busy_num = 0;
-	int i;
+	uint8_t busy;
 
 	/* Get adjacent channels we should care */
 	bandwidth = wifi_bw_enum2MHz(bw);
 	channels = radio_chan2list(channel, bandwidth, sideband);
 
-	/* Get average value */
-	while (channels && *channels) {
-		for (i = 0; i < chan_num; i++) {
-			if (chan[i].channel != *channels)
-				continue;
-
-			/* If invalid value for one channel - mark bw invalid */
-			if (chan[i].busy > 100)
-				return 255;
-
-			busy += chan[i].busy;
-			busy_num++;
-			break;
-		}
-		channels++;
-	}
-
-	if (!busy_num)
-		return 255;
-
-	busy = busy/busy_num;
+	/* Get average value, invalid if invalid for one channel */
+	busy = wifi_chscore_busy(cs, channels);
 	libwifi_dbg("[%s] avg busy %d\n", name, busy);
-	return (uint8_t)((busy > 255) ? 255 : busy);
+	return busy;
 }
 
 static uint8_t radio_opclass_bss_num(const char *name, int channel, enum wifi_bw bw,
-				     enum wifi_chan_ext sideband, struct chan_entry *chan,
-				     int chan_num, struct wifi_bss *bss, int bss_num)
+				     enum wifi_chan_ext sideband, enum wifi_band band,
+				     struct chscore *cs)
 {
-	const int *chans, *channels;
+	const int *channels;
 	int bandwidth;
-	uint8_t num = 0;
-	int i;
+	int num;
 
 	bandwidth = wifi_bw_enum2MHz(bw);
 	channels = radio_adjacent_channels(channel, bandwidth, sideband);
-	for (i = 0; i < bss_num; i++) {
-		chans = channels;
-		while (chans && *chans) {
-			if (bss[i].channel == *chans) {
-				num++;
-				libwifi_dbg("[%s] chan %d/%d new bss (bss %s chan %d) num: %d\n",
-					    name, channel, bandwidth, bss[i].ssid, *chans, num);
-			}
-			chans++;
-		}
-	}
+	num = wifi_chscore_bss_num(cs, band, channels);
+	libwifi_dbg("[%s] chan %d/%d %d bss on adjacent channels\n",
+		    name, channel, bandwidth, num);
 
-	return num;
+	return (uint8_t)(num > 255 ? 255 : num);
 }
 
 static uint8_t radio_opclass_recalc_score(const char *name, int channel, enum wifi_bw bw,
-					  enum wifi_chan_ext sideband, struct chan_entry *chan,
-					  int chan_num, struct wifi_bss *bss, int bss_num,
-					  struct chan_entry *cur)
+					  enum wifi_chan_ext sideband, struct chscore *cs,
+					  enum wifi_band band, struct chan_entry *cur)
 {
+	const struct chan_entry *ctrl;
 	const int *channels;
-	int score_num = 0;
+	int bss_num;
 	int bandwidth;
 	int score = 0;
 	int delta = 0;
-	int i;
 
 	/* Get adjacent channels we should care */
 	bandwidth = wifi_bw_enum2MHz(bw);
 	channels = radio_chan2list(channel, bandwidth, sideband);
 
-	for (i = 0; i < chan_num; i++) {
-		if (chan[i].channel == cur->channel) {
-			cur->score = chan[i].score;
-			break;
-		}
-	}
+	ctrl = wifi_chscore_chan(cs, (int)cur->channel);
+	if (ctrl)
+		cur->score = ctrl->score;
 
 	libwifi_dbg("[%s] stage1: chan %d/20 ctrl chan score %d\n",
 		    name, channel, cur->score);
 
-	/* Get average score value */
-	while (channels && *channels) {
-		for (i = 0; i < chan_num; i++) {
-			if (chan[i].channel != *channels)
-				continue;
-
-			/* If any score invalid - report invalid also */
-			if (chan[i].score == 255)
-				return 255;
-
-			score += chan[i].score;
-			score_num++;
-			break;
-		}
-		channels++;
-	}
-
-	if (!score_num)
+	/* Get average score value; if any score invalid - report invalid also */
+	score = wifi_chscore_score(cs, channels);
+	if (score == 255)
 		return 255;
 
-	score = score/score_num;
-
 	libwifi_dbg("[%s] stage2: chan %d/%d avg score %d\n",
 		    name, channel, bandwidth, score);
 
@@ -1684,6 +1864,7 @@ static uint8_t radio_opclass_recalc_score(const char *name, int channel, enum wi
 		return (uint8_t)(score > 255 ? 255 : score);
 
 	/* Now check BSSes */
+	bss_num = wifi_chscore_band_bss_num(cs, band);
 	if (bss_num < 20)
 		delta = cur->bss_num * 3;
 	else
@@ -1738,7 +1919,7 @@ static bool radio_channel_supported(struct chan_entry *channel, enum wifi_band b
 }
 
 static int radio_update_opclass(const char *name, struct wifi_opclass *opclass, struct chan_entry *chan,
-				int chan_num, struct wifi_bss *scan_bss, int scan_bss_num, uint32_t supp_bw)
+				int chan_num, uint32_t supp_bw, struct chscore *cs)
 {
 	enum wifi_chan_ext sideband = EXTCH_NONE;
 	struct chan_entry *chan_entry;
@@ -1796,36 +1977,30 @@ static int radio_update_opclass(const char *name, struct wifi_opclass *opclass,
 							chan_entry->channel,
 							opclass->bw,
 							sideband,
-							chan,
-							chan_num);
+							cs);
 
 		chan_entry->busy = radio_opclass_recalc_busy(
 							name,
 							chan_entry->channel,
 							opclass->bw,
 							sideband,
-							chan,
-							chan_num);
+							cs);
 
 		chan_entry->bss_num = radio_opclass_bss_num(
 							name,
 							chan_entry->channel,
 							opclass->bw,
 							sideband,
-							chan,
-							chan_num,
-							scan_bss,
-							scan_bss_num);
+							opclass->band,
+							cs);
 
 		chan_entry->score = radio_opclass_recalc_score(
 							name,
 							chan_entry->channel,
 							opclass->bw,
 							sideband,
-							chan,
-							chan_num,
-							scan_bss,
-							scan_bss_num,
+							cs,
+							opclass->band,
 							chan_entry);
 
 		chan_entry->dfs_state = radio_opclass_dfs_state(
@@ -1875,42 +2050,38 @@ static int radio_update_opclass(const char *name, struct wifi_opclass *opclass,
 static int radio_update_opclass_channels(const char *name, struct wifi_opclass *opclass,
 					 struct chan_entry *chan, int chan_num)
 {
-	struct chan_entry opclass_ch[64] = {};
 	struct chan_entry *chan_entry;
 	int opclass_ch_num = 0;
 	int i;
 
+	/* Drop unsupported channels in place; kept ones only move down */
 	for (i = 0; i < opclass->opchannel.num; i++) {
 		chan_entry = &opclass->opchannel.ch[i];
 		/* TODO check chan/bw also here */
 		if (!radio_channel_supported(chan_entry, opclass->band, chan, chan_num))
 			continue;
 
-		if (WARN_ON(opclass_ch_num >= ARRAY_SIZE(opclass_ch)))
-			break;
-
-		/* Copy chan_entry */
-		memcpy(&opclass_ch[opclass_ch_num], chan_entry, sizeof(*chan_entry));
+		if (opclass_ch_num != i)
+			memcpy(&opclass->opchannel.ch[opclass_ch_num], chan_entry,
+			       sizeof(*chan_entry));
 		opclass_ch_num++;
 	}
 
-
-	if (WARN_ON(opclass_ch_num >= ARRAY_SIZE(opclass->opchannel.ch)))
-		return -1;
-
-	memset(opclass->opchannel.ch, 0x0, sizeof(opclass->opchannel.ch));
-	memcpy(opclass->opchannel.ch, opclass_ch, opclass_ch_num * sizeof(struct chan_entry));
+	memset(&opclass->opchannel.ch[opclass_ch_num], 0x0,
+	       (ARRAY_SIZE(opclass->opchannel.ch) - (size_t)opclass_ch_num) *
+	       sizeof(struct chan_entry));
 	opclass->opchannel.num = (uint8_t)opclass_ch_num;
 
 	return (opclass_ch_num ? 0 : -1);
 }
 
-int wifi_get_supported_opclass(const char *name, int *num_opclass, struct wifi_opclass *o)
+static int radio_get_supported_opclass(const char *name, int *num_opclass, struct wifi_opclass *o)
 {
-	struct chan_entry channel[64];
-	int channel_num = ARRAY_SIZE(channel);
 	struct wifi_opclass *rd_opclass = NULL;
+	struct radio_arena *a = NULL;
 	struct wifi_opclass *opclass;
+	struct chan_entry *channel;
+	int channel_num;
 	int i, rd_num_opclass;
 	uint32_t supp_bw = 0;
 	int num, max;
@@ -1934,14 +2105,21 @@ int wifi_get_supported_opclass(const char *name, int *num_opclass, struct wifi_o
 	if (WARN_ON(ret))
 		return ret;
 
-	ret = wifi_channels_info(name, channel, &channel_num);
+	a = radio_arena_get(name);
+	if (WARN_ON(!a))
+		return -1;
+
+	ret = radio_arena_channels(name, a, &channel_num);
 	if (WARN_ON(ret))
-		return ret;
+		goto end;
 
-	rd_opclass = calloc(max, sizeof(struct wifi_opclass));
+	channel = a->chan;
+	rd_opclass = radio_arena_opclass(a, max);
 	WARN_ON(!rd_opclass);
-	if (!rd_opclass)
-		return -1;
+	if (!rd_opclass) {
+		ret = -1;
+		goto end;
+	}
 
 	rd_num_opclass = max;
 	ret  = _radio_get_supported_opclass(name, &rd_num_opclass, rd_opclass);
@@ -1969,31 +2147,65 @@ int wifi_get_supported_opclass(const char *name, int *num_opclass, struct wifi_o
 
 	*num_opclass = num;
 end:
-	free(rd_opclass);
+	radio_arena_put(a);
 	return ret;
 }
 
+int wifi_get_supported_opclass(const char *name, int *num_opclass, struct wifi_opclass *o)
+{
+	return radio_opclass_cached(name, OPCLASS_CACHE_SUPPORTED, num_opclass, o,
+				    radio_get_supported_opclass);
+}
+
 bool wifi_is_dfs_usable(const char *name, int chan, enum wifi_bw bw)
 {
-	struct chan_entry channel[64];
-	int channel_num = ARRAY_SIZE(channel);
+	struct radio_arena *a;
+	int channel_num;
+	bool usable;
 	int ret;
 
-	ret = wifi_channels_info(name, channel, &channel_num);
-	if (WARN_ON(ret))
+	if (!wifi_dfs_is_usable(name, (uint32_t)chan, bw, &usable))
+		return usable;
+
+	a = radio_arena_get(name);
+	if (WARN_ON(!a))
 		return false;
 
-	return radio_opclass_dfs_usable(chan, bw, channel, channel_num);
+	ret = radio_arena_channels(name, a, &channel_num);
+	usable = !WARN_ON(ret) &&
+		 radio_opclass_dfs_usable(chan, bw, a->chan, channel_num);
+
+	radio_arena_put(a);
+	return usable;
 }
 
-int wifi_get_opclass_pref(const char *name, int *num_opclass, struct wifi_opclass *o)
+/* Scan results are recorded in the BSS database as they are passed on */
+static int radio_bssdb_seen(struct wifi_bss *bss, void *priv)
+{
+	return 0;
+}
+
+/* Get scan results of the radio into the BSS database, unless it has
+ * recent ones already.
+ */
+static void radio_bssdb_refresh(const char *name)
+{
+	uint64_t now = time_monotonic_msecs();
+
+	if (!wifi_bssdb_need_refresh(name, now))
+		return;
+
+	if (!WARN_ON(wifi_iterate_scan_results(name, NULL, radio_bssdb_seen, NULL)))
+		wifi_bssdb_update(name, NULL, 0, true, now);
+}
+
+static int radio_get_opclass_pref(const char *name, int *num_opclass, struct wifi_opclass *o)
 {
-	struct chan_entry channel[64];
-	int channel_num = ARRAY_SIZE(channel);
-	struct wifi_bss scan_bss[128]={0};
-	int scan_bss_num = ARRAY_SIZE(scan_bss);
 	struct wifi_opclass *rd_opclass = NULL;
+	struct radio_arena *a = NULL;
 	struct wifi_opclass *opclass;
+	struct chan_entry *channel;
+	int channel_num;
 	int i, rd_num_opclass;
 	uint32_t supp_bw = 0;
 	int num, max;
@@ -2017,16 +2229,26 @@ int wifi_get_opclass_pref(const char *name, int *num_opclass, struct wifi_opclas
 	if (WARN_ON(ret))
 		return ret;
 
-	ret = wifi_channels_info(name, channel, &channel_num);
-	if (WARN_ON(ret))
-		return ret;
+	radio_bssdb_refresh(name);
 
-	WARN_ON(wifi_get_scan_results(name, scan_bss, &scan_bss_num));
+	a = radio_arena_get(name);
+	if (WARN_ON(!a))
+		return -1;
 
-	rd_opclass = calloc(max, sizeof(struct wifi_opclass));
+	ret = radio_arena_channels(name, a, &channel_num);
+	if (WARN_ON(ret))
+		goto end;
+
+	channel = a->chan;
+	rd_opclass = radio_arena_opclass(a, max);
 	WARN_ON(!rd_opclass);
-	if (!rd_opclass)
-		return -1;
+	if (!rd_opclass) {
+		ret = -1;
+		goto end;
+	}
+
+	/* per channel aggregates, wider channels' ones are got from */
+	wifi_chscore_init(&a->score, channel, channel_num);
 
 	rd_num_opclass = max;
 	ret  = _radio_get_supported_opclass(name, &rd_num_opclass, rd_opclass);
@@ -2041,8 +2263,8 @@ int wifi_get_opclass_pref(const char *name, int *num_opclass, struct wifi_opclas
 		if (WARN_ON(num >= max))
 			break;
 
-		radio_update_opclass(name, opclass, channel, channel_num,
-				     scan_bss, scan_bss_num, supp_bw);
+		radio_update_opclass(name, opclass, channel, channel_num, supp_bw,
+				     &a->score);
 
 		/* Finally if bw/channel(s) supported */
 		memcpy(&o[num], opclass, sizeof(*opclass));
@@ -2051,6 +2273,103 @@ int wifi_get_opclass_pref(const char *name, int *num_opclass, struct wifi_opclas
 
 	*num_opclass = num;
 end:
-	free(rd_opclass);
+	radio_arena_put(a);
+	return ret;
+}
+
+int wifi_get_opclass_pref(const char *name, int *num_opclass, struct wifi_opclass *o)
+{
+	/* preferences are scored on neighbours too; redo them on new ones */
+	if (wifi_bssdb_need_refresh(name, time_monotonic_msecs()))
+		wifi_opclass_cache_drop(name, OPCLASS_CACHE_PREF);
+
+	return radio_opclass_cached(name, OPCLASS_CACHE_PREF, num_opclass, o,
+				    radio_get_opclass_pref);
+}
+
+static int radio_channel_rank_cmp(const void *a, const void *b)
+{
+	const struct wifi_channel_rank *x = a;
+	const struct wifi_channel_rank *y = b;
+
+	if (x->score != y->score)
+		return y->score - x->score;
+
+	if (x->bss_num != y->bss_num)
+		return x->bss_num - y->bss_num;
+
+	if (x->busy != y->busy)
+		return x->busy - y->busy;
+
+	return x->channel - y->channel;
+}
+
+int wifi_get_best_channels(const char *name, enum wifi_band band,
+			   enum wifi_bw bw, struct wifi_channel_rank *r,
+			   int *num)
+{
+	int num_opclass = wifi_opclass_global_size;
+	struct wifi_channel_rank *rank = NULL;
+	struct wifi_opclass *opclass;
+	struct chan_entry *ch;
+	int num_rank = 0;
+	int max_rank = 0;
+	int ret;
+	int i, j;
+
+	if (WARN_ON(!r || !num || *num <= 0))
+		return -EINVAL;
+
+	opclass = calloc((size_t)num_opclass, sizeof(*opclass));
+	if (WARN_ON(!opclass))
+		return -ENOMEM;
+
+	ret = wifi_get_opclass_pref(name, &num_opclass, opclass);
+	if (WARN_ON(ret))
+		goto out;
+
+	for (i = 0; i < num_opclass; i++) {
+		if (opclass[i].band == band && opclass[i].bw == bw)
+			max_rank += opclass[i].opchannel.num;
+	}
+
+	rank = calloc(max_rank ? (size_t)max_rank : 1, sizeof(*rank));
+	if (WARN_ON(!rank)) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	/* channels not supported, or without a score, aren't ranked */
+	for (i = 0; i < num_opclass; i++) {
+		if (opclass[i].band != band || opclass[i].bw != bw)
+			continue;
+
+		for (j = 0; j < opclass[i].opchannel.num; j++) {
+			ch = &opclass[i].opchannel.ch[j];
+			if (!ch->score || ch->score == 255)
+				continue;
+
+			rank[num_rank].opclass = (uint8_t)opclass[i].g_opclass;
+			rank[num_rank].channel = (uint8_t)ch->channel;
+			rank[num_rank].score = ch->score;
+			rank[num_rank].busy = ch->busy;
+			rank[num_rank].bss_num = ch->bss_num;
+			rank[num_rank].noise = ch->noise;
+			rank[num_rank].dfs = ch->dfs;
+			rank[num_rank].dfs_state = ch->dfs_state;
+			num_rank++;
+		}
+	}
+
+	qsort(rank, (size_t)num_rank, sizeof(*rank), radio_channel_rank_cmp);
+
+	if (num_rank > *num)
+		num_rank = *num;
+
+	memcpy(r, rank, (size_t)num_rank * sizeof(*rank));
+	*num = num_rank;
+out:
+	free(rank);
+	free(opclass);
 	return ret;
 }
@@ -0,0 +1,248 @@
+/*
+ * chscore.c - channel scores from per 20MHz channel aggregates
+ *
+ * The noise, busy and score of each channel of a radio, and the number of
+ * neighbor BSSs on it, are gathered once per channel list and scan update
+ * into tables by channel number and prefix sums over runs of channels 1
+ * and 4 apart. Those of a wider channel are then got from its member
+ * channels without looking each of them up in the channel list or the BSS
+ * database again.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+static const enum wifi_band chscore_bands[CHSCORE_NUM_BANDS] = {
+	BAND_2, BAND_5, BAND_6, BAND_60,
+};
+
+static int chscore_band(enum wifi_band band)
+{
+	int i;
+
+	for (i = 0; i < CHSCORE_NUM_BANDS; i++) {
+		if (chscore_bands[i] == band)
+			return i;
+	}
+
+	return -1;
+}
+
+/* Turn per channel values in 'by1[1..]' into the prefix sums */
+static void chscore_sum_build(struct chscore_sum *s)
+{
+	uint32_t lane[4] = { 0 };
+	uint32_t sum = 0;
+	uint32_t v;
+	int c, l;
+
+	s->by1[0] = 0;
+	for (l = 0; l < 4; l++)
+		s->by4[l][0] = 0;
+
+	for (c = 0; c < CHSCORE_NUM_CHANNELS; c += 4) {
+		for (l = 0; l < 4; l++) {
+			v = s->by1[c + l + 1];
+			sum += v;
+			lane[l] += v;
+			s->by1[c + l + 1] = sum;
+			s->by4[l][(c >> 2) + 1] = lane[l];
+		}
+	}
+}
+
+static void chscore_sum_set(struct chscore_sum *s, int channel, uint32_t v)
+{
+	s->by1[channel + 1] = v;
+}
+
+static uint32_t chscore_sum_get(const struct chscore_sum *s, int channel)
+{
+	return s->by1[channel + 1] - s->by1[channel];
+}
+
+/* Sum over member channels; a run of channels 1 or 4 apart, as all of
+ * chan2list() are, is got from the prefix sums, others one by one.
+ */
+static uint32_t chscore_sum(const struct chscore_sum *s, const int *chans)
+{
+	bool lane = true;
+	uint32_t sum = 0;
+	int lo = CHSCORE_NUM_CHANNELS;
+	int hi = -1;
+	int n = 0;
+	int i;
+
+	for (i = 0; chans[i]; i++) {
+		if (chans[i] < 0 || chans[i] >= CHSCORE_NUM_CHANNELS)
+			return 0;
+
+		if (chans[i] < lo)
+			lo = chans[i];
+		if (chans[i] > hi)
+			hi = chans[i];
+		lane &= (chans[i] & 3) == (chans[0] & 3);
+		n++;
+	}
+
+	if (!n)
+		return 0;
+
+	if (hi - lo == n - 1)
+		return s->by1[hi + 1] - s->by1[lo];
+
+	if (lane && hi - lo == 4 * (n - 1))
+		return s->by4[lo & 3][(hi >> 2) + 1] - s->by4[lo & 3][lo >> 2];
+
+	for (i = 0; i < n; i++)
+		sum += chscore_sum_get(s, chans[i]);
+
+	return sum;
+}
+
+void wifi_chscore_init(struct chscore *cs, const struct chan_entry *chan,
+		       int chan_num)
+{
+	uint16_t count[CHSCORE_NUM_CHANNELS];
+	const struct chan_entry *ch;
+	int c, i;
+
+	memset(cs->idx, 0xff, sizeof(cs->idx));
+	cs->chan = chan;
+
+	/* a channel number is taken for its first entry */
+	for (i = chan_num - 1; i >= 0; i--) {
+		if (chan[i].channel < CHSCORE_NUM_CHANNELS)
+			cs->idx[chan[i].channel] = (int16_t)i;
+	}
+
+	for (c = 0; c < CHSCORE_NUM_CHANNELS; c++) {
+		ch = cs->idx[c] < 0 ? NULL : &chan[cs->idx[c]];
+
+		chscore_sum_set(&cs->busy_bad, c, ch && ch->busy > 100);
+		chscore_sum_set(&cs->busy, c, ch && ch->busy <= 100 ? ch->busy : 0);
+		chscore_sum_set(&cs->busy_num, c, ch && ch->busy <= 100);
+
+		chscore_sum_set(&cs->score_bad, c, ch && ch->score == 255);
+		chscore_sum_set(&cs->score, c, ch && ch->score != 255 ? ch->score : 0);
+		chscore_sum_set(&cs->score_num, c, ch && ch->score != 255);
+	}
+
+	chscore_sum_build(&cs->busy);
+	chscore_sum_build(&cs->busy_num);
+	chscore_sum_build(&cs->busy_bad);
+	chscore_sum_build(&cs->score);
+	chscore_sum_build(&cs->score_num);
+	chscore_sum_build(&cs->score_bad);
+
+	/* sums of a band without neighbours aren't looked at */
+	for (i = 0; i < CHSCORE_NUM_BANDS; i++) {
+		cs->band_bss[i] = wifi_bssdb_count_channels(chscore_bands[i], count);
+		if (!cs->band_bss[i])
+			continue;
+
+		for (c = 0; c < CHSCORE_NUM_CHANNELS; c++)
+			chscore_sum_set(&cs->bss[i], c, count[c]);
+
+		chscore_sum_build(&cs->bss[i]);
+	}
+}
+
+/* First entry of a channel number, or NULL */
+const struct chan_entry *wifi_chscore_chan(struct chscore *cs, int channel)
+{
+	if (channel < 0 || channel >= CHSCORE_NUM_CHANNELS ||
+	    cs->idx[channel] < 0)
+		return NULL;
+
+	return &cs->chan[cs->idx[channel]];
+}
+
+/* Worst (highest) noise of the member channels, -255 if none known */
+int wifi_chscore_noise(struct chscore *cs, const int *chans)
+{
+	const struct chan_entry *ch;
+	int noise = -255;
+
+	while (chans && *chans) {
+		ch = wifi_chscore_chan(cs, *chans);
+		if (ch && ch->noise > noise)
+			noise = ch->noise;
+		chans++;
+	}
+
+	return noise;
+}
+
+/* Average busy of the member channels, 255 if any or all is unknown */
+uint8_t wifi_chscore_busy(struct chscore *cs, const int *chans)
+{
+	uint32_t num;
+
+	if (!chans || chscore_sum(&cs->busy_bad, chans))
+		return 255;
+
+	num = chscore_sum(&cs->busy_num, chans);
+	if (!num)
+		return 255;
+
+	num = chscore_sum(&cs->busy, chans) / num;
+	return (uint8_t)(num > 255 ? 255 : num);
+}
+
+/* Average score of the member channels, 255 if any or all is unknown */
+uint8_t wifi_chscore_score(struct chscore *cs, const int *chans)
+{
+	uint32_t num;
+
+	if (!chans || chscore_sum(&cs->score_bad, chans))
+		return 255;
+
+	num = chscore_sum(&cs->score_num, chans);
+	if (!num)
+		return 255;
+
+	return (uint8_t)(chscore_sum(&cs->score, chans) / num);
+}
+
+/* Number of BSSs of a band on the member channels */
+int wifi_chscore_bss_num(struct chscore *cs, enum wifi_band band,
+			 const int *chans)
+{
+	int idx = chscore_band(band);
+
+	if (idx < 0 || !chans || !cs->band_bss[idx])
+		return 0;
+
+	return (int)chscore_sum(&cs->bss[idx], chans);
+}
+
+/* Number of BSSs on all channels of a band */
+int wifi_chscore_band_bss_num(struct chscore *cs, enum wifi_band band)
+{
+	int idx = chscore_band(band);
+
+	return idx < 0 ? 0 : cs->band_bss[idx];
+}
@@ -0,0 +1,219 @@
+/*
+ * coalesce.c - coalescing of concurrent identical driver queries
+ *
+ * When enabled, a query issued while an identical one (same op, ifname
+ * and args) is in flight in another thread does not go to the driver; the
+ * caller waits for the first caller's result and gets a copy of it.
+ * Optionally, a successful result is also reused by identical queries
+ * issued within 'ttl' msecs of its completion.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+#define COALESCE_KEYLEN		32
+
+struct coalesce_entry {
+	enum wifi_coalesce_op op;
+	char ifname[16];
+	uint8_t key[COALESCE_KEYLEN];
+	size_t klen;
+	size_t olen;
+	bool done;
+	int refs;		/* callers waiting for the result */
+	int ret;
+	int num;
+	uint64_t tdone;
+	uint8_t *out;
+	struct coalesce_entry *next;
+};
+
+static pthread_mutex_t coalesce_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t coalesce_cond = PTHREAD_COND_INITIALIZER;
+static struct coalesce_entry *coalesce_list;
+static struct wifi_coalesce_stats coalesce_stats[WIFI_COALESCE_NUM_OPS];
+static bool coalesce_enabled;
+static uint32_t coalesce_ttl;
+
+/* A finished result can be handed out to new callers */
+static bool coalesce_fresh(struct coalesce_entry *e, uint64_t now)
+{
+	return !e->ret && now - e->tdone < coalesce_ttl;
+}
+
+static struct coalesce_entry *coalesce_lookup(enum wifi_coalesce_op op,
+					      const char *ifname,
+					      const void *key, size_t klen,
+					      size_t olen, uint64_t now)
+{
+	struct coalesce_entry *e;
+
+	for (e = coalesce_list; e; e = e->next) {
+		if (e->op != op || e->klen != klen || e->olen != olen ||
+		    strncmp(e->ifname, ifname, sizeof(e->ifname)) ||
+		    (klen && memcmp(e->key, key, klen)))
+			continue;
+
+		if (!e->done || coalesce_fresh(e, now))
+			return e;
+	}
+
+	return NULL;
+}
+
+/* Free the finished results nobody waits for and which can't be reused */
+static void coalesce_reap(uint64_t now)
+{
+	struct coalesce_entry *e, **pe;
+
+	pe = &coalesce_list;
+	while ((e = *pe)) {
+		if (e->done && !e->refs && !coalesce_fresh(e, now)) {
+			*pe = e->next;
+			free(e->out);
+			free(e);
+			continue;
+		}
+
+		pe = &e->next;
+	}
+}
+
+static int coalesce_copy(struct coalesce_entry *e, void *out, int *num)
+{
+	if (e->olen)
+		memcpy(out, e->out, e->olen);
+
+	if (num)
+		*num = e->num;
+
+	return e->ret;
+}
+
+int wifi_coalesce(enum wifi_coalesce_op op, const char *ifname,
+		  const void *key, size_t klen, void *out, size_t olen,
+		  int *num, int (*fn)(void *ctx), void *ctx)
+{
+	struct wifi_coalesce_stats *st;
+	struct coalesce_entry *e;
+	uint64_t now;
+	int ret;
+
+	if (op >= WIFI_COALESCE_NUM_OPS || !ifname || klen > COALESCE_KEYLEN)
+		return fn(ctx);
+
+	pthread_mutex_lock(&coalesce_lock);
+	if (!coalesce_enabled) {
+		pthread_mutex_unlock(&coalesce_lock);
+		return fn(ctx);
+	}
+
+	st = &coalesce_stats[op];
+	now = time_monotonic_msecs();
+	coalesce_reap(now);
+
+	e = coalesce_lookup(op, ifname, key, klen, olen, now);
+	if (e) {
+		if (!e->done) {
+			st->wait++;
+			e->refs++;
+			while (!e->done)
+				pthread_cond_wait(&coalesce_cond, &coalesce_lock);
+			e->refs--;
+		}
+
+		st->hit++;
+		ret = coalesce_copy(e, out, num);
+		coalesce_reap(time_monotonic_msecs());
+		pthread_mutex_unlock(&coalesce_lock);
+		return ret;
+	}
+
+	st->miss++;
+	e = calloc(1, sizeof(*e));
+	if (e && olen) {
+		e->out = malloc(olen);
+		if (!e->out) {
+			free(e);
+			e = NULL;
+		}
+	}
+
+	if (!e) {
+		pthread_mutex_unlock(&coalesce_lock);
+		return fn(ctx);
+	}
+
+	e->op = op;
+	strncpy(e->ifname, ifname, sizeof(e->ifname) - 1);
+	if (klen)
+		memcpy(e->key, key, klen);
+	e->klen = klen;
+	e->olen = olen;
+	e->next = coalesce_list;
+	coalesce_list = e;
+	pthread_mutex_unlock(&coalesce_lock);
+
+	ret = fn(ctx);
+
+	pthread_mutex_lock(&coalesce_lock);
+	e->ret = ret;
+	if (olen)
+		memcpy(e->out, out, olen);
+	e->num = num ? *num : 0;
+	e->tdone = time_monotonic_msecs();
+	e->done = true;
+	pthread_cond_broadcast(&coalesce_cond);
+	coalesce_reap(e->tdone);
+	pthread_mutex_unlock(&coalesce_lock);
+
+	return ret;
+}
+
+int wifi_coalesce_config(bool enable, uint32_t ttl)
+{
+	pthread_mutex_lock(&coalesce_lock);
+	coalesce_enabled = enable;
+	coalesce_ttl = ttl;
+	coalesce_reap(time_monotonic_msecs());
+	pthread_mutex_unlock(&coalesce_lock);
+
+	return 0;
+}
+
+int wifi_get_coalesce_stats(enum wifi_coalesce_op op,
+			    struct wifi_coalesce_stats *s)
+{
+	if (op >= WIFI_COALESCE_NUM_OPS || !s)
+		return -EINVAL;
+
+	pthread_mutex_lock(&coalesce_lock);
+	memcpy(s, &coalesce_stats[op], sizeof(*s));
+	pthread_mutex_unlock(&coalesce_lock);
+
+	return 0;
+}
@@ -0,0 +1,458 @@
+/*
+ * dfs.c - DFS state of the channels of radios, tracked from DFS events
+ *
+ * The state of a radio's DFS channels is got from its channels once, then
+ * kept up to date from the CAC, radar and NOP events its driver reports,
+ * with the NOP of a channel counted down from when radar was detected on
+ * it. Drivers which can't report DFS events get the state from their
+ * channels again whenever the radio's channel state may have changed.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+#define DFS_NOP_TIME		1800000	/* msecs */
+#define DFS_MAX_CHANNELS	64
+#define DFS_EVENTS_NUM		32	/* got from the driver at a time */
+#define DFS_SEED_CHANNELS	64
+#define DFS_SEED_MAX_CHANNELS	1024
+
+struct dfs_chan {
+	uint8_t channel;
+	enum dfs_state state;
+	uint32_t cac_time;	/* secs */
+	uint64_t nop_end;	/* msecs */
+};
+
+struct dfs_radio {
+	char name[16];
+	bool seeded;
+	bool events;		/* driver reports DFS events */
+	uint32_t gen;
+	int num;
+	struct dfs_chan ch[DFS_MAX_CHANNELS];
+	uint8_t idx[256];	/* 5GHz channel to ch[] + 1 */
+	struct dfs_radio *next;
+};
+
+static struct dfs_radio *dfs_list;
+static pthread_mutex_t dfs_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t dfs_nop_time = DFS_NOP_TIME;
+
+static struct dfs_radio *dfs_lookup(const char *name)
+{
+	struct dfs_radio *r;
+
+	for (r = dfs_list; r; r = r->next) {
+		if (!strncmp(r->name, name, sizeof(r->name)))
+			return r;
+	}
+
+	r = calloc(1, sizeof(*r));
+	if (!r)
+		return NULL;
+
+	strncpy(r->name, name, sizeof(r->name) - 1);
+	r->next = dfs_list;
+	dfs_list = r;
+
+	return r;
+}
+
+/* Get the events pending for the radio; returns number of them got, or
+ * an error, -ESTALE if some were lost.
+ */
+static int dfs_get_events(struct dfs_radio *r, struct wifi_dfs_event *ev)
+{
+	int num = DFS_EVENTS_NUM;
+	int ret;
+
+	ret = wifi_get_dfs_events(r->name, ev, &num);
+	if (ret)
+		return ret;
+
+	return num;
+}
+
+static int dfs_seed(struct dfs_radio *r, uint64_t now)
+{
+	struct wifi_dfs_event ev[DFS_EVENTS_NUM];
+	int max = DFS_SEED_CHANNELS;
+	struct chan_entry *chan;
+	struct dfs_chan *c;
+	int num;
+	int ret;
+	int i;
+
+	/* the channels have what happened till now */
+	do {
+		ret = dfs_get_events(r, ev);
+	} while (ret == DFS_EVENTS_NUM || ret == -ESTALE);
+
+	r->events = ret >= 0;
+
+	for (;;) {
+		chan = calloc((size_t)max, sizeof(*chan));
+		if (!chan)
+			return -ENOMEM;
+
+		num = max;
+		ret = wifi_channels_info(r->name, chan, &num);
+		if (ret || num < max || max >= DFS_SEED_MAX_CHANNELS)
+			break;
+
+		free(chan);
+		max *= 2;
+	}
+
+	if (ret) {
+		free(chan);
+		return ret;
+	}
+
+	memset(r->idx, 0, sizeof(r->idx));
+	r->num = 0;
+	for (i = 0; i < num && r->num < DFS_MAX_CHANNELS; i++) {
+		if (!chan[i].dfs || chan[i].band != BAND_5 ||
+		    chan[i].channel > 255 || r->idx[chan[i].channel])
+			continue;
+
+		c = &r->ch[r->num++];
+		c->channel = (uint8_t)chan[i].channel;
+		c->state = chan[i].dfs_state;
+		c->cac_time = chan[i].cac_time;
+		c->nop_end = 0;
+		if (c->state == WIFI_DFS_STATE_UNAVAILABLE) {
+			/* a whole NOP if the time left isn't known */
+			c->nop_end = now + (chan[i].nop_time ?
+				     (uint64_t)chan[i].nop_time * 1000 :
+				     dfs_nop_time);
+		}
+
+		r->idx[c->channel] = (uint8_t)r->num;
+	}
+
+	free(chan);
+	r->seeded = true;
+
+	return 0;
+}
+
+static const int *dfs_members(uint32_t channel, enum wifi_bw bw, int *one)
+{
+	const int *chans = NULL;
+
+	if (bw >= BW20 && bw <= BW160)
+		chans = chan2list((int)channel, 20 << bw);
+	else if (bw == BW8080)
+		chans = chan2list((int)channel, 80);
+
+	if (chans)
+		return chans;
+
+	one[0] = (int)channel;
+	one[1] = 0;
+	return one;
+}
+
+/* Apply an event to the DFS member channels; returns if any changed */
+static bool dfs_apply(struct dfs_radio *r, struct wifi_dfs_event *ev,
+		      uint64_t now)
+{
+	enum dfs_state state;
+	const int *chans;
+	bool changed = false;
+	struct dfs_chan *c;
+	int one[2];
+
+	for (chans = dfs_members(ev->channel, ev->bw, one); *chans; chans++) {
+		if (*chans > 255 || !r->idx[*chans])
+			continue;
+
+		c = &r->ch[r->idx[*chans] - 1];
+		state = c->state;
+
+		switch (ev->type) {
+		case WIFI_DFS_EVENT_CAC_STARTED:
+			if (state != WIFI_DFS_STATE_UNAVAILABLE)
+				state = WIFI_DFS_STATE_CAC;
+			break;
+		case WIFI_DFS_EVENT_CAC_FINISHED:
+			if (state != WIFI_DFS_STATE_UNAVAILABLE)
+				state = WIFI_DFS_STATE_AVAILABLE;
+			break;
+		case WIFI_DFS_EVENT_CAC_ABORTED:
+			if (state == WIFI_DFS_STATE_CAC)
+				state = WIFI_DFS_STATE_USABLE;
+			break;
+		case WIFI_DFS_EVENT_RADAR:
+			state = WIFI_DFS_STATE_UNAVAILABLE;
+			c->nop_end = now + dfs_nop_time;
+			break;
+		case WIFI_DFS_EVENT_NOP_FINISHED:
+			if (state == WIFI_DFS_STATE_UNAVAILABLE)
+				state = WIFI_DFS_STATE_USABLE;
+			break;
+		case WIFI_DFS_EVENT_PRE_CAC_EXPIRED:
+			if (state == WIFI_DFS_STATE_AVAILABLE)
+				state = WIFI_DFS_STATE_USABLE;
+			break;
+		default:
+			break;
+		}
+
+		if (state != WIFI_DFS_STATE_UNAVAILABLE)
+			c->nop_end = 0;
+
+		changed |= state != c->state;
+		c->state = state;
+	}
+
+	return changed;
+}
+
+/* Get the DFS state of 'name' up to date. Returns 0 with the lock held. */
+static int dfs_get(const char *name, struct dfs_radio **out)
+{
+	struct wifi_dfs_event ev[DFS_EVENTS_NUM];
+	uint64_t now = time_monotonic_msecs();
+	bool changed = false;
+	struct dfs_radio *r;
+	bool has_gen;
+	uint32_t gen = 0;
+	int ret;
+	int i;
+
+	pthread_mutex_lock(&dfs_lock);
+	r = dfs_lookup(name);
+	if (!r) {
+		pthread_mutex_unlock(&dfs_lock);
+		return -ENOMEM;
+	}
+
+	if (r->seeded && !r->events) {
+		has_gen = !wifi_get_chan_gen(name, &gen);
+		if (!has_gen || gen != r->gen)
+			r->seeded = false;
+	}
+
+	if (!r->seeded) {
+		wifi_get_chan_gen(name, &gen);
+		ret = dfs_seed(r, now);
+		if (ret) {
+			pthread_mutex_unlock(&dfs_lock);
+			return ret;
+		}
+
+		r->gen = gen;
+	}
+
+	while (r->events) {
+		ret = dfs_get_events(r, ev);
+		if (ret == -ESTALE) {
+			/* start over from the channels */
+			dfs_seed(r, now);
+			changed = true;
+			break;
+		}
+
+		for (i = 0; i < ret; i++)
+			changed |= dfs_apply(r, &ev[i], now);
+
+		if (ret < DFS_EVENTS_NUM)
+			break;
+	}
+
+	for (i = 0; i < r->num; i++) {
+		if (r->ch[i].state == WIFI_DFS_STATE_UNAVAILABLE &&
+		    r->ch[i].nop_end <= now) {
+			r->ch[i].state = WIFI_DFS_STATE_USABLE;
+			r->ch[i].nop_end = 0;
+			changed = true;
+		}
+	}
+
+	/* opclass tables have the DFS state in */
+	if (changed && r->events)
+		wifi_opclass_cache_flush(name);
+
+	*out = r;
+	return 0;
+}
+
+static uint32_t dfs_nop_left(struct dfs_chan *c, uint64_t now)
+{
+	if (c->state != WIFI_DFS_STATE_UNAVAILABLE || c->nop_end <= now)
+		return 0;
+
+	return (uint32_t)((c->nop_end - now + 999) / 1000);
+}
+
+/* DFS state of the member channels of a channel at a bandwidth */
+struct dfs_members_state {
+	int num;
+	int usable;
+	int cac;
+	int available;
+	bool unavailable;
+	uint32_t cac_time;	/* highest */
+	uint32_t nop_time;	/* highest */
+};
+
+static int dfs_get_members(const char *name, uint32_t channel,
+			   enum wifi_bw bw, struct dfs_members_state *m)
+{
+	uint64_t now = time_monotonic_msecs();
+	struct dfs_radio *r;
+	const int *chans;
+	struct dfs_chan *c;
+	int one[2];
+	int ret;
+
+	ret = dfs_get(name, &r);
+	if (ret)
+		return ret;
+
+	memset(m, 0, sizeof(*m));
+	for (chans = dfs_members(channel, bw, one); *chans; chans++) {
+		if (*chans > 255 || !r->idx[*chans])
+			continue;
+
+		c = &r->ch[r->idx[*chans] - 1];
+		m->num++;
+		m->unavailable |= c->state == WIFI_DFS_STATE_UNAVAILABLE;
+		m->usable += c->state == WIFI_DFS_STATE_USABLE;
+		m->cac += c->state == WIFI_DFS_STATE_CAC;
+		m->available += c->state == WIFI_DFS_STATE_AVAILABLE;
+		m->cac_time = max(m->cac_time, c->cac_time);
+		m->nop_time = max(m->nop_time, dfs_nop_left(c, now));
+	}
+
+	pthread_mutex_unlock(&dfs_lock);
+	return 0;
+}
+
+int wifi_dfs_get_state(const char *name, uint32_t channel, enum wifi_bw bw,
+		       enum dfs_state *state, uint32_t *cac_time,
+		       uint32_t *nop_time)
+{
+	struct dfs_members_state m;
+	int ret;
+
+	if (!name || !state)
+		return -EINVAL;
+
+	ret = dfs_get_members(name, channel, bw, &m);
+	if (ret)
+		return ret;
+
+	/* as radio_opclass_dfs_state() gets it from the channels */
+	if (!m.num)
+		*state = WIFI_DFS_STATE_NONE;
+	else if (m.unavailable)
+		*state = WIFI_DFS_STATE_UNAVAILABLE;
+	else if (m.available == m.num)
+		*state = WIFI_DFS_STATE_AVAILABLE;
+	else if (m.cac == m.num)
+		*state = WIFI_DFS_STATE_CAC;
+	else
+		*state = WIFI_DFS_STATE_USABLE;
+
+	if (cac_time)
+		*cac_time = m.cac_time;
+	if (nop_time)
+		*nop_time = m.nop_time;
+
+	return 0;
+}
+
+/* Whether all the DFS member channels of a channel at a bandwidth are
+ * usable, i.e. can be CACed; as radio_opclass_dfs_usable() tells from the
+ * channels. USABLE got from wifi_dfs_get_state() may be a mix of states.
+ */
+int wifi_dfs_is_usable(const char *name, uint32_t channel, enum wifi_bw bw,
+		       bool *usable)
+{
+	struct dfs_members_state m;
+	int ret;
+
+	ret = dfs_get_members(name, channel, bw, &m);
+	if (ret)
+		return ret;
+
+	*usable = m.usable == m.num;
+	return 0;
+}
+
+/* Put the tracked DFS state in channels of 'name' got from its driver */
+void wifi_dfs_update_channels(const char *name, struct chan_entry *chan,
+			      int num)
+{
+	uint64_t now = time_monotonic_msecs();
+	struct dfs_radio *r;
+	struct dfs_chan *c;
+	int i;
+
+	if (dfs_get(name, &r))
+		return;
+
+	for (i = 0; r->events && i < num; i++) {
+		if (!chan[i].dfs || chan[i].band != BAND_5 ||
+		    chan[i].channel > 255 || !r->idx[chan[i].channel])
+			continue;
+
+		c = &r->ch[r->idx[chan[i].channel] - 1];
+		chan[i].dfs_state = c->state;
+		chan[i].nop_time = dfs_nop_left(c, now);
+	}
+
+	pthread_mutex_unlock(&dfs_lock);
+}
+
+int wifi_dfs_config(uint32_t nop_time)
+{
+	if (!nop_time)
+		return -EINVAL;
+
+	pthread_mutex_lock(&dfs_lock);
+	dfs_nop_time = nop_time;
+	pthread_mutex_unlock(&dfs_lock);
+
+	return 0;
+}
+
+void wifi_dfs_flush(const char *name)
+{
+	struct dfs_radio *r;
+
+	pthread_mutex_lock(&dfs_lock);
+	for (r = dfs_list; r; r = r->next) {
+		if (!name || !strncmp(r->name, name, sizeof(r->name)))
+			r->seeded = false;
+	}
+	pthread_mutex_unlock(&dfs_lock);
+}
@@ -0,0 +1,558 @@
+/*
+ * fanout.c - run a batch of queries on several radios concurrently
+ *
+ * The requests of a batch are grouped by radio, and the groups queued per
+ * radio. A small pool of workers, started on first use and kept after,
+ * takes a group off the queue of a radio not busy with another one and
+ * runs its requests in order. So a radio sees its queries one after
+ * another, as with a serial walk, also across concurrent batches, while
+ * the radios are queried in parallel.
+ *
+ * Results are got into buffers owned by the batch and copied out to the
+ * caller's buffers as each request completes. When the deadline expires,
+ * wifi_fanout() returns; requests still running or queued get -ETIMEDOUT,
+ * and their late results are dropped, so the workers never touch the
+ * caller's buffers once it has returned. A radio still busy with a query
+ * of an expired batch, e.g. hung in its driver, gets no new queries; they
+ * fail with -EBUSY instead of piling up behind it.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "debug.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+#define FANOUT_MAX_WORKERS	4
+
+/* size of an entry of the result of an op */
+static const size_t fanout_out_size[WIFI_FANOUT_NUM_OPS] = {
+	[WIFI_FANOUT_RADIO_INFO] = sizeof(struct wifi_radio),
+	[WIFI_FANOUT_RADIO_STATS] = sizeof(struct wifi_radio_stats),
+	[WIFI_FANOUT_CHANNELS_INFO] = sizeof(struct chan_entry),
+	[WIFI_FANOUT_AP_INFO] = sizeof(struct wifi_ap),
+	[WIFI_FANOUT_AP_STATS] = sizeof(struct wifi_ap_stats),
+	[WIFI_FANOUT_ASSOCLIST] = 6,
+	[WIFI_FANOUT_STA_INFO] = sizeof(struct wifi_sta),
+	[WIFI_FANOUT_STAS_INFO] = sizeof(struct wifi_sta),
+};
+
+struct fanout_job {
+	struct wifi_fanout_req *req;	/* caller's request */
+	enum wifi_fanout_op op;
+	char ifname[16];
+	uint8_t addr[6];
+	int num;
+	void *out;
+	size_t olen;
+	int group;
+	bool done;
+};
+
+struct fanout_batch;
+
+/* the jobs of a batch on one radio */
+struct fanout_group {
+	struct fanout_batch *b;
+	int id;
+	char radio[16];
+	struct fanout_group *next;
+};
+
+struct fanout_batch {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int refs;		/* caller and queued or running groups */
+	bool expired;		/* caller has returned */
+	int pending;		/* jobs not done yet */
+	int num_groups;
+	struct fanout_group *groups;
+	int num_jobs;
+	struct fanout_job job[];
+};
+
+/* groups queued on a radio; one runs at a time */
+struct fanout_radio {
+	char name[16];
+	struct fanout_group *running;
+	struct fanout_group *head;
+	struct fanout_group **tail;
+	struct fanout_radio *next;
+};
+
+static pthread_mutex_t fanout_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t fanout_cond = PTHREAD_COND_INITIALIZER;
+static struct fanout_radio *fanout_radios;
+static int fanout_workers;
+static int fanout_idle;
+
+static void fanout_put(struct fanout_batch *b)
+{
+	int i;
+
+	pthread_mutex_lock(&b->lock);
+	if (--b->refs) {
+		pthread_mutex_unlock(&b->lock);
+		return;
+	}
+	pthread_mutex_unlock(&b->lock);
+
+	for (i = 0; i < b->num_jobs; i++)
+		free(b->job[i].out);
+
+	pthread_cond_destroy(&b->cond);
+	pthread_mutex_destroy(&b->lock);
+	free(b->groups);
+	free(b);
+}
+
+static int fanout_run(struct fanout_job *j)
+{
+	switch (j->op) {
+	case WIFI_FANOUT_RADIO_INFO:
+		return wifi_radio_info(j->ifname, j->out);
+	case WIFI_FANOUT_RADIO_STATS:
+		return wifi_radio_get_stats(j->ifname, j->out);
+	case WIFI_FANOUT_CHANNELS_INFO:
+		return wifi_channels_info(j->ifname, j->out, &j->num);
+	case WIFI_FANOUT_AP_INFO:
+		return wifi_ap_info(j->ifname, j->out);
+	case WIFI_FANOUT_AP_STATS:
+		return wifi_ap_get_stats(j->ifname, j->out);
+	case WIFI_FANOUT_ASSOCLIST:
+		return wifi_get_assoclist(j->ifname, j->out, &j->num);
+	case WIFI_FANOUT_STA_INFO:
+		return wifi_get_sta_info(j->ifname, j->addr, j->out);
+	case WIFI_FANOUT_STAS_INFO:
+		return wifi_get_stas_info(j->ifname, j->out, &j->num);
+	default:
+		return -EINVAL;
+	}
+}
+
+/* Run the jobs of a group in order, unless the batch expires meanwhile */
+static void fanout_run_group(struct fanout_group *g)
+{
+	struct fanout_batch *b = g->b;
+	struct fanout_job *j;
+	int ret;
+	int i;
+
+	pthread_mutex_lock(&b->lock);
+	for (i = 0; i < b->num_jobs && !b->expired; i++) {
+		j = &b->job[i];
+		if (j->group != g->id)
+			continue;
+
+		pthread_mutex_unlock(&b->lock);
+		ret = fanout_run(j);
+		pthread_mutex_lock(&b->lock);
+
+		j->done = true;
+		b->pending--;
+		if (!b->expired) {
+			if (!ret)
+				memcpy(j->req->out, j->out, j->olen);
+			j->req->num = j->num;
+			j->req->status = ret;
+		}
+	}
+
+	pthread_cond_broadcast(&b->cond);
+	pthread_mutex_unlock(&b->lock);
+}
+
+/* Fail the jobs of a group not run, with 'err' */
+static void fanout_fail_group(struct fanout_group *g, int err)
+{
+	struct fanout_batch *b = g->b;
+	struct fanout_job *j;
+	int i;
+
+	pthread_mutex_lock(&b->lock);
+	for (i = 0; i < b->num_jobs; i++) {
+		j = &b->job[i];
+		if (j->group != g->id || j->done)
+			continue;
+
+		j->done = true;
+		b->pending--;
+		j->req->status = err;
+	}
+
+	pthread_cond_broadcast(&b->cond);
+	pthread_mutex_unlock(&b->lock);
+}
+
+/* Whether a group is left running a job after its batch expired */
+static bool fanout_stuck(struct fanout_group *g)
+{
+	struct fanout_batch *b = g->b;
+	bool stuck = false;
+	int i;
+
+	pthread_mutex_lock(&b->lock);
+	for (i = 0; i < b->num_jobs && b->expired; i++) {
+		if (b->job[i].group == g->id && !b->job[i].done) {
+			stuck = true;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&b->lock);
+
+	return stuck;
+}
+
+/* called with fanout_lock held */
+static struct fanout_radio *fanout_radio_get(const char name[16])
+{
+	struct fanout_radio *r;
+
+	for (r = fanout_radios; r; r = r->next) {
+		if (!strncmp(r->name, name, sizeof(r->name)))
+			return r;
+	}
+
+	r = calloc(1, sizeof(*r));
+	if (!r)
+		return NULL;
+
+	memcpy(r->name, name, sizeof(r->name) - 1);
+	r->tail = &r->head;
+	r->next = fanout_radios;
+	fanout_radios = r;
+
+	return r;
+}
+
+/* called with fanout_lock held; frees the radio if left with no work */
+static void fanout_radio_idle(struct fanout_radio *r)
+{
+	struct fanout_radio **pr;
+
+	if (r->running || r->head)
+		return;
+
+	for (pr = &fanout_radios; *pr; pr = &(*pr)->next) {
+		if (*pr == r) {
+			*pr = r->next;
+			free(r);
+			return;
+		}
+	}
+}
+
+/* Queue a group on its radio, called with fanout_lock held. Returns the
+ * error its jobs fail with if not queued.
+ */
+static int fanout_queue(struct fanout_group *g)
+{
+	struct fanout_radio *r;
+
+	r = fanout_radio_get(g->radio);
+	if (!r)
+		return -ENOMEM;
+
+	if (r->running && fanout_stuck(r->running)) {
+		libwifi_dbg("[%s] busy with an expired query\n", r->name);
+		return -EBUSY;
+	}
+
+	pthread_mutex_lock(&g->b->lock);
+	g->b->refs++;
+	pthread_mutex_unlock(&g->b->lock);
+
+	g->next = NULL;
+	*r->tail = g;
+	r->tail = &g->next;
+
+	return 0;
+}
+
+/* Take the first queued group of batch 'b', or of any radio not busy if
+ * 'b' is NULL. Called with fanout_lock held.
+ */
+static struct fanout_group *fanout_dequeue(struct fanout_batch *b,
+					   struct fanout_radio **rp)
+{
+	struct fanout_group *g, **pg;
+	struct fanout_radio *r;
+
+	for (r = fanout_radios; r; r = r->next) {
+		if (!b && r->running)
+			continue;
+
+		for (pg = &r->head; (g = *pg); pg = &g->next) {
+			if (b && g->b != b)
+				continue;
+
+			*pg = g->next;
+			if (!*pg)
+				r->tail = pg;
+
+			*rp = r;
+			return g;
+		}
+	}
+
+	return NULL;
+}
+
+static void *fanout_worker(void *arg)
+{
+	struct fanout_radio *r;
+	struct fanout_group *g;
+
+	pthread_mutex_lock(&fanout_lock);
+	for (;;) {
+		g = fanout_dequeue(NULL, &r);
+		if (!g) {
+			fanout_idle++;
+			pthread_cond_wait(&fanout_cond, &fanout_lock);
+			fanout_idle--;
+			continue;
+		}
+
+		r->running = g;
+		pthread_mutex_unlock(&fanout_lock);
+
+		fanout_run_group(g);
+
+		pthread_mutex_lock(&fanout_lock);
+		r->running = NULL;
+		fanout_put(g->b);
+		fanout_radio_idle(r);
+	}
+
+	return NULL;
+}
+
+/* Start workers for radios with queued groups, up to FANOUT_MAX_WORKERS.
+ * Called with fanout_lock held; returns the number of workers.
+ */
+static int fanout_start_workers(void)
+{
+	struct fanout_radio *r;
+	pthread_attr_t attr;
+	pthread_t t;
+	int need = 0;
+
+	for (r = fanout_radios; r; r = r->next) {
+		if (r->head && !r->running)
+			need++;
+	}
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	while (need > fanout_idle && fanout_workers < FANOUT_MAX_WORKERS) {
+		if (pthread_create(&t, &attr, fanout_worker, NULL))
+			break;
+
+		fanout_workers++;
+		need--;
+	}
+	pthread_attr_destroy(&attr);
+
+	pthread_cond_broadcast(&fanout_cond);
+	return fanout_workers;
+}
+
+/* Group jobs by radio, or by ifname if no radio given, in order of first
+ * appearance.
+ */
+static int fanout_group(struct wifi_fanout_req *req, int num,
+			struct fanout_job *job)
+{
+	const char *key, *k;
+	int groups = 0;
+	int i, k_i;
+
+	for (i = 0; i < num; i++) {
+		key = req[i].radio[0] ? req[i].radio : req[i].ifname;
+		job[i].group = -1;
+
+		for (k_i = 0; k_i < i; k_i++) {
+			k = req[k_i].radio[0] ? req[k_i].radio : req[k_i].ifname;
+			if (!strncmp(k, key, 16)) {
+				job[i].group = job[k_i].group;
+				break;
+			}
+		}
+
+		if (job[i].group < 0)
+			job[i].group = groups++;
+	}
+
+	return groups;
+}
+
+static void fanout_deadline(struct timespec *ts, int timeout)
+{
+	clock_gettime(CLOCK_MONOTONIC, ts);
+	ts->tv_sec += timeout / 1000;
+	ts->tv_nsec += (long)(timeout % 1000) * 1000000;
+	if (ts->tv_nsec >= 1000000000) {
+		ts->tv_sec++;
+		ts->tv_nsec -= 1000000000;
+	}
+}
+
+int wifi_fanout(struct wifi_fanout_req *req, int num, int timeout)
+{
+	struct fanout_group *g;
+	struct fanout_radio *r;
+	struct fanout_batch *b;
+	pthread_condattr_t cattr;
+	struct timespec deadline;
+	const char *key;
+	int workers;
+	int ret = 0;
+	int i;
+
+	if (!req || num <= 0)
+		return -EINVAL;
+
+	b = calloc(1, sizeof(*b) + (size_t)num * sizeof(struct fanout_job));
+	if (!b)
+		return -ENOMEM;
+
+	b->groups = calloc((size_t)num, sizeof(struct fanout_group));
+	if (!b->groups) {
+		free(b);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < num; i++) {
+		struct fanout_job *j = &b->job[i];
+
+		req[i].status = -EINPROGRESS;
+		if (req[i].op >= WIFI_FANOUT_NUM_OPS || !req[i].out ||
+		    req[i].num < 0) {
+			req[i].status = -EINVAL;
+			j->done = true;
+			continue;
+		}
+
+		j->req = &req[i];
+		j->op = req[i].op;
+		strncpy(j->ifname, req[i].ifname, sizeof(j->ifname) - 1);
+		memcpy(j->addr, req[i].addr, 6);
+		j->num = req[i].num;
+		j->olen = (size_t)(j->num ? j->num : 1) * fanout_out_size[j->op];
+		j->out = calloc(1, j->olen);
+		if (!j->out) {
+			req[i].status = -ENOMEM;
+			j->done = true;
+			continue;
+		}
+
+		b->pending++;
+	}
+
+	b->num_jobs = num;
+	b->num_groups = fanout_group(req, num, b->job);
+	for (i = 0; i < num; i++) {
+		g = &b->groups[b->job[i].group];
+		if (!g->b) {
+			key = req[i].radio[0] ? req[i].radio : req[i].ifname;
+			g->b = b;
+			g->id = b->job[i].group;
+			strncpy(g->radio, key, sizeof(g->radio) - 1);
+		}
+
+		if (b->job[i].done)
+			b->job[i].group = -1;
+	}
+
+	pthread_mutex_init(&b->lock, NULL);
+	pthread_condattr_init(&cattr);
+	pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+	pthread_cond_init(&b->cond, &cattr);
+	pthread_condattr_destroy(&cattr);
+	b->refs = 1;
+
+	if (timeout > 0)
+		fanout_deadline(&deadline, timeout);
+
+	pthread_mutex_lock(&fanout_lock);
+	for (i = 0; i < b->num_groups; i++) {
+		ret = fanout_queue(&b->groups[i]);
+		if (ret)
+			fanout_fail_group(&b->groups[i], ret);
+	}
+	ret = 0;
+
+	workers = fanout_start_workers();
+	if (!workers) {
+		/* no worker could be started; run the batch here */
+		while ((g = fanout_dequeue(b, &r))) {
+			r->running = g;
+			pthread_mutex_unlock(&fanout_lock);
+			fanout_run_group(g);
+			pthread_mutex_lock(&fanout_lock);
+			r->running = NULL;
+			fanout_put(b);
+			fanout_radio_idle(r);
+		}
+	}
+	pthread_mutex_unlock(&fanout_lock);
+
+	pthread_mutex_lock(&b->lock);
+	while (b->pending) {
+		if (timeout <= 0) {
+			pthread_cond_wait(&b->cond, &b->lock);
+			continue;
+		}
+
+		if (pthread_cond_timedwait(&b->cond, &b->lock,
+					   &deadline) == ETIMEDOUT)
+			break;
+	}
+
+	if (b->pending) {
+		for (i = 0; i < num; i++) {
+			if (!b->job[i].done && b->job[i].req)
+				req[i].status = -ETIMEDOUT;
+		}
+
+		ret = -ETIMEDOUT;
+	}
+
+	b->expired = true;
+	pthread_mutex_unlock(&b->lock);
+
+	/* drop the groups not taken by a worker yet */
+	pthread_mutex_lock(&fanout_lock);
+	while ((g = fanout_dequeue(b, &r))) {
+		fanout_put(b);
+		fanout_radio_idle(r);
+	}
+	pthread_mutex_unlock(&fanout_lock);
+
+	fanout_put(b);
+
+	return ret;
+}
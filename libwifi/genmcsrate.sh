@@ -0,0 +1,76 @@
+#!/bin/sh
+#
+# genmcsrate.sh - generate mcsrate.h, the PHY rates of 802.11n/ac/ax/be
+# MCSs looked up by wifi_mcs2rate().
+#
+# Rates are in kbps, rounded down, for each symbol time and guard interval,
+# bandwidth, number of spatial streams and MCS:
+#
+#   rate = Nsd * Nbpscs * R * Nss / (Tdft + Tgi)
+#
+# with Nsd the data subcarriers of HT/VHT or HE/EHT at the bandwidth.
+#
+# Usage: ./genmcsrate.sh > mcsrate.h
+
+awk '
+BEGIN {
+	# symbol and guard interval, in 100ns
+	nsym = split("36 40 136 144 160", tsym, " ")
+	split("3.2us symbol, 0.4us GI;3.2us symbol, 0.8us GI;" \
+	      "12.8us symbol, 0.8us GI;12.8us symbol, 1.6us GI;" \
+	      "12.8us symbol, 3.2us GI", symname, ";")
+
+	# data subcarriers at 20, 40, 80, 160 and 320MHz
+	nbw = split("20 40 80 160 320", bwname, " ")
+	split("52 108 234 468 0", sd_ht, " ")
+	split("234 468 980 1960 3920", sd_he, " ")
+
+	# modulation and coding rate of MCS 0-13
+	nmcs = split("1 2 2 4 4 6 6 6 8 8 10 10 12 12", bpscs, " ")
+	split("1 1 3 1 3 2 3 5 3 5 3 5 3 5", crn, " ")
+	split("2 2 4 2 4 3 4 6 4 6 4 6 4 6", crd, " ")
+
+	nss_max = 16
+
+	print "/*"
+	print " * mcsrate.h - PHY rates of 802.11n/ac/ax/be MCSs in kbps"
+	print " *"
+	print " * Generated by genmcsrate.sh; do not edit."
+	print " */"
+	print "#ifndef MCSRATE_H"
+	print "#define MCSRATE_H"
+	print ""
+	printf "#define MCSRATE_SYM_NUM\t\t%d\n", nsym
+	printf "#define MCSRATE_BW_NUM\t\t%d\n", nbw
+	printf "#define MCSRATE_NSS_MAX\t\t%d\n", nss_max
+	printf "#define MCSRATE_MCS_NUM\t\t%d\n", nmcs
+	print ""
+	print "/* [symbol and GI][bandwidth][streams - 1][mcs] */"
+	print "static const uint32_t mcsrate_kbps[MCSRATE_SYM_NUM][MCSRATE_BW_NUM]"
+	print "\t\t\t\t\t[MCSRATE_NSS_MAX][MCSRATE_MCS_NUM] = {"
+
+	for (s = 1; s <= nsym; s++) {
+		printf "\t/* %s */\n\t{\n", symname[s]
+		for (b = 1; b <= nbw; b++) {
+			sd = s <= 2 ? sd_ht[b] : sd_he[b]
+			printf "\t\t/* %sMHz */\n\t\t{\n", bwname[b]
+			for (n = 1; n <= nss_max; n++) {
+				printf "\t\t\t{"
+				for (m = 1; m <= nmcs; m++) {
+					r = int(sd * bpscs[m] * crn[m] * n * 10000 / \
+						(crd[m] * tsym[s]))
+					if (m == 8)
+						printf "\n\t\t\t "
+					printf " %d%s", r, m < nmcs ? "," : ""
+				}
+				printf " },\t/* %d ss */\n", n
+			}
+			printf "\t\t},\n"
+		}
+		printf "\t},\n"
+	}
+
+	print "};"
+	print ""
+	print "#endif /* MCSRATE_H */"
+}'
@@ -0,0 +1,909 @@
+/*
+ * mcsrate.h - PHY rates of 802.11n/ac/ax/be MCSs in kbps
+ *
+ * Generated by genmcsrate.sh; do not edit.
+ */
+#ifndef MCSRATE_H
+#define MCSRATE_H
+
+#define MCSRATE_SYM_NUM		5
+#define MCSRATE_BW_NUM		5
+#define MCSRATE_NSS_MAX		16
+#define MCSRATE_MCS_NUM		14
+
+/* [symbol and GI][bandwidth][streams - 1][mcs] */
+static const uint32_t mcsrate_kbps[MCSRATE_SYM_NUM][MCSRATE_BW_NUM]
+					[MCSRATE_NSS_MAX][MCSRATE_MCS_NUM] = {
+	/* 3.2us symbol, 0.4us GI */
+	{
+		/* 20MHz */
+		{
+			{ 7222, 14444, 21666, 28888, 43333, 57777, 65000,
+			  72222, 86666, 96296, 108333, 120370, 130000, 144444 },	/* 1 ss */
+			{ 14444, 28888, 43333, 57777, 86666, 115555, 130000,
+			  144444, 173333, 192592, 216666, 240740, 260000, 288888 },	/* 2 ss */
+			{ 21666, 43333, 65000, 86666, 130000, 173333, 195000,
+			  216666, 260000, 288888, 325000, 361111, 390000, 433333 },	/* 3 ss */
+			{ 28888, 57777, 86666, 115555, 173333, 231111, 260000,
+			  288888, 346666, 385185, 433333, 481481, 520000, 577777 },	/* 4 ss */
+			{ 36111, 72222, 108333, 144444, 216666, 288888, 325000,
+			  361111, 433333, 481481, 541666, 601851, 650000, 722222 },	/* 5 ss */
+			{ 43333, 86666, 130000, 173333, 260000, 346666, 390000,
+			  433333, 520000, 577777, 650000, 722222, 780000, 866666 },	/* 6 ss */
+			{ 50555, 101111, 151666, 202222, 303333, 404444, 455000,
+			  505555, 606666, 674074, 758333, 842592, 910000, 1011111 },	/* 7 ss */
+			{ 57777, 115555, 173333, 231111, 346666, 462222, 520000,
+			  577777, 693333, 770370, 866666, 962962, 1040000, 1155555 },	/* 8 ss */
+			{ 65000, 130000, 195000, 260000, 390000, 520000, 585000,
+			  650000, 780000, 866666, 975000, 1083333, 1170000, 1300000 },	/* 9 ss */
+			{ 72222, 144444, 216666, 288888, 433333, 577777, 650000,
+			  722222, 866666, 962962, 1083333, 1203703, 1300000, 1444444 },	/* 10 ss */
+			{ 79444, 158888, 238333, 317777, 476666, 635555, 715000,
+			  794444, 953333, 1059259, 1191666, 1324074, 1430000, 1588888 },	/* 11 ss */
+			{ 86666, 173333, 260000, 346666, 520000, 693333, 780000,
+			  866666, 1040000, 1155555, 1300000, 1444444, 1560000, 1733333 },	/* 12 ss */
+			{ 93888, 187777, 281666, 375555, 563333, 751111, 845000,
+			  938888, 1126666, 1251851, 1408333, 1564814, 1690000, 1877777 },	/* 13 ss */
+			{ 101111, 202222, 303333, 404444, 606666, 808888, 910000,
+			  1011111, 1213333, 1348148, 1516666, 1685185, 1820000, 2022222 },	/* 14 ss */
+			{ 108333, 216666, 325000, 433333, 650000, 866666, 975000,
+			  1083333, 1300000, 1444444, 1625000, 1805555, 1950000, 2166666 },	/* 15 ss */
+			{ 115555, 231111, 346666, 462222, 693333, 924444, 1040000,
+			  1155555, 1386666, 1540740, 1733333, 1925925, 2080000, 2311111 },	/* 16 ss */
+		},
+		/* 40MHz */
+		{
+			{ 15000, 30000, 45000, 60000, 90000, 120000, 135000,
+			  150000, 180000, 200000, 225000, 250000, 270000, 300000 },	/* 1 ss */
+			{ 30000, 60000, 90000, 120000, 180000, 240000, 270000,
+			  300000, 360000, 400000, 450000, 500000, 540000, 600000 },	/* 2 ss */
+			{ 45000, 90000, 135000, 180000, 270000, 360000, 405000,
+			  450000, 540000, 600000, 675000, 750000, 810000, 900000 },	/* 3 ss */
+			{ 60000, 120000, 180000, 240000, 360000, 480000, 540000,
+			  600000, 720000, 800000, 900000, 1000000, 1080000, 1200000 },	/* 4 ss */
+			{ 75000, 150000, 225000, 300000, 450000, 600000, 675000,
+			  750000, 900000, 1000000, 1125000, 1250000, 1350000, 1500000 },	/* 5 ss */
+			{ 90000, 180000, 270000, 360000, 540000, 720000, 810000,
+			  900000, 1080000, 1200000, 1350000, 1500000, 1620000, 1800000 },	/* 6 ss */
+			{ 105000, 210000, 315000, 420000, 630000, 840000, 945000,
+			  1050000, 1260000, 1400000, 1575000, 1750000, 1890000, 2100000 },	/* 7 ss */
+			{ 120000, 240000, 360000, 480000, 720000, 960000, 1080000,
+			  1200000, 1440000, 1600000, 1800000, 2000000, 2160000, 2400000 },	/* 8 ss */
+			{ 135000, 270000, 405000, 540000, 810000, 1080000, 1215000,
+			  1350000, 1620000, 1800000, 2025000, 2250000, 2430000, 2700000 },	/* 9 ss */
+			{ 150000, 300000, 450000, 600000, 900000, 1200000, 1350000,
+			  1500000, 1800000, 2000000, 2250000, 2500000, 2700000, 3000000 },	/* 10 ss */
+			{ 165000, 330000, 495000, 660000, 990000, 1320000, 1485000,
+			  1650000, 1980000, 2200000, 2475000, 2750000, 2970000, 3300000 },	/* 11 ss */
+			{ 180000, 360000, 540000, 720000, 1080000, 1440000, 1620000,
+			  1800000, 2160000, 2400000, 2700000, 3000000, 3240000, 3600000 },	/* 12 ss */
+			{ 195000, 390000, 585000, 780000, 1170000, 1560000, 1755000,
+			  1950000, 2340000, 2600000, 2925000, 3250000, 3510000, 3900000 },	/* 13 ss */
+			{ 210000, 420000, 630000, 840000, 1260000, 1680000, 1890000,
+			  2100000, 2520000, 2800000, 3150000, 3500000, 3780000, 4200000 },	/* 14 ss */
+			{ 225000, 450000, 675000, 900000, 1350000, 1800000, 2025000,
+			  2250000, 2700000, 3000000, 3375000, 3750000, 4050000, 4500000 },	/* 15 ss */
+			{ 240000, 480000, 720000, 960000, 1440000, 1920000, 2160000,
+			  2400000, 2880000, 3200000, 3600000, 4000000, 4320000, 4800000 },	/* 16 ss */
+		},
+		/* 80MHz */
+		{
+			{ 32500, 65000, 97500, 130000, 195000, 260000, 292500,
+			  325000, 390000, 433333, 487500, 541666, 585000, 650000 },	/* 1 ss */
+			{ 65000, 130000, 195000, 260000, 390000, 520000, 585000,
+			  650000, 780000, 866666, 975000, 1083333, 1170000, 1300000 },	/* 2 ss */
+			{ 97500, 195000, 292500, 390000, 585000, 780000, 877500,
+			  975000, 1170000, 1300000, 1462500, 1625000, 1755000, 1950000 },	/* 3 ss */
+			{ 130000, 260000, 390000, 520000, 780000, 1040000, 1170000,
+			  1300000, 1560000, 1733333, 1950000, 2166666, 2340000, 2600000 },	/* 4 ss */
+			{ 162500, 325000, 487500, 650000, 975000, 1300000, 1462500,
+			  1625000, 1950000, 2166666, 2437500, 2708333, 2925000, 3250000 },	/* 5 ss */
+			{ 195000, 390000, 585000, 780000, 1170000, 1560000, 1755000,
+			  1950000, 2340000, 2600000, 2925000, 3250000, 3510000, 3900000 },	/* 6 ss */
+			{ 227500, 455000, 682500, 910000, 1365000, 1820000, 2047500,
+			  2275000, 2730000, 3033333, 3412500, 3791666, 4095000, 4550000 },	/* 7 ss */
+			{ 260000, 520000, 780000, 1040000, 1560000, 2080000, 2340000,
+			  2600000, 3120000, 3466666, 3900000, 4333333, 4680000, 5200000 },	/* 8 ss */
+			{ 292500, 585000, 877500, 1170000, 1755000, 2340000, 2632500,
+			  2925000, 3510000, 3900000, 4387500, 4875000, 5265000, 5850000 },	/* 9 ss */
+			{ 325000, 650000, 975000, 1300000, 1950000, 2600000, 2925000,
+			  3250000, 3900000, 4333333, 4875000, 5416666, 5850000, 6500000 },	/* 10 ss */
+			{ 357500, 715000, 1072500, 1430000, 2145000, 2860000, 3217500,
+			  3575000, 4290000, 4766666, 5362500, 5958333, 6435000, 7150000 },	/* 11 ss */
+			{ 390000, 780000, 1170000, 1560000, 2340000, 3120000, 3510000,
+			  3900000, 4680000, 5200000, 5850000, 6500000, 7020000, 7800000 },	/* 12 ss */
+			{ 422500, 845000, 1267500, 1690000, 2535000, 3380000, 3802500,
+			  4225000, 5070000, 5633333, 6337500, 7041666, 7605000, 8450000 },	/* 13 ss */
+			{ 455000, 910000, 1365000, 1820000, 2730000, 3640000, 4095000,
+			  4550000, 5460000, 6066666, 6825000, 7583333, 8190000, 9100000 },	/* 14 ss */
+			{ 487500, 975000, 1462500, 1950000, 2925000, 3900000, 4387500,
+			  4875000, 5850000, 6500000, 7312500, 8125000, 8775000, 9750000 },	/* 15 ss */
+			{ 520000, 1040000, 1560000, 2080000, 3120000, 4160000, 4680000,
+			  5200000, 6240000, 6933333, 7800000, 8666666, 9360000, 10400000 },	/* 16 ss */
+		},
+		/* 160MHz */
+		{
+			{ 65000, 130000, 195000, 260000, 390000, 520000, 585000,
+			  650000, 780000, 866666, 975000, 1083333, 1170000, 1300000 },	/* 1 ss */
+			{ 130000, 260000, 390000, 520000, 780000, 1040000, 1170000,
+			  1300000, 1560000, 1733333, 1950000, 2166666, 2340000, 2600000 },	/* 2 ss */
+			{ 195000, 390000, 585000, 780000, 1170000, 1560000, 1755000,
+			  1950000, 2340000, 2600000, 2925000, 3250000, 3510000, 3900000 },	/* 3 ss */
+			{ 260000, 520000, 780000, 1040000, 1560000, 2080000, 2340000,
+			  2600000, 3120000, 3466666, 3900000, 4333333, 4680000, 5200000 },	/* 4 ss */
+			{ 325000, 650000, 975000, 1300000, 1950000, 2600000, 2925000,
+			  3250000, 3900000, 4333333, 4875000, 5416666, 5850000, 6500000 },	/* 5 ss */
+			{ 390000, 780000, 1170000, 1560000, 2340000, 3120000, 3510000,
+			  3900000, 4680000, 5200000, 5850000, 6500000, 7020000, 7800000 },	/* 6 ss */
+			{ 455000, 910000, 1365000, 1820000, 2730000, 3640000, 4095000,
+			  4550000, 5460000, 6066666, 6825000, 7583333, 8190000, 9100000 },	/* 7 ss */
+			{ 520000, 1040000, 1560000, 2080000, 3120000, 4160000, 4680000,
+			  5200000, 6240000, 6933333, 7800000, 8666666, 9360000, 10400000 },	/* 8 ss */
+			{ 585000, 1170000, 1755000, 2340000, 3510000, 4680000, 5265000,
+			  5850000, 7020000, 7800000, 8775000, 9750000, 10530000, 11700000 },	/* 9 ss */
+			{ 650000, 1300000, 1950000, 2600000, 3900000, 5200000, 5850000,
+			  6500000, 7800000, 8666666, 9750000, 10833333, 11700000, 13000000 },	/* 10 ss */
+			{ 715000, 1430000, 2145000, 2860000, 4290000, 5720000, 6435000,
+			  7150000, 8580000, 9533333, 10725000, 11916666, 12870000, 14300000 },	/* 11 ss */
+			{ 780000, 1560000, 2340000, 3120000, 4680000, 6240000, 7020000,
+			  7800000, 9360000, 10400000, 11700000, 13000000, 14040000, 15600000 },	/* 12 ss */
+			{ 845000, 1690000, 2535000, 3380000, 5070000, 6760000, 7605000,
+			  8450000, 10140000, 11266666, 12675000, 14083333, 15210000, 16900000 },	/* 13 ss */
+			{ 910000, 1820000, 2730000, 3640000, 5460000, 7280000, 8190000,
+			  9100000, 10920000, 12133333, 13650000, 15166666, 16380000, 18200000 },	/* 14 ss */
+			{ 975000, 1950000, 2925000, 3900000, 5850000, 7800000, 8775000,
+			  9750000, 11700000, 13000000, 14625000, 16250000, 17550000, 19500000 },	/* 15 ss */
+			{ 1040000, 2080000, 3120000, 4160000, 6240000, 8320000, 9360000,
+			  10400000, 12480000, 13866666, 15600000, 17333333, 18720000, 20800000 },	/* 16 ss */
+		},
+		/* 320MHz */
+		{
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 1 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 2 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 3 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 4 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 5 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 6 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 7 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 8 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 9 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 10 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 11 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 12 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 13 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 14 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 15 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 16 ss */
+		},
+	},
+	/* 3.2us symbol, 0.8us GI */
+	{
+		/* 20MHz */
+		{
+			{ 6500, 13000, 19500, 26000, 39000, 52000, 58500,
+			  65000, 78000, 86666, 97500, 108333, 117000, 130000 },	/* 1 ss */
+			{ 13000, 26000, 39000, 52000, 78000, 104000, 117000,
+			  130000, 156000, 173333, 195000, 216666, 234000, 260000 },	/* 2 ss */
+			{ 19500, 39000, 58500, 78000, 117000, 156000, 175500,
+			  195000, 234000, 260000, 292500, 325000, 351000, 390000 },	/* 3 ss */
+			{ 26000, 52000, 78000, 104000, 156000, 208000, 234000,
+			  260000, 312000, 346666, 390000, 433333, 468000, 520000 },	/* 4 ss */
+			{ 32500, 65000, 97500, 130000, 195000, 260000, 292500,
+			  325000, 390000, 433333, 487500, 541666, 585000, 650000 },	/* 5 ss */
+			{ 39000, 78000, 117000, 156000, 234000, 312000, 351000,
+			  390000, 468000, 520000, 585000, 650000, 702000, 780000 },	/* 6 ss */
+			{ 45500, 91000, 136500, 182000, 273000, 364000, 409500,
+			  455000, 546000, 606666, 682500, 758333, 819000, 910000 },	/* 7 ss */
+			{ 52000, 104000, 156000, 208000, 312000, 416000, 468000,
+			  520000, 624000, 693333, 780000, 866666, 936000, 1040000 },	/* 8 ss */
+			{ 58500, 117000, 175500, 234000, 351000, 468000, 526500,
+			  585000, 702000, 780000, 877500, 975000, 1053000, 1170000 },	/* 9 ss */
+			{ 65000, 130000, 195000, 260000, 390000, 520000, 585000,
+			  650000, 780000, 866666, 975000, 1083333, 1170000, 1300000 },	/* 10 ss */
+			{ 71500, 143000, 214500, 286000, 429000, 572000, 643500,
+			  715000, 858000, 953333, 1072500, 1191666, 1287000, 1430000 },	/* 11 ss */
+			{ 78000, 156000, 234000, 312000, 468000, 624000, 702000,
+			  780000, 936000, 1040000, 1170000, 1300000, 1404000, 1560000 },	/* 12 ss */
+			{ 84500, 169000, 253500, 338000, 507000, 676000, 760500,
+			  845000, 1014000, 1126666, 1267500, 1408333, 1521000, 1690000 },	/* 13 ss */
+			{ 91000, 182000, 273000, 364000, 546000, 728000, 819000,
+			  910000, 1092000, 1213333, 1365000, 1516666, 1638000, 1820000 },	/* 14 ss */
+			{ 97500, 195000, 292500, 390000, 585000, 780000, 877500,
+			  975000, 1170000, 1300000, 1462500, 1625000, 1755000, 1950000 },	/* 15 ss */
+			{ 104000, 208000, 312000, 416000, 624000, 832000, 936000,
+			  1040000, 1248000, 1386666, 1560000, 1733333, 1872000, 2080000 },	/* 16 ss */
+		},
+		/* 40MHz */
+		{
+			{ 13500, 27000, 40500, 54000, 81000, 108000, 121500,
+			  135000, 162000, 180000, 202500, 225000, 243000, 270000 },	/* 1 ss */
+			{ 27000, 54000, 81000, 108000, 162000, 216000, 243000,
+			  270000, 324000, 360000, 405000, 450000, 486000, 540000 },	/* 2 ss */
+			{ 40500, 81000, 121500, 162000, 243000, 324000, 364500,
+			  405000, 486000, 540000, 607500, 675000, 729000, 810000 },	/* 3 ss */
+			{ 54000, 108000, 162000, 216000, 324000, 432000, 486000,
+			  540000, 648000, 720000, 810000, 900000, 972000, 1080000 },	/* 4 ss */
+			{ 67500, 135000, 202500, 270000, 405000, 540000, 607500,
+			  675000, 810000, 900000, 1012500, 1125000, 1215000, 1350000 },	/* 5 ss */
+			{ 81000, 162000, 243000, 324000, 486000, 648000, 729000,
+			  810000, 972000, 1080000, 1215000, 1350000, 1458000, 1620000 },	/* 6 ss */
+			{ 94500, 189000, 283500, 378000, 567000, 756000, 850500,
+			  945000, 1134000, 1260000, 1417500, 1575000, 1701000, 1890000 },	/* 7 ss */
+			{ 108000, 216000, 324000, 432000, 648000, 864000, 972000,
+			  1080000, 1296000, 1440000, 1620000, 1800000, 1944000, 2160000 },	/* 8 ss */
+			{ 121500, 243000, 364500, 486000, 729000, 972000, 1093500,
+			  1215000, 1458000, 1620000, 1822500, 2025000, 2187000, 2430000 },	/* 9 ss */
+			{ 135000, 270000, 405000, 540000, 810000, 1080000, 1215000,
+			  1350000, 1620000, 1800000, 2025000, 2250000, 2430000, 2700000 },	/* 10 ss */
+			{ 148500, 297000, 445500, 594000, 891000, 1188000, 1336500,
+			  1485000, 1782000, 1980000, 2227500, 2475000, 2673000, 2970000 },	/* 11 ss */
+			{ 162000, 324000, 486000, 648000, 972000, 1296000, 1458000,
+			  1620000, 1944000, 2160000, 2430000, 2700000, 2916000, 3240000 },	/* 12 ss */
+			{ 175500, 351000, 526500, 702000, 1053000, 1404000, 1579500,
+			  1755000, 2106000, 2340000, 2632500, 2925000, 3159000, 3510000 },	/* 13 ss */
+			{ 189000, 378000, 567000, 756000, 1134000, 1512000, 1701000,
+			  1890000, 2268000, 2520000, 2835000, 3150000, 3402000, 3780000 },	/* 14 ss */
+			{ 202500, 405000, 607500, 810000, 1215000, 1620000, 1822500,
+			  2025000, 2430000, 2700000, 3037500, 3375000, 3645000, 4050000 },	/* 15 ss */
+			{ 216000, 432000, 648000, 864000, 1296000, 1728000, 1944000,
+			  2160000, 2592000, 2880000, 3240000, 3600000, 3888000, 4320000 },	/* 16 ss */
+		},
+		/* 80MHz */
+		{
+			{ 29250, 58500, 87750, 117000, 175500, 234000, 263250,
+			  292500, 351000, 390000, 438750, 487500, 526500, 585000 },	/* 1 ss */
+			{ 58500, 117000, 175500, 234000, 351000, 468000, 526500,
+			  585000, 702000, 780000, 877500, 975000, 1053000, 1170000 },	/* 2 ss */
+			{ 87750, 175500, 263250, 351000, 526500, 702000, 789750,
+			  877500, 1053000, 1170000, 1316250, 1462500, 1579500, 1755000 },	/* 3 ss */
+			{ 117000, 234000, 351000, 468000, 702000, 936000, 1053000,
+			  1170000, 1404000, 1560000, 1755000, 1950000, 2106000, 2340000 },	/* 4 ss */
+			{ 146250, 292500, 438750, 585000, 877500, 1170000, 1316250,
+			  1462500, 1755000, 1950000, 2193750, 2437500, 2632500, 2925000 },	/* 5 ss */
+			{ 175500, 351000, 526500, 702000, 1053000, 1404000, 1579500,
+			  1755000, 2106000, 2340000, 2632500, 2925000, 3159000, 3510000 },	/* 6 ss */
+			{ 204750, 409500, 614250, 819000, 1228500, 1638000, 1842750,
+			  2047500, 2457000, 2730000, 3071250, 3412500, 3685500, 4095000 },	/* 7 ss */
+			{ 234000, 468000, 702000, 936000, 1404000, 1872000, 2106000,
+			  2340000, 2808000, 3120000, 3510000, 3900000, 4212000, 4680000 },	/* 8 ss */
+			{ 263250, 526500, 789750, 1053000, 1579500, 2106000, 2369250,
+			  2632500, 3159000, 3510000, 3948750, 4387500, 4738500, 5265000 },	/* 9 ss */
+			{ 292500, 585000, 877500, 1170000, 1755000, 2340000, 2632500,
+			  2925000, 3510000, 3900000, 4387500, 4875000, 5265000, 5850000 },	/* 10 ss */
+			{ 321750, 643500, 965250, 1287000, 1930500, 2574000, 2895750,
+			  3217500, 3861000, 4290000, 4826250, 5362500, 5791500, 6435000 },	/* 11 ss */
+			{ 351000, 702000, 1053000, 1404000, 2106000, 2808000, 3159000,
+			  3510000, 4212000, 4680000, 5265000, 5850000, 6318000, 7020000 },	/* 12 ss */
+			{ 380250, 760500, 1140750, 1521000, 2281500, 3042000, 3422250,
+			  3802500, 4563000, 5070000, 5703750, 6337500, 6844500, 7605000 },	/* 13 ss */
+			{ 409500, 819000, 1228500, 1638000, 2457000, 3276000, 3685500,
+			  4095000, 4914000, 5460000, 6142500, 6825000, 7371000, 8190000 },	/* 14 ss */
+			{ 438750, 877500, 1316250, 1755000, 2632500, 3510000, 3948750,
+			  4387500, 5265000, 5850000, 6581250, 7312500, 7897500, 8775000 },	/* 15 ss */
+			{ 468000, 936000, 1404000, 1872000, 2808000, 3744000, 4212000,
+			  4680000, 5616000, 6240000, 7020000, 7800000, 8424000, 9360000 },	/* 16 ss */
+		},
+		/* 160MHz */
+		{
+			{ 58500, 117000, 175500, 234000, 351000, 468000, 526500,
+			  585000, 702000, 780000, 877500, 975000, 1053000, 1170000 },	/* 1 ss */
+			{ 117000, 234000, 351000, 468000, 702000, 936000, 1053000,
+			  1170000, 1404000, 1560000, 1755000, 1950000, 2106000, 2340000 },	/* 2 ss */
+			{ 175500, 351000, 526500, 702000, 1053000, 1404000, 1579500,
+			  1755000, 2106000, 2340000, 2632500, 2925000, 3159000, 3510000 },	/* 3 ss */
+			{ 234000, 468000, 702000, 936000, 1404000, 1872000, 2106000,
+			  2340000, 2808000, 3120000, 3510000, 3900000, 4212000, 4680000 },	/* 4 ss */
+			{ 292500, 585000, 877500, 1170000, 1755000, 2340000, 2632500,
+			  2925000, 3510000, 3900000, 4387500, 4875000, 5265000, 5850000 },	/* 5 ss */
+			{ 351000, 702000, 1053000, 1404000, 2106000, 2808000, 3159000,
+			  3510000, 4212000, 4680000, 5265000, 5850000, 6318000, 7020000 },	/* 6 ss */
+			{ 409500, 819000, 1228500, 1638000, 2457000, 3276000, 3685500,
+			  4095000, 4914000, 5460000, 6142500, 6825000, 7371000, 8190000 },	/* 7 ss */
+			{ 468000, 936000, 1404000, 1872000, 2808000, 3744000, 4212000,
+			  4680000, 5616000, 6240000, 7020000, 7800000, 8424000, 9360000 },	/* 8 ss */
+			{ 526500, 1053000, 1579500, 2106000, 3159000, 4212000, 4738500,
+			  5265000, 6318000, 7020000, 7897500, 8775000, 9477000, 10530000 },	/* 9 ss */
+			{ 585000, 1170000, 1755000, 2340000, 3510000, 4680000, 5265000,
+			  5850000, 7020000, 7800000, 8775000, 9750000, 10530000, 11700000 },	/* 10 ss */
+			{ 643500, 1287000, 1930500, 2574000, 3861000, 5148000, 5791500,
+			  6435000, 7722000, 8580000, 9652500, 10725000, 11583000, 12870000 },	/* 11 ss */
+			{ 702000, 1404000, 2106000, 2808000, 4212000, 5616000, 6318000,
+			  7020000, 8424000, 9360000, 10530000, 11700000, 12636000, 14040000 },	/* 12 ss */
+			{ 760500, 1521000, 2281500, 3042000, 4563000, 6084000, 6844500,
+			  7605000, 9126000, 10140000, 11407500, 12675000, 13689000, 15210000 },	/* 13 ss */
+			{ 819000, 1638000, 2457000, 3276000, 4914000, 6552000, 7371000,
+			  8190000, 9828000, 10920000, 12285000, 13650000, 14742000, 16380000 },	/* 14 ss */
+			{ 877500, 1755000, 2632500, 3510000, 5265000, 7020000, 7897500,
+			  8775000, 10530000, 11700000, 13162500, 14625000, 15795000, 17550000 },	/* 15 ss */
+			{ 936000, 1872000, 2808000, 3744000, 5616000, 7488000, 8424000,
+			  9360000, 11232000, 12480000, 14040000, 15600000, 16848000, 18720000 },	/* 16 ss */
+		},
+		/* 320MHz */
+		{
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 1 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 2 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 3 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 4 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 5 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 6 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 7 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 8 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 9 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 10 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 11 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 12 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 13 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 14 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 15 ss */
+			{ 0, 0, 0, 0, 0, 0, 0,
+			  0, 0, 0, 0, 0, 0, 0 },	/* 16 ss */
+		},
+	},
+	/* 12.8us symbol, 0.8us GI */
+	{
+		/* 20MHz */
+		{
+			{ 8602, 17205, 25808, 34411, 51617, 68823, 77426,
+			  86029, 103235, 114705, 129044, 143382, 154852, 172058 },	/* 1 ss */
+			{ 17205, 34411, 51617, 68823, 103235, 137647, 154852,
+			  172058, 206470, 229411, 258088, 286764, 309705, 344117 },	/* 2 ss */
+			{ 25808, 51617, 77426, 103235, 154852, 206470, 232279,
+			  258088, 309705, 344117, 387132, 430147, 464558, 516176 },	/* 3 ss */
+			{ 34411, 68823, 103235, 137647, 206470, 275294, 309705,
+			  344117, 412941, 458823, 516176, 573529, 619411, 688235 },	/* 4 ss */
+			{ 43014, 86029, 129044, 172058, 258088, 344117, 387132,
+			  430147, 516176, 573529, 645220, 716911, 774264, 860294 },	/* 5 ss */
+			{ 51617, 103235, 154852, 206470, 309705, 412941, 464558,
+			  516176, 619411, 688235, 774264, 860294, 929117, 1032352 },	/* 6 ss */
+			{ 60220, 120441, 180661, 240882, 361323, 481764, 541985,
+			  602205, 722647, 802941, 903308, 1003676, 1083970, 1204411 },	/* 7 ss */
+			{ 68823, 137647, 206470, 275294, 412941, 550588, 619411,
+			  688235, 825882, 917647, 1032352, 1147058, 1238823, 1376470 },	/* 8 ss */
+			{ 77426, 154852, 232279, 309705, 464558, 619411, 696838,
+			  774264, 929117, 1032352, 1161397, 1290441, 1393676, 1548529 },	/* 9 ss */
+			{ 86029, 172058, 258088, 344117, 516176, 688235, 774264,
+			  860294, 1032352, 1147058, 1290441, 1433823, 1548529, 1720588 },	/* 10 ss */
+			{ 94632, 189264, 283897, 378529, 567794, 757058, 851691,
+			  946323, 1135588, 1261764, 1419485, 1577205, 1703382, 1892647 },	/* 11 ss */
+			{ 103235, 206470, 309705, 412941, 619411, 825882, 929117,
+			  1032352, 1238823, 1376470, 1548529, 1720588, 1858235, 2064705 },	/* 12 ss */
+			{ 111838, 223676, 335514, 447352, 671029, 894705, 1006544,
+			  1118382, 1342058, 1491176, 1677573, 1863970, 2013088, 2236764 },	/* 13 ss */
+			{ 120441, 240882, 361323, 481764, 722647, 963529, 1083970,
+			  1204411, 1445294, 1605882, 1806617, 2007352, 2167941, 2408823 },	/* 14 ss */
+			{ 129044, 258088, 387132, 516176, 774264, 1032352, 1161397,
+			  1290441, 1548529, 1720588, 1935661, 2150735, 2322794, 2580882 },	/* 15 ss */
+			{ 137647, 275294, 412941, 550588, 825882, 1101176, 1238823,
+			  1376470, 1651764, 1835294, 2064705, 2294117, 2477647, 2752941 },	/* 16 ss */
+		},
+		/* 40MHz */
+		{
+			{ 17205, 34411, 51617, 68823, 103235, 137647, 154852,
+			  172058, 206470, 229411, 258088, 286764, 309705, 344117 },	/* 1 ss */
+			{ 34411, 68823, 103235, 137647, 206470, 275294, 309705,
+			  344117, 412941, 458823, 516176, 573529, 619411, 688235 },	/* 2 ss */
+			{ 51617, 103235, 154852, 206470, 309705, 412941, 464558,
+			  516176, 619411, 688235, 774264, 860294, 929117, 1032352 },	/* 3 ss */
+			{ 68823, 137647, 206470, 275294, 412941, 550588, 619411,
+			  688235, 825882, 917647, 1032352, 1147058, 1238823, 1376470 },	/* 4 ss */
+			{ 86029, 172058, 258088, 344117, 516176, 688235, 774264,
+			  860294, 1032352, 1147058, 1290441, 1433823, 1548529, 1720588 },	/* 5 ss */
+			{ 103235, 206470, 309705, 412941, 619411, 825882, 929117,
+			  1032352, 1238823, 1376470, 1548529, 1720588, 1858235, 2064705 },	/* 6 ss */
+			{ 120441, 240882, 361323, 481764, 722647, 963529, 1083970,
+			  1204411, 1445294, 1605882, 1806617, 2007352, 2167941, 2408823 },	/* 7 ss */
+			{ 137647, 275294, 412941, 550588, 825882, 1101176, 1238823,
+			  1376470, 1651764, 1835294, 2064705, 2294117, 2477647, 2752941 },	/* 8 ss */
+			{ 154852, 309705, 464558, 619411, 929117, 1238823, 1393676,
+			  1548529, 1858235, 2064705, 2322794, 2580882, 2787352, 3097058 },	/* 9 ss */
+			{ 172058, 344117, 516176, 688235, 1032352, 1376470, 1548529,
+			  1720588, 2064705, 2294117, 2580882, 2867647, 3097058, 3441176 },	/* 10 ss */
+			{ 189264, 378529, 567794, 757058, 1135588, 1514117, 1703382,
+			  1892647, 2271176, 2523529, 2838970, 3154411, 3406764, 3785294 },	/* 11 ss */
+			{ 206470, 412941, 619411, 825882, 1238823, 1651764, 1858235,
+			  2064705, 2477647, 2752941, 3097058, 3441176, 3716470, 4129411 },	/* 12 ss */
+			{ 223676, 447352, 671029, 894705, 1342058, 1789411, 2013088,
+			  2236764, 2684117, 2982352, 3355147, 3727941, 4026176, 4473529 },	/* 13 ss */
+			{ 240882, 481764, 722647, 963529, 1445294, 1927058, 2167941,
+			  2408823, 2890588, 3211764, 3613235, 4014705, 4335882, 4817647 },	/* 14 ss */
+			{ 258088, 516176, 774264, 1032352, 1548529, 2064705, 2322794,
+			  2580882, 3097058, 3441176, 3871323, 4301470, 4645588, 5161764 },	/* 15 ss */
+			{ 275294, 550588, 825882, 1101176, 1651764, 2202352, 2477647,
+			  2752941, 3303529, 3670588, 4129411, 4588235, 4955294, 5505882 },	/* 16 ss */
+		},
+		/* 80MHz */
+		{
+			{ 36029, 72058, 108088, 144117, 216176, 288235, 324264,
+			  360294, 432352, 480392, 540441, 600490, 648529, 720588 },	/* 1 ss */
+			{ 72058, 144117, 216176, 288235, 432352, 576470, 648529,
+			  720588, 864705, 960784, 1080882, 1200980, 1297058, 1441176 },	/* 2 ss */
+			{ 108088, 216176, 324264, 432352, 648529, 864705, 972794,
+			  1080882, 1297058, 1441176, 1621323, 1801470, 1945588, 2161764 },	/* 3 ss */
+			{ 144117, 288235, 432352, 576470, 864705, 1152941, 1297058,
+			  1441176, 1729411, 1921568, 2161764, 2401960, 2594117, 2882352 },	/* 4 ss */
+			{ 180147, 360294, 540441, 720588, 1080882, 1441176, 1621323,
+			  1801470, 2161764, 2401960, 2702205, 3002450, 3242647, 3602941 },	/* 5 ss */
+			{ 216176, 432352, 648529, 864705, 1297058, 1729411, 1945588,
+			  2161764, 2594117, 2882352, 3242647, 3602941, 3891176, 4323529 },	/* 6 ss */
+			{ 252205, 504411, 756617, 1008823, 1513235, 2017647, 2269852,
+			  2522058, 3026470, 3362745, 3783088, 4203431, 4539705, 5044117 },	/* 7 ss */
+			{ 288235, 576470, 864705, 1152941, 1729411, 2305882, 2594117,
+			  2882352, 3458823, 3843137, 4323529, 4803921, 5188235, 5764705 },	/* 8 ss */
+			{ 324264, 648529, 972794, 1297058, 1945588, 2594117, 2918382,
+			  3242647, 3891176, 4323529, 4863970, 5404411, 5836764, 6485294 },	/* 9 ss */
+			{ 360294, 720588, 1080882, 1441176, 2161764, 2882352, 3242647,
+			  3602941, 4323529, 4803921, 5404411, 6004901, 6485294, 7205882 },	/* 10 ss */
+			{ 396323, 792647, 1188970, 1585294, 2377941, 3170588, 3566911,
+			  3963235, 4755882, 5284313, 5944852, 6605392, 7133823, 7926470 },	/* 11 ss */
+			{ 432352, 864705, 1297058, 1729411, 2594117, 3458823, 3891176,
+			  4323529, 5188235, 5764705, 6485294, 7205882, 7782352, 8647058 },	/* 12 ss */
+			{ 468382, 936764, 1405147, 1873529, 2810294, 3747058, 4215441,
+			  4683823, 5620588, 6245098, 7025735, 7806372, 8430882, 9367647 },	/* 13 ss */
+			{ 504411, 1008823, 1513235, 2017647, 3026470, 4035294, 4539705,
+			  5044117, 6052941, 6725490, 7566176, 8406862, 9079411, 10088235 },	/* 14 ss */
+			{ 540441, 1080882, 1621323, 2161764, 3242647, 4323529, 4863970,
+			  5404411, 6485294, 7205882, 8106617, 9007352, 9727941, 10808823 },	/* 15 ss */
+			{ 576470, 1152941, 1729411, 2305882, 3458823, 4611764, 5188235,
+			  5764705, 6917647, 7686274, 8647058, 9607843, 10376470, 11529411 },	/* 16 ss */
+		},
+		/* 160MHz */
+		{
+			{ 72058, 144117, 216176, 288235, 432352, 576470, 648529,
+			  720588, 864705, 960784, 1080882, 1200980, 1297058, 1441176 },	/* 1 ss */
+			{ 144117, 288235, 432352, 576470, 864705, 1152941, 1297058,
+			  1441176, 1729411, 1921568, 2161764, 2401960, 2594117, 2882352 },	/* 2 ss */
+			{ 216176, 432352, 648529, 864705, 1297058, 1729411, 1945588,
+			  2161764, 2594117, 2882352, 3242647, 3602941, 3891176, 4323529 },	/* 3 ss */
+			{ 288235, 576470, 864705, 1152941, 1729411, 2305882, 2594117,
+			  2882352, 3458823, 3843137, 4323529, 4803921, 5188235, 5764705 },	/* 4 ss */
+			{ 360294, 720588, 1080882, 1441176, 2161764, 2882352, 3242647,
+			  3602941, 4323529, 4803921, 5404411, 6004901, 6485294, 7205882 },	/* 5 ss */
+			{ 432352, 864705, 1297058, 1729411, 2594117, 3458823, 3891176,
+			  4323529, 5188235, 5764705, 6485294, 7205882, 7782352, 8647058 },	/* 6 ss */
+			{ 504411, 1008823, 1513235, 2017647, 3026470, 4035294, 4539705,
+			  5044117, 6052941, 6725490, 7566176, 8406862, 9079411, 10088235 },	/* 7 ss */
+			{ 576470, 1152941, 1729411, 2305882, 3458823, 4611764, 5188235,
+			  5764705, 6917647, 7686274, 8647058, 9607843, 10376470, 11529411 },	/* 8 ss */
+			{ 648529, 1297058, 1945588, 2594117, 3891176, 5188235, 5836764,
+			  6485294, 7782352, 8647058, 9727941, 10808823, 11673529, 12970588 },	/* 9 ss */
+			{ 720588, 1441176, 2161764, 2882352, 4323529, 5764705, 6485294,
+			  7205882, 8647058, 9607843, 10808823, 12009803, 12970588, 14411764 },	/* 10 ss */
+			{ 792647, 1585294, 2377941, 3170588, 4755882, 6341176, 7133823,
+			  7926470, 9511764, 10568627, 11889705, 13210784, 14267647, 15852941 },	/* 11 ss */
+			{ 864705, 1729411, 2594117, 3458823, 5188235, 6917647, 7782352,
+			  8647058, 10376470, 11529411, 12970588, 14411764, 15564705, 17294117 },	/* 12 ss */
+			{ 936764, 1873529, 2810294, 3747058, 5620588, 7494117, 8430882,
+			  9367647, 11241176, 12490196, 14051470, 15612745, 16861764, 18735294 },	/* 13 ss */
+			{ 1008823, 2017647, 3026470, 4035294, 6052941, 8070588, 9079411,
+			  10088235, 12105882, 13450980, 15132352, 16813725, 18158823, 20176470 },	/* 14 ss */
+			{ 1080882, 2161764, 3242647, 4323529, 6485294, 8647058, 9727941,
+			  10808823, 12970588, 14411764, 16213235, 18014705, 19455882, 21617647 },	/* 15 ss */
+			{ 1152941, 2305882, 3458823, 4611764, 6917647, 9223529, 10376470,
+			  11529411, 13835294, 15372549, 17294117, 19215686, 20752941, 23058823 },	/* 16 ss */
+		},
+		/* 320MHz */
+		{
+			{ 144117, 288235, 432352, 576470, 864705, 1152941, 1297058,
+			  1441176, 1729411, 1921568, 2161764, 2401960, 2594117, 2882352 },	/* 1 ss */
+			{ 288235, 576470, 864705, 1152941, 1729411, 2305882, 2594117,
+			  2882352, 3458823, 3843137, 4323529, 4803921, 5188235, 5764705 },	/* 2 ss */
+			{ 432352, 864705, 1297058, 1729411, 2594117, 3458823, 3891176,
+			  4323529, 5188235, 5764705, 6485294, 7205882, 7782352, 8647058 },	/* 3 ss */
+			{ 576470, 1152941, 1729411, 2305882, 3458823, 4611764, 5188235,
+			  5764705, 6917647, 7686274, 8647058, 9607843, 10376470, 11529411 },	/* 4 ss */
+			{ 720588, 1441176, 2161764, 2882352, 4323529, 5764705, 6485294,
+			  7205882, 8647058, 9607843, 10808823, 12009803, 12970588, 14411764 },	/* 5 ss */
+			{ 864705, 1729411, 2594117, 3458823, 5188235, 6917647, 7782352,
+			  8647058, 10376470, 11529411, 12970588, 14411764, 15564705, 17294117 },	/* 6 ss */
+			{ 1008823, 2017647, 3026470, 4035294, 6052941, 8070588, 9079411,
+			  10088235, 12105882, 13450980, 15132352, 16813725, 18158823, 20176470 },	/* 7 ss */
+			{ 1152941, 2305882, 3458823, 4611764, 6917647, 9223529, 10376470,
+			  11529411, 13835294, 15372549, 17294117, 19215686, 20752941, 23058823 },	/* 8 ss */
+			{ 1297058, 2594117, 3891176, 5188235, 7782352, 10376470, 11673529,
+			  12970588, 15564705, 17294117, 19455882, 21617647, 23347058, 25941176 },	/* 9 ss */
+			{ 1441176, 2882352, 4323529, 5764705, 8647058, 11529411, 12970588,
+			  14411764, 17294117, 19215686, 21617647, 24019607, 25941176, 28823529 },	/* 10 ss */
+			{ 1585294, 3170588, 4755882, 6341176, 9511764, 12682352, 14267647,
+			  15852941, 19023529, 21137254, 23779411, 26421568, 28535294, 31705882 },	/* 11 ss */
+			{ 1729411, 3458823, 5188235, 6917647, 10376470, 13835294, 15564705,
+			  17294117, 20752941, 23058823, 25941176, 28823529, 31129411, 34588235 },	/* 12 ss */
+			{ 1873529, 3747058, 5620588, 7494117, 11241176, 14988235, 16861764,
+			  18735294, 22482352, 24980392, 28102941, 31225490, 33723529, 37470588 },	/* 13 ss */
+			{ 2017647, 4035294, 6052941, 8070588, 12105882, 16141176, 18158823,
+			  20176470, 24211764, 26901960, 30264705, 33627450, 36317647, 40352941 },	/* 14 ss */
+			{ 2161764, 4323529, 6485294, 8647058, 12970588, 17294117, 19455882,
+			  21617647, 25941176, 28823529, 32426470, 36029411, 38911764, 43235294 },	/* 15 ss */
+			{ 2305882, 4611764, 6917647, 9223529, 13835294, 18447058, 20752941,
+			  23058823, 27670588, 30745098, 34588235, 38431372, 41505882, 46117647 },	/* 16 ss */
+		},
+	},
+	/* 12.8us symbol, 1.6us GI */
+	{
+		/* 20MHz */
+		{
+			{ 8125, 16250, 24375, 32500, 48750, 65000, 73125,
+			  81250, 97500, 108333, 121875, 135416, 146250, 162500 },	/* 1 ss */
+			{ 16250, 32500, 48750, 65000, 97500, 130000, 146250,
+			  162500, 195000, 216666, 243750, 270833, 292500, 325000 },	/* 2 ss */
+			{ 24375, 48750, 73125, 97500, 146250, 195000, 219375,
+			  243750, 292500, 325000, 365625, 406250, 438750, 487500 },	/* 3 ss */
+			{ 32500, 65000, 97500, 130000, 195000, 260000, 292500,
+			  325000, 390000, 433333, 487500, 541666, 585000, 650000 },	/* 4 ss */
+			{ 40625, 81250, 121875, 162500, 243750, 325000, 365625,
+			  406250, 487500, 541666, 609375, 677083, 731250, 812500 },	/* 5 ss */
+			{ 48750, 97500, 146250, 195000, 292500, 390000, 438750,
+			  487500, 585000, 650000, 731250, 812500, 877500, 975000 },	/* 6 ss */
+			{ 56875, 113750, 170625, 227500, 341250, 455000, 511875,
+			  568750, 682500, 758333, 853125, 947916, 1023750, 1137500 },	/* 7 ss */
+			{ 65000, 130000, 195000, 260000, 390000, 520000, 585000,
+			  650000, 780000, 866666, 975000, 1083333, 1170000, 1300000 },	/* 8 ss */
+			{ 73125, 146250, 219375, 292500, 438750, 585000, 658125,
+			  731250, 877500, 975000, 1096875, 1218750, 1316250, 1462500 },	/* 9 ss */
+			{ 81250, 162500, 243750, 325000, 487500, 650000, 731250,
+			  812500, 975000, 1083333, 1218750, 1354166, 1462500, 1625000 },	/* 10 ss */
+			{ 89375, 178750, 268125, 357500, 536250, 715000, 804375,
+			  893750, 1072500, 1191666, 1340625, 1489583, 1608750, 1787500 },	/* 11 ss */
+			{ 97500, 195000, 292500, 390000, 585000, 780000, 877500,
+			  975000, 1170000, 1300000, 1462500, 1625000, 1755000, 1950000 },	/* 12 ss */
+			{ 105625, 211250, 316875, 422500, 633750, 845000, 950625,
+			  1056250, 1267500, 1408333, 1584375, 1760416, 1901250, 2112500 },	/* 13 ss */
+			{ 113750, 227500, 341250, 455000, 682500, 910000, 1023750,
+			  1137500, 1365000, 1516666, 1706250, 1895833, 2047500, 2275000 },	/* 14 ss */
+			{ 121875, 243750, 365625, 487500, 731250, 975000, 1096875,
+			  1218750, 1462500, 1625000, 1828125, 2031250, 2193750, 2437500 },	/* 15 ss */
+			{ 130000, 260000, 390000, 520000, 780000, 1040000, 1170000,
+			  1300000, 1560000, 1733333, 1950000, 2166666, 2340000, 2600000 },	/* 16 ss */
+		},
+		/* 40MHz */
+		{
+			{ 16250, 32500, 48750, 65000, 97500, 130000, 146250,
+			  162500, 195000, 216666, 243750, 270833, 292500, 325000 },	/* 1 ss */
+			{ 32500, 65000, 97500, 130000, 195000, 260000, 292500,
+			  325000, 390000, 433333, 487500, 541666, 585000, 650000 },	/* 2 ss */
+			{ 48750, 97500, 146250, 195000, 292500, 390000, 438750,
+			  487500, 585000, 650000, 731250, 812500, 877500, 975000 },	/* 3 ss */
+			{ 65000, 130000, 195000, 260000, 390000, 520000, 585000,
+			  650000, 780000, 866666, 975000, 1083333, 1170000, 1300000 },	/* 4 ss */
+			{ 81250, 162500, 243750, 325000, 487500, 650000, 731250,
+			  812500, 975000, 1083333, 1218750, 1354166, 1462500, 1625000 },	/* 5 ss */
+			{ 97500, 195000, 292500, 390000, 585000, 780000, 877500,
+			  975000, 1170000, 1300000, 1462500, 1625000, 1755000, 1950000 },	/* 6 ss */
+			{ 113750, 227500, 341250, 455000, 682500, 910000, 1023750,
+			  1137500, 1365000, 1516666, 1706250, 1895833, 2047500, 2275000 },	/* 7 ss */
+			{ 130000, 260000, 390000, 520000, 780000, 1040000, 1170000,
+			  1300000, 1560000, 1733333, 1950000, 2166666, 2340000, 2600000 },	/* 8 ss */
+			{ 146250, 292500, 438750, 585000, 877500, 1170000, 1316250,
+			  1462500, 1755000, 1950000, 2193750, 2437500, 2632500, 2925000 },	/* 9 ss */
+			{ 162500, 325000, 487500, 650000, 975000, 1300000, 1462500,
+			  1625000, 1950000, 2166666, 2437500, 2708333, 2925000, 3250000 },	/* 10 ss */
+			{ 178750, 357500, 536250, 715000, 1072500, 1430000, 1608750,
+			  1787500, 2145000, 2383333, 2681250, 2979166, 3217500, 3575000 },	/* 11 ss */
+			{ 195000, 390000, 585000, 780000, 1170000, 1560000, 1755000,
+			  1950000, 2340000, 2600000, 2925000, 3250000, 3510000, 3900000 },	/* 12 ss */
+			{ 211250, 422500, 633750, 845000, 1267500, 1690000, 1901250,
+			  2112500, 2535000, 2816666, 3168750, 3520833, 3802500, 4225000 },	/* 13 ss */
+			{ 227500, 455000, 682500, 910000, 1365000, 1820000, 2047500,
+			  2275000, 2730000, 3033333, 3412500, 3791666, 4095000, 4550000 },	/* 14 ss */
+			{ 243750, 487500, 731250, 975000, 1462500, 1950000, 2193750,
+			  2437500, 2925000, 3250000, 3656250, 4062500, 4387500, 4875000 },	/* 15 ss */
+			{ 260000, 520000, 780000, 1040000, 1560000, 2080000, 2340000,
+			  2600000, 3120000, 3466666, 3900000, 4333333, 4680000, 5200000 },	/* 16 ss */
+		},
+		/* 80MHz */
+		{
+			{ 34027, 68055, 102083, 136111, 204166, 272222, 306250,
+			  340277, 408333, 453703, 510416, 567129, 612500, 680555 },	/* 1 ss */
+			{ 68055, 136111, 204166, 272222, 408333, 544444, 612500,
+			  680555, 816666, 907407, 1020833, 1134259, 1225000, 1361111 },	/* 2 ss */
+			{ 102083, 204166, 306250, 408333, 612500, 816666, 918750,
+			  1020833, 1225000, 1361111, 1531250, 1701388, 1837500, 2041666 },	/* 3 ss */
+			{ 136111, 272222, 408333, 544444, 816666, 1088888, 1225000,
+			  1361111, 1633333, 1814814, 2041666, 2268518, 2450000, 2722222 },	/* 4 ss */
+			{ 170138, 340277, 510416, 680555, 1020833, 1361111, 1531250,
+			  1701388, 2041666, 2268518, 2552083, 2835648, 3062500, 3402777 },	/* 5 ss */
+			{ 204166, 408333, 612500, 816666, 1225000, 1633333, 1837500,
+			  2041666, 2450000, 2722222, 3062500, 3402777, 3675000, 4083333 },	/* 6 ss */
+			{ 238194, 476388, 714583, 952777, 1429166, 1905555, 2143750,
+			  2381944, 2858333, 3175925, 3572916, 3969907, 4287500, 4763888 },	/* 7 ss */
+			{ 272222, 544444, 816666, 1088888, 1633333, 2177777, 2450000,
+			  2722222, 3266666, 3629629, 4083333, 4537037, 4900000, 5444444 },	/* 8 ss */
+			{ 306250, 612500, 918750, 1225000, 1837500, 2450000, 2756250,
+			  3062500, 3675000, 4083333, 4593750, 5104166, 5512500, 6125000 },	/* 9 ss */
+			{ 340277, 680555, 1020833, 1361111, 2041666, 2722222, 3062500,
+			  3402777, 4083333, 4537037, 5104166, 5671296, 6125000, 6805555 },	/* 10 ss */
+			{ 374305, 748611, 1122916, 1497222, 2245833, 2994444, 3368750,
+			  3743055, 4491666, 4990740, 5614583, 6238425, 6737500, 7486111 },	/* 11 ss */
+			{ 408333, 816666, 1225000, 1633333, 2450000, 3266666, 3675000,
+			  4083333, 4900000, 5444444, 6125000, 6805555, 7350000, 8166666 },	/* 12 ss */
+			{ 442361, 884722, 1327083, 1769444, 2654166, 3538888, 3981250,
+			  4423611, 5308333, 5898148, 6635416, 7372685, 7962500, 8847222 },	/* 13 ss */
+			{ 476388, 952777, 1429166, 1905555, 2858333, 3811111, 4287500,
+			  4763888, 5716666, 6351851, 7145833, 7939814, 8575000, 9527777 },	/* 14 ss */
+			{ 510416, 1020833, 1531250, 2041666, 3062500, 4083333, 4593750,
+			  5104166, 6125000, 6805555, 7656250, 8506944, 9187500, 10208333 },	/* 15 ss */
+			{ 544444, 1088888, 1633333, 2177777, 3266666, 4355555, 4900000,
+			  5444444, 6533333, 7259259, 8166666, 9074074, 9800000, 10888888 },	/* 16 ss */
+		},
+		/* 160MHz */
+		{
+			{ 68055, 136111, 204166, 272222, 408333, 544444, 612500,
+			  680555, 816666, 907407, 1020833, 1134259, 1225000, 1361111 },	/* 1 ss */
+			{ 136111, 272222, 408333, 544444, 816666, 1088888, 1225000,
+			  1361111, 1633333, 1814814, 2041666, 2268518, 2450000, 2722222 },	/* 2 ss */
+			{ 204166, 408333, 612500, 816666, 1225000, 1633333, 1837500,
+			  2041666, 2450000, 2722222, 3062500, 3402777, 3675000, 4083333 },	/* 3 ss */
+			{ 272222, 544444, 816666, 1088888, 1633333, 2177777, 2450000,
+			  2722222, 3266666, 3629629, 4083333, 4537037, 4900000, 5444444 },	/* 4 ss */
+			{ 340277, 680555, 1020833, 1361111, 2041666, 2722222, 3062500,
+			  3402777, 4083333, 4537037, 5104166, 5671296, 6125000, 6805555 },	/* 5 ss */
+			{ 408333, 816666, 1225000, 1633333, 2450000, 3266666, 3675000,
+			  4083333, 4900000, 5444444, 6125000, 6805555, 7350000, 8166666 },	/* 6 ss */
+			{ 476388, 952777, 1429166, 1905555, 2858333, 3811111, 4287500,
+			  4763888, 5716666, 6351851, 7145833, 7939814, 8575000, 9527777 },	/* 7 ss */
+			{ 544444, 1088888, 1633333, 2177777, 3266666, 4355555, 4900000,
+			  5444444, 6533333, 7259259, 8166666, 9074074, 9800000, 10888888 },	/* 8 ss */
+			{ 612500, 1225000, 1837500, 2450000, 3675000, 4900000, 5512500,
+			  6125000, 7350000, 8166666, 9187500, 10208333, 11025000, 12250000 },	/* 9 ss */
+			{ 680555, 1361111, 2041666, 2722222, 4083333, 5444444, 6125000,
+			  6805555, 8166666, 9074074, 10208333, 11342592, 12250000, 13611111 },	/* 10 ss */
+			{ 748611, 1497222, 2245833, 2994444, 4491666, 5988888, 6737500,
+			  7486111, 8983333, 9981481, 11229166, 12476851, 13475000, 14972222 },	/* 11 ss */
+			{ 816666, 1633333, 2450000, 3266666, 4900000, 6533333, 7350000,
+			  8166666, 9800000, 10888888, 12250000, 13611111, 14700000, 16333333 },	/* 12 ss */
+			{ 884722, 1769444, 2654166, 3538888, 5308333, 7077777, 7962500,
+			  8847222, 10616666, 11796296, 13270833, 14745370, 15925000, 17694444 },	/* 13 ss */
+			{ 952777, 1905555, 2858333, 3811111, 5716666, 7622222, 8575000,
+			  9527777, 11433333, 12703703, 14291666, 15879629, 17150000, 19055555 },	/* 14 ss */
+			{ 1020833, 2041666, 3062500, 4083333, 6125000, 8166666, 9187500,
+			  10208333, 12250000, 13611111, 15312500, 17013888, 18375000, 20416666 },	/* 15 ss */
+			{ 1088888, 2177777, 3266666, 4355555, 6533333, 8711111, 9800000,
+			  10888888, 13066666, 14518518, 16333333, 18148148, 19600000, 21777777 },	/* 16 ss */
+		},
+		/* 320MHz */
+		{
+			{ 136111, 272222, 408333, 544444, 816666, 1088888, 1225000,
+			  1361111, 1633333, 1814814, 2041666, 2268518, 2450000, 2722222 },	/* 1 ss */
+			{ 272222, 544444, 816666, 1088888, 1633333, 2177777, 2450000,
+			  2722222, 3266666, 3629629, 4083333, 4537037, 4900000, 5444444 },	/* 2 ss */
+			{ 408333, 816666, 1225000, 1633333, 2450000, 3266666, 3675000,
+			  4083333, 4900000, 5444444, 6125000, 6805555, 7350000, 8166666 },	/* 3 ss */
+			{ 544444, 1088888, 1633333, 2177777, 3266666, 4355555, 4900000,
+			  5444444, 6533333, 7259259, 8166666, 9074074, 9800000, 10888888 },	/* 4 ss */
+			{ 680555, 1361111, 2041666, 2722222, 4083333, 5444444, 6125000,
+			  6805555, 8166666, 9074074, 10208333, 11342592, 12250000, 13611111 },	/* 5 ss */
+			{ 816666, 1633333, 2450000, 3266666, 4900000, 6533333, 7350000,
+			  8166666, 9800000, 10888888, 12250000, 13611111, 14700000, 16333333 },	/* 6 ss */
+			{ 952777, 1905555, 2858333, 3811111, 5716666, 7622222, 8575000,
+			  9527777, 11433333, 12703703, 14291666, 15879629, 17150000, 19055555 },	/* 7 ss */
+			{ 1088888, 2177777, 3266666, 4355555, 6533333, 8711111, 9800000,
+			  10888888, 13066666, 14518518, 16333333, 18148148, 19600000, 21777777 },	/* 8 ss */
+			{ 1225000, 2450000, 3675000, 4900000, 7350000, 9800000, 11025000,
+			  12250000, 14700000, 16333333, 18375000, 20416666, 22050000, 24500000 },	/* 9 ss */
+			{ 1361111, 2722222, 4083333, 5444444, 8166666, 10888888, 12250000,
+			  13611111, 16333333, 18148148, 20416666, 22685185, 24500000, 27222222 },	/* 10 ss */
+			{ 1497222, 2994444, 4491666, 5988888, 8983333, 11977777, 13475000,
+			  14972222, 17966666, 19962962, 22458333, 24953703, 26950000, 29944444 },	/* 11 ss */
+			{ 1633333, 3266666, 4900000, 6533333, 9800000, 13066666, 14700000,
+			  16333333, 19600000, 21777777, 24500000, 27222222, 29400000, 32666666 },	/* 12 ss */
+			{ 1769444, 3538888, 5308333, 7077777, 10616666, 14155555, 15925000,
+			  17694444, 21233333, 23592592, 26541666, 29490740, 31850000, 35388888 },	/* 13 ss */
+			{ 1905555, 3811111, 5716666, 7622222, 11433333, 15244444, 17150000,
+			  19055555, 22866666, 25407407, 28583333, 31759259, 34300000, 38111111 },	/* 14 ss */
+			{ 2041666, 4083333, 6125000, 8166666, 12250000, 16333333, 18375000,
+			  20416666, 24500000, 27222222, 30625000, 34027777, 36750000, 40833333 },	/* 15 ss */
+			{ 2177777, 4355555, 6533333, 8711111, 13066666, 17422222, 19600000,
+			  21777777, 26133333, 29037037, 32666666, 36296296, 39200000, 43555555 },	/* 16 ss */
+		},
+	},
+	/* 12.8us symbol, 3.2us GI */
+	{
+		/* 20MHz */
+		{
+			{ 7312, 14625, 21937, 29250, 43875, 58500, 65812,
+			  73125, 87750, 97500, 109687, 121875, 131625, 146250 },	/* 1 ss */
+			{ 14625, 29250, 43875, 58500, 87750, 117000, 131625,
+			  146250, 175500, 195000, 219375, 243750, 263250, 292500 },	/* 2 ss */
+			{ 21937, 43875, 65812, 87750, 131625, 175500, 197437,
+			  219375, 263250, 292500, 329062, 365625, 394875, 438750 },	/* 3 ss */
+			{ 29250, 58500, 87750, 117000, 175500, 234000, 263250,
+			  292500, 351000, 390000, 438750, 487500, 526500, 585000 },	/* 4 ss */
+			{ 36562, 73125, 109687, 146250, 219375, 292500, 329062,
+			  365625, 438750, 487500, 548437, 609375, 658125, 731250 },	/* 5 ss */
+			{ 43875, 87750, 131625, 175500, 263250, 351000, 394875,
+			  438750, 526500, 585000, 658125, 731250, 789750, 877500 },	/* 6 ss */
+			{ 51187, 102375, 153562, 204750, 307125, 409500, 460687,
+			  511875, 614250, 682500, 767812, 853125, 921375, 1023750 },	/* 7 ss */
+			{ 58500, 117000, 175500, 234000, 351000, 468000, 526500,
+			  585000, 702000, 780000, 877500, 975000, 1053000, 1170000 },	/* 8 ss */
+			{ 65812, 131625, 197437, 263250, 394875, 526500, 592312,
+			  658125, 789750, 877500, 987187, 1096875, 1184625, 1316250 },	/* 9 ss */
+			{ 73125, 146250, 219375, 292500, 438750, 585000, 658125,
+			  731250, 877500, 975000, 1096875, 1218750, 1316250, 1462500 },	/* 10 ss */
+			{ 80437, 160875, 241312, 321750, 482625, 643500, 723937,
+			  804375, 965250, 1072500, 1206562, 1340625, 1447875, 1608750 },	/* 11 ss */
+			{ 87750, 175500, 263250, 351000, 526500, 702000, 789750,
+			  877500, 1053000, 1170000, 1316250, 1462500, 1579500, 1755000 },	/* 12 ss */
+			{ 95062, 190125, 285187, 380250, 570375, 760500, 855562,
+			  950625, 1140750, 1267500, 1425937, 1584375, 1711125, 1901250 },	/* 13 ss */
+			{ 102375, 204750, 307125, 409500, 614250, 819000, 921375,
+			  1023750, 1228500, 1365000, 1535625, 1706250, 1842750, 2047500 },	/* 14 ss */
+			{ 109687, 219375, 329062, 438750, 658125, 877500, 987187,
+			  1096875, 1316250, 1462500, 1645312, 1828125, 1974375, 2193750 },	/* 15 ss */
+			{ 117000, 234000, 351000, 468000, 702000, 936000, 1053000,
+			  1170000, 1404000, 1560000, 1755000, 1950000, 2106000, 2340000 },	/* 16 ss */
+		},
+		/* 40MHz */
+		{
+			{ 14625, 29250, 43875, 58500, 87750, 117000, 131625,
+			  146250, 175500, 195000, 219375, 243750, 263250, 292500 },	/* 1 ss */
+			{ 29250, 58500, 87750, 117000, 175500, 234000, 263250,
+			  292500, 351000, 390000, 438750, 487500, 526500, 585000 },	/* 2 ss */
+			{ 43875, 87750, 131625, 175500, 263250, 351000, 394875,
+			  438750, 526500, 585000, 658125, 731250, 789750, 877500 },	/* 3 ss */
+			{ 58500, 117000, 175500, 234000, 351000, 468000, 526500,
+			  585000, 702000, 780000, 877500, 975000, 1053000, 1170000 },	/* 4 ss */
+			{ 73125, 146250, 219375, 292500, 438750, 585000, 658125,
+			  731250, 877500, 975000, 1096875, 1218750, 1316250, 1462500 },	/* 5 ss */
+			{ 87750, 175500, 263250, 351000, 526500, 702000, 789750,
+			  877500, 1053000, 1170000, 1316250, 1462500, 1579500, 1755000 },	/* 6 ss */
+			{ 102375, 204750, 307125, 409500, 614250, 819000, 921375,
+			  1023750, 1228500, 1365000, 1535625, 1706250, 1842750, 2047500 },	/* 7 ss */
+			{ 117000, 234000, 351000, 468000, 702000, 936000, 1053000,
+			  1170000, 1404000, 1560000, 1755000, 1950000, 2106000, 2340000 },	/* 8 ss */
+			{ 131625, 263250, 394875, 526500, 789750, 1053000, 1184625,
+			  1316250, 1579500, 1755000, 1974375, 2193750, 2369250, 2632500 },	/* 9 ss */
+			{ 146250, 292500, 438750, 585000, 877500, 1170000, 1316250,
+			  1462500, 1755000, 1950000, 2193750, 2437500, 2632500, 2925000 },	/* 10 ss */
+			{ 160875, 321750, 482625, 643500, 965250, 1287000, 1447875,
+			  1608750, 1930500, 2145000, 2413125, 2681250, 2895750, 3217500 },	/* 11 ss */
+			{ 175500, 351000, 526500, 702000, 1053000, 1404000, 1579500,
+			  1755000, 2106000, 2340000, 2632500, 2925000, 3159000, 3510000 },	/* 12 ss */
+			{ 190125, 380250, 570375, 760500, 1140750, 1521000, 1711125,
+			  1901250, 2281500, 2535000, 2851875, 3168750, 3422250, 3802500 },	/* 13 ss */
+			{ 204750, 409500, 614250, 819000, 1228500, 1638000, 1842750,
+			  2047500, 2457000, 2730000, 3071250, 3412500, 3685500, 4095000 },	/* 14 ss */
+			{ 219375, 438750, 658125, 877500, 1316250, 1755000, 1974375,
+			  2193750, 2632500, 2925000, 3290625, 3656250, 3948750, 4387500 },	/* 15 ss */
+			{ 234000, 468000, 702000, 936000, 1404000, 1872000, 2106000,
+			  2340000, 2808000, 3120000, 3510000, 3900000, 4212000, 4680000 },	/* 16 ss */
+		},
+		/* 80MHz */
+		{
+			{ 30625, 61250, 91875, 122500, 183750, 245000, 275625,
+			  306250, 367500, 408333, 459375, 510416, 551250, 612500 },	/* 1 ss */
+			{ 61250, 122500, 183750, 245000, 367500, 490000, 551250,
+			  612500, 735000, 816666, 918750, 1020833, 1102500, 1225000 },	/* 2 ss */
+			{ 91875, 183750, 275625, 367500, 551250, 735000, 826875,
+			  918750, 1102500, 1225000, 1378125, 1531250, 1653750, 1837500 },	/* 3 ss */
+			{ 122500, 245000, 367500, 490000, 735000, 980000, 1102500,
+			  1225000, 1470000, 1633333, 1837500, 2041666, 2205000, 2450000 },	/* 4 ss */
+			{ 153125, 306250, 459375, 612500, 918750, 1225000, 1378125,
+			  1531250, 1837500, 2041666, 2296875, 2552083, 2756250, 3062500 },	/* 5 ss */
+			{ 183750, 367500, 551250, 735000, 1102500, 1470000, 1653750,
+			  1837500, 2205000, 2450000, 2756250, 3062500, 3307500, 3675000 },	/* 6 ss */
+			{ 214375, 428750, 643125, 857500, 1286250, 1715000, 1929375,
+			  2143750, 2572500, 2858333, 3215625, 3572916, 3858750, 4287500 },	/* 7 ss */
+			{ 245000, 490000, 735000, 980000, 1470000, 1960000, 2205000,
+			  2450000, 2940000, 3266666, 3675000, 4083333, 4410000, 4900000 },	/* 8 ss */
+			{ 275625, 551250, 826875, 1102500, 1653750, 2205000, 2480625,
+			  2756250, 3307500, 3675000, 4134375, 4593750, 4961250, 5512500 },	/* 9 ss */
+			{ 306250, 612500, 918750, 1225000, 1837500, 2450000, 2756250,
+			  3062500, 3675000, 4083333, 4593750, 5104166, 5512500, 6125000 },	/* 10 ss */
+			{ 336875, 673750, 1010625, 1347500, 2021250, 2695000, 3031875,
+			  3368750, 4042500, 4491666, 5053125, 5614583, 6063750, 6737500 },	/* 11 ss */
+			{ 367500, 735000, 1102500, 1470000, 2205000, 2940000, 3307500,
+			  3675000, 4410000, 4900000, 5512500, 6125000, 6615000, 7350000 },	/* 12 ss */
+			{ 398125, 796250, 1194375, 1592500, 2388750, 3185000, 3583125,
+			  3981250, 4777500, 5308333, 5971875, 6635416, 7166250, 7962500 },	/* 13 ss */
+			{ 428750, 857500, 1286250, 1715000, 2572500, 3430000, 3858750,
+			  4287500, 5145000, 5716666, 6431250, 7145833, 7717500, 8575000 },	/* 14 ss */
+			{ 459375, 918750, 1378125, 1837500, 2756250, 3675000, 4134375,
+			  4593750, 5512500, 6125000, 6890625, 7656250, 8268750, 9187500 },	/* 15 ss */
+			{ 490000, 980000, 1470000, 1960000, 2940000, 3920000, 4410000,
+			  4900000, 5880000, 6533333, 7350000, 8166666, 8820000, 9800000 },	/* 16 ss */
+		},
+		/* 160MHz */
+		{
+			{ 61250, 122500, 183750, 245000, 367500, 490000, 551250,
+			  612500, 735000, 816666, 918750, 1020833, 1102500, 1225000 },	/* 1 ss */
+			{ 122500, 245000, 367500, 490000, 735000, 980000, 1102500,
+			  1225000, 1470000, 1633333, 1837500, 2041666, 2205000, 2450000 },	/* 2 ss */
+			{ 183750, 367500, 551250, 735000, 1102500, 1470000, 1653750,
+			  1837500, 2205000, 2450000, 2756250, 3062500, 3307500, 3675000 },	/* 3 ss */
+			{ 245000, 490000, 735000, 980000, 1470000, 1960000, 2205000,
+			  2450000, 2940000, 3266666, 3675000, 4083333, 4410000, 4900000 },	/* 4 ss */
+			{ 306250, 612500, 918750, 1225000, 1837500, 2450000, 2756250,
+			  3062500, 3675000, 4083333, 4593750, 5104166, 5512500, 6125000 },	/* 5 ss */
+			{ 367500, 735000, 1102500, 1470000, 2205000, 2940000, 3307500,
+			  3675000, 4410000, 4900000, 5512500, 6125000, 6615000, 7350000 },	/* 6 ss */
+			{ 428750, 857500, 1286250, 1715000, 2572500, 3430000, 3858750,
+			  4287500, 5145000, 5716666, 6431250, 7145833, 7717500, 8575000 },	/* 7 ss */
+			{ 490000, 980000, 1470000, 1960000, 2940000, 3920000, 4410000,
+			  4900000, 5880000, 6533333, 7350000, 8166666, 8820000, 9800000 },	/* 8 ss */
+			{ 551250, 1102500, 1653750, 2205000, 3307500, 4410000, 4961250,
+			  5512500, 6615000, 7350000, 8268750, 9187500, 9922500, 11025000 },	/* 9 ss */
+			{ 612500, 1225000, 1837500, 2450000, 3675000, 4900000, 5512500,
+			  6125000, 7350000, 8166666, 9187500, 10208333, 11025000, 12250000 },	/* 10 ss */
+			{ 673750, 1347500, 2021250, 2695000, 4042500, 5390000, 6063750,
+			  6737500, 8085000, 8983333, 10106250, 11229166, 12127500, 13475000 },	/* 11 ss */
+			{ 735000, 1470000, 2205000, 2940000, 4410000, 5880000, 6615000,
+			  7350000, 8820000, 9800000, 11025000, 12250000, 13230000, 14700000 },	/* 12 ss */
+			{ 796250, 1592500, 2388750, 3185000, 4777500, 6370000, 7166250,
+			  7962500, 9555000, 10616666, 11943750, 13270833, 14332500, 15925000 },	/* 13 ss */
+			{ 857500, 1715000, 2572500, 3430000, 5145000, 6860000, 7717500,
+			  8575000, 10290000, 11433333, 12862500, 14291666, 15435000, 17150000 },	/* 14 ss */
+			{ 918750, 1837500, 2756250, 3675000, 5512500, 7350000, 8268750,
+			  9187500, 11025000, 12250000, 13781250, 15312500, 16537500, 18375000 },	/* 15 ss */
+			{ 980000, 1960000, 2940000, 3920000, 5880000, 7840000, 8820000,
+			  9800000, 11760000, 13066666, 14700000, 16333333, 17640000, 19600000 },	/* 16 ss */
+		},
+		/* 320MHz */
+		{
+			{ 122500, 245000, 367500, 490000, 735000, 980000, 1102500,
+			  1225000, 1470000, 1633333, 1837500, 2041666, 2205000, 2450000 },	/* 1 ss */
+			{ 245000, 490000, 735000, 980000, 1470000, 1960000, 2205000,
+			  2450000, 2940000, 3266666, 3675000, 4083333, 4410000, 4900000 },	/* 2 ss */
+			{ 367500, 735000, 1102500, 1470000, 2205000, 2940000, 3307500,
+			  3675000, 4410000, 4900000, 5512500, 6125000, 6615000, 7350000 },	/* 3 ss */
+			{ 490000, 980000, 1470000, 1960000, 2940000, 3920000, 4410000,
+			  4900000, 5880000, 6533333, 7350000, 8166666, 8820000, 9800000 },	/* 4 ss */
+			{ 612500, 1225000, 1837500, 2450000, 3675000, 4900000, 5512500,
+			  6125000, 7350000, 8166666, 9187500, 10208333, 11025000, 12250000 },	/* 5 ss */
+			{ 735000, 1470000, 2205000, 2940000, 4410000, 5880000, 6615000,
+			  7350000, 8820000, 9800000, 11025000, 12250000, 13230000, 14700000 },	/* 6 ss */
+			{ 857500, 1715000, 2572500, 3430000, 5145000, 6860000, 7717500,
+			  8575000, 10290000, 11433333, 12862500, 14291666, 15435000, 17150000 },	/* 7 ss */
+			{ 980000, 1960000, 2940000, 3920000, 5880000, 7840000, 8820000,
+			  9800000, 11760000, 13066666, 14700000, 16333333, 17640000, 19600000 },	/* 8 ss */
+			{ 1102500, 2205000, 3307500, 4410000, 6615000, 8820000, 9922500,
+			  11025000, 13230000, 14700000, 16537500, 18375000, 19845000, 22050000 },	/* 9 ss */
+			{ 1225000, 2450000, 3675000, 4900000, 7350000, 9800000, 11025000,
+			  12250000, 14700000, 16333333, 18375000, 20416666, 22050000, 24500000 },	/* 10 ss */
+			{ 1347500, 2695000, 4042500, 5390000, 8085000, 10780000, 12127500,
+			  13475000, 16170000, 17966666, 20212500, 22458333, 24255000, 26950000 },	/* 11 ss */
+			{ 1470000, 2940000, 4410000, 5880000, 8820000, 11760000, 13230000,
+			  14700000, 17640000, 19600000, 22050000, 24500000, 26460000, 29400000 },	/* 12 ss */
+			{ 1592500, 3185000, 4777500, 6370000, 9555000, 12740000, 14332500,
+			  15925000, 19110000, 21233333, 23887500, 26541666, 28665000, 31850000 },	/* 13 ss */
+			{ 1715000, 3430000, 5145000, 6860000, 10290000, 13720000, 15435000,
+			  17150000, 20580000, 22866666, 25725000, 28583333, 30870000, 34300000 },	/* 14 ss */
+			{ 1837500, 3675000, 5512500, 7350000, 11025000, 14700000, 16537500,
+			  18375000, 22050000, 24500000, 27562500, 30625000, 33075000, 36750000 },	/* 15 ss */
+			{ 1960000, 3920000, 5880000, 7840000, 11760000, 15680000, 17640000,
+			  19600000, 23520000, 26133333, 29400000, 32666666, 35280000, 39200000 },	/* 16 ss */
+		},
+	},
+};
+
+#endif /* MCSRATE_H */
@@ -58,10 +58,10 @@ wl_ether_atoe(const char *a, struct wl_ether_addr *n)
 	return (i == ETHER_ADDR_LEN);
 }
 
+/* 'etoa_buf' is of at least ETHER_ADDR_LEN * 3 bytes */
 char *
-wl_ether_etoa(const struct wl_ether_addr *n)
+wl_ether_etoa(const struct wl_ether_addr *n, char *etoa_buf)
 {
-	static char etoa_buf[ETHER_ADDR_LEN * 3];
 	char *c = etoa_buf;
 	int i;
 
@@ -763,6 +763,7 @@ static int bcm_wifi_bss_info(const char *ifname, struct wifi_bss *bss)
 	uint8_t *he_ie;
 	uint16_t capability = 0;
 	uint8_t *ie_start;
+	struct wifi_ie_index idx;
 	uint16_t ie_offset = 0;
 	uint32_t ie_len = 0;
 	uint8_t *ies = (uint8_t *)bufptr;
@@ -852,15 +853,16 @@ static int bcm_wifi_bss_info(const char *ifname, struct wifi_bss *bss)
 		libwifi_dbg("]\n");
 	} */
 
-	ht_ie = wifi_find_ie(ie_start, ie_len, IE_HT_CAP);
-	vht_ie = wifi_find_ie(ie_start, ie_len, IE_VHT_CAP);
-	ext_ie = wifi_find_ie(ie_start, ie_len, IE_EXT_CAP);
-	rrm_ie = wifi_find_ie(ie_start, ie_len, IE_RRM);
-	ft_ie = wifi_find_ie(ie_start, ie_len, IE_MDE);
+	wifi_ie_index_build(&idx, ie_start, ie_len);
+	ht_ie = wifi_ie_index_find(&idx, IE_HT_CAP);
+	vht_ie = wifi_ie_index_find(&idx, IE_VHT_CAP);
+	ext_ie = wifi_ie_index_find(&idx, IE_EXT_CAP);
+	rrm_ie = wifi_ie_index_find(&idx, IE_RRM);
+	ft_ie = wifi_ie_index_find(&idx, IE_MDE);
 
-	he_ie = wifi_find_ie_ext(ie_start, ie_len, IE_EXT_HE_CAP);
+	he_ie = wifi_ie_index_find_ext(&idx, IE_EXT_HE_CAP);
 
-	wmm_ie = wifi_find_vsie(ie_start, ie_len, (uint8_t *)"\x00\x50\xf2", 2, 0xff);
+	wmm_ie = wifi_ie_index_find_vsie(&idx, (uint8_t *)"\x00\x50\xf2", 2, 0xff);
 	if (wmm_ie) {
 		wifi_cap_set(bss->cbitmap, WIFI_CAP_WMM);
 		wmm_ie += 2 + 3 + 2 + 1;  /* skip upto 'version' */
@@ -904,7 +906,7 @@ static int bcm_wifi_bss_info(const char *ifname, struct wifi_bss *bss)
 
 	free(tmp);
 	bcm_get_security(ifname, &bss->auth, &bss->enc); // TODO: deprecate
-	wifi_get_bss_security_from_ies(bss, ie_start, ie_len);
+	wifi_get_bss_security_from_ie_index(bss, &idx);
 
 	/* get bss ch utilization */
 	memset(bufptr, 0, sizeof(bufptr));
@@ -1842,6 +1844,12 @@ static int bcm_get_sta_info_airtime(const char *ifname, uint8_t *addr,
 			airtm = ctr->time_delta ?
 				ctr->airtime * 100 / ctr->time_delta : 0;
 
+			/* bs_data only has the Tx airtime over its window;
+			 * there are no duration counters to track.
+			 */
+			wsta->tx_airtime = ctr->time_delta ?
+				(uint64_t)ctr->airtime * 1000 / ctr->time_delta : 0;
+
 			wsta->airtime = airtm;
 			if (wsta->airtime > 100) {
 				/* Rare but seen; can happen when more than
@@ -2868,6 +2876,7 @@ int bcm_del_vendor_ie(const char *ifname, struct vendor_iereq *req)
 
 const struct wifi_driver bcm_driver = {
 	.name = "wl",
+	.counter_bits = 32,	/* wl_cnt */
 	.info = bcm_driver_info,
 	/* .get_device_id = bcm_get_device_id, */
 	.scan = bcm_scan,
@@ -357,6 +357,31 @@ static int radio_get_scan_results(const char *name, struct wifi_bss *bsss, int *
 	return nlwifi_get_scan_results(netdev, bsss, num);
 }
 
+static int radio_iterate_scan_results(const char *name,
+				      struct wifi_scan_filter *f,
+				      int (*cb)(struct wifi_bss *bss, void *priv),
+				      void *priv)
+{
+	char netdev[16];
+
+	nlwifi_phy_to_netdev(name, netdev, sizeof(netdev));
+	libwifi_dbg("[%s, %s] %s called\n", name, netdev, __func__);
+	return nlwifi_iterate_scan_results(netdev, f, cb, priv);
+}
+
+static int radio_iterate_scan_ies(const char *name,
+				  struct wifi_scan_filter *f,
+				  int (*cb)(struct wifi_bss *bss, uint8_t *ies,
+					    size_t ies_len, void *priv),
+				  void *priv)
+{
+	char netdev[16];
+
+	nlwifi_phy_to_netdev(name, netdev, sizeof(netdev));
+	libwifi_dbg("[%s, %s] %s called\n", name, netdev, __func__);
+	return nlwifi_iterate_scan_ies(netdev, f, cb, priv);
+}
+
 static int radio_get_bss_scan_result(const char *name, uint8_t *bssid,
 				     struct wifi_bss_detail *b)
 {
@@ -526,6 +551,42 @@ static int radio_list_iface(const char *name, struct iface_entry *iface, int *nu
 	return 0;
 }
 
+static int radio_get_wmm_stats(const char *name, struct wifi_bss_wmm_stats *bss,
+			       int *num)
+{
+	struct iface_entry iface[16] = {0};
+	int num_iface = ARRAY_SIZE(iface);
+	int count = 0;
+	int i;
+
+	libwifi_dbg("[%s] %s called\n", name, __func__);
+
+	if (WARN_ON(radio_list_iface(name, iface, &num_iface)))
+		return -1;
+
+	for (i = 0; i < num_iface; i++) {
+		struct wifi_bss_wmm_stats *e;
+
+		if (iface[i].mode != WIFI_MODE_AP)
+			continue;
+
+		if (WARN_ON(count >= *num))
+			break;
+
+		e = &bss[count];
+		memset(e, 0, sizeof(*e));
+		strncpy(e->ifname, iface[i].name, sizeof(e->ifname) - 1);
+		nlwifi_get_bssid(e->ifname, e->bssid);
+		if (bcmwl_iface_get_wmm_stats(e->ifname, e->ac))
+			continue;
+
+		count++;
+	}
+
+	*num = count;
+	return 0;
+}
+
 /* common iface callbacks */
 
 static int iface_start_wps(const char *ifname, struct wps_param wps)
@@ -1076,6 +1137,7 @@ static int recv_event(const char *ifname, void *evhandle)
 
 const struct wifi_driver brcm_driver = {
 	.name = "wl,phy,wds",
+	.counter_bits = 32,	/* wl_cnt */
 	.info = bcmwl_driver_info,
 
 	/* Radio/phy callbacks */
@@ -1106,6 +1168,8 @@ const struct wifi_driver brcm_driver = {
 	.scan = radio_scan,
 	.scan_ex = radio_scan_ex,
 	.get_scan_results = radio_get_scan_results,
+	.iterate_scan_results = radio_iterate_scan_results,
+	.iterate_scan_ies = radio_iterate_scan_ies,
 	.get_bss_scan_result = radio_get_bss_scan_result,
 
 	.get_noise = radio_get_noise,
@@ -1123,6 +1187,8 @@ const struct wifi_driver brcm_driver = {
 	.del_iface = radio_del_iface,
 	.list_iface = radio_list_iface,
 	.channels_info = bcmwl_radio_channels_info,
+	.get_dfs_events = bcmwl_radio_get_dfs_events,
+	.get_wmm_stats = radio_get_wmm_stats,
 
 	/* Interface/vif common callbacks */
 	.iface.start_wps = iface_start_wps,
@@ -43,6 +43,7 @@
 #include <wlc_types.h>
 #include <linux/filter.h>
 #include <linux/socket.h>
+#include <pthread.h>
 
 #include "easy.h"
 #include "debug.h"
@@ -487,6 +488,7 @@ int wl_ioctl_iface_get_assoc_info(const char *name, struct wifi_sta *sta)
 	uint32_t req_ies_len = 0, resp_ies_len = 0;
 	int swap = wl_swap(name);
 	uint8_t *ie_ptr = NULL;
+	struct wifi_ie_index idx;
 	int ret;
 
 	libwifi_dbg("[%s] %s caleld\n", name, __func__);
@@ -514,6 +516,8 @@ int wl_ioctl_iface_get_assoc_info(const char *name, struct wifi_sta *sta)
 		if (WARN_ON(ret))
 			return ret;
 
+		wifi_ie_index_build(&idx, buf, req_ies_len);
+
 		/* capabilities information */
 		ie_ptr = (uint8_t *)&assoc_info.req.capability;
 		sta->caps.valid |= WIFI_CAP_BASIC_VALID;
@@ -521,7 +525,7 @@ int wl_ioctl_iface_get_assoc_info(const char *name, struct wifi_sta *sta)
 		wifi_cap_set_from_ie(sta->cbitmap, ie_ptr, sizeof(assoc_info.req.capability));
 
 		/* ht capabilities */
-		ie_ptr = wifi_find_ie(buf, req_ies_len, IE_HT_CAP);
+		ie_ptr = wifi_ie_index_find(&idx, IE_HT_CAP);
 		if (ie_ptr) {
 			sta->caps.valid |= WIFI_CAP_HT_VALID;
 			memcpy(&sta->caps.ht, &ie_ptr[2], ie_ptr[1]);
@@ -529,7 +533,7 @@ int wl_ioctl_iface_get_assoc_info(const char *name, struct wifi_sta *sta)
 		}
 
 		/* vht capabilities */
-		ie_ptr = wifi_find_ie(buf, req_ies_len, IE_VHT_CAP);
+		ie_ptr = wifi_ie_index_find(&idx, IE_VHT_CAP);
 		if (ie_ptr) {
 			sta->caps.valid |= WIFI_CAP_VHT_VALID;
 			memcpy(&sta->caps.vht, &ie_ptr[2], ie_ptr[1]);
@@ -537,7 +541,7 @@ int wl_ioctl_iface_get_assoc_info(const char *name, struct wifi_sta *sta)
 		}
 
 		/* extended capabilities */
-		ie_ptr = wifi_find_ie(buf, req_ies_len, IE_EXT_CAP);
+		ie_ptr = wifi_ie_index_find(&idx, IE_EXT_CAP);
 		if (ie_ptr) {
 			sta->caps.valid |= WIFI_CAP_EXT_VALID;
 			memcpy(&sta->caps.ext, &ie_ptr[2], ie_ptr[1]);
@@ -545,7 +549,7 @@ int wl_ioctl_iface_get_assoc_info(const char *name, struct wifi_sta *sta)
 		}
 
 		/* RM enabled capabilities */
-		ie_ptr = wifi_find_ie(buf, req_ies_len, IE_RRM);
+		ie_ptr = wifi_ie_index_find(&idx, IE_RRM);
 		if (ie_ptr) {
 			sta->caps.valid |= WIFI_CAP_RM_VALID;
 			memcpy(&sta->caps.ext, &ie_ptr[2], ie_ptr[1]);
@@ -553,13 +557,13 @@ int wl_ioctl_iface_get_assoc_info(const char *name, struct wifi_sta *sta)
 		}
 
 		/* mobility domain element */
-		ie_ptr = wifi_find_ie(buf, req_ies_len, IE_MDE);
+		ie_ptr = wifi_ie_index_find(&idx, IE_MDE);
 		if (ie_ptr) {
 			wifi_cap_set_from_ie(sta->cbitmap, ie_ptr, ie_ptr[1] + 2);
 		}
 
 		/* HE capabilities */
-		ie_ptr = wifi_find_ie_ext(buf, req_ies_len, IE_EXT_HE_CAP);
+		ie_ptr = wifi_ie_index_find_ext(&idx, IE_EXT_HE_CAP);
 		if (ie_ptr) {
 			sta->caps.valid |= WIFI_CAP_HE_VALID;
 			memcpy(&sta->caps.he, &ie_ptr[3], min(ie_ptr[1], sizeof(struct wifi_caps_he)));
@@ -567,7 +571,7 @@ int wl_ioctl_iface_get_assoc_info(const char *name, struct wifi_sta *sta)
 		}
 
 		/* WMM */
-		ie_ptr = wifi_find_vsie(buf, req_ies_len, microsoft_oui, 2, 1);
+		ie_ptr = wifi_ie_index_find_vsie(&idx, microsoft_oui, 2, 1);
 		if (ie_ptr) {
 			wifi_cap_set_from_ie(sta->cbitmap, ie_ptr, ie_ptr[1] + 2);
 		}
@@ -1654,6 +1658,18 @@ end:
 	return ret;
 }
 
+static void bcmwl_chanspec_to_channel(chanspec_t val, uint32_t *channel,
+				      enum wifi_bw *bw)
+{
+	*bw = BW_UNKNOWN;
+	if (CHSPEC_IS20(val)) *bw = BW20;
+	if (CHSPEC_IS40(val)) *bw = BW40;
+	if (CHSPEC_IS80(val)) *bw = BW80;
+	if (CHSPEC_IS160(val)) *bw = BW160;
+	if (CHSPEC_IS8080(val)) *bw = BW8080;
+	*channel = chanspec_to_ctrlchannel(val);
+}
+
 int bcmwl_radio_get_channel(const char *name, uint32_t *channel, enum wifi_bw *bw)
 {
 	chanspec_t val;
@@ -1665,12 +1681,7 @@ int bcmwl_radio_get_channel(const char *name, uint32_t *channel, enum wifi_bw *b
 	if (WARN_ON(ret))
 		return ret;
 
-	if (CHSPEC_IS20(val)) *bw = BW20;
-	if (CHSPEC_IS40(val)) *bw = BW40;
-	if (CHSPEC_IS80(val)) *bw = BW80;
-	if (CHSPEC_IS160(val)) *bw = BW160;
-	if (CHSPEC_IS8080(val)) *bw = BW8080;
-	*channel = chanspec_to_ctrlchannel(val);
+	bcmwl_chanspec_to_channel(val, channel, bw);
 
 	return 0;
 }
@@ -1887,8 +1898,7 @@ int bcmwl_iface_get_stats(const char *ifname, struct wifi_ap_stats *s)
 	return ret;
 }
 
-static int bcmwl_get_ap_wmm_stats(const char *ifname,
-				  struct wifi_ap_wmm_ac a[])
+int bcmwl_iface_get_wmm_stats(const char *ifname, struct wifi_ap_wmm_ac_stats *ac)
 {
 	uint8_t buf[256] = {0};
 	wl_wme_cnt_t *cnt = (wl_wme_cnt_t *)buf;
@@ -1913,29 +1923,50 @@ static int bcmwl_get_ap_wmm_stats(const char *ifname,
 	}
 
 	for (i = 0; i < WIFI_NUM_AC; i++) {
-		a[i].stats.tx_bytes = swap ?
-					BCMSWAP32(cnt->tx[i].bytes) :
-					cnt->tx[i].bytes;
+		ac[i].tx_bytes = swap ?
+				BCMSWAP32(cnt->tx[i].bytes) :
+				cnt->tx[i].bytes;
+
+		ac[i].rx_bytes = swap ?
+				BCMSWAP32(cnt->rx[i].bytes) :
+				cnt->rx[i].bytes;
+
+		ac[i].tx_pkts = swap ?
+				BCMSWAP32(cnt->tx[i].packets) :
+				cnt->tx[i].packets;
 
-		a[i].stats.rx_bytes = swap ?
-					BCMSWAP32(cnt->rx[i].bytes) :
-					cnt->rx[i].bytes;
+		ac[i].rx_pkts = swap ?
+				BCMSWAP32(cnt->rx[i].packets) :
+				cnt->rx[i].packets;
 
-		a[i].stats.tx_pkts = swap ?
-					BCMSWAP32(cnt->tx[i].packets) :
-					cnt->tx[i].packets;
+		ac[i].tx_err_pkts = swap ?
+				BCMSWAP32(cnt->tx_failed[i].packets) :
+				cnt->tx_failed[i].packets;
+
+		ac[i].rx_err_pkts = swap ?
+				BCMSWAP32(cnt->rx_failed[i].packets) :
+				cnt->rx_failed[i].packets;
+	}
 
-		a[i].stats.rx_pkts = swap ?
-					BCMSWAP32(cnt->rx[i].packets) :
-					cnt->rx[i].packets;
+	return 0;
+}
+
+static int bcmwl_get_ap_wmm_stats(const char *ifname,
+				  struct wifi_ap_wmm_ac a[])
+{
+	struct wifi_ap_wmm_ac_stats ac[WIFI_NUM_AC];
+	int i;
 
-		a[i].stats.tx_err_pkts = swap ?
-					BCMSWAP32(cnt->tx_failed[i].packets) :
-					cnt->tx_failed[i].packets;
+	if (bcmwl_iface_get_wmm_stats(ifname, ac))
+		return -1;
 
-		a[i].stats.rx_err_pkts = swap ?
-					BCMSWAP32(cnt->rx_failed[i].packets) :
-					cnt->rx_failed[i].packets;
+	for (i = 0; i < WIFI_NUM_AC; i++) {
+		a[i].stats.tx_bytes = ac[i].tx_bytes;
+		a[i].stats.rx_bytes = ac[i].rx_bytes;
+		a[i].stats.tx_pkts = ac[i].tx_pkts;
+		a[i].stats.rx_pkts = ac[i].rx_pkts;
+		a[i].stats.tx_err_pkts = ac[i].tx_err_pkts;
+		a[i].stats.rx_err_pkts = ac[i].rx_err_pkts;
 	}
 
 	return 0;
@@ -2045,6 +2076,7 @@ int bcmwl_iface_ap_info(const char *name, struct wifi_ap *ap)
 	size_t beacon_len = sizeof(beacon);
 	size_t ies_len;
 	struct beacon_frame *bf;
+	struct wifi_ie_index idx;
 
 	WARN_ON(wl_ioctl_iface_get_assoclist_max(name, &ap->assoclist_max));
 
@@ -2061,12 +2093,13 @@ int bcmwl_iface_ap_info(const char *name, struct wifi_ap *ap)
 	ies_len = beacon_len - ((uint8_t *)&bf->cap_info - beacon + 2);
 	beacon_ies = bf->var;
 
-	ret = wifi_oper_stds_set_from_ie(beacon_ies, ies_len, &ap->bss.oper_std);
+	wifi_ie_index_build(&idx, beacon_ies, ies_len);
+	ret = wifi_oper_stds_set_from_ie_index(&idx, &ap->bss.oper_std);
 	if (ret)
 		WARN_ON(bcmwl_get_oper_stds(name, &ap->bss.oper_std));
-	WARN_ON(wifi_ssid_advertised_set_from_ie(beacon_ies, ies_len, &ap->ssid_advertised));
-	WARN_ON(wifi_get_bss_security_from_ies(&ap->bss, beacon_ies, ies_len));
-	WARN_ON(wifi_apload_set_from_ie(beacon_ies, ies_len, &ap->bss.load));
+	WARN_ON(wifi_ssid_advertised_set_from_ie_index(&idx, &ap->ssid_advertised));
+	WARN_ON(wifi_get_bss_security_from_ie_index(&ap->bss, &idx));
+	WARN_ON(wifi_apload_set_from_ie_index(&idx, &ap->bss.load));
 	ap->bss.beacon_int = bf->beacon_int;
 	ap->sec.curr_mode = ap->bss.security;
 
@@ -2077,7 +2110,7 @@ int bcmwl_iface_ap_info(const char *name, struct wifi_ap *ap)
 	wifi_cap_set_from_ie(ap->bss.cbitmap, ie_ptr, sizeof(bf->cap_info));
 
 	/* wmm params */
-	ie_ptr = wifi_find_vsie(beacon_ies, ies_len, (uint8_t *)"\x00\x50\xf2", 2, 0xff);
+	ie_ptr = wifi_ie_index_find_vsie(&idx, (uint8_t *)"\x00\x50\xf2", 2, 0xff);
 	if (ie_ptr) {
 		wifi_cap_set(ap->bss.cbitmap, WIFI_CAP_WMM);
 		ie_ptr += 2 + 3 + 2 + 1;  /* skip upto 'version' */
@@ -2089,7 +2122,7 @@ int bcmwl_iface_ap_info(const char *name, struct wifi_ap *ap)
 	}
 
 	/* ht capabilities */
-	ie_ptr = wifi_find_ie(beacon_ies, ies_len, IE_HT_CAP);
+	ie_ptr = wifi_ie_index_find(&idx, IE_HT_CAP);
 	if (ie_ptr) {
 		ap->bss.caps.valid |= WIFI_CAP_HT_VALID;
 		memcpy(&ap->bss.caps.ht, &ie_ptr[2], ie_ptr[1]);
@@ -2097,7 +2130,7 @@ int bcmwl_iface_ap_info(const char *name, struct wifi_ap *ap)
 	}
 
 	/* vht capabilities */
-	ie_ptr = wifi_find_ie(beacon_ies, ies_len, IE_VHT_CAP);
+	ie_ptr = wifi_ie_index_find(&idx, IE_VHT_CAP);
 	if (ie_ptr) {
 		ap->bss.caps.valid |= WIFI_CAP_VHT_VALID;
 		memcpy(&ap->bss.caps.vht, &ie_ptr[2], ie_ptr[1]);
@@ -2105,7 +2138,7 @@ int bcmwl_iface_ap_info(const char *name, struct wifi_ap *ap)
 	}
 
 	/* extended capabilities */
-	ie_ptr = wifi_find_ie(beacon_ies, ies_len, IE_EXT_CAP);
+	ie_ptr = wifi_ie_index_find(&idx, IE_EXT_CAP);
 	if (ie_ptr) {
 		ap->bss.caps.valid |= WIFI_CAP_EXT_VALID;
 		memcpy(&ap->bss.caps.ext, &ie_ptr[2], ie_ptr[1]);
@@ -2113,7 +2146,7 @@ int bcmwl_iface_ap_info(const char *name, struct wifi_ap *ap)
 	}
 
 	/* RM enabled capabilities */
-	ie_ptr = wifi_find_ie(beacon_ies, ies_len, IE_RRM);
+	ie_ptr = wifi_ie_index_find(&idx, IE_RRM);
 	if (ie_ptr) {
 		ap->bss.caps.valid |= WIFI_CAP_RM_VALID;
 		memcpy(&ap->bss.caps.ext, &ie_ptr[2], ie_ptr[1]);
@@ -2121,13 +2154,13 @@ int bcmwl_iface_ap_info(const char *name, struct wifi_ap *ap)
 	}
 
 	/* mobility domain element */
-	ie_ptr = wifi_find_ie(beacon_ies, ies_len, IE_MDE);
+	ie_ptr = wifi_ie_index_find(&idx, IE_MDE);
 	if (ie_ptr) {
 		wifi_cap_set_from_ie(ap->bss.cbitmap, ie_ptr, ie_ptr[1] + 2);
 	}
 
 	/* HE capabilities */
-	ie_ptr = wifi_find_ie_ext(beacon_ies, ies_len, IE_EXT_HE_CAP);
+	ie_ptr = wifi_ie_index_find_ext(&idx, IE_EXT_HE_CAP);
 	if (ie_ptr) {
 		ap->bss.caps.valid |= WIFI_CAP_HE_VALID;
 		memcpy(&ap->bss.caps.he, &ie_ptr[3], min(ie_ptr[1], sizeof(struct wifi_caps_he)));
@@ -2444,11 +2477,45 @@ int bcmwl_iface_get_exp_tp(const char *ifname, uint8_t *macaddr, struct wifi_sta
 	return 0;
 }
 
+/* Get our capabilities from the assoc request IEs, which are read from the
+ * driver only once per association with the bssid.
+ */
+static void bcmwl_iface_sta_assoc_caps(const char *ifname, struct wifi_sta *sta)
+{
+	uint64_t now = time_monotonic_msecs();
+	struct wifi_sta t;
+	int i;
+
+	if (hwaddr_is_zero(sta->bssid)) {
+		wifi_sta_caps_del(ifname, NULL);
+		return;
+	}
+
+	memset(&t, 0, sizeof(t));
+	memcpy(t.macaddr, sta->bssid, 6);
+	t.conn_time = sta->conn_time;
+	if (wifi_sta_caps_get(ifname, &t, now)) {
+		/* (re)associated; forget the previous association */
+		wifi_sta_caps_del(ifname, NULL);
+		if (wl_ioctl_iface_get_assoc_info(ifname, &t))
+			return;
+
+		wifi_sta_caps_put(ifname, sta->bssid, sta->conn_time, &t, now);
+	}
+
+	for (i = 0; i < sizeof(sta->cbitmap); i++)
+		sta->cbitmap[i] |= t.cbitmap[i];
+
+	if (t.caps.valid) {
+		t.caps.valid |= sta->caps.valid;
+		memcpy(&sta->caps, &t.caps, sizeof(sta->caps));
+	}
+}
+
 int bcmwl_iface_sta_info(const char *ifname, struct wifi_sta *sta)
 {
 	libwifi_dbg("[%s] %s called\n", ifname, __func__);
 
-	wl_ioctl_iface_get_assoc_info(ifname, sta);
 	WARN_ON(bcmwl_get_rssi(ifname, &sta->rssi[0]));
 	WARN_ON(bcmwl_get_macaddr(ifname, sta->macaddr));
 	WARN_ON(bcmwl_get_bssid(ifname, sta->bssid));
@@ -2459,6 +2526,7 @@ int bcmwl_iface_sta_info(const char *ifname, struct wifi_sta *sta)
 
 	WARN_ON(supplicant_cli_get_sta_security(ifname, &sta->sec));
 	bcmwl_get_sta_info(ifname, sta->bssid, sta);
+	bcmwl_iface_sta_assoc_caps(ifname, sta);
 	bcmwl_iface_get_exp_tp(ifname, sta->bssid, sta);
 
 	return 0;
@@ -3740,6 +3808,205 @@ static int bcmwl_event_handle_cac_state_change(const char *ifname, bcm_event_t *
 	return 0;
 }
 
+/* DFS events of radios are read off an event socket of their own, kept
+ * open from the first call on, as the ones of bcmwl_register_event() exist
+ * only while a caller has registered for events.
+ */
+#define BCMWL_DFS_MAX_RADIOS	4
+
+static struct {
+	char name[16];
+	int fd;
+} bcmwl_dfs[BCMWL_DFS_MAX_RADIOS];
+static pthread_mutex_t bcmwl_dfs_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void bcmwl_bpf_filter_dfs(const char *ifname, int fd)
+{
+	struct sock_filter code[] = {
+		BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(bcm_event_t, event.event_type)),
+		BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, WLC_E_RADAR_DETECTED, 2, 0),
+		BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, WLC_E_AP_CHAN_CHANGE, 1, 0),
+		BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, WLC_E_CAC_STATE_CHANGE, 0, 1),
+		BPF_STMT(BPF_RET | BPF_K, 0xffff),
+		BPF_STMT(BPF_RET | BPF_K, 0),
+	};
+	struct sock_fprog bpf = {
+		.len = ARRAY_SIZE(code),
+		.filter = code
+	};
+
+	if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &bpf, sizeof(bpf)) < 0)
+		libwifi_err("[%s] attach bpf filter failed errno %d (%s)", ifname, errno, strerror(errno));
+}
+
+/* called with bcmwl_dfs_lock held */
+static int bcmwl_dfs_socket(const char *name)
+{
+	int i;
+
+	for (i = 0; i < BCMWL_DFS_MAX_RADIOS && bcmwl_dfs[i].name[0]; i++) {
+		if (!strncmp(bcmwl_dfs[i].name, name, sizeof(bcmwl_dfs[i].name)))
+			return bcmwl_dfs[i].fd;
+	}
+
+	if (WARN_ON(i == BCMWL_DFS_MAX_RADIOS))
+		return -1;
+
+	bcmwl_dfs[i].fd = bcmwl_event_socket_open(name);
+	if (bcmwl_dfs[i].fd < 0)
+		return -1;
+
+	/* only the DFS events, not the probe filter of event sockets */
+	bcmwl_bpf_filter_dfs(name, bcmwl_dfs[i].fd);
+	WARN_ON(bcmwl_enable_event_bit(name, WLC_E_RADAR_DETECTED));
+	WARN_ON(bcmwl_enable_event_bit(name, WLC_E_AP_CHAN_CHANGE));
+	WARN_ON(bcmwl_enable_event_bit(name, WLC_E_CAC_STATE_CHANGE));
+
+	strncpy(bcmwl_dfs[i].name, name, sizeof(bcmwl_dfs[i].name) - 1);
+	return bcmwl_dfs[i].fd;
+}
+
+/* Get the DFS events of an event; returns the number of them */
+static int bcmwl_dfs_event(const char *name, bcm_event_t *event, ssize_t size,
+			   struct wifi_dfs_event *ev, int max)
+{
+	wl_event_radar_detect_data_t *radar;
+	wl_dfs_sub_status_t *status;
+	wl_event_change_chan_t *cc;
+	chanspec_t chanspec[2];
+	uint32_t datalen;
+	wlc_cac_event_t *cac;
+	int num = 0;
+	int swap;
+	int i;
+
+	if (size < (ssize_t)sizeof(*event))
+		return 0;
+
+	datalen = ntohl(event->event.datalen);
+	if (sizeof(*event) + datalen > (size_t)size)
+		return 0;
+
+	swap = wl_swap(name);
+
+	switch (ntohl(event->event.event_type)) {
+	case WLC_E_RADAR_DETECTED:
+		radar = (wl_event_radar_detect_data_t *)(event + 1);
+		if (datalen < sizeof(*radar))
+			return 0;
+
+		chanspec[num] = swap ? BCMSWAP16(radar->current_chanspec) :
+				       radar->current_chanspec;
+		ev[num++].type = WIFI_DFS_EVENT_RADAR;
+		break;
+	case WLC_E_AP_CHAN_CHANGE:
+		/* background CAC of the channel to move the AP to */
+		cc = (wl_event_change_chan_t *)(event + 1);
+		if (datalen < sizeof(*cc))
+			return 0;
+
+		chanspec[num] = swap ? BCMSWAP16(cc->target_chanspec) :
+				       cc->target_chanspec;
+
+		switch (swap ? BCMSWAP32(cc->reason) : cc->reason) {
+		case WL_CHAN_REASON_DFS_AP_MOVE_START:
+		case WL_CHAN_REASON_CSA_TO_DFS_CHAN_FOR_CAC_ONLY:
+			ev[num++].type = WIFI_DFS_EVENT_CAC_STARTED;
+			break;
+		case WL_CHAN_REASON_DFS_AP_MOVE_RADAR_FOUND:
+			ev[num++].type = WIFI_DFS_EVENT_RADAR;
+			break;
+		case WL_CHAN_REASON_DFS_AP_MOVE_ABORTED:
+		case WL_CHAN_REASON_DFS_AP_MOVE_STUNT:
+			ev[num++].type = WIFI_DFS_EVENT_CAC_ABORTED;
+			break;
+		case WL_CHAN_REASON_DFS_AP_MOVE_SUCCESS:
+			ev[num++].type = WIFI_DFS_EVENT_CAC_FINISHED;
+			break;
+		default:
+			break;
+		}
+		break;
+	case WLC_E_CAC_STATE_CHANGE:
+		/* the state of the main and the background CAC */
+		cac = (wlc_cac_event_t *)(event + 1);
+		if (datalen < sizeof(*cac) ||
+		    (swap ? BCMSWAP16(cac->type) : cac->type) !=
+		    WLC_E_CAC_STATE_TYPE_DFS_STATUS_ALL)
+			return 0;
+
+		for (i = 0; i < 2 && num < max; i++) {
+			if (i >= (swap ? BCMSWAP16(cac->scan_status.num_sub_status) :
+					 cac->scan_status.num_sub_status))
+				break;
+
+			status = &cac->scan_status.dfs_sub_status[i];
+			chanspec[num] = swap ? BCMSWAP16(status->chanspec) :
+					       status->chanspec;
+			if (chanspec[num] == INVCHANSPEC)
+				continue;
+
+			switch (swap ? BCMSWAP32(status->state) : status->state) {
+			case WL_DFS_CACSTATE_PREISM_CAC:
+			case WL_DFS_CACSTATE_PREISM_OOC:
+				ev[num++].type = WIFI_DFS_EVENT_CAC_STARTED;
+				break;
+			case WL_DFS_CACSTATE_ISM:
+				ev[num++].type = WIFI_DFS_EVENT_CAC_FINISHED;
+				break;
+			default:
+				break;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+
+	for (i = 0; i < num; i++)
+		bcmwl_chanspec_to_channel(chanspec[i], &ev[i].channel, &ev[i].bw);
+
+	return num;
+}
+
+int bcmwl_radio_get_dfs_events(const char *name, struct wifi_dfs_event *ev,
+			       int *num)
+{
+	struct tpacket_stats st;
+	socklen_t len = sizeof(st);
+	uint8_t buf[2048];
+	ssize_t size;
+	int ret = 0;
+	int n = 0;
+	int fd;
+
+	pthread_mutex_lock(&bcmwl_dfs_lock);
+	fd = bcmwl_dfs_socket(name);
+	if (fd < 0) {
+		pthread_mutex_unlock(&bcmwl_dfs_lock);
+		return -1;
+	}
+
+	/* events dropped off a full socket */
+	if (!getsockopt(fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) &&
+	    st.tp_drops)
+		ret = -ESTALE;
+
+	/* room for the two events a CAC state change can take */
+	while (n + 2 <= *num) {
+		size = bcmwl_event_socket_read(fd, buf, sizeof(buf));
+		if (size <= 0)
+			break;
+
+		n += bcmwl_dfs_event(name, (bcm_event_t *)buf, size, &ev[n],
+				     *num - n);
+	}
+	pthread_mutex_unlock(&bcmwl_dfs_lock);
+
+	*num = n;
+	return ret;
+}
+
 static int bcmwl_event_handle_escan_result(const char *ifname, bcm_event_t *event,
 					   int size, char *out, size_t olen)
 {
@@ -4032,6 +4299,12 @@ static int bcm_get_sta_info_airtime(const char *ifname, uint8_t *addr,
 			airtm = ctr->time_delta ?
 				ctr->airtime * 100 / ctr->time_delta : 0;
 
+			/* bs_data only has the Tx airtime over its window;
+			 * there are no duration counters to track.
+			 */
+			wsta->tx_airtime = ctr->time_delta ?
+				(uint64_t)ctr->airtime * 1000 / ctr->time_delta : 0;
+
 			wsta->airtime = airtm;
 			if (wsta->airtime > 100) {
 				/* Rare but seen; can happen when more than
@@ -8,6 +8,7 @@ int bcmwl_radio_get_country(const char *name, char *alpha2);
 int bcmwl_radio_get_countrylist(const char *name, char *cc, int *num);
 int bcmwl_radio_get_stats(const char *name, struct wifi_radio_stats *s);
 int bcmwl_iface_get_stats(const char *ifname, struct wifi_ap_stats *s);
+int bcmwl_iface_get_wmm_stats(const char *ifname, struct wifi_ap_wmm_ac_stats *ac);
 int bcmwl_get_supported_security_const(const char *name, uint32_t *sec);
 int bcmwl_iface_get_auth(const char *name, uint32_t *auth);
 int bcmwl_iface_get_wsec(const char *name, uint32_t *enc);
@@ -50,6 +51,7 @@ int bcmwl_iface_ap_set_state(const char *ifname, bool up);
 int bcmwl_iface_get_4addr_parent(const char *ifname, const char *parent);
 int bcmwl_radio_get_channels(const char *name, enum wifi_bw bw, enum wifi_chan_ext sb, uint32_t *channels, int *num);
 int bcmwl_get_oper_band(const char *name, enum wifi_band *band);
+int bcmwl_radio_get_dfs_events(const char *name, struct wifi_dfs_event *ev, int *num);
 int bcmwl_iface_get_exp_tp(const char *ifname, uint8_t *macaddr, struct wifi_sta *sta);
 
 int bcmwl_register_event(const char *ifname, struct event_struct *ev, void **evhandle);
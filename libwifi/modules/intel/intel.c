@@ -19,14 +19,20 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
  * 02110-1301 USA
  */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <errno.h>
 #include <sys/types.h>
 #include <fcntl.h>
 #include <net/if.h>
+#include <pthread.h>
 #include <netlink/genl/genl.h>
 #include <netlink/genl/ctrl.h>
 #include <netpacket/packet.h>
@@ -35,6 +41,7 @@
 /* header for Intel's vendor cmds */
 #include <vendor_cmds.h>
 
+#include "easy.h"
 #include "debug.h"
 #include "util.h"
 #include "wifi.h"
@@ -57,240 +64,582 @@ static uint8_t wmode2std[] = {
 	[11] = WIFI_A | WIFI_N | WIFI_AC,
 };
 
-int intel_get_sta_info(const char *ifname, uint8_t *addr, struct wifi_sta *info)
+/* Vendor cmd responses are cached per (ifname, subcmd) for a short while,
+ * so that the getters called within one poll do not repeat the same vendor
+ * cmd. A miss on any cmd of a group refreshes the whole group with one
+ * pipelined batch of vendor cmds, which concurrent misses wait for.
+ */
+#define INTEL_VCACHE_TTL_DEFAULT	1000	/* msecs */
+#define INTEL_VCMDS_MAX			8
+
+struct intel_vcache {
+	char ifname[16];
+	uint32_t subcmd;
+	uint64_t tstamp;	/* msecs */
+	int status;
+	int len;
+	uint8_t *data;
+	bool refreshing;	/* in a batch in flight */
+	struct intel_vcache *next;
+};
+
+struct intel_vcmd {
+	uint32_t subcmd;
+	int size;
+};
+
+/* radio level vendor blobs */
+static const struct intel_vcmd intel_radio_vcmds[] = {
+	{ LTQ_NL80211_VENDOR_SUBCMD_GET_RADIO_INFO, sizeof(mtlk_radio_info_t) },
+	{ LTQ_NL80211_VENDOR_SUBCMD_GET_NETWORK_MODE, sizeof(int) },
+	{ LTQ_NL80211_VENDOR_SUBCMD_GET_BEACON_PERIOD, sizeof(int) },
+	{ LTQ_NL80211_VENDOR_SUBCMD_GET_DTIM_PERIOD, sizeof(int) },
+	{ LTQ_NL80211_VENDOR_SUBCMD_GET_TEMPERATURE_SENSOR, sizeof(int) },
+};
+
+/* vap level vendor blobs */
+static const struct intel_vcmd intel_vap_vcmds[] = {
+	{ LTQ_NL80211_VENDOR_SUBCMD_GET_VAP_MEASUREMENTS, sizeof(struct mtlk_vap_info) },
+	{ LTQ_NL80211_VENDOR_SUBCMD_GET_AP_CAPABILITIES_MAX_STAs, sizeof(int) },
+	{ LTQ_NL80211_VENDOR_SUBCMD_GET_HIDDEN_SSID, sizeof(int) },
+	{ LTQ_NL80211_VENDOR_SUBCMD_GET_AP_FORWARDING, sizeof(int) },
+};
+
+static struct intel_vcache *intel_vcache_list;
+static int intel_vcache_ttl = INTEL_VCACHE_TTL_DEFAULT;
+static pthread_mutex_t intel_vcache_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t intel_vcache_cond = PTHREAD_COND_INITIALIZER;
+
+static struct intel_vcache *intel_vcache_lookup(const char *ifname,
+						uint32_t subcmd)
 {
-	char sbuf[512] = {0};
-	mtlk_sta_info_t s;
-	int slen = 0;
-	int ret;
+	struct intel_vcache *e;
 
-	if (!addr) {
-		libwifi_err("Invalid args!\n");
-		return -EINVAL;
+	for (e = intel_vcache_list; e; e = e->next) {
+		if (e->subcmd == subcmd &&
+		    !strncmp(e->ifname, ifname, sizeof(e->ifname)))
+			return e;
 	}
 
-	nlwifi_get_sta_info(ifname, addr, info);
+	return NULL;
+}
+
+static bool intel_vcache_fresh(struct intel_vcache *e, uint64_t now)
+{
+	return e && e->data && now < e->tstamp + (uint64_t)intel_vcache_ttl;
+}
+
+static struct intel_vcache *intel_vcache_get(const char *ifname,
+					     uint32_t subcmd)
+{
+	struct intel_vcache *e;
+
+	e = intel_vcache_lookup(ifname, subcmd);
+	if (e)
+		return e;
+
+	e = calloc(1, sizeof(*e));
+	if (!e)
+		return NULL;
+
+	strncpy(e->ifname, ifname, sizeof(e->ifname) - 1);
+	e->subcmd = subcmd;
+	e->next = intel_vcache_list;
+	intel_vcache_list = e;
+
+	return e;
+}
 
-	ret = nlwifi_vendor_cmd(ifname, OUI_LTQ,
-			LTQ_NL80211_VENDOR_SUBCMD_GET_STA_MEASUREMENTS,
-			addr, 6, (uint8_t *)&s, &slen);
-
-	if (!ret && slen == sizeof(mtlk_sta_info_t)) {
-		/* update with vendor fetched data */
-		info->rssi_avg = s.peer_stats.SignalStrength;
-		info->rssi[0] = s.peer_stats.ShortTermRSSIAverage[0];
-		info->rssi[1] = s.peer_stats.ShortTermRSSIAverage[1];
-		info->rssi[2] = s.peer_stats.ShortTermRSSIAverage[2];
-		info->rssi[3] = s.peer_stats.ShortTermRSSIAverage[3];
-
-		/* XXX: antenna[0] is NC for 2.4Ghz 3x3 as
-		 * it returns value -128.
-		 */
-		if (info->rssi[0] == -128) {
-			info->rssi[0] = info->rssi[1];
-			info->rssi[1] = info->rssi[2];
-			info->rssi[2] = info->rssi[3];
-			info->rssi[3] = 0;
+/* Mark 'cmds' as in a batch in flight; called with the lock held */
+static void intel_vcache_mark(const char *ifname,
+			      const struct intel_vcmd *cmds, int num)
+{
+	struct intel_vcache *e;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		e = intel_vcache_get(ifname, cmds[i].subcmd);
+		if (e)
+			e->refreshing = true;
+	}
+}
+
+/* takes ownership of 'data' */
+static void intel_vcache_store(const char *ifname, uint32_t subcmd,
+			       int status, uint8_t *data, int len,
+			       uint64_t now)
+{
+	struct intel_vcache *e;
+
+	e = intel_vcache_get(ifname, subcmd);
+	if (!e) {
+		free(data);
+		return;
+	}
+
+	free(e->data);
+	e->data = data;
+	e->len = len;
+	e->status = status;
+	e->tstamp = now;
+}
+
+/* Get 'cmds' marked by intel_vcache_mark() in one batch, and wake up the
+ * ones waiting for it.
+ */
+static int intel_vcache_refresh(const char *ifname,
+				const struct intel_vcmd *cmds, int num)
+{
+	struct nlwifi_vendor_req req[INTEL_VCMDS_MAX];
+	struct intel_vcache *e;
+	uint64_t now;
+	int ret = -EINVAL;
+	int i;
+
+	memset(req, 0, sizeof(req));
+	if (WARN_ON(num > INTEL_VCMDS_MAX))
+		goto out;
+
+	for (i = 0; i < num; i++) {
+		req[i].subcmd = cmds[i].subcmd;
+		req[i].osize = cmds[i].size;
+		req[i].out = calloc(1, cmds[i].size);
+		if (!req[i].out) {
+			ret = -ENOMEM;
+			goto out;
 		}
+	}
+
+	ret = nlwifi_vendor_cmd_batch(ifname, OUI_LTQ, req, num);
+	if (ret)
+		goto out;
+
+	now = time_monotonic_msecs();
+	pthread_mutex_lock(&intel_vcache_lock);
+	for (i = 0; i < num; i++) {
+		intel_vcache_store(ifname, req[i].subcmd, req[i].status,
+				   req[i].out, req[i].olen, now);
+		req[i].out = NULL;
+	}
+	pthread_mutex_unlock(&intel_vcache_lock);
 
-		info->tx_rate.rate = s.peer_stats.LastDataUplinkRate;
-		info->rx_rate.rate = s.peer_stats.LastDataDownlinkRate;
+out:
+	for (i = 0; i < INTEL_VCMDS_MAX; i++)
+		free(req[i].out);
 
-		info->stats.tx_rtx_pkts = s.peer_stats.Retransmissions;
-		info->stats.tx_bytes = s.peer_stats.traffic_stats.BytesSent;
-		info->stats.rx_bytes = s.peer_stats.traffic_stats.BytesReceived;
-		info->stats.tx_pkts = s.peer_stats.traffic_stats.PacketsSent;
-		info->stats.rx_pkts = s.peer_stats.traffic_stats.PacketsReceived;
+	pthread_mutex_lock(&intel_vcache_lock);
+	for (i = 0; i < num; i++) {
+		e = intel_vcache_lookup(ifname, cmds[i].subcmd);
+		if (e)
+			e->refreshing = false;
 	}
+	pthread_cond_broadcast(&intel_vcache_cond);
+	pthread_mutex_unlock(&intel_vcache_lock);
 
-	/* Wait.. we don't have the sta capabilities yet!
-	 * Parse the (re)assoc request frame last received by hostapd and try
-	 * to get capabilities of this sta.
+	return ret;
+}
+
+/* Refresh the stale radio and vap level vendor blobs of 'ifname' in one go */
+static int intel_vendor_cache_refresh(const char *ifname)
+{
+	struct intel_vcmd cmds[INTEL_VCMDS_MAX];
+	struct intel_vcache *e;
+	uint64_t now;
+	int num = 0;
+	int i;
+
+	if (intel_vcache_ttl <= 0)
+		return 0;
+
+	now = time_monotonic_msecs();
+	pthread_mutex_lock(&intel_vcache_lock);
+	for (i = 0; i < ARRAY_SIZE(intel_radio_vcmds) + ARRAY_SIZE(intel_vap_vcmds); i++) {
+		const struct intel_vcmd *c = i < ARRAY_SIZE(intel_radio_vcmds) ?
+				&intel_radio_vcmds[i] :
+				&intel_vap_vcmds[i - ARRAY_SIZE(intel_radio_vcmds)];
+
+		/* fresh, or already being got */
+		e = intel_vcache_lookup(ifname, c->subcmd);
+		if (intel_vcache_fresh(e, now) || (e && e->refreshing))
+			continue;
+
+		if (WARN_ON(num >= INTEL_VCMDS_MAX))
+			break;
+
+		cmds[num++] = *c;
+	}
+
+	intel_vcache_mark(ifname, cmds, num);
+	pthread_mutex_unlock(&intel_vcache_lock);
+
+	if (!num)
+		return 0;
+
+	return intel_vcache_refresh(ifname, cmds, num);
+}
+
+static int intel_vcmd_group(uint32_t subcmd, const struct intel_vcmd **cmds)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(intel_radio_vcmds); i++) {
+		if (intel_radio_vcmds[i].subcmd == subcmd) {
+			*cmds = intel_radio_vcmds;
+			return ARRAY_SIZE(intel_radio_vcmds);
+		}
+	}
+
+	for (i = 0; i < ARRAY_SIZE(intel_vap_vcmds); i++) {
+		if (intel_vap_vcmds[i].subcmd == subcmd) {
+			*cmds = intel_vap_vcmds;
+			return ARRAY_SIZE(intel_vap_vcmds);
+		}
+	}
+
+	return 0;
+}
+
+/* Same as nlwifi_vendor_cmd() for a vendor cmd without input data, but
+ * served from the vendor cache when the cmd is a cacheable one. '*olen' is
+ * the size of 'out'; -ENOSPC if a cached response doesn't fit.
+ */
+static int intel_vendor_cmd_cached(const char *ifname, uint32_t subcmd,
+				   uint8_t *out, int *olen)
+{
+	const struct intel_vcmd *cmds = NULL;
+	struct intel_vcache *e;
+	uint64_t now;
+	int ret = 0;
+	int num;
+
+	num = intel_vcmd_group(subcmd, &cmds);
+	if (!num || intel_vcache_ttl <= 0)
+		return nlwifi_vendor_cmd(ifname, OUI_LTQ, subcmd, NULL, 0,
+					 out, olen);
+
+	now = time_monotonic_msecs();
+	pthread_mutex_lock(&intel_vcache_lock);
+	e = intel_vcache_lookup(ifname, subcmd);
+	if (e && e->refreshing) {
+		/* wait for the batch in flight, and take what it got */
+		while (e && e->refreshing) {
+			pthread_cond_wait(&intel_vcache_cond, &intel_vcache_lock);
+			e = intel_vcache_lookup(ifname, subcmd);
+		}
+	} else if (!intel_vcache_fresh(e, now)) {
+		intel_vcache_mark(ifname, cmds, num);
+		pthread_mutex_unlock(&intel_vcache_lock);
+		ret = intel_vcache_refresh(ifname, cmds, num);
+		pthread_mutex_lock(&intel_vcache_lock);
+		e = intel_vcache_lookup(ifname, subcmd);
+	}
+
+	if (ret || !intel_vcache_fresh(e, now) || e->status) {
+		ret = -1;
+	} else if (e->len > *olen) {
+		libwifi_dbg("[%s] vendor subcmd %u: %d bytes > %d\n", ifname,
+			    subcmd, e->len, *olen);
+		ret = -ENOSPC;
+	} else {
+		memcpy(out, e->data, e->len);
+		*olen = e->len;
+	}
+
+	pthread_mutex_unlock(&intel_vcache_lock);
+	return ret;
+}
+
+static void intel_sta_update_measurements(struct wifi_sta *info,
+					  mtlk_sta_info_t *s)
+{
+	/* update with vendor fetched data */
+	info->rssi_avg = s->peer_stats.SignalStrength;
+	info->rssi[0] = s->peer_stats.ShortTermRSSIAverage[0];
+	info->rssi[1] = s->peer_stats.ShortTermRSSIAverage[1];
+	info->rssi[2] = s->peer_stats.ShortTermRSSIAverage[2];
+	info->rssi[3] = s->peer_stats.ShortTermRSSIAverage[3];
+
+	/* XXX: antenna[0] is NC for 2.4Ghz 3x3 as
+	 * it returns value -128.
 	 */
-	chrCmd(sbuf, sizeof(sbuf),
-		"hostapd_cli -i %s get_last_assoc_req " MACFMT " | cut -d'=' -f2",
-		ifname, MAC2STR(addr));
-	if (sbuf[0] != '\0') {
-		int pos = 10;
-		uint8_t buf[256] = {0};
-		int reassoc = 0;
-
-		/* libwifi_dbg("sta last assoc req: %s\n", sbuf); */
-		strtob(sbuf, sizeof(sbuf), buf);
-		reassoc = buf[0] == 0x20 ? 1 : 0;
-		if (!memcmp(&buf[pos], addr, 6)) {
-			char ssid[32] = {0};
-			uint8_t cap[2] = {0};
-			uint8_t *ie_start;
-			uint8_t *vht_ie, *ht_ie;
-			uint8_t *ext_ie, *rrm_ie, *ft_ie;
-			int matched = 0;
-			/* following for max phyrate calculations */
-			//int phy_mode = 0;
-			int bw = 20;
-			int sgi = 0;
-			int nss = 0;
-			int max_mcs = -1;
-			uint8_t *supp_mcs = NULL;
-			int octet;
-			int l;
+	if (info->rssi[0] == -128) {
+		info->rssi[0] = info->rssi[1];
+		info->rssi[1] = info->rssi[2];
+		info->rssi[2] = info->rssi[3];
+		info->rssi[3] = 0;
+	}
+
+	info->tx_rate.rate = s->peer_stats.LastDataUplinkRate;
+	info->rx_rate.rate = s->peer_stats.LastDataDownlinkRate;
+
+	info->stats.tx_rtx_pkts = s->peer_stats.Retransmissions;
+	info->stats.tx_bytes = s->peer_stats.traffic_stats.BytesSent;
+	info->stats.rx_bytes = s->peer_stats.traffic_stats.BytesReceived;
+	info->stats.tx_pkts = s->peer_stats.traffic_stats.PacketsSent;
+	info->stats.rx_pkts = s->peer_stats.traffic_stats.PacketsReceived;
+}
+
+/* Parse the (re)assoc request frame last received by hostapd from the sta,
+ * passed in as hex string, and get the sta's capabilities from it.
+ */
+static int intel_sta_caps_from_assoc_req(const char *ssid, uint8_t *addr,
+					 char *sbuf, int sbuflen,
+					 struct wifi_sta *info)
+{
+	int pos = 10;
+	uint8_t buf[256] = {0};
+	int reassoc = 0;
+	uint8_t cap[2] = {0};
+	uint8_t *ie_start;
+	int ielen;
+	uint8_t *vht_ie, *ht_ie;
+	uint8_t *ext_ie, *rrm_ie, *ft_ie;
+	struct wifi_ie_index idx;
+	/* following for max phyrate calculations */
+	//int phy_mode = 0;
+	int bw = 20;
+	int sgi = 0;
+	int nss = 0;
+	int max_mcs = -1;
+	uint8_t *supp_mcs = NULL;
+	int octet;
+	int l;
+
+	if (sbuf[0] == '\0')
+		return -1;
+
+	/* libwifi_dbg("sta last assoc req: %s\n", sbuf); */
+	strtob(sbuf, sbuflen, buf);
+	reassoc = buf[0] == 0x20 ? 1 : 0;
+	if (memcmp(&buf[pos], addr, 6))
+		return -1;
 
 #ifndef bit
 #define bit(_n)	(1 << (_n))
 #endif
-			/* Addr2 matched; lookahead for ssid and jump to
-			 * capability info.
-			 * Then iterate through the ies for ht/vht_caps
-			 * elements.
-			 */
-			pos += 14;
-			cap[0] = buf[pos];
-			cap[1] = buf[pos + 1];
-			libwifi_dbg("capability = 0x%2x%2x\n", cap[0] & 0xff, cap[1] & 0xff);
-			pos += reassoc ? 10 : 4;
-			ie_start = (uint8_t *)&buf[pos];
-			nlwifi_get_ssid(ifname, ssid);
-			if (ssid[0] != '\0' && buf[pos] == 0x0 &&
-				!memcmp(&buf[pos + 2], ssid, strlen(ssid))) {
-				matched = 1;
-			}
+	/* Addr2 matched; lookahead for ssid and jump to
+	 * capability info.
+	 * Then iterate through the ies for ht/vht_caps
+	 * elements.
+	 */
+	pos += 14;
+	cap[0] = buf[pos];
+	cap[1] = buf[pos + 1];
+	libwifi_dbg("capability = 0x%2x%2x\n", cap[0] & 0xff, cap[1] & 0xff);
+	pos += reassoc ? 10 : 4;
+	ie_start = (uint8_t *)&buf[pos];
+	ielen = sizeof(buf) - pos;
+	if (ssid[0] == '\0' || buf[pos] != 0x0 ||
+	    memcmp(&buf[pos + 2], ssid, strlen(ssid)))
+		return -1;
 
-			if (!matched)
-				return ret;
+	wifi_cap_set_from_ie(info->cbitmap, cap, 2);
 
-			wifi_cap_set_from_ie(info->cbitmap, cap, 2);
+	wifi_ie_index_build(&idx, ie_start, ielen);
+	ht_ie = wifi_ie_index_find(&idx, IE_HT_CAP);
+	vht_ie = wifi_ie_index_find(&idx, IE_VHT_CAP);
+	ext_ie = wifi_ie_index_find(&idx, IE_EXT_CAP);
+	rrm_ie = wifi_ie_index_find(&idx, IE_RRM);
+	ft_ie = wifi_ie_index_find(&idx, IE_MDE);
 
-			ht_ie = wifi_find_ie(ie_start, 512, IE_HT_CAP);
-			vht_ie = wifi_find_ie(ie_start, 512, IE_VHT_CAP);
-			ext_ie = wifi_find_ie(ie_start, 512, IE_EXT_CAP);
-			rrm_ie = wifi_find_ie(ie_start, 512, IE_RRM);
-			ft_ie = wifi_find_ie(ie_start, 512, IE_MDE);
+	if (ext_ie) {
+		info->caps.valid |= WIFI_CAP_EXT_VALID;
+		wifi_cap_set_from_ie(info->cbitmap, ext_ie, ext_ie[1] + 2);
+		/////////////////////////////////
+		{
+			int _x;
 
-			if (ext_ie) {
-				info->caps.valid |= WIFI_CAP_EXT_VALID;
-				wifi_cap_set_from_ie(info->cbitmap, ext_ie, ext_ie[1] + 2);
-				/////////////////////////////////
-				{
-					int _x;
+			libwifi_dbg("Extended IE:  [");
+			for (_x = 0; _x < ext_ie[1] + 2; _x++)
+				libwifi_dbg("%02X ", ext_ie[_x]);
+			libwifi_dbg("]\n");
+		}
+		////////////////////////////////
 
-					libwifi_dbg("Extended IE:  [");
-					for (_x = 0; _x < ext_ie[1] + 2; _x++)
-						libwifi_dbg("%02X ", ext_ie[_x]);
-					libwifi_dbg("]\n");
-				}
-				////////////////////////////////
+	}
 
-			}
+	if (rrm_ie) {
+		info->caps.valid |= WIFI_CAP_RM_VALID;
+		wifi_cap_set_from_ie(info->cbitmap, rrm_ie, rrm_ie[1] + 2);
 
-			if (rrm_ie) {
-				info->caps.valid |= WIFI_CAP_RM_VALID;
-				wifi_cap_set_from_ie(info->cbitmap, rrm_ie, rrm_ie[1] + 2);
+		/////////////////////////////////
+		{
+			int _x;
 
-				/////////////////////////////////
-				{
-					int _x;
+			libwifi_dbg("RRM IE:  [");
+			for (_x = 0; _x < rrm_ie[1] + 2; _x++)
+				libwifi_dbg("%02X ", rrm_ie[_x]);
+			libwifi_dbg("]\n");
+		}
+		////////////////////////////////
+	}
 
-					libwifi_dbg("RRM IE:  [");
-					for (_x = 0; _x < rrm_ie[1] + 2; _x++)
-						libwifi_dbg("%02X ", rrm_ie[_x]);
-					libwifi_dbg("]\n");
-				}
-				////////////////////////////////
-			}
+	if (ft_ie) {
+		wifi_cap_set_from_ie(info->cbitmap, ft_ie, ft_ie[1] + 2);
+	}
 
-			if (ft_ie) {
-				wifi_cap_set_from_ie(info->cbitmap, ft_ie, ft_ie[1] + 2);
-			}
+	if (ht_ie) {
+		info->caps.valid |= WIFI_CAP_HT_VALID;
+		//phy_mode = 1;	// ht
+		bw = 40;
 
-			if (ht_ie) {
-				info->caps.valid |= WIFI_CAP_HT_VALID;
-				//phy_mode = 1;	// ht
-				bw = 40;
-
-				wifi_cap_set_from_ie(info->cbitmap, ht_ie, ht_ie[1] + 2);
-
-				if (wifi_cap_isset(info->cbitmap, WIFI_CAP_SGI20) ||
-					wifi_cap_isset(info->cbitmap, WIFI_CAP_SGI40))
-					sgi = 1;
-
-				/////////////////////////////////
-				{
-					int _x;
-
-					libwifi_dbg("HT IE:  [");
-					for (_x = 0; _x < ht_ie[1] + 2; _x++)
-						libwifi_dbg("%02X ", ht_ie[_x]);
-					libwifi_dbg("]\n");
-				}
-				////////////////////////////////
-
-				ht_ie += 2; /* ie + ielen */
-				supp_mcs = ht_ie += 3; /* supported mcs */
-				octet = 0;
-				for (l = 0; l < 76; l++) {
-					if (l && !(l % 8))
-						octet++;
-
-					if (!!(supp_mcs[octet] & bit(l % 8)))
-						max_mcs++;
-				}
-				nss = (max_mcs / 8) + 1;
-				max_mcs %= 8;
-			}
-			if (vht_ie) {
-				//phy_mode = 2;	// vht
-				bw = 80;
-				info->caps.valid |= WIFI_CAP_VHT_VALID;
-
-				wifi_cap_set_from_ie(info->cbitmap, vht_ie, vht_ie[1] + 2);
-
-				if (wifi_cap_isset(info->cbitmap, WIFI_CAP_SGI80) ||
-					wifi_cap_isset(info->cbitmap, WIFI_CAP_SGI160))
-					sgi = 1;
-
-
-				/////////////////////////////////
-				{
-					int _x;
-
-					libwifi_dbg("VHT IE:  [");
-					for (_x = 0; _x < vht_ie[1] + 2; _x++)
-						libwifi_dbg("%02X ", vht_ie[_x]);
-					libwifi_dbg("]\n");
-				}
-				////////////////////////////////
-
-				vht_ie += 2; /* ie + ielen */
-				supp_mcs = vht_ie += 4;  /* supported msc & nss */
-				nss = 0;
-				octet = 0;
-				max_mcs = -1;
-				for (l = 0; l < 16; l += 2) {
-					uint8_t supp_mcs_mask = 0;
-
-					if (l && !(l % 8))
-						octet++;
-
-					supp_mcs_mask = supp_mcs[octet] & (0x3 << (l % 8));
-					supp_mcs_mask >>= (l % 8);
-					if (supp_mcs_mask == 3)
-						break;
-
-					nss++;
-					if (supp_mcs_mask == 0)
-						max_mcs = 7;
-					else if (supp_mcs_mask == 1)
-						max_mcs = 8;
-					else if (supp_mcs_mask == 2)
-						max_mcs = 9;
-				}
-			}
-			info->maxrate = (ht_ie || vht_ie) ?
-					wifi_mcs2rate(max_mcs, bw, nss, sgi ? WIFI_SGI : WIFI_LGI)
-					: 54;   /* TODO: 11b-only rate */
-#undef bit
+		wifi_cap_set_from_ie(info->cbitmap, ht_ie, ht_ie[1] + 2);
+
+		if (wifi_cap_isset(info->cbitmap, WIFI_CAP_SGI20) ||
+			wifi_cap_isset(info->cbitmap, WIFI_CAP_SGI40))
+			sgi = 1;
+
+		/////////////////////////////////
+		{
+			int _x;
+
+			libwifi_dbg("HT IE:  [");
+			for (_x = 0; _x < ht_ie[1] + 2; _x++)
+				libwifi_dbg("%02X ", ht_ie[_x]);
+			libwifi_dbg("]\n");
+		}
+		////////////////////////////////
+
+		ht_ie += 2; /* ie + ielen */
+		supp_mcs = ht_ie += 3; /* supported mcs */
+		octet = 0;
+		for (l = 0; l < 76; l++) {
+			if (l && !(l % 8))
+				octet++;
+
+			if (!!(supp_mcs[octet] & bit(l % 8)))
+				max_mcs++;
 		}
+		nss = (max_mcs / 8) + 1;
+		max_mcs %= 8;
 	}
+	if (vht_ie) {
+		//phy_mode = 2;	// vht
+		bw = 80;
+		info->caps.valid |= WIFI_CAP_VHT_VALID;
+
+		wifi_cap_set_from_ie(info->cbitmap, vht_ie, vht_ie[1] + 2);
+
+		if (wifi_cap_isset(info->cbitmap, WIFI_CAP_SGI80) ||
+			wifi_cap_isset(info->cbitmap, WIFI_CAP_SGI160))
+			sgi = 1;
+
+
+		/////////////////////////////////
+		{
+			int _x;
+
+			libwifi_dbg("VHT IE:  [");
+			for (_x = 0; _x < vht_ie[1] + 2; _x++)
+				libwifi_dbg("%02X ", vht_ie[_x]);
+			libwifi_dbg("]\n");
+		}
+		////////////////////////////////
+
+		vht_ie += 2; /* ie + ielen */
+		supp_mcs = vht_ie += 4;  /* supported msc & nss */
+		nss = 0;
+		octet = 0;
+		max_mcs = -1;
+		for (l = 0; l < 16; l += 2) {
+			uint8_t supp_mcs_mask = 0;
+
+			if (l && !(l % 8))
+				octet++;
+
+			supp_mcs_mask = supp_mcs[octet] & (0x3 << (l % 8));
+			supp_mcs_mask >>= (l % 8);
+			if (supp_mcs_mask == 3)
+				break;
+
+			nss++;
+			if (supp_mcs_mask == 0)
+				max_mcs = 7;
+			else if (supp_mcs_mask == 1)
+				max_mcs = 8;
+			else if (supp_mcs_mask == 2)
+				max_mcs = 9;
+		}
+	}
+	info->maxrate = (ht_ie || vht_ie) ?
+			wifi_mcs2rate(max_mcs, bw, nss, sgi ? WIFI_SGI : WIFI_LGI)
+			: 54;   /* TODO: 11b-only rate */
+#undef bit
+
+	return 0;
+}
+
+static void intel_get_last_assoc_req(const char *ifname, uint8_t *addr,
+				     char *sbuf, int sbuflen)
+{
+	chrCmd(sbuf, sbuflen,
+		"hostapd_cli -i %s get_last_assoc_req " MACFMT " | cut -d'=' -f2",
+		ifname, MAC2STR(addr));
+}
+
+
+/* Get the capabilities of a sta from its (re)assoc request frame. The frame
+ * is fetched from hostapd and parsed only once per association; 'ssid' is
+ * read on first use.
+ */
+static void intel_get_sta_caps(const char *ifname, char *ssid,
+			       struct wifi_sta *sta)
+{
+	uint64_t now = time_monotonic_msecs();
+	char sbuf[512] = {0};
+	struct wifi_sta t;
+
+	if (!wifi_sta_caps_get(ifname, sta, now))
+		return;
+
+	if (ssid[0] == '\0')
+		nlwifi_get_ssid(ifname, ssid);
+
+	memset(&t, 0, sizeof(t));
+	intel_get_last_assoc_req(ifname, sta->macaddr, sbuf, sizeof(sbuf));
+	if (intel_sta_caps_from_assoc_req(ssid, sta->macaddr, sbuf,
+					  sizeof(sbuf), &t))
+		return;
+
+	wifi_sta_caps_put(ifname, sta->macaddr, sta->conn_time, &t, now);
+	wifi_sta_caps_get(ifname, sta, now);
+}
+
+static int intel_get_sta_info_mask(const char *ifname, uint8_t *addr,
+				   uint32_t mask, struct wifi_sta *info)
+{
+	char sbuf[512] = {0};
+	char ssid[33] = {0};
+	mtlk_sta_info_t s;
+	int slen = 0;
+	int ret = 0;
+
+	if (!addr) {
+		libwifi_err("Invalid args!\n");
+		return -EINVAL;
+	}
+
+	nlwifi_get_sta_info(ifname, addr, info);
+
+	if (mask & (WIFI_STA_F_RSSI | WIFI_STA_F_RATE | WIFI_STA_F_STATS)) {
+		ret = nlwifi_vendor_cmd(ifname, OUI_LTQ,
+				LTQ_NL80211_VENDOR_SUBCMD_GET_STA_MEASUREMENTS,
+				addr, 6, (uint8_t *)&s, &slen);
+
+		if (!ret && slen == sizeof(mtlk_sta_info_t))
+			intel_sta_update_measurements(info, &s);
+	}
+
+	/* Wait.. we don't have the sta capabilities yet!
+	 * Parse the (re)assoc request frame last received by hostapd and try
+	 * to get capabilities of this sta.
+	 */
+	memcpy(info->macaddr, addr, 6);
+	if (mask & WIFI_STA_F_CAPS)
+		intel_get_sta_caps(ifname, ssid, info);
+
+	if (!(mask & WIFI_STA_F_AIRTIME))
+		return ret;
 
 	/* .... and the airtime m|n,
 	 * This could have been part of the mtlk_sta_info_t
@@ -314,16 +663,126 @@ int intel_get_sta_info(const char *ifname, uint8_t *addr, struct wifi_sta *info)
 	return ret;
 }
 
+int intel_get_sta_info(const char *ifname, uint8_t *addr, struct wifi_sta *info)
+{
+	return intel_get_sta_info_mask(ifname, addr, WIFI_STA_F_ALL, info);
+}
+
+/* Read the airtime of all stas in one pass of the PeerFlowStatus proc entry */
+static void intel_get_stas_airtime(const char *ifname, struct wifi_sta *stas,
+				   int num)
+{
+	char (*macstr)[18];
+	char path[128];
+	char line[256];
+	int cur = -1;
+	int after = 0;
+	FILE *f;
+	int i;
+
+	snprintf(path, sizeof(path), "/proc/net/mtlk/%s/PeerFlowStatus", ifname);
+	f = fopen(path, "r");
+	if (!f)
+		return;
+
+	macstr = calloc(num, sizeof(*macstr));
+	if (!macstr) {
+		fclose(f);
+		return;
+	}
+
+	for (i = 0; i < num; i++)
+		hwaddr_ntoa(stas[i].macaddr, macstr[i]);
+
+	while (fgets(line, sizeof(line), f)) {
+		for (i = 0; i < num; i++) {
+			if (strcasestr(line, macstr[i]))
+				break;
+		}
+
+		if (i < num) {
+			cur = i;
+			after = 0;
+			continue;
+		}
+
+		if (cur < 0 || ++after > 10)
+			continue;
+
+		if (strstr(line, "Air Time Used by RX/TX to/from STA")) {
+			stas[cur].airtime = atoi(line);
+			cur = -1;
+		}
+	}
+
+	free(macstr);
+	fclose(f);
+}
+
+/* Get info of all stas with one station dump and one pipelined batch of
+ * vendor cmds, instead of a round of commands per sta.
+ */
+static int intel_get_stas_info(const char *ifname, struct wifi_sta *stas,
+			       int *num)
+{
+	struct nlwifi_vendor_req *req;
+	char ssid[33] = {0};
+	mtlk_sta_info_t *s;
+	int n = *num;
+	int ret;
+	int i;
+
+	ret = nlwifi_get_stations(ifname, stas, &n);
+	if (ret)
+		return ret;
+
+	*num = n;
+	if (!n)
+		return 0;
+
+	req = calloc(n, sizeof(*req));
+	s = calloc(n, sizeof(*s));
+	if (!req || !s) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	for (i = 0; i < n; i++) {
+		req[i].subcmd = LTQ_NL80211_VENDOR_SUBCMD_GET_STA_MEASUREMENTS;
+		req[i].in = stas[i].macaddr;
+		req[i].ilen = 6;
+		req[i].out = (uint8_t *)&s[i];
+		req[i].osize = sizeof(mtlk_sta_info_t);
+	}
+
+	nlwifi_vendor_cmd_batch(ifname, OUI_LTQ, req, n);
+
+	for (i = 0; i < n; i++) {
+		if (!req[i].status && req[i].olen == sizeof(mtlk_sta_info_t))
+			intel_sta_update_measurements(&stas[i], &s[i]);
+	}
+
+	for (i = 0; i < n; i++)
+		intel_get_sta_caps(ifname, ssid, &stas[i]);
+
+	intel_get_stas_airtime(ifname, stas, n);
+
+out:
+	free(req);
+	free(s);
+	return ret;
+}
+
 static int intel_get_noise(const char *ifname, int *noise)
 {
 	mtlk_radio_info_t r;
-	int rlen = 0;
+	int rlen = sizeof(r);
 	int ret;
 
 	*noise = 0;
-	ret = nlwifi_vendor_cmd(ifname, OUI_LTQ,
+	ret = intel_vendor_cmd_cached(ifname,
 			LTQ_NL80211_VENDOR_SUBCMD_GET_RADIO_INFO,
-			NULL, 0, (uint8_t *)&r, &rlen);
+			(uint8_t *)&r, &rlen);
 
 	if (!ret && rlen == sizeof(mtlk_radio_info_t))
 		*noise = r.hw_stats.Noise;
@@ -334,13 +793,13 @@ static int intel_get_noise(const char *ifname, int *noise)
 static int intel_get_bandwidth(const char *ifname, enum wifi_bw *bw)
 {
 	mtlk_radio_info_t r;
-	int rlen = 0;
+	int rlen = sizeof(r);
 	int ret;
 
 	*bw = BW20;
-	ret = nlwifi_vendor_cmd(ifname, OUI_LTQ,
+	ret = intel_vendor_cmd_cached(ifname,
 			LTQ_NL80211_VENDOR_SUBCMD_GET_RADIO_INFO,
-			NULL, 0, (uint8_t *)&r, &rlen);
+			(uint8_t *)&r, &rlen);
 
 	if (!ret && rlen == sizeof(mtlk_radio_info_t)) {
 		if (r.width == 160)
@@ -374,12 +833,12 @@ int intel_radio_get_stats(const char *ifname, struct wifi_radio_stats *s)
 {
 	struct mtlk_radio_info info;
 	struct mtlk_wssa_drv_tr181_hw_stats *st;
-	int ilen = 0;
+	int ilen = sizeof(info);
 	int ret;
 
-	ret = nlwifi_vendor_cmd(ifname, OUI_LTQ,
+	ret = intel_vendor_cmd_cached(ifname,
 			LTQ_NL80211_VENDOR_SUBCMD_GET_RADIO_INFO,
-			NULL, 0, (uint8_t *)&info, &ilen);
+			(uint8_t *)&info, &ilen);
 
 	if (!ret && ilen == sizeof(struct mtlk_radio_info)) {
 		st = &info.hw_stats;
@@ -406,12 +865,12 @@ int intel_ap_get_stats(const char *ifname, struct wifi_ap_stats *s)
 {
 	struct mtlk_vap_info info;
 	struct mtlk_wssa_drv_tr181_vap_stats *st;
-	int ilen = 0;
+	int ilen = sizeof(info);
 	int ret;
 
-	ret = nlwifi_vendor_cmd(ifname, OUI_LTQ,
+	ret = intel_vendor_cmd_cached(ifname,
 			LTQ_NL80211_VENDOR_SUBCMD_GET_VAP_MEASUREMENTS,
-			NULL, 0, (uint8_t *)&info, &ilen);
+			(uint8_t *)&info, &ilen);
 
 	if (!ret && ilen == sizeof(struct mtlk_vap_info)) {
 		st = &info.vap_stats;
@@ -483,23 +942,25 @@ static int intel_get_ap_info(const char *ifname, struct wifi_ap *ap)
 		}
 	}
 
-	ret = nlwifi_vendor_cmd(ifname, OUI_LTQ,
+	ret = intel_vendor_cmd_cached(ifname,
 		LTQ_NL80211_VENDOR_SUBCMD_GET_AP_CAPABILITIES_MAX_STAs,
-		NULL, 0, (uint8_t *)&s, &slen);
+		(uint8_t *)&s, &slen);
 	if (!ret)
 		ap->assoclist_max = s;
 
 	s = 0;
-	ret = nlwifi_vendor_cmd(ifname, OUI_LTQ,
+	slen = sizeof(s);
+	ret = intel_vendor_cmd_cached(ifname,
 		LTQ_NL80211_VENDOR_SUBCMD_GET_HIDDEN_SSID,
-		NULL, 0, (uint8_t *)&s, &slen);
+		(uint8_t *)&s, &slen);
 	if (!ret)
 		ap->ssid_advertised = (s == 0) ? true : false;
 
 	s = 0;
-	ret = nlwifi_vendor_cmd(ifname, OUI_LTQ,
+	slen = sizeof(s);
+	ret = intel_vendor_cmd_cached(ifname,
 		LTQ_NL80211_VENDOR_SUBCMD_GET_AP_FORWARDING,
-		NULL, 0, (uint8_t *)&s, &slen);
+		(uint8_t *)&s, &slen);
 	if (!ret)
 		ap->isolate_enabled = (s == 1) ? false : true;
 
@@ -533,9 +994,9 @@ static int intel_radio_get_param(const char *name, const char *param,
 		int s = 0;
 		int slen = 4;
 
-		ret = nlwifi_vendor_cmd(name, OUI_LTQ,
+		ret = intel_vendor_cmd_cached(name,
 				LTQ_NL80211_VENDOR_SUBCMD_GET_TEMPERATURE_SENSOR,
-				NULL, 0, (uint8_t *)&s, &slen);
+				(uint8_t *)&s, &slen);
 		if (ret)
 			return -1;
 		*((int *)val) = s;
@@ -546,15 +1007,33 @@ static int intel_radio_get_param(const char *name, const char *param,
 	return 0;
 }
 
+static int intel_radio_set_param(const char *name, const char *param,
+						int len, void *val)
+{
+	if (!param || param[0] == '\0')
+		return -EINVAL;
+
+	/* vendor cache ttl in msecs; 0 disables the cache */
+	if (strncmp(param, "vendor_cache_ttl", strlen(param)) == 0) {
+		if (len < 1 || *((int *)val) < 0)
+			return -EINVAL;
+
+		intel_vcache_ttl = *((int *)val);
+		return 0;
+	}
+
+	return -ENOTSUP;
+}
+
 static int intel_get_oper_stds(const char *name, uint8_t *std)
 {
 	int ret = 0;
 	int s = 0;
 	int slen = 4;
 
-	ret = nlwifi_vendor_cmd(name, OUI_LTQ,
+	ret = intel_vendor_cmd_cached(name,
 			LTQ_NL80211_VENDOR_SUBCMD_GET_NETWORK_MODE,
-			NULL, 0, (uint8_t *)&s, &slen);
+			(uint8_t *)&s, &slen);
 
 	if (ret || s > ARRAY_SIZE(wmode2std))
 		return -1;
@@ -568,15 +1047,15 @@ static int intel_get_maxrate(const char *ifname, unsigned long *rate)
 	uint8_t std = 0;
 	int bw = 20;
 	mtlk_radio_info_t r;
-	int rlen = 0;
+	int rlen = sizeof(r);
 	uint8_t rx_ants;
 	int max_mcs;
 	int ret;
 
 	*rate = 0;
-	ret = nlwifi_vendor_cmd(ifname, OUI_LTQ,
+	ret = intel_vendor_cmd_cached(ifname,
 			LTQ_NL80211_VENDOR_SUBCMD_GET_RADIO_INFO,
-			NULL, 0, (uint8_t *)&r, &rlen);
+			(uint8_t *)&r, &rlen);
 
 	if (!ret && rlen == sizeof(mtlk_radio_info_t))
 		bw = r.width;
@@ -612,6 +1091,11 @@ static int intel_radio_info(const char *name, struct wifi_radio *radio)
 	uint8_t std = 0;
 	int ret;
 
+	/* fetch the vendor blobs needed below and by the follow-up
+	 * stats/ap getters in one batch.
+	 */
+	intel_vendor_cache_refresh(name);
+
 	ret = nlwifi_radio_info(name, radio);
 
 	ret |= intel_get_oper_stds(name, &std);
@@ -623,9 +1107,9 @@ static int intel_radio_info(const char *name, struct wifi_radio *radio)
 		int s = 0;
 		int slen = 4;
 
-		ret = nlwifi_vendor_cmd(name, OUI_LTQ,
+		ret = intel_vendor_cmd_cached(name,
 				LTQ_NL80211_VENDOR_SUBCMD_GET_BEACON_PERIOD,
-				NULL, 0, (uint8_t *)&s, &slen);
+				(uint8_t *)&s, &slen);
 		if (!ret)
 			radio->beacon_int = s;
 	}
@@ -634,9 +1118,9 @@ static int intel_radio_info(const char *name, struct wifi_radio *radio)
 		int s = 0;
 		int slen = 4;
 
-		ret = nlwifi_vendor_cmd(name, OUI_LTQ,
+		ret = intel_vendor_cmd_cached(name,
 				LTQ_NL80211_VENDOR_SUBCMD_GET_DTIM_PERIOD,
-				NULL, 0, (uint8_t *)&s, &slen);
+				(uint8_t *)&s, &slen);
 		if (!ret)
 			radio->dtim_period = s;
 	}
@@ -1213,8 +1697,14 @@ int intel_del_vendor_ie(const char *ifname, struct vendor_iereq *req)
 
 const struct wifi_driver intel_driver = {
 	.name = "wlan",
+	.counter_bits = 32,	/* mtlk traffic stats */
 	.scan = nlwifi_scan,
 	.get_scan_results = nlwifi_get_scan_results,
+	.iterate_scan_results = nlwifi_iterate_scan_results,
+	.iterate_scan_ies = nlwifi_iterate_scan_ies,
+	.get_chan_gen = nlwifi_get_chan_gen,
+	.get_reg_rules = nlwifi_get_reg_rules,
+	.get_dfs_events = nlwifi_get_dfs_events,
 	.get_bssid = nlwifi_get_bssid,
 	.get_ssid = nlwifi_get_ssid,
 	.get_maxrate = intel_get_maxrate,
@@ -1232,10 +1722,13 @@ const struct wifi_driver intel_driver = {
 	.get_assoclist = nlwifi_get_assoclist,
 	.iface.get_security = intel_get_security,
 	.get_sta_info = intel_get_sta_info,
+	.get_sta_info_mask = intel_get_sta_info_mask,
+	.get_stas_info = intel_get_stas_info,
 	.radio.get_caps = nlwifi_radio_get_caps,
 	.get_country = nlwifi_get_country,
 	.radio.info = intel_radio_info,
 	.radio.get_param = intel_radio_get_param,
+	.radio.set_param = intel_radio_set_param,
 	.disconnect_sta = intel_disconnect_sta,
 	.monitor_sta = intel_monitor_sta,
 	.iface.start_wps = intel_start_wps,
@@ -1253,4 +1746,9 @@ const struct wifi_driver intel_driver = {
 	.iface.req_bss_transition = intel_req_bss_transition,
 	.iface.add_vendor_ie = intel_add_vendor_ie,
 	.iface.del_vendor_ie = intel_del_vendor_ie,
+	.iface.subscribe_frames = nlwifi_subscribe_frames,
+	.iface.unsubscribe_frames = nlwifi_unsubscribe_frames,
+	.iface.get_frames_fd = nlwifi_get_frames_fd,
+	.iface.get_frames = nlwifi_get_frames,
+	.iface.track_probe_req = nlwifi_track_probe_req,
 };
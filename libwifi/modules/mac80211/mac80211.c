@@ -374,6 +374,31 @@ static int radio_get_scan_results(const char *name, struct wifi_bss *bsss, int *
 	return nlwifi_get_scan_results(netdev, bsss, num);
 }
 
+static int radio_iterate_scan_results(const char *name,
+				      struct wifi_scan_filter *f,
+				      int (*cb)(struct wifi_bss *bss, void *priv),
+				      void *priv)
+{
+	char netdev[16];
+
+	nlwifi_phy_to_netdev(name, netdev, sizeof(netdev));
+	libwifi_dbg("[%s, %s] %s called\n", name, netdev, __func__);
+	return nlwifi_iterate_scan_results(netdev, f, cb, priv);
+}
+
+static int radio_iterate_scan_ies(const char *name,
+				  struct wifi_scan_filter *f,
+				  int (*cb)(struct wifi_bss *bss, uint8_t *ies,
+					    size_t ies_len, void *priv),
+				  void *priv)
+{
+	char netdev[16];
+
+	nlwifi_phy_to_netdev(name, netdev, sizeof(netdev));
+	libwifi_dbg("[%s, %s] %s called\n", name, netdev, __func__);
+	return nlwifi_iterate_scan_ies(netdev, f, cb, priv);
+}
+
 static int radio_get_bss_scan_result(const char *name, uint8_t *bssid,
 				     struct wifi_bss_detail *b)
 {
@@ -555,6 +580,42 @@ static int radio_list_iface(const char *name, struct iface_entry *iface, int *nu
 	return 0;
 }
 
+static int radio_get_wmm_stats(const char *name, struct wifi_bss_wmm_stats *bss,
+			       int *num)
+{
+	struct iface_entry iface[16] = {0};
+	int num_iface = ARRAY_SIZE(iface);
+	int count = 0;
+	int i;
+
+	libwifi_dbg("[%s] %s called\n", name, __func__);
+
+	if (WARN_ON(radio_list_iface(name, iface, &num_iface)))
+		return -1;
+
+	for (i = 0; i < num_iface; i++) {
+		struct wifi_bss_wmm_stats *e;
+
+		if (iface[i].mode != WIFI_MODE_AP)
+			continue;
+
+		if (WARN_ON(count >= *num))
+			break;
+
+		e = &bss[count];
+		memset(e, 0, sizeof(*e));
+		memcpy(e->ifname, iface[i].name, sizeof(e->ifname) - 1);
+		nlwifi_get_bssid(e->ifname, e->bssid);
+		if (nlwifi_get_ap_wmm_stats(e->ifname, e->ac))
+			continue;
+
+		count++;
+	}
+
+	*num = count;
+	return 0;
+}
+
 static int radio_channels_info(const char *name, struct chan_entry *channel, int *num)
 {
 	char cc[3] = {0};
@@ -843,9 +904,39 @@ static int iface_get_ssid(const char *ifname, char *ssid)
 
 static int iface_get_stats(const char *ifname, struct wifi_ap_stats *s)
 {
+	struct wifi_sta_stats sum = {0};
+	struct if_stats ifs = {0};
+	int ret;
+
 	libwifi_dbg("[%s] %s called\n", ifname, __func__);
 
 	memset(s, 0, sizeof(*s));
+
+	/* netdev counters come from one rtnetlink IFLA_STATS64 read */
+	ret = if_getstats(ifname, &ifs);
+	if (ret)
+		return ret;
+
+	s->tx_bytes = ifs.tx_bytes;
+	s->rx_bytes = ifs.rx_bytes;
+	s->tx_pkts = ifs.tx_packets;
+	s->rx_pkts = ifs.rx_packets;
+	s->tx_err_pkts = ifs.tx_errors;
+	s->rx_err_pkts = ifs.rx_errors;
+	s->tx_dropped_pkts = ifs.tx_dropped;
+	s->rx_dropped_pkts = ifs.rx_dropped;
+	s->rx_mcast_pkts = ifs.rx_multicast;
+
+	/* unicast, retry and failed counts are per-sta in mac80211 */
+	ret = nlwifi_get_stations_stats(ifname, &sum, NULL);
+	if (ret)
+		return ret;
+
+	s->tx_ucast_pkts = sum.tx_pkts;
+	s->rx_ucast_pkts = sum.rx_pkts;
+	s->tx_retry_pkts = sum.tx_retry_pkts;
+	s->tx_rtx_fail_pkts = sum.tx_fail_pkts;
+
 	return 0;
 }
 
@@ -865,35 +956,80 @@ static int iface_get_assoclist(const char *ifname, uint8_t *stas, int *num_stas)
 	return -1;
 }
 
-static int iface_get_sta_info(const char *ifname, uint8_t *addr, struct wifi_sta *info)
+static int iface_get_sta_info_mask(const char *ifname, uint8_t *addr,
+				   uint32_t mask, struct wifi_sta *info)
 {
-	const char *iface;
 	char ifname_wds[256] = { 0 };
+	unsigned long maxrate = 0;
+	struct wifi_sta caps;
+	uint64_t now;
 	int ret = 0;
 
-	libwifi_dbg("[%s] %s called\n", ifname, __func__);
-	if (hostapd_cli_is_wds_sta(ifname, addr, ifname_wds, sizeof(ifname_wds))) {
+	libwifi_dbg("[%s] %s called mask 0x%x\n", ifname, __func__, mask);
+
+	/* a sta on a virtual AP iface is only looked up (through hostapd)
+	 * when not found on ifname
+	 */
+	ret = nlwifi_get_station(ifname, addr, info);
+	if (ret && hostapd_cli_is_wds_sta(ifname, addr, ifname_wds,
+					  sizeof(ifname_wds))) {
 		libwifi_dbg("[%s] has virtual AP iface[%s]\n", ifname, ifname_wds);
-		iface = ifname_wds;
-	} else {
-		iface = ifname;
+		ret = nlwifi_get_station(ifname_wds, addr, info);
 	}
-	ret = nlwifi_get_sta_info(iface, addr, info);
+
+	if (ret) {
+		/* not associated (anymore) */
+		wifi_sta_caps_del(ifname, addr);
+		return ret;
+	}
+
+	if (!(mask & WIFI_STA_F_CAPS))
+		return 0;
+
+	/* capabilities are fetched from hostapd once per association */
+	now = time_monotonic_msecs();
+	if (!wifi_sta_caps_get(ifname, info, now))
+		return 0;
+
+	memset(&caps, 0, sizeof(caps));
+	ret = hostapd_cli_iface_get_sta_info(ifname, addr, &caps);
 	if (!ret) {
-		ret = hostapd_cli_iface_get_sta_info(ifname, addr, info);
+		ret = radio_get_maxrate(ifname, &maxrate);
 	}
 
 	if (!ret) {
-		ret = radio_get_maxrate(ifname, (unsigned long *) &info->maxrate);
+		caps.maxrate = (uint32_t)maxrate;
+		wifi_sta_caps_put(ifname, addr, info->conn_time, &caps, now);
+		wifi_sta_caps_get(ifname, info, now);
 	}
 
 	return ret;
 }
 
+static int iface_get_sta_info(const char *ifname, uint8_t *addr, struct wifi_sta *info)
+{
+	return iface_get_sta_info_mask(ifname, addr, WIFI_STA_F_ALL, info);
+}
+
 static int iface_get_sta_stats(const char *ifname, uint8_t *addr, struct wifi_sta_stats *s)
 {
+	char ifname_wds[256] = { 0 };
+	const char *iface = ifname;
+	struct wifi_sta info;
+	int ret;
+
 	libwifi_dbg("[%s] %s called\n", ifname, __func__);
-	return -1;
+
+	if (hostapd_cli_is_wds_sta(ifname, addr, ifname_wds, sizeof(ifname_wds)))
+		iface = ifname_wds;
+
+	memset(&info, 0, sizeof(info));
+	ret = nlwifi_get_station(iface, addr, &info);
+	if (ret)
+		return ret;
+
+	memcpy(s, &info.stats, sizeof(*s));
+	return 0;
 }
 
 static int iface_disconnect_sta(const char *ifname, uint8_t *sta, uint16_t reason)
@@ -1228,6 +1364,11 @@ const struct wifi_driver mac80211_driver = {
 	.scan = radio_scan,
 	.scan_ex = radio_scan_ex,
 	.get_scan_results = radio_get_scan_results,
+	.iterate_scan_results = radio_iterate_scan_results,
+	.iterate_scan_ies = radio_iterate_scan_ies,
+	.get_chan_gen = nlwifi_get_chan_gen,
+	.get_reg_rules = nlwifi_get_reg_rules,
+	.get_dfs_events = nlwifi_get_dfs_events,
 	.get_bss_scan_result = radio_get_bss_scan_result,
 
 	.get_noise = radio_get_noise,
@@ -1246,6 +1387,7 @@ const struct wifi_driver mac80211_driver = {
 	.del_iface = radio_del_iface,
 	.list_iface = radio_list_iface,
 	.channels_info = radio_channels_info,
+	.get_wmm_stats = radio_get_wmm_stats,
 
 	/* Interface/vif common callbacks */
 	.iface.start_wps = iface_start_wps,
@@ -1268,6 +1410,11 @@ const struct wifi_driver mac80211_driver = {
 	.vendor_cmd = iface_vendor_cmd,
 	.iface.subscribe_frame = iface_subscribe_frame,
 	.iface.unsubscribe_frame = iface_unsubscribe_frame,
+	.iface.subscribe_frames = nlwifi_subscribe_frames,
+	.iface.unsubscribe_frames = nlwifi_unsubscribe_frames,
+	.iface.get_frames_fd = nlwifi_get_frames_fd,
+	.iface.get_frames = nlwifi_get_frames,
+	.iface.track_probe_req = nlwifi_track_probe_req,
 	.set_4addr = iface_set_4addr,
 	.get_4addr = iface_get_4addr,
 	.get_4addr_parent = iface_get_4addr_parent,
@@ -1282,6 +1429,7 @@ const struct wifi_driver mac80211_driver = {
 
 	.get_assoclist = iface_get_assoclist,
 	.get_sta_info = iface_get_sta_info,
+	.get_sta_info_mask = iface_get_sta_info_mask,
 	.get_sta_stats = iface_get_sta_stats,
 	.disconnect_sta = iface_disconnect_sta,
 	.restrict_sta = iface_restrict_sta,
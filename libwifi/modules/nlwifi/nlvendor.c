@@ -0,0 +1,270 @@
+/*
+ * nlvendor.c - pipelined nl80211 vendor commands
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <net/if.h>
+#include <netlink/genl/genl.h>
+#include <netlink/genl/ctrl.h>
+
+#include "easy.h"
+#include "debug.h"
+#include "wifi.h"
+#include "wifiutils.h"
+#include "nlwifi.h"
+#include "nl80211_copy.h"
+
+/*
+ * Requests of a batch are sent back-to-back on one socket, keeping upto
+ * 'window' of them in flight. Replies are matched to their requests by
+ * the netlink sequence number, so the driver may answer in any order.
+ */
+
+struct nlvendor_batch {
+	struct nlwifi_vendor_req *req;
+	int num;
+	int pending;
+};
+
+static struct nlwifi_vendor_req *nlvendor_find_req(struct nlvendor_batch *b,
+						   uint32_t seq)
+{
+	uint32_t idx;
+	int i;
+
+	/* sequence numbers are allocated consecutively on a socket */
+	idx = seq - b->req[0].seq;
+	if (idx < (uint32_t)b->num && b->req[idx].seq == seq &&
+	    b->req[idx].status == -EINPROGRESS)
+		return &b->req[idx];
+
+	for (i = 0; i < b->num; i++) {
+		if (b->req[i].seq == seq && b->req[i].status == -EINPROGRESS)
+			return &b->req[i];
+	}
+
+	return NULL;
+}
+
+static int nlvendor_resp_handler(struct nl_msg *msg, void *arg)
+{
+	struct nlvendor_batch *b = arg;
+	struct nlmsghdr *nlh = nlmsg_hdr(msg);
+	struct genlmsghdr *gnlh = nlmsg_data(nlh);
+	struct nlattr *tb[NL80211_ATTR_MAX + 1];
+	struct nlwifi_vendor_req *r;
+	struct nlattr *nl_iter;
+	int iter = 0;
+
+	r = nlvendor_find_req(b, nlh->nlmsg_seq);
+	if (!r)
+		return NL_SKIP;
+
+	nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0),
+			genlmsg_attrlen(gnlh, 0), NULL);
+
+	if (!tb[NL80211_ATTR_VENDOR_DATA] || !r->out)
+		return NL_SKIP;
+
+	nla_for_each_nested(nl_iter, tb[NL80211_ATTR_VENDOR_DATA], iter) {
+		int len = nla_len(nl_iter);
+
+		if (r->olen + len > r->osize) {
+			libwifi_warn("vendor resp subcmd %u truncated (%d > %d)\n",
+				     r->subcmd, r->olen + len, r->osize);
+			len = r->osize - r->olen;
+		}
+
+		memcpy(r->out + r->olen, nla_data(nl_iter), (size_t)len);
+		r->olen += len;
+	}
+
+	return NL_SKIP;
+}
+
+static int nlvendor_ack_handler(struct nl_msg *msg, void *arg)
+{
+	struct nlvendor_batch *b = arg;
+	struct nlwifi_vendor_req *r;
+
+	r = nlvendor_find_req(b, nlmsg_hdr(msg)->nlmsg_seq);
+	if (r) {
+		r->status = 0;
+		b->pending--;
+	}
+
+	return NL_SKIP;
+}
+
+static int nlvendor_err_handler(struct sockaddr_nl *nla, struct nlmsgerr *err,
+				void *arg)
+{
+	struct nlvendor_batch *b = arg;
+	struct nlwifi_vendor_req *r;
+
+	r = nlvendor_find_req(b, err->msg.nlmsg_seq);
+	if (r) {
+		r->status = err->error;
+		b->pending--;
+		libwifi_dbg("vendor subcmd %u: %s\n", r->subcmd,
+			    strerror(-err->error));
+	}
+
+	return NL_SKIP;
+}
+
+static int nlvendor_no_seq_check(struct nl_msg *msg, void *arg)
+{
+	return NL_OK;
+}
+
+static int nlvendor_send(struct nl_sock *sk, int family, int ifindex,
+			 uint32_t vid, struct nlwifi_vendor_req *r)
+{
+	struct nl_msg *msg;
+	int ret = -ENOMEM;
+
+	msg = nlmsg_alloc();
+	if (!msg)
+		return ret;
+
+	genlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, family, 0, 0,
+		    NL80211_CMD_VENDOR, 0);
+
+	NLA_PUT_U32(msg, NL80211_ATTR_IFINDEX, (uint32_t)ifindex);
+	NLA_PUT_U32(msg, NL80211_ATTR_VENDOR_ID, vid);
+	NLA_PUT_U32(msg, NL80211_ATTR_VENDOR_SUBCMD, r->subcmd);
+	if (r->in)
+		NLA_PUT(msg, NL80211_ATTR_VENDOR_DATA, r->ilen, r->in);
+
+	ret = nl_send_auto(sk, msg);
+	if (ret >= 0) {
+		r->seq = nlmsg_hdr(msg)->nlmsg_seq;
+		ret = 0;
+	}
+
+nla_put_failure:
+	nlmsg_free(msg);
+	return ret < 0 ? ret : 0;
+}
+
+int nlwifi_vendor_cmd_pipeline(struct nl_sock *sk, int family, int ifindex,
+			       uint32_t vid, struct nlwifi_vendor_req *req,
+			       int num, int window)
+{
+	struct nlvendor_batch b = {
+		.req = req,
+		.num = num,
+		.pending = 0,
+	};
+	struct nl_cb *cb;
+	int sent = 0;
+	int ret = 0;
+	int i;
+
+	if (num <= 0)
+		return 0;
+
+	if (window <= 0)
+		window = 1;
+
+	for (i = 0; i < num; i++) {
+		req[i].olen = 0;
+		req[i].seq = 0;
+		req[i].status = -EAGAIN;
+	}
+
+	cb = nl_cb_alloc(NL_CB_DEFAULT);
+	if (!cb)
+		return -ENOMEM;
+
+	nl_cb_err(cb, NL_CB_CUSTOM, nlvendor_err_handler, &b);
+	nl_cb_set(cb, NL_CB_ACK, NL_CB_CUSTOM, nlvendor_ack_handler, &b);
+	nl_cb_set(cb, NL_CB_VALID, NL_CB_CUSTOM, nlvendor_resp_handler, &b);
+	nl_cb_set(cb, NL_CB_SEQ_CHECK, NL_CB_CUSTOM, nlvendor_no_seq_check, NULL);
+
+	for (;;) {
+		while (sent < num && b.pending < window) {
+			struct nlwifi_vendor_req *r = &req[sent++];
+			int err;
+
+			r->status = -EINPROGRESS;
+			err = nlvendor_send(sk, family, ifindex, vid, r);
+			if (err) {
+				r->status = err;
+				continue;
+			}
+			b.pending++;
+		}
+
+		if (!b.pending)
+			break;
+
+		ret = nl_recvmsgs(sk, cb);
+		if (ret < 0) {
+			libwifi_err("%s: %s\n", __func__, nl_geterror(ret));
+			break;
+		}
+	}
+
+	/* whatever is still outstanding is lost with the socket */
+	for (i = 0; i < num; i++) {
+		if (req[i].status == -EINPROGRESS || req[i].status == -EAGAIN)
+			req[i].status = -EIO;
+	}
+
+	nl_cb_put(cb);
+	return ret < 0 ? -EIO : 0;
+}
+
+int nlwifi_vendor_cmd_batch(const char *ifname, uint32_t vid,
+			    struct nlwifi_vendor_req *req, int num)
+{
+	struct nl_sock *sk;
+	int ifindex;
+	int family;
+	int ret = -1;
+
+	libwifi_dbg("[%s] %s called vid 0x%x num %d\n", ifname, __func__, vid, num);
+
+	ifindex = (int)if_nametoindex(ifname);
+	if (!ifindex)
+		return -errno;
+
+	sk = nl_socket_alloc();
+	if (!sk)
+		return -ENOMEM;
+
+	if (genl_connect(sk))
+		goto out;
+
+	family = genl_ctrl_resolve(sk, "nl80211");
+	if (family < 0)
+		goto out;
+
+	ret = nlwifi_vendor_cmd_pipeline(sk, family, ifindex, vid, req, num,
+					 NLWIFI_VENDOR_WINDOW);
+out:
+	nl_socket_free(sk);
+	return ret;
+}
@@ -33,6 +33,9 @@
 #include <netlink/genl/ctrl.h>
 #include <netpacket/packet.h>
 #include <dirent.h>
+#include <pthread.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 
 #include "easy.h"
 #include "debug.h"
@@ -806,129 +809,6 @@ UNUSED_FUNC static void nlwifi_parse_wpa_ie(uint8_t *iebuf, size_t len, int *nxt
 		return;
 }
 
-static int nlwifi_get_ie(uint8_t *ies, size_t len, uint8_t e, void *data)
-{
-	int offset = 0;
-	int ielen = 0;
-	uint8_t eid;
-
-	while (offset <= (len - 2)) {
-		eid = ies[offset];
-		ielen = ies[offset + 1];
-		if (eid != e) {
-			offset += ielen + 2;
-			continue;
-		}
-
-		switch (eid) {
-		case IE_BSS_LOAD:
-			if (ielen > sizeof(struct wifi_ap_load))
-				return -1;
-			break;
-		case IE_EXT_CAP:
-			if (ielen > sizeof(struct wifi_caps_ext))
-				return -1;
-			break;
-		case IE_HT_CAP:
-			if (ielen > sizeof(struct wifi_caps_ht))
-				return -1;
-			break;
-		case IE_VHT_CAP:
-			if (ielen > sizeof(struct wifi_caps_vht))
-				return -1;
-			break;
-		case IE_RRM:
-			if (ielen > sizeof(struct wifi_caps_rm))
-				return -1;
-			break;
-		default:
-			break;
-		}
-
-		memcpy((uint8_t *)data, &ies[offset + 2], ielen);
-		return 0;
-	}
-
-	return -ENOENT;
-}
-
-static int nlwifi_get_bandwidth_from_ie(uint8_t *ies, size_t len,
-						enum wifi_bw *bw)
-{
-	int offset = 0;
-	int ielen = 0;
-	uint8_t *p = NULL;
-	int cntr = 0;
-
-#ifndef bit
-#define bit(n)	(1 << (n))
-#endif
-
-	while (offset <= (len - 2)) {
-		ielen = ies[offset + 1];
-		p = &ies[offset + 2];
-
-		switch (ies[offset]) {
-		case 61:   /* HT oper */
-			{
-				uint8_t *ht_op;
-				uint8_t off = 0;
-
-				if (ielen != 22)
-					return -1;
-
-				ht_op = p + 1;
-				off = ht_op[0] & 0x3;
-
-				if (off == 0)
-					*bw = BW20;
-				else if (off == 1 || off == 3)
-					*bw = BW40;
-
-				if ((ht_op[0] & bit(2)) == 0)
-					*bw = BW20;
-				cntr++;
-			}
-			break;
-		case 192:  /* VHT oper */
-			{
-				uint8_t *vht_op;
-				uint8_t w, cfs0, cfs1;
-
-				if (ielen < 5)
-					return -1;
-
-				vht_op = p;
-				w = vht_op[0];
-				cfs0 = vht_op[1];
-				cfs1 = vht_op[2];
-
-				if (w == 0)
-					break;
-
-				if (cfs1 == 0) {
-					*bw = BW80;
-				} else {
-					if (cfs1 - cfs0 == 8)
-						*bw = BW160;
-					else if (cfs1 - cfs0 == 16)
-						*bw = BW8080;
-				}
-				cntr++;
-			}
-			break;
-		default:
-			break;
-		}
-
-		if (cntr == 2)
-			break;
-
-		offset += ies[offset + 1] + 2;
-	}
-	return 0;
-}
-
 static int nlwifi_get_iface_cb(struct nl_msg *msg, void *data)
 {
 	struct nlattr *tb[NL80211_ATTR_MAX + 1];
@@ -2068,6 +1948,7 @@ static int nlwifi_get_station_cb(struct nl_msg *msg, void *data)
 		[NL80211_STA_INFO_CONNECTED_TIME] = { .type = NLA_U32},
 		[NL80211_STA_INFO_RX_DURATION] = { .type = NLA_U64 },
 		[NL80211_STA_INFO_TX_DURATION] = { .type = NLA_U64 },
+		[NL80211_STA_INFO_AIRTIME_WEIGHT] = { .type = NLA_U16 },
 		[NL80211_STA_INFO_STA_FLAGS] =
 			{ .minlen = sizeof(struct nl80211_sta_flag_update) },
 		[NL80211_STA_INFO_RX_BYTES64] = { .type = NLA_U64 },
@@ -2115,15 +1996,19 @@ static int nlwifi_get_station_cb(struct nl_msg *msg, void *data)
 		nlwifi_bitrate_attrs(s[NL80211_STA_INFO_RX_BITRATE], &sta->rx_rate);
 
 	if (s[NL80211_STA_INFO_RX_DURATION])
-		sta->rx_airtime =
-			nla_get_u32(s[NL80211_STA_INFO_RX_DURATION]);
+		sta->rx_duration =
+			nla_get_u64(s[NL80211_STA_INFO_RX_DURATION]);
 
 	if (s[NL80211_STA_INFO_TX_BITRATE])
 		nlwifi_bitrate_attrs(s[NL80211_STA_INFO_TX_BITRATE], &sta->tx_rate);
 
 	if (s[NL80211_STA_INFO_TX_DURATION])
-		sta->tx_airtime =
-			nla_get_u32(s[NL80211_STA_INFO_TX_DURATION]);
+		sta->tx_duration =
+			nla_get_u64(s[NL80211_STA_INFO_TX_DURATION]);
+
+	if (s[NL80211_STA_INFO_AIRTIME_WEIGHT])
+		sta->airtime_weight =
+			nla_get_u16(s[NL80211_STA_INFO_AIRTIME_WEIGHT]);
 
 	if (s[NL80211_STA_INFO_RX_BYTES64]) {
 		sta->stats.rx_bytes =
@@ -2254,6 +2139,181 @@ int nlwifi_get_sta_info(const char *ifname, uint8_t *addr, struct wifi_sta *info
 	return nlwifi_cmd(ifname, &ctx);
 }
 
+/* Get info of one station with a unicast NL80211_CMD_GET_STATION */
+int nlwifi_get_station(const char *ifname, uint8_t *addr, struct wifi_sta *info)
+{
+	struct stainfo {
+		const char *vif;
+		const uint8_t *macaddr;
+		struct wifi_sta *s;
+	} sta = {
+		.vif = ifname,
+		.macaddr = addr,
+		.s = info,
+	};
+	struct nl_sock *nl;
+	struct nl_msg *msg;
+	uint32_t devidx;
+	int ret = -1;
+
+	libwifi_dbg("[%s] %s called " MACFMT "\n", ifname, __func__, MAC2STR(addr));
+
+	devidx = if_nametoindex(ifname);
+	if (!devidx)
+		return -errno;
+
+	nl = nlwifi_socket();
+	if (!nl)
+		return -1;
+
+	msg = nlwifi_alloc_msg(nl, NL80211_CMD_GET_STATION, 0, 0);
+	if (!msg)
+		goto out_msg_failure;
+
+	NLA_PUT_U32(msg, NL80211_ATTR_IFINDEX, devidx);
+	NLA_PUT(msg, NL80211_ATTR_MAC, 6, addr);
+
+	ret = nlwifi_send_msg(nl, msg, nlwifi_get_station_cb, &sta);
+
+nla_put_failure:
+	nlmsg_free(msg);
+out_msg_failure:
+	nl_socket_free(nl);
+	return ret;
+}
+
+struct stations_stats {
+	const char *vif;
+	int num;
+	struct wifi_sta_stats *sum;
+};
+
+static int nlwifi_get_stations_stats_cb(struct nl_msg *msg, void *data)
+{
+	struct stations_stats *st = data;
+	struct wifi_sta_stats *sum = st->sum;
+	struct wifi_sta s;
+	struct stainfo {
+		const char *vif;
+		const uint8_t *macaddr;
+		struct wifi_sta *s;
+	} sta = {
+		.vif = st->vif,
+		.macaddr = NULL,
+		.s = &s,
+	};
+	static const uint8_t zero_mac[6] = {0};
+
+	memset(&s, 0, sizeof(s));
+	nlwifi_get_station_cb(msg, &sta);
+	if (!memcmp(s.macaddr, zero_mac, 6))
+		return NL_SKIP;
+
+	sum->tx_bytes += s.stats.tx_bytes;
+	sum->rx_bytes += s.stats.rx_bytes;
+	sum->tx_pkts += s.stats.tx_pkts;
+	sum->rx_pkts += s.stats.rx_pkts;
+	sum->tx_retry_pkts += s.stats.tx_retry_pkts;
+	sum->tx_fail_pkts += s.stats.tx_fail_pkts;
+	sum->rx_fail_pkts += s.stats.rx_fail_pkts;
+	st->num++;
+
+	return NL_SKIP;
+}
+
+/* Sum up the stats of all stations of the interface from one station dump */
+int nlwifi_get_stations_stats(const char *ifname, struct wifi_sta_stats *sum,
+			      int *num)
+{
+	struct stations_stats st = {
+		.vif = ifname,
+		.num = 0,
+		.sum = sum,
+	};
+	struct nlwifi_ctx ctx = {
+		.cmd = NL80211_CMD_GET_STATION,
+		.flags = NLM_F_DUMP,
+		.cb = nlwifi_get_stations_stats_cb,
+		.data = &st,
+	};
+	int ret;
+
+	libwifi_dbg("[%s] %s called\n", ifname, __func__);
+
+	memset(sum, 0, sizeof(*sum));
+	ret = nlwifi_cmd(ifname, &ctx);
+	if (ret)
+		return ret;
+
+	if (num)
+		*num = st.num;
+
+	return 0;
+}
+
+struct stations {
+	const char *vif;
+	int i;
+	int nr;
+	struct wifi_sta *stas;
+};
+
+static int nlwifi_get_stations_cb(struct nl_msg *msg, void *data)
+{
+	struct stations *list = data;
+	struct stainfo {
+		const char *vif;
+		const uint8_t *macaddr;
+		struct wifi_sta *s;
+	} sta = {
+		.vif = list->vif,
+		.macaddr = NULL,
+	};
+	static const uint8_t zero_mac[6] = {0};
+
+	if (list->i >= list->nr) {
+		libwifi_warn("Num stations > %d !\n", list->nr);
+		return NL_SKIP;
+	}
+
+	sta.s = &list->stas[list->i];
+	memset(sta.s, 0, sizeof(*sta.s));
+	nlwifi_get_station_cb(msg, &sta);
+
+	/* entry was filled only if the station belongs to our interface */
+	if (memcmp(sta.s->macaddr, zero_mac, 6))
+		list->i++;
+
+	return NL_SKIP;
+}
+
+/* Get info of all stations of the interface from a single station dump */
+int nlwifi_get_stations(const char *ifname, struct wifi_sta *stas, int *num)
+{
+	struct stations list = {
+		.vif = ifname,
+		.i = 0,
+		.nr = *num,
+		.stas = stas,
+	};
+	struct nlwifi_ctx ctx = {
+		.cmd = NL80211_CMD_GET_STATION,
+		.flags = NLM_F_DUMP,
+		.cb = nlwifi_get_stations_cb,
+		.data = &list,
+	};
+	int ret;
+
+	libwifi_dbg("[%s] %s called\n", ifname, __func__);
+
+	ret = nlwifi_cmd(ifname, &ctx);
+	if (ret)
+		return ret;
+
+	*num = list.i;
+	return 0;
+}
+
 int nlwifi_sta_get_stats(const char *ifname, struct wifi_sta_stats *stats)
 {
 	int ret;
@@ -2287,7 +2347,120 @@ int nlwifi_sta_get_stats(const char *ifname, struct wifi_sta_stats *stats)
 	return 0;
 }
 
-static int nlwifi_get_scan_results_cb(struct nl_msg *msg, void *sres)
+/* 802.1D user priority (TID) to WMM access category */
+static const enum wmm_ac_type nlwifi_tid_to_ac[] = {
+	BE, BK, BK, BE, VI, VI, VO, VO
+};
+
+struct nlwifi_wmm_stats {
+	const char *vif;
+	struct wifi_ap_wmm_ac_stats *ac;
+};
+
+static void nlwifi_tid_stats_attrs(struct nlattr *attr,
+				   struct wifi_ap_wmm_ac_stats *ac)
+{
+	struct nlattr *t[NL80211_TID_STATS_MAX + 1];
+	static struct nla_policy tid_policy[NL80211_TID_STATS_MAX + 1] = {
+		[NL80211_TID_STATS_RX_MSDU] = { .type = NLA_U64 },
+		[NL80211_TID_STATS_TX_MSDU] = { .type = NLA_U64 },
+		[NL80211_TID_STATS_TX_MSDU_RETRIES] = { .type = NLA_U64 },
+		[NL80211_TID_STATS_TX_MSDU_FAILED] = { .type = NLA_U64 },
+	};
+	struct nlattr *tid_attr;
+	int rem;
+
+	nla_for_each_nested(tid_attr, attr, rem) {
+		struct wifi_ap_wmm_ac_stats *a;
+		int tid = nla_type(tid_attr) - 1;
+
+		if (nla_parse_nested(t, NL80211_TID_STATS_MAX, tid_attr,
+				     tid_policy))
+			continue;
+
+		/*
+		 * TIDs 8-15 (TSPEC) and the trailing non-QoS entry are
+		 * accounted as best effort.
+		 */
+		if (tid >= 0 && tid < ARRAY_SIZE(nlwifi_tid_to_ac))
+			a = &ac[nlwifi_tid_to_ac[tid]];
+		else
+			a = &ac[BE];
+
+		if (t[NL80211_TID_STATS_RX_MSDU])
+			a->rx_pkts += nla_get_u64(t[NL80211_TID_STATS_RX_MSDU]);
+		if (t[NL80211_TID_STATS_TX_MSDU])
+			a->tx_pkts += nla_get_u64(t[NL80211_TID_STATS_TX_MSDU]);
+		if (t[NL80211_TID_STATS_TX_MSDU_RETRIES])
+			a->tx_rtx_pkts += nla_get_u64(t[NL80211_TID_STATS_TX_MSDU_RETRIES]);
+		if (t[NL80211_TID_STATS_TX_MSDU_FAILED])
+			a->tx_err_pkts += nla_get_u64(t[NL80211_TID_STATS_TX_MSDU_FAILED]);
+	}
+}
+
+static int nlwifi_get_wmm_stats_cb(struct nl_msg *msg, void *data)
+{
+	struct nlattr *tb[NL80211_ATTR_MAX + 1];
+	struct genlmsghdr *gnlh = nlmsg_data(nlmsg_hdr(msg));
+	struct nlattr *s[NL80211_STA_INFO_MAX + 1];
+	static struct nla_policy sta_policy[NL80211_STA_INFO_MAX + 1] = {
+		[NL80211_STA_INFO_TID_STATS] = { .type = NLA_NESTED },
+	};
+	struct nlwifi_wmm_stats *req = data;
+	char ifname[16] = {0};
+
+	nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0),
+			genlmsg_attrlen(gnlh, 0), NULL);
+
+	if (!tb[NL80211_ATTR_IFINDEX] || !tb[NL80211_ATTR_STA_INFO])
+		return NL_SKIP;
+
+	if_indextoname(nla_get_u32(tb[NL80211_ATTR_IFINDEX]), ifname);
+	if (strncmp(req->vif, ifname, 15))
+		return NL_SKIP;
+
+	if (nla_parse_nested(s, NL80211_STA_INFO_MAX, tb[NL80211_ATTR_STA_INFO],
+			     sta_policy)) {
+		libwifi_warn("Error parsing NL80211_STA_INFO attrs!\n");
+		return NL_SKIP;
+	}
+
+	if (s[NL80211_STA_INFO_TID_STATS])
+		nlwifi_tid_stats_attrs(s[NL80211_STA_INFO_TID_STATS], req->ac);
+
+	return NL_SKIP;
+}
+
+/* Per-AC counters of an AP interface, summed over its associated stations */
+int nlwifi_get_ap_wmm_stats(const char *ifname, struct wifi_ap_wmm_ac_stats *ac)
+{
+	struct nlwifi_wmm_stats req = {
+		.vif = ifname,
+		.ac = ac,
+	};
+	struct nlwifi_ctx ctx = {
+		.cmd = NL80211_CMD_GET_STATION,
+		.flags = NLM_F_DUMP,
+		.cb = nlwifi_get_wmm_stats_cb,
+		.data = &req,
+	};
+
+	libwifi_dbg("[%s] %s called\n", ifname, __func__);
+
+	memset(ac, 0, WIFI_NUM_AC * sizeof(*ac));
+	return nlwifi_cmd(ifname, &ctx);
+}
+
+struct nlwifi_scan_iter {
+	struct wifi_scan_filter *f;
+	int (*cb)(struct wifi_bss *bss, void *priv);
+	int (*ies_cb)(struct wifi_bss *bss, uint8_t *ies, size_t ies_len,
+		      void *priv);
+	void *priv;
+	bool stop;
+};
+
+static int nlwifi_get_scan_results_cb(struct nl_msg *msg, void *arg)
 {
 	struct nlattr *tb[NL80211_ATTR_MAX + 1];
 	struct genlmsghdr *gnlh = nlmsg_data(nlmsg_hdr(msg));
@@ -2305,31 +2478,26 @@ static int nlwifi_get_scan_results_cb(struct nl_msg *msg, void *sres)
 		[NL80211_BSS_SEEN_MS_AGO] = { .type = NLA_U32 },
 		[NL80211_BSS_BEACON_IES] = { .type = NLA_UNSPEC },
 	};
-	struct scanresult {
-		int i;
-		int num;
-		struct wifi_bss *bsss;
-	} *scanres = sres;
-	struct wifi_bss *e = scanres->bsss + scanres->i;
+	struct nlwifi_scan_iter *it = arg;
+	struct wifi_bss bs, *e = &bs;
+	struct wifi_ie_index idx;
 	uint8_t *ssid_ie;
 	size_t ie_len;
 	uint8_t *ie;
+	int age = -1;
 	int rssi = 0;
-	int ret;
 	int i;
 
-	libwifi_dbg("sres: &bsss = %p (numbss limit = %d)\n", e, scanres->num);
+	/* drain the rest of the dump once the caller has had enough */
+	if (it->stop)
+		return NL_SKIP;
+
 	nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0),
 			genlmsg_attrlen(gnlh, 0), NULL);
 
 	if (!tb[NL80211_ATTR_BSS])
 		return NL_SKIP;  /* no bssid */
 
-	if (scanres->i >= scanres->num) {
-		libwifi_warn("Num scan results > %d !\n", scanres->num);
-		return NL_SKIP;
-	}
-
 	if (nla_parse_nested(bss, NL80211_BSS_MAX, tb[NL80211_ATTR_BSS],
 				bss_policy))
 		return NL_SKIP;
@@ -2342,11 +2510,10 @@ static int nlwifi_get_scan_results_cb(struct nl_msg *msg, void *sres)
 		ie_len = 0;
 	}
 
+	memset(e, 0, sizeof(struct wifi_bss));
 	if (bss[NL80211_BSS_BSSID]) {
 		libwifi_dbg("BSSID: " MACFMT "  ",
 			MAC2STR((uint8_t *)nla_data(bss[NL80211_BSS_BSSID])));
-		e = scanres->bsss + scanres->i;
-		memset(e, 0, sizeof(struct wifi_bss));
 		memcpy(e->bssid, nla_data(bss[NL80211_BSS_BSSID]), 6);
 	}
 
@@ -2359,6 +2526,18 @@ static int nlwifi_get_scan_results_cb(struct nl_msg *msg, void *sres)
 		e->band = ieee80211_frequency_to_band(frequency);
 	}
 
+	if (bss[NL80211_BSS_SIGNAL_MBM]) {
+		rssi = nla_get_u32(bss[NL80211_BSS_SIGNAL_MBM]);
+		rssi /= 100;	/* in dBm */
+	} else if (bss[NL80211_BSS_SIGNAL_UNSPEC]) {
+		rssi = nla_get_u8(bss[NL80211_BSS_SIGNAL_UNSPEC]);
+	}
+	e->rssi = rssi;
+	libwifi_dbg("    Rssi: %d dBm", rssi);
+
+	if (bss[NL80211_BSS_SEEN_MS_AGO])
+		age = (int)nla_get_u32(bss[NL80211_BSS_SEEN_MS_AGO]);
+
 	if (bss[NL80211_BSS_BEACON_INTERVAL]) {
 		e->beacon_int = nla_get_u16(bss[NL80211_BSS_BEACON_INTERVAL]);
 		libwifi_dbg("    Bcn Int: %d  ",
@@ -2370,16 +2549,27 @@ static int nlwifi_get_scan_results_cb(struct nl_msg *msg, void *sres)
 		e->caps.valid |= WIFI_CAP_BASIC_VALID;
 	}
 
-	if (bss[NL80211_BSS_SIGNAL_MBM]) {
-		rssi = nla_get_u32(bss[NL80211_BSS_SIGNAL_MBM]);
-		rssi /= 100;	/* in dBm */
-	} else if (bss[NL80211_BSS_SIGNAL_UNSPEC]) {
-		rssi = nla_get_u8(bss[NL80211_BSS_SIGNAL_UNSPEC]);
+	/* filter before parsing the ies, on what's got so far */
+	if (!wifi_scan_filter_match(it->f, WIFI_SCAN_FILTER_BSSID |
+				    WIFI_SCAN_FILTER_BAND |
+				    WIFI_SCAN_FILTER_CHANNEL |
+				    WIFI_SCAN_FILTER_RSSI |
+				    WIFI_SCAN_FILTER_AGE, e, age))
+		return NL_SKIP;
+
+	/* the caller parses the ies itself, unless filtering on them */
+	if (it->ies_cb && (!it->f || !(it->f->flag & (WIFI_SCAN_FILTER_SSID |
+						      WIFI_SCAN_FILTER_SECURITY)))) {
+		if (it->ies_cb(e, ie, ie_len, it->priv))
+			it->stop = true;
+
+		return NL_SKIP;
 	}
-	e->rssi = rssi;
-	libwifi_dbg("    Rssi: %d dBm", rssi);
 
-	ssid_ie = wifi_find_ie(ie, ie_len, IE_SSID);
+	/* the ies are walked once, for all got from them */
+	wifi_ie_index_build(&idx, ie, ie_len);
+
+	ssid_ie = wifi_ie_index_find(&idx, IE_SSID);
 	if (ssid_ie) {
 		libwifi_dbg("     Ssid: ");
 		for (i = 0; i < ssid_ie[1]; i++)
@@ -2388,69 +2578,106 @@ static int nlwifi_get_scan_results_cb(struct nl_msg *msg, void *sres)
 		memcpy(e->ssid, &ssid_ie[2], ssid_ie[1]);
 	}
 
-	wifi_get_bss_security_from_ies(e, ie, ie_len);
+	if (!wifi_scan_filter_match(it->f, WIFI_SCAN_FILTER_SSID, e, age))
+		return NL_SKIP;
+
+	wifi_get_bss_security_from_ie_index(e, &idx);
 	libwifi_dbg("       wpa_versions 0x%x pairwise = 0x%x, group = 0x%x akms 0x%x caps 0x%x\n",
 		    e->rsn.wpa_versions, e->rsn.pair_ciphers, e->rsn.group_cipher,
 		    e->rsn.akms, e->rsn.rsn_caps);
 
-	nlwifi_get_ie(ie, ie_len, IE_BSS_LOAD, &e->load);
-
-	ret = nlwifi_get_ie(ie, ie_len, IE_EXT_CAP, &e->caps.ext);
-	if (!ret)
-		e->caps.valid |= WIFI_CAP_EXT_VALID;
-
-	ret = nlwifi_get_ie(ie, ie_len, IE_HT_CAP, &e->caps.ht);
-	if (!ret)
-		e->caps.valid |= WIFI_CAP_HT_VALID;
-
-	ret = nlwifi_get_ie(ie, ie_len, IE_VHT_CAP, &e->caps.vht);
-	if (!ret)
-		e->caps.valid |= WIFI_CAP_VHT_VALID;
+	if (!wifi_scan_filter_match(it->f, WIFI_SCAN_FILTER_SECURITY, e, age))
+		return NL_SKIP;
 
-	ret = nlwifi_get_ie(ie, ie_len, IE_RRM, &e->caps.rrm);
-	if (!ret)
-		e->caps.valid |= WIFI_CAP_RM_VALID;
+	if (it->ies_cb) {
+		if (it->ies_cb(e, ie, ie_len, it->priv))
+			it->stop = true;
 
-	nlwifi_get_bandwidth_from_ie(ie, ie_len, &e->curr_bw);
+		return NL_SKIP;
+	}
 
-	//TODO: wifi supp standards
-	//TODO: a-only, b-only, g-only etc.
-	if (!!(e->caps.valid & WIFI_CAP_VHT_VALID))
-		e->oper_std = WIFI_N | WIFI_AC;
-	else if (!!(e->caps.valid & WIFI_CAP_HT_VALID))
-		e->oper_std = e->channel > 14 ? (WIFI_A | WIFI_N) :
-						(WIFI_B | WIFI_G | WIFI_N);
-	else
-		e->oper_std = e->channel > 14 ? WIFI_A : (WIFI_B | WIFI_G);
+	wifi_bss_caps_set_from_ie_index(e, &idx);
 
-	scanres->i += 1;
+	if (it->cb(e, it->priv))
+		it->stop = true;
 
 	return NL_SKIP;
 }
 
-int nlwifi_get_scan_results(const char *ifname, struct wifi_bss *bsss,
-						int *num)
+int nlwifi_iterate_scan_results(const char *ifname, struct wifi_scan_filter *f,
+				int (*cb)(struct wifi_bss *bss, void *priv),
+				void *priv)
 {
-	struct scanres {
-		int i;
-		int nr;
-		struct wifi_bss *bsslist;
-	} scanres = {
-		.i = 0,
-		.nr = *num,
-		.bsslist = bsss,
+	struct nlwifi_scan_iter it = {
+		.f = f,
+		.cb = cb,
+		.priv = priv,
 	};
 
 	struct nlwifi_ctx ctx = {
 		.cmd = NL80211_CMD_GET_SCAN,
 		.flags = NLM_F_DUMP,
 		.cb = nlwifi_get_scan_results_cb,
-		.data = &scanres,
+		.data = &it,
 	};
 
+	return nlwifi_cmd(ifname, &ctx);
+}
+
+int nlwifi_iterate_scan_ies(const char *ifname, struct wifi_scan_filter *f,
+			    int (*cb)(struct wifi_bss *bss, uint8_t *ies,
+				      size_t ies_len, void *priv),
+			    void *priv)
+{
+	struct nlwifi_scan_iter it = {
+		.f = f,
+		.ies_cb = cb,
+		.priv = priv,
+	};
+
+	struct nlwifi_ctx ctx = {
+		.cmd = NL80211_CMD_GET_SCAN,
+		.flags = NLM_F_DUMP,
+		.cb = nlwifi_get_scan_results_cb,
+		.data = &it,
+	};
+
+	return nlwifi_cmd(ifname, &ctx);
+}
+
+struct nlwifi_scan_results {
+	int i;
+	int num;
+	struct wifi_bss *bsss;
+};
+
+static int nlwifi_scan_results_add(struct wifi_bss *bss, void *priv)
+{
+	struct nlwifi_scan_results *scanres = priv;
+
+	if (scanres->i >= scanres->num) {
+		libwifi_warn("Num scan results > %d !\n", scanres->num);
+		return 0;
+	}
+
+	memcpy(scanres->bsss + scanres->i, bss, sizeof(*bss));
+	scanres->i += 1;
+
+	return 0;
+}
+
+int nlwifi_get_scan_results(const char *ifname, struct wifi_bss *bsss,
+						int *num)
+{
+	struct nlwifi_scan_results scanres = {
+		.i = 0,
+		.num = *num,
+		.bsss = bsss,
+	};
 	int ret;
 
-	ret = nlwifi_cmd(ifname, &ctx);
+	ret = nlwifi_iterate_scan_results(ifname, NULL, nlwifi_scan_results_add,
+					  &scanres);
 	if (ret)
 		return ret;
 
@@ -2502,6 +2729,104 @@ out:
 	return ret;
 }
 
+struct nlwifi_reg_rules {
+	char *alpha2;
+	struct wifi_reg_rule *rules;
+	int num;
+	int max;
+};
+
+static int nlwifi_get_reg_rules_cb(struct nl_msg *msg, void *data)
+{
+	struct genlmsghdr *gnlh = nlmsg_data(nlmsg_hdr(msg));
+	struct nlattr *tb_rule[NL80211_REG_RULE_ATTR_MAX + 1];
+	struct nlattr *tb[NL80211_ATTR_MAX + 1];
+	struct nlwifi_reg_rules *r = data;
+	struct wifi_reg_rule *rule;
+	struct nlattr *nl_rule;
+	uint32_t flags;
+	int rem;
+
+	nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0),
+			genlmsg_attrlen(gnlh, 0), NULL);
+
+	if (!tb[NL80211_ATTR_REG_ALPHA2] || !tb[NL80211_ATTR_REG_RULES])
+		return NL_SKIP;
+
+	memcpy(r->alpha2, nla_data(tb[NL80211_ATTR_REG_ALPHA2]), 2);
+
+	nla_for_each_nested(nl_rule, tb[NL80211_ATTR_REG_RULES], rem) {
+		nla_parse(tb_rule, NL80211_REG_RULE_ATTR_MAX,
+			  nla_data(nl_rule), nla_len(nl_rule), NULL);
+
+		if (!tb_rule[NL80211_ATTR_REG_RULE_FLAGS] ||
+		    !tb_rule[NL80211_ATTR_FREQ_RANGE_START] ||
+		    !tb_rule[NL80211_ATTR_FREQ_RANGE_END] ||
+		    !tb_rule[NL80211_ATTR_FREQ_RANGE_MAX_BW])
+			continue;
+
+		if (r->num >= r->max) {
+			libwifi_dbg("%s: more than %d rules\n", __func__, r->max);
+			break;
+		}
+
+		rule = &r->rules[r->num++];
+		memset(rule, 0, sizeof(*rule));
+		rule->start_freq = nla_get_u32(tb_rule[NL80211_ATTR_FREQ_RANGE_START]);
+		rule->end_freq = nla_get_u32(tb_rule[NL80211_ATTR_FREQ_RANGE_END]);
+		rule->max_bw = nla_get_u32(tb_rule[NL80211_ATTR_FREQ_RANGE_MAX_BW]);
+
+		if (tb_rule[NL80211_ATTR_POWER_RULE_MAX_EIRP])
+			rule->max_eirp = (int)nla_get_u32(tb_rule[NL80211_ATTR_POWER_RULE_MAX_EIRP]);
+
+		if (tb_rule[NL80211_ATTR_DFS_CAC_TIME])
+			rule->cac_time = nla_get_u32(tb_rule[NL80211_ATTR_DFS_CAC_TIME]);
+
+		flags = nla_get_u32(tb_rule[NL80211_ATTR_REG_RULE_FLAGS]);
+		if (flags & NL80211_RRF_DFS)
+			rule->flags |= WIFI_REG_RULE_DFS;
+		if (flags & NL80211_RRF_NO_IR)
+			rule->flags |= WIFI_REG_RULE_NO_IR;
+		if (flags & NL80211_RRF_AUTO_BW)
+			rule->flags |= WIFI_REG_RULE_AUTO_BW;
+		if (flags & NL80211_RRF_NO_OUTDOOR)
+			rule->flags |= WIFI_REG_RULE_NO_OUTDOOR;
+	}
+
+	return NL_SKIP;
+}
+
+/* Rules of the wiphy's own regdomain if it has one, else the global ones */
+int nlwifi_get_reg_rules(const char *name, char *alpha2,
+			 struct wifi_reg_rule *rules, int *num)
+{
+	struct nlwifi_reg_rules r = {
+		.alpha2 = alpha2,
+		.rules = rules,
+		.max = *num,
+	};
+	struct nlwifi_ctx ctx = {
+		.cmd = NL80211_CMD_GET_REG,
+		.cb = nlwifi_get_reg_rules_cb,
+		.data = &r,
+	};
+	char phy[16] = {};
+	int ret;
+
+	libwifi_dbg("%s %s called\n", name, __func__);
+
+	if (WARN_ON(nlwifi_get_phy(name, phy, sizeof(phy))))
+		return -1;
+
+	memset(alpha2, 0, 3);
+	ret = nlwifi_cmd(phy, &ctx);
+	if (ret < 0)
+		return ret;
+
+	*num = r.num;
+	return 0;
+}
+
 static int nlwifi_get_survey_cb(struct nl_msg *msg, void *data)
 {
 	struct nlattr *tb[NL80211_ATTR_MAX + 1];
@@ -2948,6 +3273,895 @@ int nlwifi_event_handler(struct nl_msg *msg, void *arg)
 	return 0;
 }
 
+#define NLWIFI_DFS_EVENTS	64
+
+/* Generation of the channel state of all radios, bumped on every event
+ * which may change a radio's regulatory, DFS or channel state. The events
+ * are read off a socket of its own, when the generation or the DFS events
+ * are asked for. DFS events are kept till got for their wiphy.
+ */
+static struct {
+	pthread_mutex_t lock;
+	struct nl_sock *sock;
+	uint32_t gen;
+	int dfs_num;
+	struct {
+		uint32_t wiphy;
+		struct wifi_dfs_event ev;
+	} dfs[NLWIFI_DFS_EVENTS];
+	uint64_t dfs_lost;	/* bit per wiphy which lost events */
+} nlwifi_chan = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static void nlwifi_chan_dfs_event(struct nlattr **tb)
+{
+	struct wifi_dfs_event *ev;
+	uint32_t width;
+	uint32_t wiphy;
+	int channel;
+
+	if (!tb[NL80211_ATTR_WIPHY] || !tb[NL80211_ATTR_RADAR_EVENT] ||
+	    !tb[NL80211_ATTR_WIPHY_FREQ])
+		return;
+
+	wiphy = nla_get_u32(tb[NL80211_ATTR_WIPHY]);
+	channel = wifi_freq_to_channel(
+			(int)nla_get_u32(tb[NL80211_ATTR_WIPHY_FREQ]));
+	if (channel <= 0)
+		return;
+
+	/* oldest one makes room */
+	if (nlwifi_chan.dfs_num == NLWIFI_DFS_EVENTS) {
+		nlwifi_chan.dfs_lost |= 1ULL << (nlwifi_chan.dfs[0].wiphy % 64);
+		memmove(&nlwifi_chan.dfs[0], &nlwifi_chan.dfs[1],
+			(NLWIFI_DFS_EVENTS - 1) * sizeof(nlwifi_chan.dfs[0]));
+		nlwifi_chan.dfs_num--;
+	}
+
+	nlwifi_chan.dfs[nlwifi_chan.dfs_num].wiphy = wiphy;
+	ev = &nlwifi_chan.dfs[nlwifi_chan.dfs_num].ev;
+
+	switch (nla_get_u32(tb[NL80211_ATTR_RADAR_EVENT])) {
+	case NL80211_RADAR_DETECTED:
+		ev->type = WIFI_DFS_EVENT_RADAR;
+		break;
+	case NL80211_RADAR_CAC_FINISHED:
+		ev->type = WIFI_DFS_EVENT_CAC_FINISHED;
+		break;
+	case NL80211_RADAR_CAC_ABORTED:
+		ev->type = WIFI_DFS_EVENT_CAC_ABORTED;
+		break;
+	case NL80211_RADAR_NOP_FINISHED:
+		ev->type = WIFI_DFS_EVENT_NOP_FINISHED;
+		break;
+	case NL80211_RADAR_PRE_CAC_EXPIRED:
+		ev->type = WIFI_DFS_EVENT_PRE_CAC_EXPIRED;
+		break;
+	case NL80211_RADAR_CAC_STARTED:
+		ev->type = WIFI_DFS_EVENT_CAC_STARTED;
+		break;
+	default:
+		return;
+	}
+
+	ev->channel = (uint32_t)channel;
+
+	width = NL80211_CHAN_WIDTH_20;
+	if (tb[NL80211_ATTR_CHANNEL_WIDTH])
+		width = nla_get_u32(tb[NL80211_ATTR_CHANNEL_WIDTH]);
+
+	switch (width) {
+	case NL80211_CHAN_WIDTH_40:
+		ev->bw = BW40;
+		break;
+	case NL80211_CHAN_WIDTH_80:
+		ev->bw = BW80;
+		break;
+	case NL80211_CHAN_WIDTH_80P80:
+		ev->bw = BW8080;
+		break;
+	case NL80211_CHAN_WIDTH_160:
+		ev->bw = BW160;
+		break;
+	default:
+		ev->bw = BW20;
+		break;
+	}
+
+	nlwifi_chan.dfs_num++;
+}
+
+static int nlwifi_chan_event(struct nl_msg *msg, void *arg)
+{
+	struct genlmsghdr *gnlh = nlmsg_data(nlmsg_hdr(msg));
+	struct nlattr *tb[NL80211_ATTR_MAX + 1];
+
+	switch (gnlh->cmd) {
+	case NL80211_CMD_RADAR_DETECT:
+		nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0),
+			  genlmsg_attrlen(gnlh, 0), NULL);
+		nlwifi_chan_dfs_event(tb);
+		nlwifi_chan.gen++;
+		break;
+	case NL80211_CMD_REG_CHANGE:
+	case NL80211_CMD_WIPHY_REG_CHANGE:
+	case NL80211_CMD_REG_BEACON_HINT:
+	case NL80211_CMD_CH_SWITCH_NOTIFY:
+	case NL80211_CMD_CH_SWITCH_STARTED_NOTIFY:
+	case NL80211_CMD_NEW_WIPHY:
+	case NL80211_CMD_DEL_WIPHY:
+		nlwifi_chan.gen++;
+		break;
+	default:
+		break;
+	}
+
+	return NL_SKIP;
+}
+
+static struct nl_sock *nlwifi_chan_socket(void)
+{
+	static const char *grps[] = { "regulatory", "mlme", "config" };
+	struct nl_sock *sock;
+	int grp;
+	int i;
+
+	sock = nl_socket_alloc();
+	if (!sock)
+		return NULL;
+
+	nl_socket_disable_seq_check(sock);
+	nl_socket_modify_cb(sock, NL_CB_VALID, NL_CB_CUSTOM,
+			    nlwifi_chan_event, NULL);
+
+	if (genl_connect(sock) < 0)
+		goto free_sock;
+
+	for (i = 0; i < ARRAY_SIZE(grps); i++) {
+		grp = genl_ctrl_resolve_grp(sock, "nl80211", grps[i]);
+		if (grp < 0 || nl_socket_add_membership(sock, grp) < 0)
+			goto free_sock;
+	}
+
+	if (nl_socket_set_nonblocking(sock) < 0)
+		goto free_sock;
+
+	return sock;
+
+free_sock:
+	nl_socket_free(sock);
+	return NULL;
+}
+
+/* Read the pending events; called with the lock held */
+static int nlwifi_chan_recv(void)
+{
+	int err;
+
+	if (!nlwifi_chan.sock) {
+		nlwifi_chan.sock = nlwifi_chan_socket();
+		if (!nlwifi_chan.sock)
+			return -ENOTSUP;
+	}
+
+	do {
+		err = nl_recvmsgs_default(nlwifi_chan.sock);
+	} while (err >= 0);
+
+	if (err != -NLE_AGAIN) {
+		/* events may be lost, e.g. on socket overrun */
+		libwifi_dbg("%s: %s\n", __func__, nl_geterror(err));
+		nlwifi_chan.gen++;
+		nlwifi_chan.dfs_lost = ~0ULL;
+	}
+
+	return 0;
+}
+
+int nlwifi_get_chan_gen(const char *name, uint32_t *gen)
+{
+	int ret;
+
+	UNUSED(name);
+
+	pthread_mutex_lock(&nlwifi_chan.lock);
+	ret = nlwifi_chan_recv();
+	if (!ret)
+		*gen = nlwifi_chan.gen;
+	pthread_mutex_unlock(&nlwifi_chan.lock);
+
+	return ret;
+}
+
+int nlwifi_get_dfs_events(const char *name, struct wifi_dfs_event *ev, int *num)
+{
+	char phy[16] = {};
+	uint64_t lost;
+	int wiphy;
+	int ret;
+	int i, k;
+	int n = 0;
+
+	if (WARN_ON(nlwifi_get_phy(name, phy, sizeof(phy))))
+		return -1;
+
+	wiphy = phy_nametoindex(phy);
+	if (wiphy < 0)
+		return -1;
+
+	pthread_mutex_lock(&nlwifi_chan.lock);
+	ret = nlwifi_chan_recv();
+	if (ret) {
+		pthread_mutex_unlock(&nlwifi_chan.lock);
+		return ret;
+	}
+
+	lost = 1ULL << (wiphy % 64);
+	if (nlwifi_chan.dfs_lost & lost) {
+		nlwifi_chan.dfs_lost &= ~lost;
+		ret = -ESTALE;
+	}
+
+	/* the ones lost with are of no use */
+	for (i = 0, k = 0; i < nlwifi_chan.dfs_num; i++) {
+		if (nlwifi_chan.dfs[i].wiphy == wiphy && (ret || n < *num)) {
+			if (!ret)
+				ev[n++] = nlwifi_chan.dfs[i].ev;
+			continue;
+		}
+
+		nlwifi_chan.dfs[k++] = nlwifi_chan.dfs[i];
+	}
+
+	nlwifi_chan.dfs_num = k;
+	pthread_mutex_unlock(&nlwifi_chan.lock);
+
+	*num = n;
+	return ret;
+}
+
+#define NLWIFI_FRAMES_RING	128
+#define NLWIFI_FRAMES_RING_MAX	1024
+#define NLWIFI_FRAMES_STAS	256	/* power of 2 */
+
+#define FRAME_TYPE_PROBE_REQ	0x0040
+#define FRAME_TYPE_ACTION	0x00d0
+
+/* Management frames an interface subscribed to, read off a socket of its
+ * own on which they are registered for; the registrations go with it, and
+ * as cfg80211 takes no second one of the same frames, the socket is closed
+ * before they are registered for again. A thread reads the socket as the
+ * frames come in, for their rx_time, into a ring the caller gets them from
+ * when an eventfd is readable; the oldest frame makes room for a new one.
+ * To rate limit or dedup, the last frame of each kind from a sta is kept
+ * track of in a table indexed by a hash of the two, where a sta may push
+ * out another one. While stas are tracked from their probe requests, these
+ * are registered for too, and recorded as they come in, not through the
+ * ring.
+ */
+struct nlwifi_frames {
+	char ifname[16];
+	uint32_t ifindex;
+
+	/* registered for on 'sock', read by 'reader' till 'stop' */
+	struct wifi_frame_sub reg;
+	struct nl_sock *sock;
+	pthread_t reader;
+	int stop;
+
+	bool track;		/* probe requests for monitored stas */
+	bool subscribed;
+	struct wifi_frame_sub sub;
+	int efd;		/* readable while frames are kept */
+	struct wifi_rx_frame *ring;
+	int size;
+	int head;		/* oldest frame */
+	int num;
+	uint32_t lost;
+	struct {
+		uint8_t sa[6];
+		uint16_t kind;
+		uint32_t hash;	/* of the frame body */
+		uint64_t last;
+	} sta[NLWIFI_FRAMES_STAS];
+	struct nlwifi_frames *next;
+};
+
+static struct {
+	pthread_mutex_t lock;		/* of the list and the frames kept */
+	pthread_mutex_t sub_lock;	/* (un)subscribing one at a time */
+	struct nlwifi_frames *list;
+} nlwifi_frames = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.sub_lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static uint32_t nlwifi_frames_hash(const uint8_t *data, size_t len,
+				   uint32_t h)
+{
+	while (len--) {
+		h ^= *data++;
+		h *= 16777619;
+	}
+
+	return h;
+}
+
+/* Check a frame against rate limit and dedup of its kind from its sta */
+static bool nlwifi_frames_pass(struct nlwifi_frames *fr, const uint8_t *frame,
+			       size_t len, uint16_t kind, uint64_t now)
+{
+	const uint8_t *sa = &frame[10];
+	uint32_t hash;
+	int i;
+
+	if (!fr->sub.ratelimit && !fr->sub.dedup)
+		return true;
+
+	i = nlwifi_frames_hash(sa, 6, 2166136261u ^ kind) &
+			(NLWIFI_FRAMES_STAS - 1);
+
+	/* body after the header, which has the sequence number */
+	hash = nlwifi_frames_hash(&frame[24], len - 24, 2166136261u);
+
+	if (!memcmp(fr->sta[i].sa, sa, 6) && fr->sta[i].kind == kind &&
+	    fr->sta[i].last) {
+		if (fr->sub.ratelimit &&
+		    now - fr->sta[i].last < fr->sub.ratelimit)
+			return false;
+
+		if (fr->sub.dedup && fr->sta[i].hash == hash)
+			return false;
+	}
+
+	memcpy(fr->sta[i].sa, sa, 6);
+	fr->sta[i].kind = kind;
+	fr->sta[i].hash = hash;
+	fr->sta[i].last = now;
+
+	return true;
+}
+
+/* Called by the reader with the lock held */
+static int nlwifi_frames_event(struct nl_msg *msg, void *arg)
+{
+	struct genlmsghdr *gnlh = nlmsg_data(nlmsg_hdr(msg));
+	struct nlattr *tb[NL80211_ATTR_MAX + 1];
+	struct nlwifi_frames *fr = arg;
+	struct wifi_rx_frame *f;
+	uint64_t now;
+	uint8_t *frame;
+	uint16_t kind;
+	int32_t rssi;
+	size_t len;
+	int i;
+
+	if (gnlh->cmd != NL80211_CMD_FRAME)
+		return NL_SKIP;
+
+	nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0),
+		  genlmsg_attrlen(gnlh, 0), NULL);
+
+	if (!tb[NL80211_ATTR_FRAME] || !tb[NL80211_ATTR_IFINDEX] ||
+	    nla_get_u32(tb[NL80211_ATTR_IFINDEX]) != fr->ifindex)
+		return NL_SKIP;
+
+	frame = nla_data(tb[NL80211_ATTR_FRAME]);
+	len = (size_t)nla_len(tb[NL80211_ATTR_FRAME]);
+	if (len < 24)
+		return NL_SKIP;
+
+	kind = (frame[0] | (frame[1] << 8)) & 0x00fc;
+	if (kind == FRAME_TYPE_ACTION) {
+		if (len < 25)
+			return NL_SKIP;
+
+		kind |= frame[24] << 8;
+	} else if (kind != FRAME_TYPE_PROBE_REQ) {
+		return NL_SKIP;
+	}
+
+	now = time_monotonic_msecs();
+	rssi = 0;
+	if (tb[NL80211_ATTR_RX_SIGNAL_DBM])
+		rssi = (int32_t)nla_get_u32(tb[NL80211_ATTR_RX_SIGNAL_DBM]);
+
+	/* tracked from the header, whether subscribed to or not */
+	if (kind == FRAME_TYPE_PROBE_REQ && fr->track) {
+		struct wifi_rx_frame rx = { .rx_time = now, .rssi = rssi, .len = 24 };
+
+		memcpy(rx.frame, frame, 24);
+		wifi_monsta_record_frames(fr->ifname, &rx, 1);
+	}
+
+	if (!fr->subscribed ||
+	    !(fr->sub.flag & (kind == FRAME_TYPE_PROBE_REQ ?
+			      WIFI_FRAME_SUB_PROBE_REQ : WIFI_FRAME_SUB_ACTION)) ||
+	    !nlwifi_frames_pass(fr, frame, len, kind, now))
+		return NL_SKIP;
+
+	/* oldest one makes room */
+	if (fr->num == fr->size) {
+		fr->head = (fr->head + 1) % fr->size;
+		fr->num--;
+		fr->lost++;
+	}
+
+	i = (fr->head + fr->num) % fr->size;
+	f = &fr->ring[i];
+	f->rx_time = now;
+	f->rssi = rssi;
+	f->freq = 0;
+	if (tb[NL80211_ATTR_WIPHY_FREQ])
+		f->freq = nla_get_u32(tb[NL80211_ATTR_WIPHY_FREQ]);
+	f->truncated = len > sizeof(f->frame);
+	f->len = (uint16_t)(f->truncated ? sizeof(f->frame) : len);
+	memcpy(f->frame, frame, f->len);
+	fr->num++;
+	eventfd_write(fr->efd, 1);
+
+	return NL_SKIP;
+}
+
+/* Read the frames off the socket as they come in, till stopped */
+static void *nlwifi_frames_reader(void *arg)
+{
+	struct nlwifi_frames *fr = arg;
+	struct pollfd pfd[2] = {
+		{ .fd = nl_socket_get_fd(fr->sock), .events = POLLIN },
+		{ .fd = fr->stop, .events = POLLIN },
+	};
+	int err;
+
+	for (;;) {
+		if (poll(pfd, 2, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		if (pfd[1].revents)
+			break;
+
+		pthread_mutex_lock(&nlwifi_frames.lock);
+		do {
+			err = nl_recvmsgs_default(fr->sock);
+		} while (err >= 0);
+		pthread_mutex_unlock(&nlwifi_frames.lock);
+
+		/* out of buffer space: frames dropped by the kernel */
+		if (err != -NLE_AGAIN && err != -NLE_NOMEM) {
+			libwifi_dbg("[%s] %s: %s\n", fr->ifname, __func__,
+				    nl_geterror(err));
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static int nlwifi_frames_register(struct nlwifi_frames *fr, int family,
+				  uint16_t type, uint8_t *match, int len)
+{
+	struct nl_msg *msg;
+	int err;
+
+	msg = nlmsg_alloc();
+	if (!msg)
+		return -ENOMEM;
+
+	if (!genlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, family, 0, 0,
+			 NL80211_CMD_REGISTER_FRAME, 0) ||
+	    nla_put_u32(msg, NL80211_ATTR_IFINDEX, fr->ifindex) ||
+	    nla_put_u16(msg, NL80211_ATTR_FRAME_TYPE, type) ||
+	    nla_put(msg, NL80211_ATTR_FRAME_MATCH, len, match)) {
+		nlmsg_free(msg);
+		return -ENOMEM;
+	}
+
+	err = nl_send_auto(fr->sock, msg);
+	nlmsg_free(msg);
+	if (err >= 0)
+		err = nl_wait_for_ack(fr->sock);
+
+	if (err < 0) {
+		libwifi_dbg("[%s] register frame 0x%04x: %s\n", fr->ifname,
+			    type, nl_geterror(err));
+		/* already registered for by another, e.g. hostapd */
+		return err == -NLE_EXIST || err == -NLE_BUSY ? -EBUSY : -EIO;
+	}
+
+	return 0;
+}
+
+/* Close the socket, with its registrations and reader */
+static void nlwifi_frames_close(struct nlwifi_frames *fr)
+{
+	if (!fr->sock)
+		return;
+
+	eventfd_write(fr->stop, 1);
+	pthread_join(fr->reader, NULL);
+	close(fr->stop);
+	fr->stop = -1;
+	nl_socket_free(fr->sock);
+	fr->sock = NULL;
+	memset(&fr->reg, 0, sizeof(fr->reg));
+}
+
+/* Register for the frames of 'reg' on a new socket, and start its reader */
+static int nlwifi_frames_open(struct nlwifi_frames *fr,
+			      struct wifi_frame_sub *reg)
+{
+	int family;
+	int ret = 0;
+	int i;
+
+	fr->sock = nl_socket_alloc();
+	fr->stop = eventfd(0, EFD_CLOEXEC);
+	if (!fr->sock || fr->stop < 0) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	nl_socket_disable_seq_check(fr->sock);
+	if (genl_connect(fr->sock) < 0) {
+		ret = -EIO;
+		goto out;
+	}
+
+	family = genl_ctrl_resolve(fr->sock, "nl80211");
+	if (family < 0) {
+		ret = -ENOTSUP;
+		goto out;
+	}
+
+	if (reg->flag & WIFI_FRAME_SUB_PROBE_REQ) {
+		ret = nlwifi_frames_register(fr, family, FRAME_TYPE_PROBE_REQ,
+					     NULL, 0);
+		if (ret)
+			goto out;
+	}
+
+	if (reg->flag & WIFI_FRAME_SUB_ACTION) {
+		if (!reg->num_category)
+			ret = nlwifi_frames_register(fr, family,
+						     FRAME_TYPE_ACTION, NULL, 0);
+
+		for (i = 0; !ret && i < reg->num_category; i++)
+			ret = nlwifi_frames_register(fr, family,
+						     FRAME_TYPE_ACTION,
+						     &reg->category[i], 1);
+		if (ret)
+			goto out;
+	}
+
+	if (nl_socket_set_nonblocking(fr->sock) < 0) {
+		ret = -EIO;
+		goto out;
+	}
+
+	/* frames are for the reader only, none while registering */
+	nl_socket_modify_cb(fr->sock, NL_CB_VALID, NL_CB_CUSTOM,
+			    nlwifi_frames_event, fr);
+
+	if (pthread_create(&fr->reader, NULL, nlwifi_frames_reader, fr)) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	fr->reg = *reg;
+	return 0;
+
+out:
+	if (fr->sock)
+		nl_socket_free(fr->sock);
+	fr->sock = NULL;
+	if (fr->stop >= 0)
+		close(fr->stop);
+	fr->stop = -1;
+	return ret;
+}
+
+/* Frames to register for, without what only filters them: the ones of a
+ * subscription, and probe requests while tracked
+ */
+static void nlwifi_frames_reg(const struct wifi_frame_sub *sub, bool track,
+			      struct wifi_frame_sub *reg)
+{
+	memset(reg, 0, sizeof(*reg));
+	if (sub) {
+		reg->flag = sub->flag;
+		if (reg->flag & WIFI_FRAME_SUB_ACTION) {
+			reg->num_category = sub->num_category;
+			memcpy(reg->category, sub->category, sub->num_category);
+		}
+	}
+
+	if (track)
+		reg->flag |= WIFI_FRAME_SUB_PROBE_REQ;
+}
+
+static bool nlwifi_frames_same_reg(const struct wifi_frame_sub *a,
+				   const struct wifi_frame_sub *b)
+{
+	return a->flag == b->flag && a->num_category == b->num_category &&
+	       !memcmp(a->category, b->category, a->num_category);
+}
+
+/* Register for the frames of 'reg' unless already, closing the socket
+ * first; the ones before are kept if they register again.
+ */
+static int nlwifi_frames_rereg(struct nlwifi_frames *fr,
+			       struct wifi_frame_sub *reg)
+{
+	struct wifi_frame_sub old = fr->reg;
+	int ret;
+
+	if (fr->sock && nlwifi_frames_same_reg(reg, &fr->reg))
+		return 0;
+
+	nlwifi_frames_close(fr);
+	if (!reg->flag)
+		return 0;
+
+	ret = nlwifi_frames_open(fr, reg);
+	if (ret && old.flag)
+		nlwifi_frames_open(fr, &old);
+
+	return ret;
+}
+
+static void nlwifi_frames_free(struct nlwifi_frames *fr)
+{
+	nlwifi_frames_close(fr);
+	if (fr->efd >= 0)
+		close(fr->efd);
+
+	free(fr->ring);
+	free(fr);
+}
+
+static struct nlwifi_frames *nlwifi_frames_lookup(const char *ifname)
+{
+	struct nlwifi_frames *fr;
+
+	for (fr = nlwifi_frames.list; fr; fr = fr->next) {
+		if (!strncmp(fr->ifname, ifname, sizeof(fr->ifname)))
+			return fr;
+	}
+
+	return NULL;
+}
+
+static void nlwifi_frames_unlink(struct nlwifi_frames *fr)
+{
+	struct nlwifi_frames **p;
+
+	for (p = &nlwifi_frames.list; *p; p = &(*p)->next) {
+		if (*p == fr) {
+			*p = fr->next;
+			break;
+		}
+	}
+}
+
+/* Get the frames of an interface to (un)subscribe, new ones not listed */
+static struct nlwifi_frames *nlwifi_frames_get(const char *ifname, int *ret)
+{
+	struct nlwifi_frames *fr;
+
+	pthread_mutex_lock(&nlwifi_frames.lock);
+	fr = nlwifi_frames_lookup(ifname);
+	pthread_mutex_unlock(&nlwifi_frames.lock);
+	if (fr)
+		return fr;
+
+	fr = calloc(1, sizeof(*fr));
+	if (!fr) {
+		*ret = -ENOMEM;
+		return NULL;
+	}
+
+	strncpy(fr->ifname, ifname, sizeof(fr->ifname) - 1);
+	fr->stop = -1;
+	fr->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	fr->ifindex = if_nametoindex(ifname);
+	if (fr->efd < 0 || !fr->ifindex) {
+		*ret = fr->efd < 0 ? -ENOMEM : -ENODEV;
+		nlwifi_frames_free(fr);
+		return NULL;
+	}
+
+	return fr;
+}
+
+/* Done (un)subscribing: listed while registered for any, else freed */
+static void nlwifi_frames_put(struct nlwifi_frames *fr)
+{
+	bool listed;
+
+	pthread_mutex_lock(&nlwifi_frames.lock);
+	listed = nlwifi_frames_lookup(fr->ifname) == fr;
+	if (fr->sock && (fr->subscribed || fr->track)) {
+		if (!listed) {
+			fr->next = nlwifi_frames.list;
+			nlwifi_frames.list = fr;
+		}
+		pthread_mutex_unlock(&nlwifi_frames.lock);
+		return;
+	}
+
+	if (listed)
+		nlwifi_frames_unlink(fr);
+	pthread_mutex_unlock(&nlwifi_frames.lock);
+
+	nlwifi_frames_free(fr);
+}
+
+/* Drop the frames kept; with the lock held */
+static void nlwifi_frames_flush(struct nlwifi_frames *fr)
+{
+	eventfd_t v;
+
+	fr->head = 0;
+	fr->num = 0;
+	fr->lost = 0;
+	memset(fr->sta, 0, sizeof(fr->sta));
+	eventfd_read(fr->efd, &v);
+}
+
+int nlwifi_subscribe_frames(const char *ifname, struct wifi_frame_sub *sub)
+{
+	struct wifi_rx_frame *ring, *old_ring = NULL;
+	struct wifi_frame_sub reg;
+	struct nlwifi_frames *fr;
+	int size;
+	int ret = 0;
+
+	if (!sub->flag || sub->num_category > WIFI_FRAME_SUB_MAX_CATEGORY ||
+	    sub->ring_size < 0 || sub->ring_size > NLWIFI_FRAMES_RING_MAX)
+		return -EINVAL;
+
+	size = sub->ring_size ? sub->ring_size : NLWIFI_FRAMES_RING;
+	ring = calloc((size_t)size, sizeof(*ring));
+	if (!ring)
+		return -ENOMEM;
+
+	pthread_mutex_lock(&nlwifi_frames.sub_lock);
+	fr = nlwifi_frames_get(ifname, &ret);
+	if (!fr)
+		goto out;
+
+	/* the same frames are filtered anew without registering again */
+	nlwifi_frames_reg(sub, fr->track, &reg);
+	ret = nlwifi_frames_rereg(fr, &reg);
+	if (!ret) {
+		/* the frames of the one replaced are lost with it */
+		pthread_mutex_lock(&nlwifi_frames.lock);
+		old_ring = fr->ring;
+		fr->ring = ring;
+		fr->size = size;
+		fr->sub = *sub;
+		fr->subscribed = true;
+		nlwifi_frames_flush(fr);
+		pthread_mutex_unlock(&nlwifi_frames.lock);
+		ring = NULL;
+	}
+
+	nlwifi_frames_put(fr);
+out:
+	pthread_mutex_unlock(&nlwifi_frames.sub_lock);
+
+	free(old_ring);
+	free(ring);
+	return ret;
+}
+
+int nlwifi_unsubscribe_frames(const char *ifname)
+{
+	struct wifi_frame_sub reg;
+	struct nlwifi_frames *fr;
+	int ret = -ENOENT;
+
+	pthread_mutex_lock(&nlwifi_frames.sub_lock);
+	pthread_mutex_lock(&nlwifi_frames.lock);
+	fr = nlwifi_frames_lookup(ifname);
+	if (fr && fr->subscribed) {
+		fr->subscribed = false;
+		nlwifi_frames_flush(fr);
+		ret = 0;
+	}
+	pthread_mutex_unlock(&nlwifi_frames.lock);
+
+	/* probe requests only, while tracked */
+	if (!ret) {
+		nlwifi_frames_reg(NULL, fr->track, &reg);
+		nlwifi_frames_rereg(fr, &reg);
+		nlwifi_frames_put(fr);
+	}
+	pthread_mutex_unlock(&nlwifi_frames.sub_lock);
+
+	return ret;
+}
+
+int nlwifi_track_probe_req(const char *ifname, bool enable)
+{
+	struct wifi_frame_sub reg;
+	struct nlwifi_frames *fr;
+	int ret = 0;
+
+	pthread_mutex_lock(&nlwifi_frames.sub_lock);
+	fr = nlwifi_frames_get(ifname, &ret);
+	if (!fr)
+		goto out;
+
+	nlwifi_frames_reg(fr->subscribed ? &fr->sub : NULL, enable, &reg);
+	ret = nlwifi_frames_rereg(fr, &reg);
+	if (!ret) {
+		pthread_mutex_lock(&nlwifi_frames.lock);
+		fr->track = enable;
+		pthread_mutex_unlock(&nlwifi_frames.lock);
+	}
+
+	nlwifi_frames_put(fr);
+out:
+	pthread_mutex_unlock(&nlwifi_frames.sub_lock);
+
+	return ret;
+}
+
+int nlwifi_get_frames_fd(const char *ifname, int *fd)
+{
+	struct nlwifi_frames *fr;
+	int ret = -ENOENT;
+
+	pthread_mutex_lock(&nlwifi_frames.lock);
+	fr = nlwifi_frames_lookup(ifname);
+	if (fr && fr->subscribed) {
+		*fd = fr->efd;
+		ret = 0;
+	}
+	pthread_mutex_unlock(&nlwifi_frames.lock);
+
+	return ret;
+}
+
+int nlwifi_get_frames(const char *ifname, struct wifi_rx_frame *f, int *num)
+{
+	struct nlwifi_frames *fr;
+	eventfd_t v;
+	int n;
+
+	pthread_mutex_lock(&nlwifi_frames.lock);
+	fr = nlwifi_frames_lookup(ifname);
+	if (!fr || !fr->subscribed) {
+		pthread_mutex_unlock(&nlwifi_frames.lock);
+		return -ENOENT;
+	}
+
+	if (fr->lost) {
+		libwifi_dbg("[%s] %s: %u frames lost\n", ifname, __func__,
+			    fr->lost);
+		fr->lost = 0;
+	}
+
+	for (n = 0; n < *num && fr->num > 0; n++) {
+		memcpy(&f[n], &fr->ring[fr->head], sizeof(*f));
+		fr->head = (fr->head + 1) % fr->size;
+		fr->num--;
+	}
+
+	/* readable again with the next frame */
+	if (!fr->num)
+		eventfd_read(fr->efd, &v);
+	pthread_mutex_unlock(&nlwifi_frames.lock);
+
+	*num = n;
+	return 0;
+}
+
 static struct nlwifi_event_struct {
 	const char *family;
 	const char *grp;
@@ -3006,6 +4220,13 @@ int nlwifi_register_event(const char *ifname, struct event_struct *req, void **h
 	}
 
 	memcpy(&wev->req, req, sizeof(struct event_struct));
+
+	/* events are of a netdev; match a phy's on the netdev it scans with */
+	if (strstr(req->ifname, "phy") &&
+	    nlwifi_phy_to_netdev(req->ifname, wev->req.ifname,
+				 sizeof(wev->req.ifname)))
+		memcpy(wev->req.ifname, req->ifname, sizeof(wev->req.ifname));
+
 	sock = nl_socket_alloc();
 	if (!sock) {
 		libwifi_err("%s: nl_socket_alloc\n", __func__);
@@ -3253,6 +4474,11 @@ const struct wifi_driver nlwifi_driver = {
 	.scan = nlwifi_scan,
 	.scan_ex = nlwifi_scan_ex,
 	.get_scan_results = nlwifi_get_scan_results,
+	.iterate_scan_results = nlwifi_iterate_scan_results,
+	.iterate_scan_ies = nlwifi_iterate_scan_ies,
+	.get_chan_gen = nlwifi_get_chan_gen,
+	.get_reg_rules = nlwifi_get_reg_rules,
+	.get_dfs_events = nlwifi_get_dfs_events,
 	.get_bssid = nlwifi_get_bssid,
 	.get_ssid = nlwifi_get_ssid,
 	.get_channel = nlwifi_get_channel,
@@ -3274,4 +4500,8 @@ const struct wifi_driver nlwifi_driver = {
 	.get_4addr = nlwifi_get_4addr,
 	.start_cac = nlwifi_start_cac,
 	.stop_cac = nlwifi_stop_cac,
+	.iface.subscribe_frames = nlwifi_subscribe_frames,
+	.iface.unsubscribe_frames = nlwifi_unsubscribe_frames,
+	.iface.get_frames_fd = nlwifi_get_frames_fd,
+	.iface.get_frames = nlwifi_get_frames,
 };
@@ -47,6 +47,25 @@ LIBWIFI_INTERNAL int nlwifi_scan(const char *ifname, struct scan_param *p);
 LIBWIFI_INTERNAL int nlwifi_scan_ex(const char *ifname, struct scan_param_ex *sp);
 LIBWIFI_INTERNAL int nlwifi_get_scan_results(const char *ifname,
 					struct wifi_bss *bsss, int *num);
+LIBWIFI_INTERNAL int nlwifi_iterate_scan_results(const char *ifname,
+					struct wifi_scan_filter *f,
+					int (*cb)(struct wifi_bss *bss, void *priv),
+					void *priv);
+LIBWIFI_INTERNAL int nlwifi_iterate_scan_ies(const char *ifname,
+					struct wifi_scan_filter *f,
+					int (*cb)(struct wifi_bss *bss, uint8_t *ies,
+						  size_t ies_len, void *priv),
+					void *priv);
+LIBWIFI_INTERNAL int nlwifi_subscribe_frames(const char *ifname,
+					struct wifi_frame_sub *sub);
+LIBWIFI_INTERNAL int nlwifi_unsubscribe_frames(const char *ifname);
+LIBWIFI_INTERNAL int nlwifi_get_frames_fd(const char *ifname, int *fd);
+LIBWIFI_INTERNAL int nlwifi_get_frames(const char *ifname,
+				       struct wifi_rx_frame *f, int *num);
+LIBWIFI_INTERNAL int nlwifi_track_probe_req(const char *ifname, bool enable);
+LIBWIFI_INTERNAL int nlwifi_get_chan_gen(const char *name, uint32_t *gen);
+LIBWIFI_INTERNAL int nlwifi_get_dfs_events(const char *name,
+					   struct wifi_dfs_event *ev, int *num);
 LIBWIFI_INTERNAL int nlwifi_get_ssid(const char *ifname, char *ssid);
 LIBWIFI_INTERNAL int nlwifi_get_bssid(const char *ifname, uint8_t *bssid);
 LIBWIFI_INTERNAL int nlwifi_get_channel_freq(const char *ifname, uint32_t *control_freq);
@@ -80,11 +99,21 @@ LIBWIFI_INTERNAL int nlwifi_sta_get_stats(const char *ifname,struct wifi_sta_sta
 
 LIBWIFI_INTERNAL int nlwifi_get_sta_info(const char *ifname, uint8_t *addr,
 					struct wifi_sta *info);
+LIBWIFI_INTERNAL int nlwifi_get_stations(const char *ifname,
+					struct wifi_sta *stas, int *num);
+LIBWIFI_INTERNAL int nlwifi_get_station(const char *ifname, uint8_t *addr,
+					struct wifi_sta *info);
+LIBWIFI_INTERNAL int nlwifi_get_stations_stats(const char *ifname,
+					struct wifi_sta_stats *sum, int *num);
+LIBWIFI_INTERNAL int nlwifi_get_ap_wmm_stats(const char *ifname,
+					struct wifi_ap_wmm_ac_stats *ac);
 
 LIBWIFI_INTERNAL int nlwifi_radio_info(const char *name, struct wifi_radio *radio);
 LIBWIFI_INTERNAL int nlwifi_get_phy_info(const char *name, struct wifi_radio *radio);
 LIBWIFI_INTERNAL int nlwifi_radio_get_caps(const char *name, struct wifi_caps *caps);
 LIBWIFI_INTERNAL int nlwifi_get_country(const char *name, char *alpha2);
+LIBWIFI_INTERNAL int nlwifi_get_reg_rules(const char *name, char *alpha2,
+					  struct wifi_reg_rule *rules, int *num);
 
 LIBWIFI_INTERNAL int nlwifi_get_phyname(const char *ifname, char *phyname);
 LIBWIFI_INTERNAL int nlwifi_get_noise(const char *name, int *noise);
@@ -116,6 +145,30 @@ struct nlwifi_event_vendor_resp {
 	uint8_t data[];
 };
 
+/* max vendor requests in flight in a pipelined batch */
+#define NLWIFI_VENDOR_WINDOW	32
+
+/* struct nlwifi_vendor_req - one vendor command of a pipelined batch */
+struct nlwifi_vendor_req {
+	uint32_t subcmd;
+	uint8_t *in;		/* request data, can be NULL */
+	int ilen;
+	uint8_t *out;		/* response buffer */
+	int osize;		/* size of response buffer */
+	int olen;		/* length of response received */
+	int status;		/* 0 or -errno of this request */
+	uint32_t seq;		/* netlink sequence number (internal) */
+};
+
+struct nl_sock;
+
+LIBWIFI_INTERNAL int nlwifi_vendor_cmd_batch(const char *ifname, uint32_t vid,
+					struct nlwifi_vendor_req *req, int num);
+LIBWIFI_INTERNAL int nlwifi_vendor_cmd_pipeline(struct nl_sock *sk, int family,
+					int ifindex, uint32_t vid,
+					struct nlwifi_vendor_req *req, int num,
+					int window);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,6 +32,7 @@
 #include <syslog.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <pthread.h>
 
 #include "easy.h"
 #include "wifiutils.h"
@@ -55,17 +56,18 @@ void log_test(const char *fmt, ...)
 	}
 
 	time_t now = time(NULL);
-	struct tm *tm_now = localtime(&now);
+	struct tm tm_now;
 	const char *tm_fmt = "[%4d-%02d-%02d %02d:%02d:%02d] ";
 
+	localtime_r(&now, &tm_now);
 	va_start(args, fmt);
 	fprintf(fp, tm_fmt,		/* Flawfinder: ignore */
-			tm_now->tm_year + 1900,
-			tm_now->tm_mon + 1,
-			tm_now->tm_mday,
-			tm_now->tm_hour,
-			tm_now->tm_min,
-			tm_now->tm_sec);
+			tm_now.tm_year + 1900,
+			tm_now.tm_mon + 1,
+			tm_now.tm_mday,
+			tm_now.tm_hour,
+			tm_now.tm_min,
+			tm_now.tm_sec);
 	vfprintf(fp, fmt, args);	/* Flawfinder: ignore */
 	va_end(args);
 
@@ -74,6 +76,15 @@ void log_test(const char *fmt, ...)
 	fclose(fp);
 }
 
+/* Simulate the latency of a driver query, in usecs, for benchmarks */
+static void test_latency(void)
+{
+	const char *usecs = getenv("LIBWIFI_TEST_LATENCY");
+
+	if (usecs)
+		usleep(atoi(usecs));
+}
+
 int test_ap_get_caps(const char *ifname, struct wifi_caps *caps)
 {
 	GET_TEST_BUF_TYPE(caps, ifname, ap_caps, struct wifi_caps);
@@ -94,6 +105,8 @@ int test_get_sta_info(const char *ifname, uint8_t *addr, struct wifi_sta *info)
 	//int ret = -1;
 	int i;
 
+	test_latency();
+
 	if (!addr) {
 		libwifi_err("Invalid args!\n");
 		return -EINVAL;
@@ -161,8 +174,32 @@ int test_get_sta_info(const char *ifname, uint8_t *addr, struct wifi_sta *info)
 	return 0;
 }
 
+int test_get_stas_info(const char *ifname, struct wifi_sta *stas, int *num)
+{
+	int num_stations;
+	int i;
+
+	num_stations = GET_TEST_ARRAY_SIZE(struct wifi_sta, ifname, stalist);
+	if (*num < num_stations)
+		return -EINVAL;
+
+	for (i = 0; i < num_stations; i++) {
+		struct wifi_sta tmp;
+
+		memset(&tmp, 0, sizeof(struct wifi_sta));
+		GET_TEST_ARRAY_ENTRY(&tmp, struct wifi_sta, ifname, stalist, i);
+
+		memset(&stas[i], 0, sizeof(struct wifi_sta));
+		test_get_sta_info(ifname, tmp.macaddr, &stas[i]);
+	}
+
+	*num = num_stations;
+	return 0;
+}
+
 int test_radio_get_stats(const char *ifname, struct wifi_radio_stats *s)
 {
+	test_latency();
 	GET_TEST_BUF_TYPE(s, ifname, radio_stats, struct wifi_radio_stats);
 
 	return 0;
@@ -170,12 +207,26 @@ int test_radio_get_stats(const char *ifname, struct wifi_radio_stats *s)
 
 int test_ap_get_stats(const char *ifname, struct wifi_ap_stats *s)
 {
-
+	test_latency();
 	GET_TEST_BUF_TYPE(s, ifname, ap_stats, struct wifi_ap_stats);
 
 	return 0;
 }
 
+int test_radio_get_wmm_stats(const char *name, struct wifi_bss_wmm_stats *bss,
+			     int *num)
+{
+	int buflen = 0;
+
+	if (*num < GET_TEST_ARRAY_SIZE(struct wifi_bss_wmm_stats, name, bss_wmm_stats))
+		return -EINVAL;
+
+	GET_TEST_BUF(bss, buflen, name, bss_wmm_stats);
+	*num = buflen / sizeof(struct wifi_bss_wmm_stats);
+
+	return 0;
+}
+
 static int test_radio_get_param(const char *name, const char *param,
 						int *len, void *val)
 {
@@ -192,6 +243,7 @@ static int test_radio_get_param(const char *name, const char *param,
 
 int test_get_assoclist(const char *ifname, uint8_t *stas, int *num_stas)
 {
+	test_latency();
 	GET_TEST_ARRAY(stas, *num_stas, macaddr_t, ifname, assoclist);
 
 	return 0;
@@ -559,16 +611,281 @@ static int test_get_noise(const char *ifname, int *noise)
 	return 0;
 }
 
+/* Channels of the tri-band radio, with their bands if asked for */
+static int test6_get_channels(uint32_t *chans, enum wifi_band *bands, int max)
+{
+	const uint32_t chans2[] = test2_supp_channels;
+	const uint32_t chans5[] = test5_supp_channels;
+	int n = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(chans2) && n < max; i++, n++) {
+		chans[n] = chans2[i];
+		if (bands)
+			bands[n] = BAND_2;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(chans5) && n < max; i++, n++) {
+		chans[n] = chans5[i];
+		if (bands)
+			bands[n] = BAND_5;
+	}
+
+	for (i = 1; i <= 233 && n < max; i += 4, n++) {
+		chans[n] = i;
+		if (bands)
+			bands[n] = BAND_6;
+	}
+
+	return n;
+}
+
 int test_get_supp_channels(const char *ifname, uint32_t *chlist, int *num,
 					const char *cc,
 					enum wifi_band band,
 					enum wifi_bw bw)
 {
+	if (ifname_is_test6(ifname)) {
+		*num = test6_get_channels(chlist, NULL, *num);
+		return 0;
+	}
+
 	GET_TEST_ARRAY(chlist, *num, uint32_t, ifname, supp_channels);
 
 	return 0;
 }
 
+static int test_get_supp_band(const char *name, uint32_t *bands)
+{
+	if (ifname_is_test6(name))
+		*bands = BAND_2 | BAND_5 | BAND_6;
+	else
+		*bands = ifname_to_band_enum(name);
+
+	return 0;
+}
+
+static int test_get_supp_bandwidths(const char *name, uint32_t *bws)
+{
+	if (ifname_is_test6(name))
+		*bws = test6_supp_bws;
+	else
+		GET_TEST_INT(*bws, name, supp_bws);
+
+	return 0;
+}
+
+static int test_chan2freq(enum wifi_band band, uint32_t channel)
+{
+	switch (band) {
+	case BAND_5:
+		return 5000 + 5 * channel;
+	case BAND_6:
+		return 5950 + 5 * channel;
+	default:
+		return 2407 + 5 * channel;
+	}
+}
+
+/* 5GHz channels 52 to 144 need radar detection; all are available */
+static int test_channels_info(const char *name, struct chan_entry *channel,
+			      int *num)
+{
+	enum wifi_band bands[test6_max_channels];
+	uint32_t chans[test6_max_channels];
+	int noise = 0;
+	int n = 0;
+	int i;
+
+	if (ifname_is_test6(name)) {
+		n = test6_get_channels(chans, bands, ARRAY_SIZE(chans));
+		noise = test5_noise;
+	} else {
+		GET_TEST_ARRAY(chans, n, uint32_t, name, supp_channels);
+		GET_TEST_INT(noise, name, noise);
+		for (i = 0; i < n; i++)
+			bands[i] = ifname_to_band_enum(name);
+	}
+
+	for (i = 0; i < n && i < *num; i++) {
+		enum wifi_band band = bands[i];
+
+		memset(&channel[i], 0, sizeof(channel[i]));
+		channel[i].channel = chans[i];
+		channel[i].band = band;
+		channel[i].freq = test_chan2freq(band, chans[i]);
+		channel[i].noise = noise;
+		channel[i].dfs = band == BAND_5 && chans[i] >= 52 &&
+				 chans[i] <= 144;
+		if (channel[i].dfs) {
+			channel[i].dfs_state = WIFI_DFS_STATE_AVAILABLE;
+			channel[i].cac_time = 60;
+		}
+	}
+
+	*num = i;
+	return 0;
+}
+
+/* Changes as LIBWIFI_TEST_CHAN_GEN is set, to simulate channel events */
+static int test_get_chan_gen(const char *name, uint32_t *gen)
+{
+	const char *g = getenv("LIBWIFI_TEST_CHAN_GEN");
+
+	*gen = g ? (uint32_t)atoi(g) : 0;
+
+	return 0;
+}
+
+/* ETSI like rules of the radio's country, or FCC like ones if
+ * LIBWIFI_TEST_REG is "US", to simulate a regulatory domain change
+ */
+static int test_get_reg_rules(const char *name, char *alpha2,
+			      struct wifi_reg_rule *rules, int *num)
+{
+	static const struct wifi_reg_rule etsi[] = {
+		{ 2400000, 2483500, 40000, 2000, 0, 0 },
+		{ 5150000, 5250000, 80000, 2300,
+		  WIFI_REG_RULE_NO_OUTDOOR | WIFI_REG_RULE_AUTO_BW, 0 },
+		{ 5250000, 5350000, 80000, 2000,
+		  WIFI_REG_RULE_DFS | WIFI_REG_RULE_AUTO_BW, 60000 },
+		{ 5470000, 5725000, 160000, 2698, WIFI_REG_RULE_DFS, 60000 },
+		{ 5945000, 6425000, 160000, 2300, WIFI_REG_RULE_NO_OUTDOOR, 0 },
+	};
+	static const struct wifi_reg_rule fcc[] = {
+		{ 2400000, 2472000, 40000, 3000, 0, 0 },
+		{ 5170000, 5250000, 80000, 2300, WIFI_REG_RULE_AUTO_BW, 0 },
+		{ 5250000, 5330000, 80000, 2300,
+		  WIFI_REG_RULE_DFS | WIFI_REG_RULE_AUTO_BW, 0 },
+		{ 5490000, 5730000, 160000, 2300, WIFI_REG_RULE_DFS, 0 },
+		{ 5735000, 5835000, 80000, 3000, 0, 0 },
+		{ 5925000, 7125000, 160000, 1200, WIFI_REG_RULE_NO_OUTDOOR, 0 },
+	};
+	const char *reg = getenv("LIBWIFI_TEST_REG");
+	const struct wifi_reg_rule *r = etsi;
+	int n = ARRAY_SIZE(etsi);
+
+	if (reg && !strcmp(reg, "US")) {
+		r = fcc;
+		n = ARRAY_SIZE(fcc);
+		memcpy(alpha2, "US", 3);
+	} else {
+		test_get_country(name, alpha2);
+	}
+
+	if (n > *num)
+		n = *num;
+
+	memcpy(rules, r, n * sizeof(*r));
+	*num = n;
+
+	return 0;
+}
+
+/* DFS events of LIBWIFI_TEST_DFS, a script of "<radio> <event> <chan>/<bw>"
+ * separated by ';', e.g. "test5 radar 100/80". Each event is got once, in
+ * order, as more are added to the end of the script; "<radio> lost" has
+ * the events got next seem lost. Unset it to start over.
+ */
+#define TEST_DFS_RADIOS		4
+
+static struct {
+	pthread_mutex_t lock;
+	char name[TEST_DFS_RADIOS][16];
+	int next[TEST_DFS_RADIOS];
+} test_dfs = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static int test_dfs_event_type(const char *s, enum wifi_dfs_event_type *t)
+{
+	static const char *names[] = {
+		[WIFI_DFS_EVENT_CAC_STARTED] = "cac_started",
+		[WIFI_DFS_EVENT_CAC_FINISHED] = "cac_finished",
+		[WIFI_DFS_EVENT_CAC_ABORTED] = "cac_aborted",
+		[WIFI_DFS_EVENT_RADAR] = "radar",
+		[WIFI_DFS_EVENT_NOP_FINISHED] = "nop_finished",
+		[WIFI_DFS_EVENT_PRE_CAC_EXPIRED] = "pre_cac_expired",
+	};
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(names); i++) {
+		if (!strcmp(s, names[i])) {
+			*t = i;
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+static int test_get_dfs_events(const char *name, struct wifi_dfs_event *ev,
+			       int *num)
+{
+	const char *script = getenv("LIBWIFI_TEST_DFS");
+	char radio[16], type[32];
+	unsigned int chan, bw;
+	char *buf, *item, *p;
+	int seen = 0;
+	int ret = 0;
+	int n = 0;
+	int r;
+
+	pthread_mutex_lock(&test_dfs.lock);
+	for (r = 0; r < TEST_DFS_RADIOS; r++) {
+		if (!test_dfs.name[r][0])
+			strncpy(test_dfs.name[r], name, sizeof(test_dfs.name[r]) - 1);
+		if (!strncmp(test_dfs.name[r], name, sizeof(test_dfs.name[r])))
+			break;
+	}
+
+	if (r == TEST_DFS_RADIOS) {
+		pthread_mutex_unlock(&test_dfs.lock);
+		return -ENOTSUP;
+	}
+
+	if (!script) {
+		test_dfs.next[r] = 0;
+		pthread_mutex_unlock(&test_dfs.lock);
+		*num = 0;
+		return 0;
+	}
+
+	buf = strdup(script);
+	if (!buf) {
+		pthread_mutex_unlock(&test_dfs.lock);
+		return -ENOMEM;
+	}
+
+	for (item = strtok_r(buf, ";", &p); item && n < *num;
+	     item = strtok_r(NULL, ";", &p)) {
+		if (sscanf(item, " %15s %31s %u/%u", radio, type, &chan, &bw) < 2 ||
+		    strcmp(radio, name) || seen++ < test_dfs.next[r])
+			continue;
+
+		test_dfs.next[r]++;
+		if (!strcmp(type, "lost")) {
+			ret = -ESTALE;
+			n = 0;
+			break;
+		}
+
+		if (test_dfs_event_type(type, &ev[n].type))
+			continue;
+
+		ev[n].channel = chan;
+		ev[n].bw = bw == 160 ? BW160 : bw == 80 ? BW80 :
+			   bw == 40 ? BW40 : BW20;
+		n++;
+	}
+
+	free(buf);
+	pthread_mutex_unlock(&test_dfs.lock);
+
+	*num = n;
+	return ret;
+}
+
 static int test_get_bandwidth(const char *ifname, enum wifi_bw *bw)
 {
 	GET_TEST_INT(*bw, ifname, bandwidth);
@@ -759,6 +1076,40 @@ static int test_acs(const char *ifname, struct acs_param *p)
 	return 0;
 }
 
+/* An event registration, notified through a pipe */
+struct test_event {
+	int pipefd[2];
+	struct event_struct req;
+	struct test_event *next;
+};
+
+static pthread_mutex_t test_event_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct test_event *test_events;
+
+/* Send a scan event to the registrations of ifname. LIBWIFI_TEST_SCAN set
+ * to "abort" aborts the scans, and to "none" never finishes them.
+ */
+static void test_scan_event(const char *ifname)
+{
+	const char *mode = getenv("LIBWIFI_TEST_SCAN");
+	struct test_event *e;
+	uint8_t type = WIFI_EVENT_SCAN_END;
+
+	if (mode && !strcmp(mode, "none"))
+		return;
+
+	if (mode && !strcmp(mode, "abort"))
+		type = WIFI_EVENT_SCAN_ABORT;
+
+	pthread_mutex_lock(&test_event_lock);
+	for (e = test_events; e; e = e->next) {
+		if (!strncmp(e->req.ifname, ifname, 16) &&
+		    write(e->pipefd[1], &type, 1) != 1)
+			libwifi_err("%s: event lost\n", ifname);
+	}
+	pthread_mutex_unlock(&test_event_lock);
+}
+
 int test_scan(const char *ifname, struct scan_param *p)
 {
 	if (p)
@@ -769,6 +1120,7 @@ int test_scan(const char *ifname, struct scan_param *p)
 	else
 		log_test("scan: { \"ifname\": \"%s\" }\n", ifname);
 
+	test_scan_event(ifname);
 	return 0;
 }
 
@@ -776,6 +1128,26 @@ int test_get_scan_results(const char *ifname, struct wifi_bss *bsss,
 						int *num)
 {
 	int buflen = 0;
+	int i;
+
+	/* neighbours on each 6GHz channel of the tri-band radio */
+	if (ifname_is_test6(ifname)) {
+		for (i = 0; i < test6_num_scanres && i < *num; i++) {
+			memset(&bsss[i], 0, sizeof(bsss[i]));
+			memcpy(bsss[i].bssid, "\x02\x66\x00\x00\x00\x00", 6);
+			bsss[i].bssid[4] = i >> 8;
+			bsss[i].bssid[5] = i & 0xff;
+			snprintf((char *)bsss[i].ssid, sizeof(bsss[i].ssid),
+				 "Test SSID 6Ghz %d", i);
+			bsss[i].band = BAND_6;
+			bsss[i].channel = 1 + 4 * (i % 59);
+			bsss[i].rssi = -50 - i % 40;
+			bsss[i].noise = test5_noise;
+		}
+
+		*num = i;
+		return 0;
+	}
 
 	GET_TEST_BUF(bsss, buflen, ifname, scanresults);
 	if (buflen)
@@ -784,6 +1156,100 @@ int test_get_scan_results(const char *ifname, struct wifi_bss *bsss,
 	return 0;
 }
 
+/* beacon IEs of a 6GHz neighbour, as WPA3 APs send them */
+static size_t test6_scanres_ies(int i, uint8_t *ies, size_t size)
+{
+	const uint8_t rates[] = { 0x8c, 0x12, 0x98, 0x24, 0xb0, 0x48, 0x60, 0x6c };
+	const uint8_t country[] = { 'D', 'E', 0x04, 0x01, 0x5d, 0x17 };
+	const uint8_t rsn[] = { 0x01, 0x00, 0x00, 0x0f, 0xac, 0x04, 0x01, 0x00,
+				0x00, 0x0f, 0xac, 0x04, 0x01, 0x00, 0x00, 0x0f,
+				0xac, 0x08, 0xc0, 0x00 };
+	const uint8_t wmm[] = { 0x00, 0x50, 0xf2, 0x02, 0x01, 0x01, 0x80, 0x00,
+				0x03, 0xa4, 0x00, 0x00, 0x27, 0xa4, 0x00, 0x00,
+				0x42, 0x43, 0x5e, 0x00, 0x62, 0x32, 0x2f, 0x00 };
+	uint8_t load[] = { i % 20, 0, (i * 7) % 256, 0x10, 0x27 };
+	uint8_t he_cap[27] = { IE_EXT_HE_CAP, 0x01, 0x08, 0x00, 0x12 };
+	uint8_t he_oper[10] = { 36, 0xf0, 0x3f, 0x00, 0xfc, 0xff, 0x02 };
+	uint8_t ext_cap[10] = { 0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x40 };
+	uint8_t rrm[5] = { 0x73, 0x00, 0x00, 0x00, 0x00 };
+	uint8_t tpe[5] = { 0x03, 0x2e, 0x2e, 0x2e, 0x2e };
+	uint8_t rnr[30] = { 0x00, 0x10, 0x51, 0x25, 0xff };
+	uint8_t mbo[7] = { 0x50, 0x6f, 0x9a, 0x16, 0x01, 0x01, 0x40 };
+	uint8_t rsnx = 0x20;
+	char ssid[33];
+	size_t len = 0;
+
+#define TEST_IE(_eid, _data, _len)					\
+	do {								\
+		if (len + 2 + (_len) > size)				\
+			return len;					\
+		ies[len] = (_eid);					\
+		ies[len + 1] = (_len);					\
+		memcpy(&ies[len + 2], (_data), (_len));			\
+		len += 2 + (_len);					\
+	} while (0)
+
+	snprintf(ssid, sizeof(ssid), "Test SSID 6Ghz %d", i);
+	TEST_IE(IE_SSID, ssid, strlen(ssid));
+	TEST_IE(IE_SUPP_RATES, rates, sizeof(rates));
+	TEST_IE(7, country, sizeof(country));
+	if (i % 2)
+		TEST_IE(IE_BSS_LOAD, load, sizeof(load));
+	TEST_IE(IE_RSN, rsn, sizeof(rsn));
+	TEST_IE(IE_RRM, rrm, sizeof(rrm));
+	TEST_IE(201, rnr, sizeof(rnr));		/* reduced neighbor report */
+	TEST_IE(IE_EXT_CAP, ext_cap, sizeof(ext_cap));
+	TEST_IE(195, tpe, sizeof(tpe));		/* transmit power envelope */
+	TEST_IE(IE_EXT, he_cap, sizeof(he_cap));
+	TEST_IE(IE_EXT, he_oper, sizeof(he_oper));
+	TEST_IE(244, &rsnx, 1);			/* RSN extension */
+	TEST_IE(IE_VEND_SPEC, wmm, sizeof(wmm));
+	TEST_IE(IE_VEND_SPEC, mbo, sizeof(mbo));
+
+#undef TEST_IE
+	return len;
+}
+
+int test_iterate_scan_ies(const char *ifname, struct wifi_scan_filter *f,
+			  int (*cb)(struct wifi_bss *bss, uint8_t *ies,
+				    size_t ies_len, void *priv),
+			  void *priv)
+{
+	struct wifi_bss bss;
+	uint8_t ies[512];
+	size_t len;
+	int i;
+
+	/* only the tri-band radio passes the IEs of its scan results */
+	if (!ifname_is_test6(ifname))
+		return -ENOTSUP;
+
+	for (i = 0; i < test6_num_scanres; i++) {
+		memset(&bss, 0, sizeof(bss));
+		memcpy(bss.bssid, "\x02\x66\x00\x00\x00\x00", 6);
+		bss.bssid[4] = i >> 8;
+		bss.bssid[5] = i & 0xff;
+		bss.band = BAND_6;
+		bss.channel = 1 + 4 * (i % 59);
+		bss.rssi = -50 - i % 40;
+		bss.noise = test5_noise;
+		bss.beacon_int = 100;
+		bss.caps.basic.cap = 0x1111;
+		bss.caps.valid |= WIFI_CAP_BASIC_VALID;
+
+		len = test6_scanres_ies(i, ies, sizeof(ies));
+		snprintf((char *)bss.ssid, sizeof(bss.ssid), "Test SSID 6Ghz %d", i);
+		wifi_get_bss_security_from_ies(&bss, ies, len);
+		if (!wifi_scan_filter_match(f, UINT32_MAX, &bss, -1))
+			continue;
+
+		if (cb(&bss, ies, len, priv))
+			break;
+	}
+
+	return 0;
+}
+
 int test_get_bss_scanresult(const char *ifname, uint8_t *bssid,
 						struct wifi_bss_detail *b)
 {
@@ -817,15 +1283,74 @@ int test_get_bss_scanresult(const char *ifname, uint8_t *bssid,
 int test_register_event(const char *ifname, struct event_struct *req,
 		void **handle)
 {
+	struct test_event *e;
+
 	log_test("register_event: { \"ifname\": \"%s\", \"family\": \"%s\", \"group\": \"%s\" }\n",
 			req->ifname, req->family, req->group);
+
+	e = calloc(1, sizeof(*e));
+	if (!e)
+		return -ENOMEM;
+
+	if (pipe(e->pipefd)) {
+		free(e);
+		return -errno;
+	}
+
+	fcntl(e->pipefd[0], F_SETFL, O_NONBLOCK);
+	fcntl(e->pipefd[1], F_SETFL, O_NONBLOCK);
+
+	memcpy(&e->req, req, sizeof(*req));
+	req->fd_monitor = e->pipefd[0];
+
+	pthread_mutex_lock(&test_event_lock);
+	e->next = test_events;
+	test_events = e;
+	pthread_mutex_unlock(&test_event_lock);
+
+	*handle = e;
+	return 0;
+}
+
+static int test_unregister_event(const char *ifname, void *handle)
+{
+	struct test_event *e, **pe;
+
+	log_test("unregister_event: { \"ifname\": \"%s\" }\n", ifname);
+
+	pthread_mutex_lock(&test_event_lock);
+	for (pe = &test_events; (e = *pe); pe = &e->next) {
+		if (e == handle) {
+			*pe = e->next;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&test_event_lock);
+
+	if (!e)
+		return -ENOENT;
+
+	close(e->pipefd[0]);
+	close(e->pipefd[1]);
+	free(e);
 	return 0;
 }
 
 int test_recv_event(const char *ifname, void *handle)
 {
+	struct test_event *e = handle;
+	uint8_t type;
+
 	log_test("recv_event: { \"ifname\": \"%s\" }\n", ifname);
-	return -1;
+
+	if (!e || read(e->pipefd[0], &type, 1) != 1)
+		return -1;
+
+	e->req.resp.type = type;
+	if (e->req.cb)
+		e->req.cb(&e->req);
+
+	return 0;
 }
 
 int test_driver_info(const char *name, struct wifi_metainfo *info)
@@ -896,6 +1421,7 @@ const struct wifi_driver test_driver = {
 	.scan = test_scan,
 	.get_scan_results = test_get_scan_results,
 	.get_bss_scan_result = test_get_bss_scanresult,
+	.iterate_scan_ies = test_iterate_scan_ies,
 	.get_bssid = test_get_bssid,
 	.get_ssid = test_get_ssid,
 	.get_maxrate = test_get_maxrate,
@@ -905,6 +1431,12 @@ const struct wifi_driver test_driver = {
 	.get_supp_channels = test_get_supp_channels,
 	.get_noise = test_get_noise,
 	.get_country = test_get_country,
+	.get_supp_band = test_get_supp_band,
+	.get_supp_bandwidths = test_get_supp_bandwidths,
+	.channels_info = test_channels_info,
+	.get_chan_gen = test_get_chan_gen,
+	.get_reg_rules = test_get_reg_rules,
+	.get_dfs_events = test_get_dfs_events,
 	.get_assoclist = test_get_assoclist,
 	.iface.ap_info = test_get_ap_info,
 	.radio.info = test_radio_info,
@@ -915,6 +1447,7 @@ const struct wifi_driver test_driver = {
 	.del_iface = test_del_iface,
 	.get_sta_info = test_get_sta_info,
 	.radio.get_stats = test_radio_get_stats,
+	.get_wmm_stats = test_radio_get_wmm_stats,
 	.iface.get_stats = test_ap_get_stats,
 	.disconnect_sta = test_disconnect_sta,
 	.monitor_sta = test_monitor_sta,
@@ -928,6 +1461,7 @@ const struct wifi_driver test_driver = {
 	.radio.get_param = test_radio_get_param,
 	.recv_event = test_recv_event,
 	.register_event = test_register_event,
+	.unregister_event = test_unregister_event,
 	.iface.get_caps = test_ap_get_caps,
 	.radio.get_caps = test_radio_get_caps,
 	/* .vendor_cmd = test_vendor_cmd, */
@@ -941,4 +1475,5 @@ const struct wifi_driver test_driver = {
 	.iface.del_vendor_ie = test_del_vendor_ie,
 	.iface.subscribe_frame = test_iface_subscribe_frame,
 	.iface.unsubscribe_frame = test_iface_unsubscribe_frame,
+	.get_stas_info = test_get_stas_info,
 };
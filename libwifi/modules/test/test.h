@@ -147,6 +147,7 @@ do {									\
 #define test5_bandwidth		BW80
 #define test5_extch		EXTCH_ABOVE
 #define test5_supp_bandwidth	BW160 | BW80 | BW40 | BW20
+#define test5_supp_bws		(1 << BW20) | (1 << BW40) | (1 << BW80) | (1 << BW160)
 #define test5_countrycode	"EU"
 #define test5_supp_channels	{36, 40, 44, 48, 52, 56, 60, 64, 100, 104, 108, 112, 116}
 #define test5_noise		-88
@@ -232,6 +233,26 @@ const struct wifi_ap_stats test5_ap_stats_data = {
 };
 #define test5_ap_stats	&test5_ap_stats_data
 
+const struct wifi_bss_wmm_stats test5_bss_wmm_stats_data[] = {
+	{
+		.ifname = "test5",
+		.bssid = "\xaa\xbb\xcc\xdd\xee\xff",
+		.ac = {
+			[BE] = { .tx_bytes = 4000000, .rx_bytes = 5000000,
+				.tx_pkts = 4000, .rx_pkts = 5000,
+				.tx_err_pkts = 100, .rx_err_pkts = 100, .tx_rtx_pkts = 400 },
+			[BK] = { .tx_bytes = 200000, .rx_bytes = 100000,
+				.tx_pkts = 200, .rx_pkts = 100, .tx_rtx_pkts = 1 },
+			[VI] = { .tx_bytes = 8000000, .rx_bytes = 800000,
+				.tx_pkts = 6000, .rx_pkts = 600,
+				.tx_err_pkts = 200, .tx_rtx_pkts = 600 },
+			[VO] = { .tx_bytes = 300000, .rx_bytes = 300000,
+				.tx_pkts = 2000, .rx_pkts = 2000, .tx_rtx_pkts = 2 },
+		},
+	},
+};
+#define test5_bss_wmm_stats	test5_bss_wmm_stats_data
+
 const struct wifi_caps test5_ap_caps_data = {
 	.valid = WIFI_CAP_BASIC_VALID | WIFI_CAP_EXT_VALID | \
 		 WIFI_CAP_HT_VALID | WIFI_CAP_VHT_VALID | WIFI_CAP_RM_VALID,
@@ -514,6 +535,7 @@ const struct sta_nbr test5_snbrs[] = {
 #define test2_bandwidth		BW20
 #define test2_extch		EXTCH_NONE
 #define test2_supp_bandwidth	BW40 | BW20
+#define test2_supp_bws		(1 << BW20) | (1 << BW40)
 #define test2_countrycode	"EU"
 #define test2_supp_channels	{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13}
 #define test2_noise		-92
@@ -599,6 +621,26 @@ const struct wifi_ap_stats test2_ap_stats_data = {
 };
 #define test2_ap_stats	&test2_ap_stats_data
 
+const struct wifi_bss_wmm_stats test2_bss_wmm_stats_data[] = {
+	{
+		.ifname = "test2",
+		.bssid = "\x00\x11\x22\x33\x44\x55",
+		.ac = {
+			[BE] = { .tx_bytes = 2000000, .rx_bytes = 2500000,
+				.tx_pkts = 2000, .rx_pkts = 2500,
+				.tx_err_pkts = 50, .rx_err_pkts = 50, .tx_rtx_pkts = 200 },
+			[BK] = { .tx_bytes = 100000, .rx_bytes = 50000,
+				.tx_pkts = 100, .rx_pkts = 50, .tx_rtx_pkts = 1 },
+			[VI] = { .tx_bytes = 4000000, .rx_bytes = 400000,
+				.tx_pkts = 3000, .rx_pkts = 300,
+				.tx_err_pkts = 100, .tx_rtx_pkts = 300 },
+			[VO] = { .tx_bytes = 150000, .rx_bytes = 150000,
+				.tx_pkts = 1000, .rx_pkts = 1000, .tx_rtx_pkts = 2 },
+		},
+	},
+};
+#define test2_bss_wmm_stats	test2_bss_wmm_stats_data
+
 const struct wifi_caps test2_ap_caps_data = {
 	.valid = WIFI_CAP_BASIC_VALID | WIFI_CAP_EXT_VALID | \
 		 WIFI_CAP_HT_VALID,
@@ -863,4 +905,17 @@ const struct wifi_monsta test2_monstas[] = {
 };
 #define test2_monitor_get	test2_monstas
 
+/* test data for a tri-band radio follows; it has the 2.4 and 5GHz channels
+ * of the above, all 20MHz 6GHz channels and more neighbours than fit a
+ * single scan results array of the other radios.
+ */
+#define test6_supp_bws		test5_supp_bws
+#define test6_max_channels	128
+#define test6_num_scanres	300
+
+static inline bool ifname_is_test6(const char *ifname)
+{
+	return strstr(ifname, "6") != NULL;
+}
+
 #endif /* TEST_WIFI_H */
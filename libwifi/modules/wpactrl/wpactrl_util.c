@@ -151,8 +151,10 @@ struct wpa_ctrl {
 
 static struct wpa_ctrl * wpa_ctrl_open(const char *ctrl_path)
 {
+	/* unique per process; a thread takes its own value of it */
+	static int counter = 0;
 	struct wpa_ctrl *ctrl;
-	static int counter = 0;		/* FIXME-CR */
+	int id;
 	int ret;
 	int tries = 0;
 	int flags;
@@ -173,13 +175,13 @@ static struct wpa_ctrl * wpa_ctrl_open(const char *ctrl_path)
 	}
 
 	ctrl->local.sun_family = AF_UNIX;
-	counter++;
+	id = __atomic_add_fetch(&counter, 1, __ATOMIC_RELAXED);
 try_again:
 	ret = snprintf(ctrl->local.sun_path,	/* Flawfinder: ignore */
 				sizeof(ctrl->local.sun_path),
 				CONFIG_CTRL_IFACE_CLIENT_DIR "/"
 				CONFIG_CTRL_IFACE_CLIENT_PREFIX "%d-%d",
-				(int) getpid(), counter);
+				(int) getpid(), id);
 
 	if (ret < 0 || (unsigned int) ret >= sizeof(ctrl->local.sun_path)) {
 		close(ctrl->s);
@@ -707,6 +709,7 @@ int hostapd_cli_iface_ap_info(const char *ifname, struct wifi_ap *ap)
 	size_t beacon_len = sizeof(beacon);
 	size_t ies_len;
 	struct beacon_frame *bf;
+	struct wifi_ie_index idx;
 
 	/* get beacon */
 	ret = hostapd_cli_get_beacon(ifname, beacon, &beacon_len);
@@ -720,10 +723,11 @@ int hostapd_cli_iface_ap_info(const char *ifname, struct wifi_ap *ap)
 	ies_len = beacon_len - ((uint8_t *)&bf->cap_info - beacon + 2);
 	beacon_ies = bf->var;
 
-	WARN_ON(wifi_oper_stds_set_from_ie(beacon_ies, ies_len, &ap->bss.oper_std));
-	WARN_ON(wifi_ssid_advertised_set_from_ie(beacon_ies, ies_len, &ap->ssid_advertised));
-	WARN_ON(wifi_get_bss_security_from_ies(&ap->bss, beacon_ies, ies_len));
-	WARN_ON(wifi_apload_set_from_ie(beacon_ies, ies_len, &ap->bss.load));
+	wifi_ie_index_build(&idx, beacon_ies, ies_len);
+	WARN_ON(wifi_oper_stds_set_from_ie_index(&idx, &ap->bss.oper_std));
+	WARN_ON(wifi_ssid_advertised_set_from_ie_index(&idx, &ap->ssid_advertised));
+	WARN_ON(wifi_get_bss_security_from_ie_index(&ap->bss, &idx));
+	WARN_ON(wifi_apload_set_from_ie_index(&idx, &ap->bss.load));
 	ap->bss.beacon_int = bf->beacon_int;
 
 	/* capabilities information */
@@ -733,7 +737,7 @@ int hostapd_cli_iface_ap_info(const char *ifname, struct wifi_ap *ap)
 	wifi_cap_set_from_ie(ap->bss.cbitmap, ie_ptr, sizeof(bf->cap_info));
 
 	/* ht capabilities */
-	ie_ptr = wifi_find_ie(beacon_ies, ies_len, IE_HT_CAP);
+	ie_ptr = wifi_ie_index_find(&idx, IE_HT_CAP);
 	if (ie_ptr) {
 		ap->bss.caps.valid |= WIFI_CAP_HT_VALID;
 		memcpy(&ap->bss.caps.ht, &ie_ptr[2], ie_ptr[1]);
@@ -741,7 +745,7 @@ int hostapd_cli_iface_ap_info(const char *ifname, struct wifi_ap *ap)
 	}
 
 	/* vht capabilities */
-	ie_ptr = wifi_find_ie(beacon_ies, ies_len, IE_VHT_CAP);
+	ie_ptr = wifi_ie_index_find(&idx, IE_VHT_CAP);
 	if (ie_ptr) {
 		ap->bss.caps.valid |= WIFI_CAP_VHT_VALID;
 		memcpy(&ap->bss.caps.vht, &ie_ptr[2], ie_ptr[1]);
@@ -749,7 +753,7 @@ int hostapd_cli_iface_ap_info(const char *ifname, struct wifi_ap *ap)
 	}
 
 	/* extended capabilities */
-	ie_ptr = wifi_find_ie(beacon_ies, ies_len, IE_EXT_CAP);
+	ie_ptr = wifi_ie_index_find(&idx, IE_EXT_CAP);
 	if (ie_ptr) {
 		ap->bss.caps.valid |= WIFI_CAP_EXT_VALID;
 		memcpy(&ap->bss.caps.ext, &ie_ptr[2], ie_ptr[1]);
@@ -757,7 +761,7 @@ int hostapd_cli_iface_ap_info(const char *ifname, struct wifi_ap *ap)
 	}
 
 	/* RM enabled capabilities */
-	ie_ptr = wifi_find_ie(beacon_ies, ies_len, IE_RRM);
+	ie_ptr = wifi_ie_index_find(&idx, IE_RRM);
 	if (ie_ptr) {
 		ap->bss.caps.valid |= WIFI_CAP_RM_VALID;
 		memcpy(&ap->bss.caps.ext, &ie_ptr[2], ie_ptr[1]);
@@ -765,13 +769,13 @@ int hostapd_cli_iface_ap_info(const char *ifname, struct wifi_ap *ap)
 	}
 
 	/* mobility domain element */
-	ie_ptr = wifi_find_ie(beacon_ies, ies_len, IE_MDE);
+	ie_ptr = wifi_ie_index_find(&idx, IE_MDE);
 	if (ie_ptr) {
 		wifi_cap_set_from_ie(ap->bss.cbitmap, ie_ptr, ie_ptr[1] + 2);
 	}
 
 	/* HE capabilities */
-	ie_ptr = wifi_find_ie_ext(beacon_ies, ies_len, IE_EXT_HE_CAP);
+	ie_ptr = wifi_ie_index_find_ext(&idx, IE_EXT_HE_CAP);
 	if (ie_ptr) {
 		ap->bss.caps.valid |= WIFI_CAP_HE_VALID;
 		memcpy(&ap->bss.caps.he, &ie_ptr[3], min(ie_ptr[1], sizeof(struct wifi_caps_he)));
@@ -779,7 +783,7 @@ int hostapd_cli_iface_ap_info(const char *ifname, struct wifi_ap *ap)
 	}
 
 	/* WMM */
-	ie_ptr = wifi_find_vsie(beacon_ies, ies_len, microsoft_oui, 2, 1);
+	ie_ptr = wifi_ie_index_find_vsie(&idx, microsoft_oui, 2, 1);
 	if (ie_ptr) {
 		wifi_wmm_set_from_ie(ap->ac, ie_ptr, ie_ptr[1] + 2);
 		wifi_cap_set_from_ie(ap->bss.cbitmap, ie_ptr, ie_ptr[1] + 2);
@@ -0,0 +1,447 @@
+/*
+ * monsta.c - unassociated stas tracked from their probe requests
+ *
+ * Every probe request received on an interface which is tracked, recorded
+ * by the driver as it comes in, apart from any frames subscribed to, or
+ * reported by the caller, updates the sta's entry: its latest rssi and
+ * EWMA, when last seen and the number of probes. The
+ * entry is found by its MAC in a hash table of the interface, and is also
+ * kept in a list by when seen. The number of stas per interface is
+ * bounded; the least recently seen sta makes room for a new one.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+#define MONSTA_ALPHA		25	/* % weight of a new rssi sample */
+#define MONSTA_MAX_STAS		256	/* per interface */
+
+/* EWMA values are kept scaled up for precision */
+#define EWMA_SCALE		16
+
+struct monsta_entry {
+	uint8_t macaddr[6];
+	int8_t rssi;				/* latest; 0 if unknown */
+	int32_t rssi_ewma;
+	uint64_t last_seen;			/* msecs */
+	uint32_t num_probes;
+	struct monsta_entry *hnext;		/* in hash bucket */
+	struct monsta_entry *prev, *next;	/* in age list, oldest first */
+};
+
+struct monsta_iface {
+	char ifname[16];
+	int alpha;
+	int max_stas;
+	int num;
+	bool frames;			/* probe requests tracked by the driver */
+	bool added;			/* or added by the caller */
+	unsigned int hash_size;		/* power of 2 */
+	struct monsta_entry **hash;
+	struct monsta_entry *oldest, *newest;
+	struct monsta_iface *next;
+};
+
+static struct monsta_iface *monsta_ifaces;
+static pthread_mutex_t monsta_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int monsta_hash(struct monsta_iface *i, const uint8_t *macaddr)
+{
+	uint32_t h = 2166136261u;
+	int k;
+
+	for (k = 0; k < 6; k++)
+		h = (h ^ macaddr[k]) * 16777619u;
+
+	return (h ^ (h >> 16)) & (i->hash_size - 1);
+}
+
+static struct monsta_iface *monsta_iface(const char *ifname)
+{
+	struct monsta_iface *i;
+
+	for (i = monsta_ifaces; i; i = i->next) {
+		if (!strncmp(i->ifname, ifname, sizeof(i->ifname)))
+			return i;
+	}
+
+	return NULL;
+}
+
+static struct monsta_entry *monsta_lookup(struct monsta_iface *i,
+					  const uint8_t *macaddr)
+{
+	struct monsta_entry *e;
+
+	for (e = i->hash[monsta_hash(i, macaddr)]; e; e = e->hnext) {
+		if (!memcmp(e->macaddr, macaddr, 6))
+			return e;
+	}
+
+	return NULL;
+}
+
+static void monsta_hash_unlink(struct monsta_iface *i, struct monsta_entry *del)
+{
+	struct monsta_entry *e, **pe;
+
+	for (pe = &i->hash[monsta_hash(i, del->macaddr)]; (e = *pe);
+	     pe = &e->hnext) {
+		if (e == del) {
+			*pe = e->hnext;
+			return;
+		}
+	}
+}
+
+static void monsta_age_unlink(struct monsta_iface *i, struct monsta_entry *e)
+{
+	if (e->prev)
+		e->prev->next = e->next;
+	else
+		i->oldest = e->next;
+
+	if (e->next)
+		e->next->prev = e->prev;
+	else
+		i->newest = e->prev;
+
+	e->prev = e->next = NULL;
+}
+
+static void monsta_age_append(struct monsta_iface *i, struct monsta_entry *e)
+{
+	e->prev = i->newest;
+	e->next = NULL;
+	if (i->newest)
+		i->newest->next = e;
+	else
+		i->oldest = e;
+
+	i->newest = e;
+}
+
+/* Hash buckets for up to 'max_stas', rehashing the stas kept */
+static int monsta_rehash(struct monsta_iface *i, int max_stas)
+{
+	struct monsta_entry **hash;
+	struct monsta_entry *e;
+	unsigned int size = 16;
+	unsigned int h;
+
+	while (size < (unsigned int)max_stas)
+		size <<= 1;
+
+	if (size == i->hash_size)
+		return 0;
+
+	hash = calloc(size, sizeof(*hash));
+	if (!hash)
+		return -ENOMEM;
+
+	free(i->hash);
+	i->hash = hash;
+	i->hash_size = size;
+
+	for (e = i->oldest; e; e = e->next) {
+		h = monsta_hash(i, e->macaddr);
+		e->hnext = i->hash[h];
+		i->hash[h] = e;
+	}
+
+	return 0;
+}
+
+static void monsta_evict(struct monsta_iface *i)
+{
+	struct monsta_entry *e = i->oldest;
+
+	monsta_hash_unlink(i, e);
+	monsta_age_unlink(i, e);
+	i->num--;
+	free(e);
+}
+
+static void monsta_flush(struct monsta_iface *i)
+{
+	while (i->oldest)
+		monsta_evict(i);
+}
+
+static int64_t ewma(int64_t avg, int64_t v, int alpha, bool first)
+{
+	v *= EWMA_SCALE;
+	if (first)
+		return v;
+
+	return avg + (v - avg) * alpha / 100;
+}
+
+/* Round a scaled EWMA value to nearest */
+static int64_t ewma_get(int64_t avg)
+{
+	return (avg + (avg < 0 ? -EWMA_SCALE / 2 : EWMA_SCALE / 2)) / EWMA_SCALE;
+}
+
+static void monsta_record(struct monsta_iface *i, const uint8_t *macaddr,
+			  int8_t rssi, uint64_t now)
+{
+	struct monsta_entry *e;
+	unsigned int h;
+
+	e = monsta_lookup(i, macaddr);
+	if (e) {
+		monsta_age_unlink(i, e);
+	} else if (i->num >= i->max_stas) {
+		/* reuse the least recently seen */
+		e = i->oldest;
+		monsta_hash_unlink(i, e);
+		monsta_age_unlink(i, e);
+		memset(e, 0, sizeof(*e));
+	} else {
+		e = calloc(1, sizeof(*e));
+		if (!e)
+			return;
+
+		i->num++;
+	}
+
+	if (!e->num_probes) {
+		memcpy(e->macaddr, macaddr, 6);
+		h = monsta_hash(i, macaddr);
+		e->hnext = i->hash[h];
+		i->hash[h] = e;
+	}
+
+	if (rssi) {
+		e->rssi_ewma = (int32_t)ewma(e->rssi_ewma, rssi, i->alpha,
+					     !e->rssi);
+		e->rssi = rssi;
+	}
+
+	e->last_seen = now;
+	e->num_probes++;
+	monsta_age_append(i, e);
+}
+
+static void monsta_get(struct monsta_iface *i, struct monsta_entry *e,
+		       struct wifi_monsta *mon, uint64_t now)
+{
+	uint64_t age = now > e->last_seen ? (now - e->last_seen) / 1000 : 0;
+
+	memset(mon, 0, sizeof(*mon));
+	memcpy(mon->macaddr, e->macaddr, 6);
+	mon->rssi[0] = e->rssi;
+	mon->rssi_avg = (int8_t)ewma_get(e->rssi_ewma);
+	mon->last_seen = age > INT32_MAX ? INT32_MAX : (int)age;
+	mon->num_probes = e->num_probes;
+}
+
+/* Stas are got from here once probe requests are tracked by the driver or added */
+bool wifi_monsta_tracked(const char *ifname)
+{
+	struct monsta_iface *i;
+	bool tracked;
+
+	pthread_mutex_lock(&monsta_lock);
+	i = monsta_iface(ifname);
+	tracked = i && (i->frames || i->added);
+	pthread_mutex_unlock(&monsta_lock);
+
+	return tracked;
+}
+
+void wifi_monsta_record_frames(const char *ifname, struct wifi_rx_frame *f,
+			       int num)
+{
+	struct monsta_iface *i;
+	int k;
+
+	pthread_mutex_lock(&monsta_lock);
+	i = monsta_iface(ifname);
+	for (k = 0; i && k < num; k++) {
+		/* probe requests, from the sa of their header */
+		if (f[k].len < 24 || (f[k].frame[0] & 0xfc) != 0x40 ||
+		    (f[k].frame[10] & 0x01))
+			continue;
+
+		monsta_record(i, &f[k].frame[10], (int8_t)f[k].rssi,
+			      f[k].rx_time);
+	}
+	pthread_mutex_unlock(&monsta_lock);
+}
+
+int wifi_monsta_get(const char *ifname, uint8_t *sta, struct wifi_monsta *mon)
+{
+	struct monsta_iface *i;
+	struct monsta_entry *e;
+	int ret = -ENOENT;
+
+	if (!sta || !mon)
+		return -EINVAL;
+
+	pthread_mutex_lock(&monsta_lock);
+	i = monsta_iface(ifname);
+	e = i ? monsta_lookup(i, sta) : NULL;
+	if (e) {
+		monsta_get(i, e, mon, time_monotonic_msecs());
+		ret = 0;
+	}
+	pthread_mutex_unlock(&monsta_lock);
+
+	return ret;
+}
+
+/* Get the stas most recently seen first */
+int wifi_monsta_get_all(const char *ifname, struct wifi_monsta *stas, int *num)
+{
+	struct monsta_iface *i;
+	struct monsta_entry *e;
+	uint64_t now;
+	int n = 0;
+
+	if (!stas || !num)
+		return -EINVAL;
+
+	now = time_monotonic_msecs();
+	pthread_mutex_lock(&monsta_lock);
+	i = monsta_iface(ifname);
+	for (e = i ? i->newest : NULL; e && n < *num; e = e->prev)
+		monsta_get(i, e, &stas[n++], now);
+	pthread_mutex_unlock(&monsta_lock);
+
+	*num = n;
+	return 0;
+}
+
+int wifi_monsta_config(const char *ifname, int alpha, int max_stas)
+{
+	struct monsta_iface *i;
+	bool frames;
+	int ret;
+
+	if (!ifname || alpha < 0 || alpha > 100 || max_stas < 0)
+		return -EINVAL;
+
+	if (!alpha)
+		alpha = MONSTA_ALPHA;
+
+	if (!max_stas)
+		max_stas = MONSTA_MAX_STAS;
+
+	pthread_mutex_lock(&monsta_lock);
+	i = monsta_iface(ifname);
+	if (!i) {
+		i = calloc(1, sizeof(*i));
+		if (!i || monsta_rehash(i, max_stas)) {
+			pthread_mutex_unlock(&monsta_lock);
+			free(i);
+			return -ENOMEM;
+		}
+
+		strncpy(i->ifname, ifname, sizeof(i->ifname) - 1);
+		i->next = monsta_ifaces;
+		monsta_ifaces = i;
+	}
+
+	while (i->num > max_stas)
+		monsta_evict(i);
+
+	ret = monsta_rehash(i, max_stas);
+	if (!ret) {
+		i->alpha = alpha;
+		i->max_stas = max_stas;
+	}
+
+	frames = i->frames;
+	pthread_mutex_unlock(&monsta_lock);
+
+	if (ret || frames)
+		return ret;
+
+	/* recorded as received, else added by the caller, e.g. from events */
+	ret = wifi_track_probe_req(ifname, true);
+	if (ret) {
+		libwifi_dbg("[%s] %s: probe requests not tracked (%d)\n",
+			    ifname, __func__, ret);
+		return 0;
+	}
+
+	pthread_mutex_lock(&monsta_lock);
+	i = monsta_iface(ifname);
+	if (i)
+		i->frames = true;
+	pthread_mutex_unlock(&monsta_lock);
+
+	return 0;
+}
+
+int wifi_monsta_add(const char *ifname, uint8_t *macaddr, int8_t rssi)
+{
+	struct monsta_iface *i;
+	int ret = -ENOENT;
+
+	if (!ifname || !macaddr)
+		return -EINVAL;
+
+	pthread_mutex_lock(&monsta_lock);
+	i = monsta_iface(ifname);
+	if (i) {
+		monsta_record(i, macaddr, rssi, time_monotonic_msecs());
+		i->added = true;
+		ret = 0;
+	}
+	pthread_mutex_unlock(&monsta_lock);
+
+	return ret;
+}
+
+void wifi_monsta_stop(const char *ifname)
+{
+	struct monsta_iface *i, **pi;
+	bool frames = false;
+
+	if (!ifname)
+		return;
+
+	pthread_mutex_lock(&monsta_lock);
+	for (pi = &monsta_ifaces; (i = *pi); pi = &i->next) {
+		if (strncmp(i->ifname, ifname, sizeof(i->ifname)))
+			continue;
+
+		*pi = i->next;
+		frames = i->frames;
+		monsta_flush(i);
+		free(i->hash);
+		free(i);
+		break;
+	}
+	pthread_mutex_unlock(&monsta_lock);
+
+	if (frames)
+		wifi_track_probe_req(ifname, false);
+}
@@ -0,0 +1,248 @@
+/*
+ * opclass_cache.c - per-radio cache of channels and operating class tables
+ *
+ * The channels of a radio, and the supported and preferred operating
+ * classes derived from them, are kept until the driver reports that the
+ * radio's regulatory, DFS or channel state may have changed, or they are
+ * flushed. Drivers which can't report it get nothing cached.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+struct opclass_cache_table {
+	bool valid;
+	uint32_t ticket;	/* of the miss to put the table for */
+	int num;
+	int max;		/* number asked for when got */
+	void *data;
+};
+
+struct opclass_cache {
+	char name[16];
+	uint32_t gen;
+	uint32_t ticket;
+	struct opclass_cache_table t[OPCLASS_CACHE_NUM];
+	struct wifi_opclass_cache_stats stats;
+	struct opclass_cache *next;
+};
+
+static struct opclass_cache *opclass_cache_list;
+static pthread_mutex_t opclass_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool opclass_cache_enabled = true;
+
+static struct opclass_cache *opclass_cache_lookup(const char *name,
+						  bool create)
+{
+	struct opclass_cache *c;
+
+	for (c = opclass_cache_list; c; c = c->next) {
+		if (!strncmp(c->name, name, sizeof(c->name)))
+			return c;
+	}
+
+	if (!create)
+		return NULL;
+
+	c = calloc(1, sizeof(*c));
+	if (!c)
+		return NULL;
+
+	strncpy(c->name, name, sizeof(c->name) - 1);
+	c->next = opclass_cache_list;
+	opclass_cache_list = c;
+
+	return c;
+}
+
+static void opclass_cache_clear(struct opclass_cache *c)
+{
+	int i;
+
+	for (i = 0; i < OPCLASS_CACHE_NUM; i++) {
+		if (c->t[i].valid)
+			c->stats.flush++;
+
+		free(c->t[i].data);
+		memset(&c->t[i], 0, sizeof(c->t[i]));
+	}
+}
+
+/* Copy a cached table of 'name' to 'out' of '*num' entries of 'size' bytes.
+ * Returns 0 if it is cached, -ENOENT if not, with the ticket to put the
+ * table with, or another error if it can't be cached.
+ */
+int wifi_opclass_cache_get(const char *name, enum opclass_cache_type type,
+			   void *out, int *num, size_t size, uint32_t *ticket)
+{
+	struct opclass_cache_table *t;
+	struct opclass_cache *c;
+	uint32_t gen;
+	bool hit;
+	int ret;
+
+	if (!name || !out || !num || *num <= 0)
+		return -EINVAL;
+
+	ret = wifi_get_chan_gen(name, &gen);
+	if (ret)
+		return ret;
+
+	pthread_mutex_lock(&opclass_cache_lock);
+	if (!opclass_cache_enabled) {
+		pthread_mutex_unlock(&opclass_cache_lock);
+		return -EPERM;
+	}
+
+	c = opclass_cache_lookup(name, true);
+	if (!c) {
+		pthread_mutex_unlock(&opclass_cache_lock);
+		return -ENOMEM;
+	}
+
+	if (c->gen != gen) {
+		opclass_cache_clear(c);
+		c->gen = gen;
+	}
+
+	/* a table cut short is good for the same size only */
+	t = &c->t[type];
+	hit = t->valid && (t->num < t->max ? *num >= t->num : *num == t->max);
+	if (!hit) {
+		t->ticket = ++c->ticket ? c->ticket : ++c->ticket;
+		*ticket = t->ticket;
+		c->stats.miss++;
+		pthread_mutex_unlock(&opclass_cache_lock);
+		return -ENOENT;
+	}
+
+	memcpy(out, t->data, (size_t)t->num * size);
+	*num = t->num;
+	c->stats.hit++;
+	pthread_mutex_unlock(&opclass_cache_lock);
+
+	return 0;
+}
+
+/* Cache a table got after a miss of wifi_opclass_cache_get(), unless the
+ * cache was flushed or missed again since
+ */
+void wifi_opclass_cache_put(const char *name, enum opclass_cache_type type,
+			    uint32_t ticket, const void *in, int num, int max,
+			    size_t size)
+{
+	struct opclass_cache_table *t;
+	struct opclass_cache *c;
+	void *data;
+
+	if (num < 0)
+		return;
+
+	data = malloc(num ? (size_t)num * size : 1);
+	if (!data)
+		return;
+
+	memcpy(data, in, (size_t)num * size);
+
+	pthread_mutex_lock(&opclass_cache_lock);
+	c = opclass_cache_lookup(name, false);
+	if (!c || c->t[type].ticket != ticket) {
+		pthread_mutex_unlock(&opclass_cache_lock);
+		free(data);
+		return;
+	}
+
+	t = &c->t[type];
+	free(t->data);
+	t->data = data;
+	t->num = num;
+	t->max = max;
+	t->ticket = 0;
+	t->valid = true;
+	pthread_mutex_unlock(&opclass_cache_lock);
+}
+
+/* Drop a table of 'name' which is out of date for other reasons than its
+ * channel state, e.g. preferences after new scan results
+ */
+void wifi_opclass_cache_drop(const char *name, enum opclass_cache_type type)
+{
+	struct opclass_cache *c;
+
+	pthread_mutex_lock(&opclass_cache_lock);
+	c = opclass_cache_lookup(name, false);
+	if (c) {
+		if (c->t[type].valid)
+			c->stats.flush++;
+
+		free(c->t[type].data);
+		memset(&c->t[type], 0, sizeof(c->t[type]));
+	}
+	pthread_mutex_unlock(&opclass_cache_lock);
+}
+
+void wifi_opclass_cache_flush(const char *name)
+{
+	struct opclass_cache *c;
+
+	pthread_mutex_lock(&opclass_cache_lock);
+	for (c = opclass_cache_list; c; c = c->next) {
+		if (!name || !strncmp(c->name, name, sizeof(c->name)))
+			opclass_cache_clear(c);
+	}
+	pthread_mutex_unlock(&opclass_cache_lock);
+}
+
+int wifi_opclass_cache_config(bool enable)
+{
+	pthread_mutex_lock(&opclass_cache_lock);
+	opclass_cache_enabled = enable;
+	pthread_mutex_unlock(&opclass_cache_lock);
+
+	if (!enable)
+		wifi_opclass_cache_flush(NULL);
+
+	return 0;
+}
+
+int wifi_get_opclass_cache_stats(const char *name,
+				 struct wifi_opclass_cache_stats *s)
+{
+	struct opclass_cache *c;
+
+	if (!name || !s)
+		return -EINVAL;
+
+	memset(s, 0, sizeof(*s));
+	pthread_mutex_lock(&opclass_cache_lock);
+	c = opclass_cache_lookup(name, false);
+	if (c)
+		memcpy(s, &c->stats, sizeof(*s));
+	pthread_mutex_unlock(&opclass_cache_lock);
+
+	return 0;
+}
@@ -0,0 +1,384 @@
+/*
+ * regdb.c - regulatory rules of radios as enforced by their drivers
+ *
+ * The rules of a radio are got from its driver once, sorted by frequency
+ * and kept until the driver reports that the radio's regulatory, DFS or
+ * channel state may have changed, e.g. on a regulatory domain change.
+ * Validity of a channel at a bandwidth, and the power allowed on it, are
+ * then found by a binary search of the rules. Drivers which can't give
+ * their rules are left to the static country tables in chlist.c.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+struct regdb {
+	char name[16];
+	bool valid;		/* driver reports changes; kept till the next */
+	uint32_t gen;
+	char alpha2[3];
+	int num;
+	struct wifi_reg_rule rule[WIFI_REG_RULES_MAX];
+	uint32_t span[WIFI_REG_RULES_MAX];	/* of contiguous rules, kHz */
+	struct regdb *next;
+};
+
+static struct regdb *regdb_list;
+static pthread_mutex_t regdb_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct regdb *regdb_lookup(const char *name, bool create)
+{
+	struct regdb *r;
+
+	for (r = regdb_list; r; r = r->next) {
+		if (!strncmp(r->name, name, sizeof(r->name)))
+			return r;
+	}
+
+	if (!create)
+		return NULL;
+
+	r = calloc(1, sizeof(*r));
+	if (!r)
+		return NULL;
+
+	strncpy(r->name, name, sizeof(r->name) - 1);
+	r->next = regdb_list;
+	regdb_list = r;
+
+	return r;
+}
+
+static int regdb_rule_cmp(const void *a, const void *b)
+{
+	const struct wifi_reg_rule *ra = a;
+	const struct wifi_reg_rule *rb = b;
+
+	if (ra->start_freq != rb->start_freq)
+		return ra->start_freq < rb->start_freq ? -1 : 1;
+
+	return 0;
+}
+
+/* Width of the run of contiguous rules each rule is in, which a rule
+ * with auto bandwidth may use up to
+ */
+static void regdb_set_span(struct regdb *r)
+{
+	int first = 0;
+	int i, j;
+
+	for (i = 1; i <= r->num; i++) {
+		if (i < r->num && r->rule[i].start_freq == r->rule[i - 1].end_freq)
+			continue;
+
+		for (j = first; j < i; j++)
+			r->span[j] = r->rule[i - 1].end_freq - r->rule[first].start_freq;
+
+		first = i;
+	}
+}
+
+/* Get the rules of 'name' up to date. Returns 0 with the lock held. */
+static int regdb_get(const char *name, struct regdb **out)
+{
+	struct wifi_reg_rule *rules;
+	char alpha2[3] = {0};
+	bool has_gen = false;
+	struct regdb *r;
+	uint32_t gen = 0;
+	int num;
+	int ret;
+
+	if (!wifi_get_chan_gen(name, &gen))
+		has_gen = true;
+
+	pthread_mutex_lock(&regdb_lock);
+	r = regdb_lookup(name, false);
+	if (r && r->valid && r->gen == gen) {
+		*out = r;
+		return 0;
+	}
+	pthread_mutex_unlock(&regdb_lock);
+
+	rules = calloc(WIFI_REG_RULES_MAX, sizeof(*rules));
+	if (!rules)
+		return -ENOMEM;
+
+	num = WIFI_REG_RULES_MAX;
+	ret = wifi_get_reg_rules(name, alpha2, rules, &num);
+	if (ret || num <= 0) {
+		free(rules);
+		return ret ? ret : -ENOENT;
+	}
+
+	qsort(rules, (size_t)num, sizeof(*rules), regdb_rule_cmp);
+
+	pthread_mutex_lock(&regdb_lock);
+	r = regdb_lookup(name, true);
+	if (!r) {
+		pthread_mutex_unlock(&regdb_lock);
+		free(rules);
+		return -ENOMEM;
+	}
+
+	memcpy(r->rule, rules, (size_t)num * sizeof(*rules));
+	memcpy(r->alpha2, alpha2, 2);
+	r->num = num;
+	r->gen = gen;
+	r->valid = has_gen;
+	regdb_set_span(r);
+	free(rules);
+
+	*out = r;
+	return 0;
+}
+
+/* Check the range 'lo' to 'hi' kHz against the rules; it must be within a
+ * run of contiguous rules, no wider than any of them allows.
+ */
+static int regdb_check_range(struct regdb *r, uint32_t lo, uint32_t hi,
+			     struct wifi_reg_rule *out)
+{
+	struct wifi_reg_rule res = {0};
+	struct wifi_reg_rule *rule;
+	int l = 0, h = r->num - 1;
+	uint32_t max_bw;
+	int i = -1;
+	int m;
+
+	/* last rule starting at or below 'lo' */
+	while (l <= h) {
+		m = (l + h) / 2;
+		if (r->rule[m].start_freq <= lo) {
+			i = m;
+			l = m + 1;
+		} else {
+			h = m - 1;
+		}
+	}
+
+	if (i < 0 || r->rule[i].end_freq <= lo)
+		return -ENOENT;
+
+	res.start_freq = r->rule[i].start_freq;
+	res.max_bw = UINT32_MAX;
+	res.max_eirp = INT32_MAX;
+
+	for (;; i++) {
+		rule = &r->rule[i];
+		max_bw = rule->flags & WIFI_REG_RULE_AUTO_BW ?
+				r->span[i] : rule->max_bw;
+		if (hi - lo > max_bw)
+			return -ENOENT;
+
+		res.end_freq = rule->end_freq;
+		res.flags |= rule->flags;
+		res.max_bw = min(res.max_bw, max_bw);
+		res.max_eirp = min(res.max_eirp, rule->max_eirp);
+		res.cac_time = max(res.cac_time, rule->cac_time);
+
+		if (hi <= rule->end_freq)
+			break;
+
+		if (i + 1 >= r->num || r->rule[i + 1].start_freq != rule->end_freq)
+			return -ENOENT;
+	}
+
+	if (out)
+		memcpy(out, &res, sizeof(res));
+
+	return 0;
+}
+
+/* check a range of MHz, as the rules are in kHz */
+static int regdb_check_mhz(struct regdb *r, int lo, int hi,
+			   struct wifi_reg_rule *out)
+{
+	return regdb_check_range(r, (uint32_t)lo * 1000, (uint32_t)hi * 1000,
+				 out);
+}
+
+static int regdb_check(struct regdb *r, enum wifi_band band, uint32_t channel,
+		       enum wifi_bw bw, struct wifi_reg_rule *out)
+{
+	int lo = INT32_MAX, hi = 0;
+	const int *chans;
+	int width;
+	int freq;
+	int first;
+
+	if (bw < BW20 || bw > BW160 || channel > 255)
+		return -EINVAL;
+
+	width = 20 << bw;
+	freq = wifi_channel_to_freq_ex((int)channel, band);
+	if (freq < 0)
+		return -EINVAL;
+
+	switch (band) {
+	case BAND_2:
+		if (bw > BW40)
+			return -ENOENT;
+
+		if (bw == BW20)
+			break;
+
+		/* either secondary channel will do */
+		if (!regdb_check_mhz(r, freq - 10, freq + 30, out))
+			return 0;
+
+		return regdb_check_mhz(r, freq - 30, freq + 10, out);
+	case BAND_5:
+		if (bw == BW20)
+			break;
+
+		chans = chan2list((int)channel, width);
+		if (!chans)
+			return -ENOENT;
+
+		for (; *chans; chans++) {
+			freq = wifi_channel_to_freq_ex(*chans, band);
+			lo = min(lo, freq - 10);
+			hi = max(hi, freq + 10);
+		}
+
+		return regdb_check_mhz(r, lo, hi, out);
+	case BAND_6:
+		/* channel groups are aligned from channel 1 */
+		first = ((int)channel - 1) / 4;
+		first -= first % (width / 20);
+		lo = 5950 + 5 * (1 + 4 * first) - 10;
+		return regdb_check_mhz(r, lo, lo + width, out);
+	default:
+		return -EINVAL;
+	}
+
+	return regdb_check_mhz(r, freq - 10, freq + 10, out);
+}
+
+int wifi_regdb_check_channel(const char *name, enum wifi_band band,
+			     uint32_t channel, enum wifi_bw bw,
+			     struct wifi_reg_rule *rule)
+{
+	struct regdb *r;
+	int ret;
+
+	if (!name)
+		return -EINVAL;
+
+	ret = regdb_get(name, &r);
+	if (ret)
+		return ret;
+
+	ret = regdb_check(r, band, channel, bw, rule);
+	pthread_mutex_unlock(&regdb_lock);
+
+	return ret;
+}
+
+int wifi_regdb_get_max_power(const char *name, enum wifi_band band,
+			     uint32_t channel, enum wifi_bw bw, int *eirp)
+{
+	struct wifi_reg_rule rule;
+	int ret;
+
+	if (!eirp)
+		return -EINVAL;
+
+	ret = wifi_regdb_check_channel(name, band, channel, bw, &rule);
+	if (ret)
+		return ret;
+
+	*eirp = rule.max_eirp / 100;
+	return 0;
+}
+
+/* Check 'num' channels of 'name' at a bandwidth in one go, for the rules
+ * of country 'cc' if not empty. Returns -ENOENT if the radio's rules are
+ * for another country.
+ */
+int wifi_regdb_check_channels(const char *name, const char *cc,
+			      enum wifi_band band, enum wifi_bw bw,
+			      const uint32_t *chs, int num, bool *valid)
+{
+	struct regdb *r;
+	int ret;
+	int i;
+
+	if (!name || !chs || !valid)
+		return -EINVAL;
+
+	ret = regdb_get(name, &r);
+	if (ret)
+		return ret;
+
+	if (cc && cc[0] != '\0' && strncmp(cc, r->alpha2, 2)) {
+		pthread_mutex_unlock(&regdb_lock);
+		return -ENOENT;
+	}
+
+	for (i = 0; i < num; i++)
+		valid[i] = !regdb_check(r, band, chs[i], bw, NULL);
+
+	pthread_mutex_unlock(&regdb_lock);
+
+	return 0;
+}
+
+int wifi_regdb_get_rules(const char *name, char *alpha2,
+			 struct wifi_reg_rule *rules, int *num)
+{
+	struct regdb *r;
+	int ret;
+
+	if (!name || !alpha2 || !rules || !num || *num <= 0)
+		return -EINVAL;
+
+	ret = regdb_get(name, &r);
+	if (ret)
+		return ret;
+
+	memcpy(alpha2, r->alpha2, 3);
+	*num = min(*num, r->num);
+	memcpy(rules, r->rule, (size_t)*num * sizeof(*rules));
+	pthread_mutex_unlock(&regdb_lock);
+
+	return 0;
+}
+
+void wifi_regdb_flush(const char *name)
+{
+	struct regdb *r;
+
+	pthread_mutex_lock(&regdb_lock);
+	for (r = regdb_list; r; r = r->next) {
+		if (!name || !strncmp(r->name, name, sizeof(r->name)))
+			r->valid = false;
+	}
+	pthread_mutex_unlock(&regdb_lock);
+}
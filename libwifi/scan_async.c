@@ -0,0 +1,516 @@
+/*
+ * scan_async.c - non-blocking scans with completion callbacks
+ *
+ * A scan requested by wifi_scan_async() is triggered at once if its ifname
+ * is not scanning already, else it is queued behind the scans in progress
+ * on that ifname. Completion is learnt from the driver's scan events; the
+ * event fds of all ifnames with pending scans, and a timer for the scan
+ * timeouts, are gathered behind a single fd, got by wifi_scan_async_fd().
+ * The caller polls that fd in its event loop and calls
+ * wifi_scan_async_process() when it is readable, which reads the events,
+ * runs the callbacks of the finished scans and starts the queued ones.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+#include "easy.h"
+#include "debug.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+#define SCAN_ASYNC_NUM_BSS	128	/* room for results at first */
+
+struct wifi_scan_req {
+	char ifname[16];
+	struct scan_param_ex sp;
+	bool has_sp;
+	uint64_t deadline;	/* 0 if none */
+	wifi_scan_cb_t cb;
+	void *userdata;
+	bool cancelled;
+	int status;
+	struct wifi_scan_req *next;
+};
+
+/* scans of an ifname; exists while it has scans pending */
+struct scan_iface {
+	char ifname[16];
+	struct event_struct ev;
+	void *evhandle;
+	uint32_t event;			/* last scan end/abort event got */
+	struct wifi_scan_req *active;	/* scan in progress */
+	struct wifi_scan_req *queue;	/* scans waiting to be triggered */
+	struct scan_iface *next;
+};
+
+static pthread_mutex_t scan_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct scan_iface *scan_ifaces;
+static int scan_epfd = -1;
+static int scan_tfd = -1;
+
+static int scan_event_cb(struct event_struct *ev)
+{
+	struct scan_iface *s = ev->priv;
+
+	if (ev->resp.type == WIFI_EVENT_SCAN_END ||
+	    ev->resp.type == WIFI_EVENT_SCAN_ABORT)
+		s->event = ev->resp.type;
+
+	return 0;
+}
+
+static int scan_fds_init(void)
+{
+	struct epoll_event e = { .events = EPOLLIN };
+
+	if (scan_epfd >= 0)
+		return 0;
+
+	scan_epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (scan_epfd < 0)
+		return -errno;
+
+	scan_tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (scan_tfd < 0 || epoll_ctl(scan_epfd, EPOLL_CTL_ADD, scan_tfd, &e)) {
+		if (scan_tfd >= 0)
+			close(scan_tfd);
+		close(scan_epfd);
+		scan_epfd = scan_tfd = -1;
+		return -errno;
+	}
+
+	return 0;
+}
+
+static struct scan_iface *scan_iface_get(const char *ifname)
+{
+	struct epoll_event e = { .events = EPOLLIN };
+	struct scan_iface *s;
+
+	for (s = scan_ifaces; s; s = s->next) {
+		if (!strncmp(s->ifname, ifname, sizeof(s->ifname)))
+			return s;
+	}
+
+	s = calloc(1, sizeof(*s));
+	if (!s)
+		return NULL;
+
+	strncpy(s->ifname, ifname, sizeof(s->ifname) - 1);
+	strncpy(s->ev.ifname, ifname, sizeof(s->ev.ifname) - 1);
+	strncpy(s->ev.family, "nl80211", sizeof(s->ev.family) - 1);
+	strncpy(s->ev.group, "scan", sizeof(s->ev.group) - 1);
+	s->ev.cb = scan_event_cb;
+	s->ev.priv = s;
+	s->ev.fd_monitor = -1;
+
+	if (wifi_register_event(ifname, &s->ev, &s->evhandle) ||
+	    s->ev.fd_monitor < 0) {
+		libwifi_err("%s: no scan events\n", ifname);
+		if (s->evhandle)
+			wifi_unregister_event(ifname, s->evhandle);
+		free(s);
+		return NULL;
+	}
+
+	if (epoll_ctl(scan_epfd, EPOLL_CTL_ADD, s->ev.fd_monitor, &e)) {
+		wifi_unregister_event(ifname, s->evhandle);
+		free(s);
+		return NULL;
+	}
+
+	s->next = scan_ifaces;
+	scan_ifaces = s;
+	return s;
+}
+
+static void scan_iface_put(struct scan_iface *s)
+{
+	struct scan_iface **ps;
+
+	if (s->active || s->queue)
+		return;
+
+	for (ps = &scan_ifaces; *ps; ps = &(*ps)->next) {
+		if (*ps == s) {
+			*ps = s->next;
+			break;
+		}
+	}
+
+	epoll_ctl(scan_epfd, EPOLL_CTL_DEL, s->ev.fd_monitor, NULL);
+	wifi_unregister_event(s->ifname, s->evhandle);
+	free(s);
+}
+
+/* Read the events got so far on an ifname */
+static void scan_iface_recv(struct scan_iface *s)
+{
+	struct pollfd pfd = { .fd = s->ev.fd_monitor, .events = POLLIN };
+
+	while (poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN)) {
+		if (wifi_recv_event(s->ifname, s->evhandle) < 0)
+			break;
+	}
+}
+
+static void scan_done(struct wifi_scan_req *req, int status,
+		      struct wifi_scan_req ***tail)
+{
+	req->status = status;
+	req->next = NULL;
+	**tail = req;
+	*tail = &req->next;
+}
+
+static int scan_trigger(struct wifi_scan_req *req)
+{
+	if (req->has_sp)
+		return wifi_scan_ex(req->ifname, &req->sp);
+
+	return wifi_scan(req->ifname, NULL);
+}
+
+/* Start the first queued scan of an idle ifname. A scan which fails to
+ * start is done, but one refused as busy stays queued, and is retried
+ * after the next scan event.
+ */
+static void scan_iface_kick(struct scan_iface *s, struct wifi_scan_req ***tail)
+{
+	struct wifi_scan_req *req;
+	int ret;
+
+	if (s->active || !s->queue)
+		return;
+
+	/* drop the events of earlier scans, not to take them for ours */
+	scan_iface_recv(s);
+
+	while (!s->active && (req = s->queue)) {
+		s->event = 0;
+		ret = scan_trigger(req);
+		if (ret == -EBUSY)
+			break;
+
+		s->queue = req->next;
+		if (ret) {
+			scan_done(req, ret, tail);
+			continue;
+		}
+
+		req->next = NULL;
+		s->active = req;
+	}
+}
+
+static uint64_t scan_next_deadline(uint64_t next, struct wifi_scan_req *req)
+{
+	if (req && req->deadline && (!next || req->deadline < next))
+		return req->deadline;
+
+	return next;
+}
+
+static void scan_timer_arm(void)
+{
+	struct itimerspec its = {0};
+	struct wifi_scan_req *req;
+	struct scan_iface *s;
+	uint64_t next = 0;
+
+	for (s = scan_ifaces; s; s = s->next) {
+		next = scan_next_deadline(next, s->active);
+		for (req = s->queue; req; req = req->next)
+			next = scan_next_deadline(next, req);
+	}
+
+	if (next) {
+		/* msecs are rounded down; don't wake up before the deadline */
+		next++;
+		its.it_value.tv_sec = (time_t)(next / 1000);
+		its.it_value.tv_nsec = (long)(next % 1000) * 1000000;
+	}
+
+	timerfd_settime(scan_tfd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+/* Collect the finished scans, and those past their deadline */
+static void scan_collect(struct scan_iface *s, uint64_t now,
+			 struct wifi_scan_req ***tail)
+{
+	struct wifi_scan_req *req, **preq;
+
+	scan_iface_recv(s);
+
+	if (s->active && s->event) {
+		req = s->active;
+		s->active = NULL;
+		scan_done(req, s->event == WIFI_EVENT_SCAN_END ?
+			  0 : -ECONNABORTED, tail);
+	}
+
+	if (s->active && s->active->deadline && now >= s->active->deadline) {
+		req = s->active;
+		s->active = NULL;
+		scan_done(req, -ETIMEDOUT, tail);
+	}
+
+	preq = &s->queue;
+	while ((req = *preq)) {
+		if (req->deadline && now >= req->deadline) {
+			*preq = req->next;
+			scan_done(req, -ETIMEDOUT, tail);
+			continue;
+		}
+
+		preq = &req->next;
+	}
+}
+
+/* results of the scans delivered, in room doubled as needed */
+struct scan_results {
+	struct wifi_bss *bss;
+	int num;
+	int max;
+	bool nomem;
+};
+
+static int scan_results_add(struct wifi_bss *bss, void *priv)
+{
+	struct scan_results *r = priv;
+	struct wifi_bss *n;
+	int max;
+
+	if (r->num == r->max) {
+		max = r->max ? r->max * 2 : SCAN_ASYNC_NUM_BSS;
+		n = realloc(r->bss, (size_t)max * sizeof(*n));
+		if (!n) {
+			r->nomem = true;
+			return -1;
+		}
+
+		r->bss = n;
+		r->max = max;
+	}
+
+	memcpy(&r->bss[r->num++], bss, sizeof(*bss));
+	return 0;
+}
+
+static void scan_deliver(struct wifi_scan_req *done)
+{
+	struct scan_results r = {0};
+	struct wifi_scan_req *req;
+
+	while ((req = done)) {
+		done = req->next;
+
+		if (req->cancelled) {
+			free(req);
+			continue;
+		}
+
+		r.num = 0;
+		r.nomem = false;
+		if (!req->status &&
+		    wifi_iterate_scan_results(req->ifname, NULL,
+					      scan_results_add, &r))
+			req->status = -EIO;
+
+		if (r.nomem)
+			req->status = -ENOMEM;
+
+		req->cb(req, req->status, req->status ? NULL : r.bss,
+			req->status ? 0 : r.num, req->userdata);
+		free(req);
+	}
+
+	free(r.bss);
+}
+
+struct wifi_scan_req *wifi_scan_async(const char *ifname,
+				      struct scan_param_ex *sp,
+				      uint32_t timeout, wifi_scan_cb_t cb,
+				      void *userdata)
+{
+	struct wifi_scan_req *done = NULL, **tail = &done;
+	struct wifi_scan_req *req, **preq;
+	struct scan_iface *s;
+
+	if (!ifname || !cb)
+		return NULL;
+
+	req = calloc(1, sizeof(*req));
+	if (!req)
+		return NULL;
+
+	strncpy(req->ifname, ifname, sizeof(req->ifname) - 1);
+	if (sp) {
+		memcpy(&req->sp, sp, sizeof(*sp));
+		req->has_sp = true;
+	}
+
+	if (timeout)
+		req->deadline = time_monotonic_msecs() + timeout;
+
+	req->cb = cb;
+	req->userdata = userdata;
+
+	pthread_mutex_lock(&scan_lock);
+	if (scan_fds_init() || !(s = scan_iface_get(ifname))) {
+		pthread_mutex_unlock(&scan_lock);
+		free(req);
+		return NULL;
+	}
+
+	for (preq = &s->queue; *preq; preq = &(*preq)->next)
+		;
+	*preq = req;
+
+	scan_iface_kick(s, &tail);
+	for (preq = &done; *preq; preq = &(*preq)->next) {
+		if (*preq == req) {
+			/* failed to start; the caller learns it from here */
+			libwifi_dbg("%s: scan failed: %d\n", ifname, req->status);
+			*preq = req->next;
+			free(req);
+			req = NULL;
+			break;
+		}
+	}
+
+	scan_iface_put(s);
+	scan_timer_arm();
+	pthread_mutex_unlock(&scan_lock);
+
+	/* queued scans which failed to start once this one was added */
+	scan_deliver(done);
+
+	return req;
+}
+
+int wifi_scan_async_fd(void)
+{
+	int ret;
+
+	pthread_mutex_lock(&scan_lock);
+	ret = scan_fds_init();
+	if (!ret)
+		ret = scan_epfd;
+	pthread_mutex_unlock(&scan_lock);
+
+	return ret;
+}
+
+int wifi_scan_async_process(void)
+{
+	struct wifi_scan_req *done = NULL, **tail = &done;
+	struct scan_iface *s, *s_next;
+	uint64_t expires;
+
+	pthread_mutex_lock(&scan_lock);
+	if (scan_epfd < 0) {
+		pthread_mutex_unlock(&scan_lock);
+		return 0;
+	}
+
+	if (read(scan_tfd, &expires, sizeof(expires)) < 0 && errno != EAGAIN)
+		libwifi_dbg("scan timer: %s\n", strerror(errno));
+
+	for (s = scan_ifaces; s; s = s->next)
+		scan_collect(s, time_monotonic_msecs(), &tail);
+
+	for (;;) {
+		/* get the results before the next scan starts; callbacks may
+		 * request new scans
+		 */
+		if (done) {
+			pthread_mutex_unlock(&scan_lock);
+			scan_deliver(done);
+			pthread_mutex_lock(&scan_lock);
+			done = NULL;
+			tail = &done;
+		}
+
+		for (s = scan_ifaces; s; s = s->next)
+			scan_iface_kick(s, &tail);
+
+		if (!done)
+			break;
+	}
+
+	for (s = scan_ifaces; s; s = s_next) {
+		s_next = s->next;
+		scan_iface_put(s);
+	}
+
+	scan_timer_arm();
+	pthread_mutex_unlock(&scan_lock);
+
+	return 0;
+}
+
+int wifi_scan_async_cancel(struct wifi_scan_req *req)
+{
+	struct wifi_scan_req **preq;
+	struct scan_iface *s;
+	int ret = -ENOENT;
+
+	if (!req)
+		return -EINVAL;
+
+	pthread_mutex_lock(&scan_lock);
+	for (s = scan_ifaces; s; s = s->next) {
+		if (s->active == req) {
+			/* the driver finishes it before the next one starts */
+			req->cancelled = true;
+			ret = 0;
+			break;
+		}
+
+		for (preq = &s->queue; *preq; preq = &(*preq)->next) {
+			if (*preq == req) {
+				*preq = req->next;
+				free(req);
+				ret = 0;
+				break;
+			}
+		}
+
+		if (!ret) {
+			scan_iface_put(s);
+			break;
+		}
+	}
+
+	if (!ret)
+		scan_timer_arm();
+	pthread_mutex_unlock(&scan_lock);
+
+	return ret;
+}
@@ -0,0 +1,267 @@
+/*
+ * scanres.c - scan results kept compact, with their IEs in one arena
+ *
+ * A struct wifi_bss_detail holds 1KB of IEs and a struct wifi_bss all that
+ * is decoded from them, though most beacons carry a few hundred bytes of
+ * IEs. Here each scan result is kept as the few fields not got from its
+ * IEs, and the IEs as sent, back to back in an arena which grows as
+ * needed. The rest of struct wifi_bss is decoded from the IEs of a scan
+ * result only when asked for.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+#define SCANRES_NUM		64
+#define SCANRES_ARENA_SIZE	16384
+
+struct scanres_ctx {
+	struct wifi_scanres *r;
+	int ret;
+};
+
+static int scanres_grow(struct wifi_scanres *r, size_t len)
+{
+	if (r->num >= r->max) {
+		int max = r->max ? r->max * 2 : SCANRES_NUM;
+		struct wifi_scanres_bss *n;
+
+		n = realloc(r->bss, (size_t)max * sizeof(*n));
+		if (!n)
+			return -ENOMEM;
+
+		r->bss = n;
+		r->max = max;
+	}
+
+	/* IEs are found by a 32-bit offset */
+	if (r->arena_len + len > UINT32_MAX)
+		return -ENOMEM;
+
+	if (r->arena_len + len > r->arena_size) {
+		size_t size = r->arena_size ? r->arena_size : SCANRES_ARENA_SIZE;
+		uint8_t *n;
+
+		while (r->arena_len + len > size)
+			size *= 2;
+
+		n = realloc(r->arena, size);
+		if (!n)
+			return -ENOMEM;
+
+		r->arena = n;
+		r->arena_size = size;
+	}
+
+	return 0;
+}
+
+/* what isn't got from the IEs of a scan result */
+static struct wifi_scanres_bss *scanres_add(struct scanres_ctx *ctx,
+					    struct wifi_bss *bss, size_t len)
+{
+	struct wifi_scanres *r = ctx->r;
+	struct wifi_scanres_bss *s;
+
+	ctx->ret = scanres_grow(r, len);
+	if (ctx->ret)
+		return NULL;
+
+	s = &r->bss[r->num++];
+	memset(s, 0, sizeof(*s));
+	memcpy(s->bssid, bss->bssid, 6);
+	s->channel = bss->channel;
+	s->band = bss->band;
+	s->rssi = (int8_t)bss->rssi;
+	s->noise = (int8_t)bss->noise;
+	s->beacon_int = (uint16_t)bss->beacon_int;
+	if (bss->caps.valid & WIFI_CAP_BASIC_VALID) {
+		s->capability = bss->caps.basic.cap;
+		s->flags |= WIFI_SCANRES_CAP;
+	}
+	s->ie_off = (uint32_t)r->arena_len;
+	r->arena_len += len;
+
+	return s;
+}
+
+static int scanres_add_ies(struct wifi_bss *bss, uint8_t *ies, size_t ies_len,
+			   void *priv)
+{
+	struct wifi_scanres_bss *s;
+
+	if (ies_len > UINT16_MAX)
+		ies_len = UINT16_MAX;
+
+	s = scanres_add(priv, bss, ies_len);
+	if (!s)
+		return -1;
+
+	s->ie_len = (uint16_t)ies_len;
+	if (ies_len)
+		memcpy(((struct scanres_ctx *)priv)->r->arena + s->ie_off, ies, ies_len);
+
+	return 0;
+}
+
+static int scanres_add_bss(struct wifi_bss *bss, void *priv)
+{
+	struct wifi_scanres_bss *s;
+
+	s = scanres_add(priv, bss, sizeof(*bss));
+	if (!s)
+		return -1;
+
+	s->flags |= WIFI_SCANRES_BSS;
+	memcpy(((struct scanres_ctx *)priv)->r->arena + s->ie_off, bss, sizeof(*bss));
+
+	return 0;
+}
+
+int wifi_get_scanres(const char *ifname, struct wifi_scan_filter *f,
+		     struct wifi_scanres *r)
+{
+	struct scanres_ctx ctx = { .r = r };
+	int ret;
+
+	if (!r)
+		return -EINVAL;
+
+	r->num = 0;
+	r->arena_len = 0;
+
+	ret = wifi_iterate_scan_ies(ifname, f, scanres_add_ies, &ctx);
+	if (ret == -ENOTSUP)
+		ret = wifi_iterate_scan_results(ifname, f, scanres_add_bss, &ctx);
+
+	if (!ret)
+		ret = ctx.ret;
+
+	if (ret) {
+		r->num = 0;
+		r->arena_len = 0;
+	}
+
+	return ret;
+}
+
+uint8_t *wifi_scanres_get_ies(struct wifi_scanres *r, int i, size_t *len)
+{
+	struct wifi_scanres_bss *s;
+
+	if (!r || i < 0 || i >= r->num)
+		return NULL;
+
+	s = &r->bss[i];
+	if (s->flags & WIFI_SCANRES_BSS)
+		return NULL;
+
+	if (len)
+		*len = s->ie_len;
+
+	return r->arena + s->ie_off;
+}
+
+int wifi_scanres_get_bss(struct wifi_scanres *r, int i, struct wifi_bss *bss)
+{
+	struct wifi_scanres_bss *s;
+	struct wifi_ie_index idx;
+
+	if (!r || !bss || i < 0 || i >= r->num)
+		return -EINVAL;
+
+	s = &r->bss[i];
+	if (s->flags & WIFI_SCANRES_BSS) {
+		memcpy(bss, r->arena + s->ie_off, sizeof(*bss));
+		return 0;
+	}
+
+	memset(bss, 0, sizeof(*bss));
+	memcpy(bss->bssid, s->bssid, 6);
+	bss->channel = s->channel;
+	bss->band = s->band;
+	bss->rssi = s->rssi;
+	bss->noise = s->noise;
+	bss->beacon_int = s->beacon_int;
+	if (s->flags & WIFI_SCANRES_CAP) {
+		bss->caps.basic.cap = s->capability;
+		bss->caps.valid |= WIFI_CAP_BASIC_VALID;
+	}
+
+	wifi_ie_index_build(&idx, r->arena + s->ie_off, s->ie_len);
+	wifi_bss_set_from_ie_index(bss, &idx);
+
+	return 0;
+}
+
+int wifi_scanres_get_bss_detail(struct wifi_scanres *r, int i,
+				struct wifi_bss_detail *b)
+{
+	uint8_t *ies, *ie;
+	size_t len = 0;
+	int ret;
+
+	if (!b)
+		return -EINVAL;
+
+	ret = wifi_scanres_get_bss(r, i, &b->basic);
+	if (ret)
+		return ret;
+
+	/* whole elements only */
+	b->ielen = 0;
+	ies = wifi_scanres_get_ies(r, i, &len);
+	if (!ies)
+		return 0;
+
+	wifi_foreach_ie(ie, ies, len) {
+		if (ie - ies + 2 + ie[1] > sizeof(b->ie))
+			break;
+
+		b->ielen = (uint32_t)(ie - ies + 2 + ie[1]);
+	}
+
+	memcpy(b->ie, ies, b->ielen);
+	return 0;
+}
+
+size_t wifi_scanres_size(struct wifi_scanres *r)
+{
+	if (!r)
+		return 0;
+
+	return (size_t)r->max * sizeof(*r->bss) + r->arena_size;
+}
+
+void wifi_scanres_free(struct wifi_scanres *r)
+{
+	if (!r)
+		return;
+
+	free(r->bss);
+	free(r->arena);
+	memset(r, 0, sizeof(*r));
+}
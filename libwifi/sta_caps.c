@@ -0,0 +1,265 @@
+/*
+ * sta_caps.c - cache of sta capabilities captured at association
+ *
+ * A sta's capabilities are parsed by the drivers from its (re)assoc request
+ * IEs, which don't change for the lifetime of the association. They are
+ * kept here per (ifname, macaddr), so that the IEs are fetched and parsed
+ * only once per association. An entry is dropped as soon as the sta is
+ * seen to have reassociated, i.e. when the start of its association as per
+ * its conn_time moves, or to be gone from the interface. At most
+ * STA_CAPS_MAX_STAS stas are kept per interface, the least recently used
+ * making room for a new one.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+#define STA_CAPS_HASHSIZE	32
+#define sta_caps_hash(m)	((m)[5] & (STA_CAPS_HASHSIZE - 1))
+
+#define STA_CAPS_MAX_STAS	128	/* per interface */
+#define STA_CAPS_ASSOC_SLACK	2000	/* msecs; conn_time is in secs */
+
+struct sta_caps_entry {
+	char ifname[16];
+	uint8_t macaddr[6];
+	uint64_t assoc_time;	/* association start, 0 if unknown */
+	uint64_t last_used;
+	uint8_t cbitmap[16];
+	struct wifi_caps caps;
+	uint32_t maxrate;
+	struct wifi_rate rate;
+	struct sta_caps_entry *next;
+};
+
+static struct sta_caps_entry *sta_caps_cache[STA_CAPS_HASHSIZE];
+static pthread_mutex_t sta_caps_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct sta_caps_entry **sta_caps_lookup(const char *ifname,
+					       uint8_t *macaddr)
+{
+	struct sta_caps_entry *e, **pe;
+
+	for (pe = &sta_caps_cache[sta_caps_hash(macaddr)]; (e = *pe);
+	     pe = &e->next) {
+		if (!memcmp(e->macaddr, macaddr, 6) &&
+		    !strncmp(e->ifname, ifname, sizeof(e->ifname)))
+			return pe;
+	}
+
+	return NULL;
+}
+
+/* Start of an association 'conn_time' secs old at 'now' msecs, or 0 if
+ * unknown, i.e. the driver doesn't report conn_time.
+ */
+static uint64_t sta_caps_assoc_time(uint32_t conn_time, uint64_t now)
+{
+	uint64_t t = (uint64_t)conn_time * 1000;
+
+	if (!conn_time)
+		return 0;
+
+	return now > t ? now - t : 1;
+}
+
+/* Fill in the cached capabilities of 'sta', looked up by its macaddr.
+ * Returns -ENOENT if the driver has to parse them, i.e. if there is no
+ * entry, or if the sta has reassociated since, as per its conn_time.
+ */
+static int sta_caps_get(const char *ifname, struct wifi_sta *sta, uint64_t now)
+{
+	struct sta_caps_entry *e, **pe;
+	uint64_t assoc_time;
+	uint32_t valid;
+	int i;
+
+	pe = sta_caps_lookup(ifname, sta->macaddr);
+	if (!pe)
+		return -ENOENT;
+
+	e = *pe;
+	assoc_time = sta_caps_assoc_time(sta->conn_time, now);
+	if ((!assoc_time != !e->assoc_time) ||
+	    (assoc_time > e->assoc_time + STA_CAPS_ASSOC_SLACK) ||
+	    (e->assoc_time > assoc_time + STA_CAPS_ASSOC_SLACK)) {
+		*pe = e->next;
+		free(e);
+		return -ENOENT;
+	}
+
+	e->last_used = now;
+
+	for (i = 0; i < sizeof(e->cbitmap); i++)
+		sta->cbitmap[i] |= e->cbitmap[i];
+
+	if (e->caps.valid) {
+		valid = sta->caps.valid;
+		memcpy(&sta->caps, &e->caps, sizeof(sta->caps));
+		sta->caps.valid |= valid;
+	}
+
+	if (e->maxrate)
+		sta->maxrate = e->maxrate;
+
+	if (e->rate.rate)
+		memcpy(&sta->rate, &e->rate, sizeof(sta->rate));
+
+	return 0;
+}
+
+int wifi_sta_caps_get(const char *ifname, struct wifi_sta *sta, uint64_t now)
+{
+	int ret;
+
+	pthread_mutex_lock(&sta_caps_lock);
+	ret = sta_caps_get(ifname, sta, now);
+	pthread_mutex_unlock(&sta_caps_lock);
+
+	return ret;
+}
+
+/* Drop the least recently used sta of 'ifname' if it has the max stas */
+static void sta_caps_evict(const char *ifname)
+{
+	struct sta_caps_entry *e, **pe, **oldest = NULL;
+	int num = 0;
+	int i;
+
+	for (i = 0; i < STA_CAPS_HASHSIZE; i++) {
+		for (pe = &sta_caps_cache[i]; (e = *pe); pe = &e->next) {
+			if (strncmp(e->ifname, ifname, sizeof(e->ifname)))
+				continue;
+
+			num++;
+			if (!oldest || e->last_used < (*oldest)->last_used)
+				oldest = pe;
+		}
+	}
+
+	if (num < STA_CAPS_MAX_STAS || !oldest)
+		return;
+
+	e = *oldest;
+	*oldest = e->next;
+	free(e);
+}
+
+/* Store the capabilities of a sta, as parsed from its assoc request into
+ * an otherwise zeroed 'caps'.
+ */
+static void sta_caps_put(const char *ifname, uint8_t *macaddr,
+			 uint32_t conn_time, struct wifi_sta *caps,
+			 uint64_t now)
+{
+	struct sta_caps_entry *e, **pe;
+
+	pe = sta_caps_lookup(ifname, macaddr);
+	if (pe) {
+		e = *pe;
+	} else {
+		sta_caps_evict(ifname);
+		e = calloc(1, sizeof(*e));
+		if (!e)
+			return;
+
+		strncpy(e->ifname, ifname, sizeof(e->ifname) - 1);
+		memcpy(e->macaddr, macaddr, 6);
+		e->next = sta_caps_cache[sta_caps_hash(macaddr)];
+		sta_caps_cache[sta_caps_hash(macaddr)] = e;
+	}
+
+	e->assoc_time = sta_caps_assoc_time(conn_time, now);
+	e->last_used = now;
+	memcpy(e->cbitmap, caps->cbitmap, sizeof(e->cbitmap));
+	memcpy(&e->caps, &caps->caps, sizeof(e->caps));
+	e->maxrate = caps->maxrate;
+	memcpy(&e->rate, &caps->rate, sizeof(e->rate));
+}
+
+void wifi_sta_caps_put(const char *ifname, uint8_t *macaddr,
+		       uint32_t conn_time, struct wifi_sta *caps, uint64_t now)
+{
+	pthread_mutex_lock(&sta_caps_lock);
+	sta_caps_put(ifname, macaddr, conn_time, caps, now);
+	pthread_mutex_unlock(&sta_caps_lock);
+}
+
+/* Drop the cached capabilities of a sta, or of all stas if addr is NULL */
+void wifi_sta_caps_del(const char *ifname, uint8_t *addr)
+{
+	struct sta_caps_entry *e, **pe;
+	int i;
+
+	pthread_mutex_lock(&sta_caps_lock);
+	for (i = 0; i < STA_CAPS_HASHSIZE; i++) {
+		pe = &sta_caps_cache[i];
+		while ((e = *pe)) {
+			if (!strncmp(e->ifname, ifname, sizeof(e->ifname)) &&
+			    (!addr || !memcmp(e->macaddr, addr, 6))) {
+				*pe = e->next;
+				free(e);
+				continue;
+			}
+
+			pe = &e->next;
+		}
+	}
+	pthread_mutex_unlock(&sta_caps_lock);
+}
+
+/* Drop the cached capabilities of the stas of 'ifname' not in 'stas' */
+void wifi_sta_caps_expire(const char *ifname, struct wifi_sta *stas, int num)
+{
+	struct sta_caps_entry *e, **pe;
+	int i, k;
+
+	pthread_mutex_lock(&sta_caps_lock);
+	for (i = 0; i < STA_CAPS_HASHSIZE; i++) {
+		pe = &sta_caps_cache[i];
+		while ((e = *pe)) {
+			if (strncmp(e->ifname, ifname, sizeof(e->ifname))) {
+				pe = &e->next;
+				continue;
+			}
+
+			for (k = 0; k < num; k++) {
+				if (!memcmp(e->macaddr, stas[k].macaddr, 6))
+					break;
+			}
+
+			if (k == num) {
+				*pe = e->next;
+				free(e);
+				continue;
+			}
+
+			pe = &e->next;
+		}
+	}
+	pthread_mutex_unlock(&sta_caps_lock);
+}
@@ -0,0 +1,334 @@
+/*
+ * sta_history.c - per-sta history of rssi, snr and rate samples
+ *
+ * Every sta info fetched through libwifi, or reported by the caller, adds
+ * a sample to the sta's history, which keeps a ring of the most recent
+ * samples and their EWMA. The number of stas tracked per interface is
+ * bounded; the least recently sampled sta makes room for a new one.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+#define STA_HISTORY_ALPHA	25	/* % weight of a new sample */
+#define STA_HISTORY_MAX_STAS	128	/* per interface */
+
+/* EWMA values are kept scaled up for precision */
+#define EWMA_SCALE		16
+
+struct sta_history_iface {
+	char ifname[16];
+	int alpha;
+	int max_stas;
+	int num_stas;
+	struct sta_history_iface *next;
+};
+
+struct sta_history_entry {
+	char ifname[16];
+	uint8_t macaddr[6];
+	int32_t rssi_ewma;
+	int32_t snr_ewma;
+	int64_t tx_rate_ewma;
+	int64_t rx_rate_ewma;
+	uint32_t num_samples;
+	int head;		/* next slot in ring */
+	int num;
+	struct wifi_sta_sample ring[WIFI_STA_HISTORY_LEN];
+	struct sta_history_entry *next;
+};
+
+static struct sta_history_iface *history_ifaces;
+static struct sta_history_entry *history_list;
+static pthread_mutex_t history_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct sta_history_iface *sta_history_iface(const char *ifname,
+						   bool create)
+{
+	struct sta_history_iface *i;
+
+	for (i = history_ifaces; i; i = i->next) {
+		if (!strncmp(i->ifname, ifname, sizeof(i->ifname)))
+			return i;
+	}
+
+	if (!create)
+		return NULL;
+
+	i = calloc(1, sizeof(*i));
+	if (!i)
+		return NULL;
+
+	strncpy(i->ifname, ifname, sizeof(i->ifname) - 1);
+	i->alpha = STA_HISTORY_ALPHA;
+	i->max_stas = STA_HISTORY_MAX_STAS;
+	i->next = history_ifaces;
+	history_ifaces = i;
+
+	return i;
+}
+
+static struct sta_history_entry *sta_history_lookup(const char *ifname,
+						    uint8_t *macaddr)
+{
+	struct sta_history_entry *e;
+
+	for (e = history_list; e; e = e->next) {
+		if (!memcmp(e->macaddr, macaddr, 6) &&
+		    !strncmp(e->ifname, ifname, sizeof(e->ifname)))
+			return e;
+	}
+
+	return NULL;
+}
+
+static void sta_history_unlink(struct sta_history_entry *del)
+{
+	struct sta_history_entry *e, **pe;
+	struct sta_history_iface *i;
+
+	for (pe = &history_list; (e = *pe); pe = &e->next) {
+		if (e != del)
+			continue;
+
+		*pe = e->next;
+		i = sta_history_iface(e->ifname, false);
+		if (i)
+			i->num_stas--;
+
+		free(e);
+		return;
+	}
+}
+
+/* Evict the sta of 'ifname' which has not been sampled for the longest */
+static bool sta_history_evict(const char *ifname)
+{
+	struct sta_history_entry *e, *oldest = NULL;
+	uint64_t t, tmin = UINT64_MAX;
+
+	for (e = history_list; e; e = e->next) {
+		if (strncmp(e->ifname, ifname, sizeof(e->ifname)))
+			continue;
+
+		t = e->num ? e->ring[(e->head + WIFI_STA_HISTORY_LEN - 1) %
+				     WIFI_STA_HISTORY_LEN].tstamp : 0;
+		if (t < tmin) {
+			tmin = t;
+			oldest = e;
+		}
+	}
+
+	if (!oldest)
+		return false;
+
+	sta_history_unlink(oldest);
+	return true;
+}
+
+static int64_t ewma(int64_t avg, int64_t v, int alpha, bool first)
+{
+	v *= EWMA_SCALE;
+	if (first)
+		return v;
+
+	return avg + (v - avg) * alpha / 100;
+}
+
+/* Round a scaled EWMA value to nearest */
+static int64_t ewma_get(int64_t avg)
+{
+	return (avg + (avg < 0 ? -EWMA_SCALE / 2 : EWMA_SCALE / 2)) / EWMA_SCALE;
+}
+
+static void sta_history_record(const char *ifname, struct wifi_sta *sta,
+			       uint64_t now)
+{
+	struct sta_history_entry *e;
+	struct sta_history_iface *i;
+	struct wifi_sta_sample *s;
+	bool first;
+
+	if (!sta->rssi_avg)
+		return;
+
+	i = sta_history_iface(ifname, true);
+	if (!i)
+		return;
+
+	e = sta_history_lookup(ifname, sta->macaddr);
+	if (!e) {
+		while (i->num_stas >= i->max_stas && sta_history_evict(ifname))
+			;
+
+		e = calloc(1, sizeof(*e));
+		if (!e)
+			return;
+
+		strncpy(e->ifname, ifname, sizeof(e->ifname) - 1);
+		memcpy(e->macaddr, sta->macaddr, 6);
+		e->next = history_list;
+		history_list = e;
+		i->num_stas++;
+	}
+
+	s = &e->ring[e->head];
+	s->tstamp = now;
+	s->rssi = sta->rssi_avg;
+	s->snr = sta->noise_avg ? (int8_t)(sta->rssi_avg - sta->noise_avg) : 0;
+	s->tx_rate = sta->tx_rate.rate;
+	s->rx_rate = sta->rx_rate.rate;
+
+	first = e->num_samples == 0;
+	e->rssi_ewma = (int32_t)ewma(e->rssi_ewma, s->rssi, i->alpha, first);
+	e->snr_ewma = (int32_t)ewma(e->snr_ewma, s->snr, i->alpha, first);
+	e->tx_rate_ewma = ewma(e->tx_rate_ewma, s->tx_rate, i->alpha, first);
+	e->rx_rate_ewma = ewma(e->rx_rate_ewma, s->rx_rate, i->alpha, first);
+
+	e->head = (e->head + 1) % WIFI_STA_HISTORY_LEN;
+	if (e->num < WIFI_STA_HISTORY_LEN)
+		e->num++;
+
+	e->num_samples++;
+}
+
+void wifi_sta_history_record(const char *ifname, struct wifi_sta *sta,
+			     uint64_t now)
+{
+	pthread_mutex_lock(&history_lock);
+	sta_history_record(ifname, sta, now);
+	pthread_mutex_unlock(&history_lock);
+}
+
+/* Drop history of the stas of 'ifname' which are not in the 'stas' list */
+void wifi_sta_history_expire(const char *ifname, struct wifi_sta *stas,
+			     int num)
+{
+	struct sta_history_entry *e, *next;
+	int k;
+
+	pthread_mutex_lock(&history_lock);
+	for (e = history_list; e; e = next) {
+		next = e->next;
+		if (strncmp(e->ifname, ifname, sizeof(e->ifname)))
+			continue;
+
+		for (k = 0; k < num; k++) {
+			if (!memcmp(e->macaddr, stas[k].macaddr, 6))
+				break;
+		}
+
+		if (k == num)
+			sta_history_unlink(e);
+	}
+	pthread_mutex_unlock(&history_lock);
+}
+
+int wifi_sta_history_add(const char *ifname, struct wifi_sta *sta)
+{
+	if (!ifname || !sta)
+		return -EINVAL;
+
+	wifi_sta_history_record(ifname, sta, time_monotonic_msecs());
+	return 0;
+}
+
+void wifi_sta_history_del(const char *ifname, uint8_t *addr)
+{
+	struct sta_history_entry *e, *next;
+
+	if (!ifname)
+		return;
+
+	pthread_mutex_lock(&history_lock);
+	for (e = history_list; e; e = next) {
+		next = e->next;
+		if (strncmp(e->ifname, ifname, sizeof(e->ifname)))
+			continue;
+
+		if (!addr || !memcmp(e->macaddr, addr, 6))
+			sta_history_unlink(e);
+	}
+	pthread_mutex_unlock(&history_lock);
+}
+
+int wifi_sta_history_config(const char *ifname, int alpha, int max_stas)
+{
+	struct sta_history_iface *i;
+
+	if (!ifname || alpha <= 0 || alpha > 100 || max_stas <= 0)
+		return -EINVAL;
+
+	pthread_mutex_lock(&history_lock);
+	i = sta_history_iface(ifname, true);
+	if (!i) {
+		pthread_mutex_unlock(&history_lock);
+		return -ENOMEM;
+	}
+
+	i->alpha = alpha;
+	i->max_stas = max_stas;
+	while (i->num_stas > i->max_stas && sta_history_evict(ifname))
+		;
+
+	pthread_mutex_unlock(&history_lock);
+	return 0;
+}
+
+int wifi_get_sta_history(const char *ifname, uint8_t *addr,
+			 struct wifi_sta_history *h)
+{
+	struct sta_history_entry *e;
+	int start;
+	int k;
+
+	if (!ifname || !addr || !h)
+		return -EINVAL;
+
+	pthread_mutex_lock(&history_lock);
+	e = sta_history_lookup(ifname, addr);
+	if (!e) {
+		pthread_mutex_unlock(&history_lock);
+		return -ENOENT;
+	}
+
+	memset(h, 0, sizeof(*h));
+	memcpy(h->macaddr, e->macaddr, 6);
+	h->rssi_ewma = (int8_t)ewma_get(e->rssi_ewma);
+	h->snr_ewma = (int8_t)ewma_get(e->snr_ewma);
+	h->tx_rate_ewma = (uint32_t)ewma_get(e->tx_rate_ewma);
+	h->rx_rate_ewma = (uint32_t)ewma_get(e->rx_rate_ewma);
+	h->num_samples = e->num_samples;
+	h->num = e->num;
+
+	start = (e->head + WIFI_STA_HISTORY_LEN - e->num) % WIFI_STA_HISTORY_LEN;
+	for (k = 0; k < e->num; k++)
+		h->sample[k] = e->ring[(start + k) % WIFI_STA_HISTORY_LEN];
+
+	pthread_mutex_unlock(&history_lock);
+	return 0;
+}
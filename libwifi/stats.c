@@ -0,0 +1,234 @@
+/*
+ * stats.c - timestamped stats snapshots and rates between them
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+#define RADIO_COUNTER(f)	offsetof(struct wifi_radio_stats, f)
+#define AP_COUNTER(f)		offsetof(struct wifi_ap_stats, f)
+#define STA_COUNTER(f)		offsetof(struct wifi_sta_stats, f)
+#define AC_COUNTER(f)		offsetof(struct wifi_ap_wmm_ac_stats, f)
+
+/* offsets of the uint64_t counters in each type of stats */
+static const size_t radio_counters[] = {
+	RADIO_COUNTER(tx_bytes),
+	RADIO_COUNTER(rx_bytes),
+	RADIO_COUNTER(tx_pkts),
+	RADIO_COUNTER(rx_pkts),
+	RADIO_COUNTER(tx_err_pkts),
+	RADIO_COUNTER(rx_err_pkts),
+	RADIO_COUNTER(tx_dropped_pkts),
+	RADIO_COUNTER(rx_dropped_pkts),
+	RADIO_COUNTER(rx_plcp_err_pkts),
+	RADIO_COUNTER(rx_fcs_err_pkts),
+	RADIO_COUNTER(rx_mac_err_pkts),
+	RADIO_COUNTER(rx_unknown_pkts),
+};
+
+static const size_t ap_counters[] = {
+	AP_COUNTER(tx_bytes),
+	AP_COUNTER(rx_bytes),
+	AP_COUNTER(tx_pkts),
+	AP_COUNTER(rx_pkts),
+	AP_COUNTER(tx_err_pkts),
+	AP_COUNTER(tx_rtx_pkts),
+	AP_COUNTER(tx_rtx_fail_pkts),
+	AP_COUNTER(tx_retry_pkts),
+	AP_COUNTER(tx_mretry_pkts),
+	AP_COUNTER(ack_fail_pkts),
+	AP_COUNTER(aggr_pkts),
+	AP_COUNTER(rx_err_pkts),
+	AP_COUNTER(tx_ucast_pkts),
+	AP_COUNTER(rx_ucast_pkts),
+	AP_COUNTER(tx_dropped_pkts),
+	AP_COUNTER(rx_dropped_pkts),
+	AP_COUNTER(tx_mcast_pkts),
+	AP_COUNTER(rx_mcast_pkts),
+	AP_COUNTER(tx_bcast_pkts),
+	AP_COUNTER(rx_bcast_pkts),
+	AP_COUNTER(rx_unknown_pkts),
+};
+
+static const size_t sta_counters[] = {
+	STA_COUNTER(tx_bytes),
+	STA_COUNTER(rx_bytes),
+	STA_COUNTER(tx_pkts),
+	STA_COUNTER(rx_pkts),
+	STA_COUNTER(tx_err_pkts),
+	STA_COUNTER(tx_rtx_pkts),
+	STA_COUNTER(tx_rtx_fail_pkts),
+	STA_COUNTER(tx_retry_pkts),
+	STA_COUNTER(tx_mretry_pkts),
+	STA_COUNTER(tx_fail_pkts),
+	STA_COUNTER(rx_fail_pkts),
+};
+
+static const size_t ac_counters[] = {
+	AC_COUNTER(tx_bytes),
+	AC_COUNTER(rx_bytes),
+	AC_COUNTER(tx_pkts),
+	AC_COUNTER(rx_pkts),
+	AC_COUNTER(tx_err_pkts),
+	AC_COUNTER(rx_err_pkts),
+	AC_COUNTER(tx_rtx_pkts),
+};
+
+/* Set the per-second rates of the counters at offsets 'off' */
+static void stats_rates(const void *prev, const void *cur, void *rate,
+			const size_t *off, size_t num, uint64_t interval,
+			int bits)
+{
+	size_t i;
+
+	for (i = 0; i < num; i++) {
+		const uint64_t *p = (const uint64_t *)((const uint8_t *)prev + off[i]);
+		const uint64_t *c = (const uint64_t *)((const uint8_t *)cur + off[i]);
+		uint64_t *r = (uint64_t *)((uint8_t *)rate + off[i]);
+
+		*r = counter_delta(*p, *c, bits) * 1000 / interval;
+	}
+}
+
+int wifi_stats_delta(const struct wifi_stats_snapshot *prev,
+		     const struct wifi_stats_snapshot *cur,
+		     struct wifi_stats_snapshot *rate)
+{
+	uint64_t interval;
+	int bits;
+	int i;
+
+	if (!prev || !cur || !rate || prev->type != cur->type)
+		return -EINVAL;
+
+	if (cur->tstamp <= prev->tstamp)
+		return -EINVAL;
+
+	interval = cur->tstamp - prev->tstamp;
+	bits = prev->counter_bits == 32 && cur->counter_bits == 32 ? 32 : 64;
+
+	/* non-counter fields are from the current sample */
+	memcpy(rate, cur, sizeof(*rate));
+	rate->tstamp = interval;
+
+	switch (cur->type) {
+	case WIFI_STATS_RADIO:
+		stats_rates(&prev->radio, &cur->radio, &rate->radio,
+			    radio_counters, ARRAY_SIZE(radio_counters), interval,
+			    bits);
+		break;
+	case WIFI_STATS_AP:
+		stats_rates(&prev->ap, &cur->ap, &rate->ap,
+			    ap_counters, ARRAY_SIZE(ap_counters), interval,
+			    bits);
+		break;
+	case WIFI_STATS_STA:
+		stats_rates(&prev->sta, &cur->sta, &rate->sta,
+			    sta_counters, ARRAY_SIZE(sta_counters), interval,
+			    bits);
+		break;
+	case WIFI_STATS_WMM:
+		if (strncmp(prev->wmm.ifname, cur->wmm.ifname, 16))
+			return -EINVAL;
+
+		for (i = 0; i < WIFI_NUM_AC; i++) {
+			stats_rates(&prev->wmm.ac[i], &cur->wmm.ac[i],
+				    &rate->wmm.ac[i], ac_counters,
+				    ARRAY_SIZE(ac_counters), interval, bits);
+		}
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int wifi_radio_stats_snapshot(const char *name, struct wifi_stats_snapshot *s)
+{
+	int ret;
+
+	memset(s, 0, sizeof(*s));
+	s->type = WIFI_STATS_RADIO;
+	ret = wifi_radio_get_stats(name, &s->radio);
+	s->tstamp = time_monotonic_msecs();
+	s->counter_bits = wifi_get_counter_bits(name);
+
+	return ret;
+}
+
+int wifi_ap_stats_snapshot(const char *ifname, struct wifi_stats_snapshot *s)
+{
+	int ret;
+
+	memset(s, 0, sizeof(*s));
+	s->type = WIFI_STATS_AP;
+	ret = wifi_ap_get_stats(ifname, &s->ap);
+	s->tstamp = time_monotonic_msecs();
+	s->counter_bits = wifi_get_counter_bits(ifname);
+
+	return ret;
+}
+
+int wifi_sta_stats_snapshot(const char *ifname, uint8_t *addr,
+			    struct wifi_stats_snapshot *s)
+{
+	int ret;
+
+	memset(s, 0, sizeof(*s));
+	s->type = WIFI_STATS_STA;
+	ret = wifi_get_sta_stats(ifname, addr, &s->sta);
+	s->tstamp = time_monotonic_msecs();
+	s->counter_bits = wifi_get_counter_bits(ifname);
+
+	return ret;
+}
+
+int wifi_wmm_stats_snapshot(const char *name, const char *ifname,
+			    struct wifi_stats_snapshot *s)
+{
+	struct wifi_bss_wmm_stats bss[WIFI_IFACE_MAX_NUM];
+	int num = ARRAY_SIZE(bss);
+	int ret;
+	int i;
+
+	memset(s, 0, sizeof(*s));
+	s->type = WIFI_STATS_WMM;
+	ret = wifi_radio_get_wmm_stats(name, bss, &num);
+	s->tstamp = time_monotonic_msecs();
+	s->counter_bits = wifi_get_counter_bits(name);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < num; i++) {
+		if (!strncmp(bss[i].ifname, ifname, sizeof(bss[i].ifname))) {
+			memcpy(&s->wmm, &bss[i], sizeof(s->wmm));
+			return 0;
+		}
+	}
+
+	return -ENODEV;
+}
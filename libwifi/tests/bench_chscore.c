@@ -0,0 +1,272 @@
+/*
+ * bench_chscore.c - benchmark scoring every channel and bandwidth of a
+ * dense tri-band environment by walking the channel list and the BSS
+ * database for each member channel, against getting the scores from the
+ * per 20MHz channel aggregates.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+#define NUM_CHAN	128
+
+static const int bws[] = { 20, 40, 80, 160 };
+
+struct chan_score {
+	int noise;
+	uint8_t busy;
+	uint8_t score;
+	int bss_num;
+};
+
+static struct chan_entry chan[NUM_CHAN];
+static int chan_num;
+
+static uint64_t now_usecs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* 2.4, 5 and 6GHz channels with random survey data, and 'num_bss'
+ * neighbours on them
+ */
+static void make_env(int num_bss)
+{
+	uint64_t now = time_monotonic_msecs();
+	struct wifi_bss b;
+	int i;
+
+	for (i = 1; i <= 13; i++) {
+		chan[chan_num].channel = i;
+		chan[chan_num++].band = BAND_2;
+	}
+
+	for (i = 36; i <= 165; i += 4) {
+		if (i == 68)
+			i = 100;
+		if (i == 148)
+			i = 149;
+		chan[chan_num].channel = i;
+		chan[chan_num++].band = BAND_5;
+	}
+
+	for (i = 1; i <= 233; i += 4) {
+		chan[chan_num].channel = i;
+		chan[chan_num++].band = BAND_6;
+	}
+
+	for (i = 0; i < chan_num; i++) {
+		chan[i].noise = -100 + rand() % 20;
+		chan[i].busy = rand() % 101;
+		chan[i].score = rand() % 101;
+	}
+
+	for (i = 0; i < num_bss; i++) {
+		memset(&b, 0, sizeof(b));
+		memcpy(b.bssid, "\x02\x00\x00\x00\x00\x00", 6);
+		b.bssid[3] = i >> 16;
+		b.bssid[4] = i >> 8;
+		b.bssid[5] = i & 0xff;
+		b.channel = chan[rand() % chan_num].channel;
+		b.band = b.channel > 14 && b.channel < 36 ? BAND_6 :
+			 chan[rand() % chan_num].band;
+		b.rssi = -50 - rand() % 40;
+		wifi_bssdb_update("wifi0", &b, 1, false, now);
+	}
+}
+
+/* as each of noise, busy, score and neighbours were got per member */
+static void score_walk(const int *chans, enum wifi_band band,
+		       struct chan_score *s)
+{
+	int score_num = 0;
+	int busy_num = 0;
+	int score = 0;
+	int busy = 0;
+	const int *c;
+	int i;
+
+	s->noise = -255;
+	s->busy = 255;
+	s->score = 255;
+	s->bss_num = 0;
+
+	for (c = chans; c && *c; c++) {
+		for (i = 0; i < chan_num; i++) {
+			if (chan[i].channel != *c)
+				continue;
+			if (chan[i].noise > s->noise)
+				s->noise = chan[i].noise;
+			break;
+		}
+	}
+
+	for (c = chans; c && *c; c++) {
+		for (i = 0; i < chan_num; i++) {
+			if (chan[i].channel != *c)
+				continue;
+			busy += chan[i].busy;
+			busy_num++;
+			break;
+		}
+	}
+
+	for (c = chans; c && *c; c++) {
+		for (i = 0; i < chan_num; i++) {
+			if (chan[i].channel != *c)
+				continue;
+			score += chan[i].score;
+			score_num++;
+			break;
+		}
+	}
+
+	for (c = chans; c && *c; c++)
+		s->bss_num += wifi_bssdb_count(band, (uint8_t)*c);
+
+	if (busy_num)
+		s->busy = busy / busy_num;
+	if (score_num)
+		s->score = score / score_num;
+}
+
+static void score_agg(struct chscore *cs, const int *chans,
+		      enum wifi_band band, struct chan_score *s)
+{
+	s->noise = wifi_chscore_noise(cs, chans);
+	s->busy = wifi_chscore_busy(cs, chans);
+	s->score = wifi_chscore_score(cs, chans);
+	s->bss_num = wifi_chscore_bss_num(cs, band, chans);
+}
+
+/* Score all 5GHz channels at each bandwidth; returns number scored */
+static int run(struct chscore *cs, struct chan_score *out)
+{
+	const int *chans;
+	int n = 0;
+	int i, b;
+
+	if (cs)
+		wifi_chscore_init(cs, chan, chan_num);
+
+	for (b = 0; b < ARRAY_SIZE(bws); b++) {
+		for (i = 0; i < chan_num; i++) {
+			if (chan[i].band != BAND_5)
+				continue;
+
+			chans = chan2list(chan[i].channel, bws[b]);
+			if (!chans)
+				continue;
+
+			if (cs)
+				score_agg(cs, chans, BAND_5, &out[n++]);
+			else
+				score_walk(chans, BAND_5, &out[n++]);
+		}
+	}
+
+	return n;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-n iterations] [-b neighbours]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+	struct chan_score ref[4 * NUM_CHAN], res[4 * NUM_CHAN];
+	uint64_t t_walk, t_agg, t;
+	struct chscore *cs;
+	int num_bss = 2000;
+	int iter = 1000;
+	int n_ref, n;
+	int ch;
+	int i;
+
+	while ((ch = getopt(argc, argv, "n:b:h")) != -1) {
+		switch (ch) {
+		case 'n':
+			iter = atoi(optarg);
+			break;
+		case 'b':
+			num_bss = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return ch == 'h' ? 0 : 1;
+		}
+	}
+
+	if (iter <= 0 || num_bss < 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	cs = calloc(1, sizeof(*cs));
+	if (!cs)
+		return 1;
+
+	memset(ref, 0, sizeof(ref));
+	memset(res, 0, sizeof(res));
+	srand(1);
+	wifi_bssdb_config(600000, num_bss + 1, 25);
+	make_env(num_bss);
+
+	n_ref = run(NULL, ref);
+	n = run(cs, res);
+	if (n != n_ref || memcmp(ref, res, n * sizeof(ref[0]))) {
+		fprintf(stderr, "scores differ\n");
+		free(cs);
+		return 1;
+	}
+
+	t = now_usecs();
+	for (i = 0; i < iter; i++)
+		run(NULL, res);
+	t_walk = now_usecs() - t;
+
+	t = now_usecs();
+	for (i = 0; i < iter; i++)
+		run(cs, res);
+	t_agg = now_usecs() - t;
+
+	printf("%d channels, %d bss, %d channel/bandwidths scored\n",
+	       chan_num, num_bss, n);
+	printf("walk:       %8.2f usecs per run\n", (double)t_walk / iter);
+	printf("aggregates: %8.2f usecs per run (incl. init)\n",
+	       (double)t_agg / iter);
+	printf("speedup:    %8.2fx\n", t_agg ? (double)t_walk / t_agg : 0.0);
+
+	free(cs);
+	return 0;
+}
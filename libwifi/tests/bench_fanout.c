@@ -0,0 +1,224 @@
+/*
+ * bench_fanout.c - benchmark a serial walk of the stats of several radios
+ * and their APs against the same queries run by wifi_fanout().
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST. The test driver sleeps for
+ * LIBWIFI_TEST_LATENCY usecs in each query, set by the '-l' option.
+ */
+#define NUM_RADIOS	3
+#define NUM_APS		8
+#define MAX_STAS	16
+
+/* per radio: radio stats, then stats and assoclist of each AP */
+#define NUM_REQS	(NUM_RADIOS * (1 + 2 * NUM_APS))
+
+struct result {
+	struct wifi_radio_stats radio[NUM_RADIOS];
+	struct wifi_ap_stats ap[NUM_RADIOS][NUM_APS];
+	uint8_t stas[NUM_RADIOS][NUM_APS][MAX_STAS * 6];
+	int num_stas[NUM_RADIOS][NUM_APS];
+};
+
+/* the test driver picks its 5GHz data by a '5' in the name */
+static const char *radios[NUM_RADIOS] = { "test2", "test5", "test2b" };
+
+static uint64_t now_usecs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void ap_name(char *ifname, int r, int a)
+{
+	snprintf(ifname, 16, "%s.%d", radios[r], a);
+}
+
+static int walk_serial(struct result *res)
+{
+	char ifname[16];
+	int ret = 0;
+	int r, a;
+
+	for (r = 0; r < NUM_RADIOS; r++) {
+		ret |= wifi_radio_get_stats(radios[r], &res->radio[r]);
+
+		for (a = 0; a < NUM_APS; a++) {
+			ap_name(ifname, r, a);
+			ret |= wifi_ap_get_stats(ifname, &res->ap[r][a]);
+			res->num_stas[r][a] = MAX_STAS;
+			ret |= wifi_get_assoclist(ifname, res->stas[r][a],
+						  &res->num_stas[r][a]);
+		}
+	}
+
+	return ret;
+}
+
+static int walk_fanout(struct result *res, int timeout, int *num_timedout)
+{
+	struct wifi_fanout_req req[NUM_REQS];
+	struct wifi_fanout_req *q = req;
+	int ret;
+	int r, a;
+	int i;
+
+	memset(req, 0, sizeof(req));
+	for (r = 0; r < NUM_RADIOS; r++) {
+		q->op = WIFI_FANOUT_RADIO_STATS;
+		strncpy(q->ifname, radios[r], 15);
+		q->out = &res->radio[r];
+		q++;
+
+		for (a = 0; a < NUM_APS; a++) {
+			q->op = WIFI_FANOUT_AP_STATS;
+			ap_name(q->ifname, r, a);
+			strncpy(q->radio, radios[r], 15);
+			q->out = &res->ap[r][a];
+			q++;
+
+			q->op = WIFI_FANOUT_ASSOCLIST;
+			ap_name(q->ifname, r, a);
+			strncpy(q->radio, radios[r], 15);
+			q->out = res->stas[r][a];
+			q->num = MAX_STAS;
+			q++;
+		}
+	}
+
+	ret = wifi_fanout(req, NUM_REQS, timeout);
+
+	*num_timedout = 0;
+	for (i = 0; i < NUM_REQS; i++) {
+		if (req[i].status == -ETIMEDOUT)
+			(*num_timedout)++;
+		else if (req[i].status)
+			return req[i].status;
+
+		if (req[i].op == WIFI_FANOUT_ASSOCLIST) {
+			r = (i / (1 + 2 * NUM_APS));
+			a = (i % (1 + 2 * NUM_APS) - 1) / 2;
+			res->num_stas[r][a] = req[i].num;
+		}
+	}
+
+	return ret;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-n iterations] [-l latency usecs] "
+		"[-t timeout msecs]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+	struct result ref, res;
+	uint64_t t_serial, t_fanout, t;
+	int num_timedout;
+	int timeout = 0;
+	int latency = 1000;
+	char buf[16];
+	int iter = 10;
+	int ret = 0;
+	int ch;
+	int i;
+
+	while ((ch = getopt(argc, argv, "n:l:t:h")) != -1) {
+		switch (ch) {
+		case 'n':
+			iter = atoi(optarg);
+			break;
+		case 'l':
+			latency = atoi(optarg);
+			break;
+		case 't':
+			timeout = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return ch == 'h' ? 0 : 1;
+		}
+	}
+
+	if (iter <= 0 || latency < 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	snprintf(buf, sizeof(buf), "%d", latency);
+	setenv("LIBWIFI_TEST_LATENCY", buf, 1);
+
+	memset(&ref, 0, sizeof(ref));
+	if (walk_serial(&ref)) {
+		fprintf(stderr, "serial walk failed\n");
+		return 1;
+	}
+
+	t = now_usecs();
+	for (i = 0; i < iter && !ret; i++)
+		ret = walk_serial(&res);
+	t_serial = now_usecs() - t;
+
+	t = now_usecs();
+	for (i = 0; i < iter && !ret; i++) {
+		memset(&res, 0, sizeof(res));
+		ret = walk_fanout(&res, timeout, &num_timedout);
+		if (ret == -ETIMEDOUT) {
+			printf("fanout: %d of %d queries timed out\n",
+			       num_timedout, NUM_REQS);
+			return 0;
+		}
+
+		if (!ret && memcmp(&res, &ref, sizeof(res)))
+			ret = -EBADMSG;
+	}
+	t_fanout = now_usecs() - t;
+
+	if (ret) {
+		fprintf(stderr, "benchmark failed: %d\n", ret);
+		return 1;
+	}
+
+	printf("%d radios x %d APs, %d queries, %d us latency, %d rounds\n",
+	       NUM_RADIOS, NUM_APS, NUM_REQS, latency, iter);
+	printf("%-20s %10llu us  (%llu us/round)\n", "serial:",
+	       (unsigned long long)t_serial,
+	       (unsigned long long)(t_serial / iter));
+	printf("%-20s %10llu us  (%llu us/round, x%.1f)\n", "fanout:",
+	       (unsigned long long)t_fanout,
+	       (unsigned long long)(t_fanout / iter),
+	       t_fanout ? (double)t_serial / (double)t_fanout : 0.0);
+
+	return 0;
+}
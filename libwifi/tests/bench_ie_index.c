@@ -0,0 +1,224 @@
+/*
+ * bench_ie_index.c - benchmark parsing the IEs of 500 scan results as the
+ * drivers do, walking the IE buffer for each element looked up, against
+ * indexing it once and looking the elements up in the index.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "easy.h"
+#include "wifiutils.h"
+
+#define MAX_BSS		4096
+#define IES_LEN		512
+
+struct scan_ies {
+	uint8_t ies[IES_LEN];
+	size_t len;
+};
+
+/* what is got from the ies of a bss */
+struct parsed {
+	struct wifi_bss bss;
+	bool ssid_advertised;
+	uint8_t *ie[7];
+};
+
+static struct scan_ies scan[MAX_BSS];
+static struct parsed res[MAX_BSS];
+static uint8_t ms_oui[3] = { 0x00, 0x50, 0xf2 };
+
+static uint64_t now_usecs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void add(struct scan_ies *s, uint8_t eid, const uint8_t *data, int len)
+{
+	if (s->len + 2 + len > IES_LEN)
+		return;
+
+	s->ies[s->len] = eid;
+	s->ies[s->len + 1] = len;
+	if (data)
+		memcpy(&s->ies[s->len + 2], data, len);
+	else
+		memset(&s->ies[s->len + 2], rand() & 0xff, len);
+	s->len += 2 + len;
+}
+
+/* beacon ies as APs put them, with some of the optional ones */
+static void make_ies(struct scan_ies *s)
+{
+	const uint8_t rsn[] = { 0x01, 0x00, 0x00, 0x0f, 0xac, 0x04, 0x01, 0x00,
+				0x00, 0x0f, 0xac, 0x04, 0x01, 0x00, 0x00, 0x0f,
+				0xac, 0x02, 0x00, 0x00 };
+	const uint8_t wmm[] = { 0x00, 0x50, 0xf2, 0x02, 0x01, 0x01, 0x80 };
+	const uint8_t rates[] = { 0x8c, 0x12, 0x98, 0x24, 0xb0, 0x48, 0x60, 0x6c };
+	const uint8_t load[] = { 3, 0, 40, 0x10, 0x27 };
+	uint8_t he[22] = { IE_EXT_HE_CAP };
+	uint8_t ch = 36 + 4 * (rand() % 8);
+	int i;
+
+	s->len = 0;
+	add(s, IE_SSID, (const uint8_t *)"neighbour-ap", 12);
+	add(s, IE_SUPP_RATES, rates, sizeof(rates));
+	add(s, IE_DS_PARAM, &ch, 1);
+	add(s, 5, NULL, 4);		/* TIM */
+	add(s, 7, NULL, 6);		/* country */
+	if (rand() % 2)
+		add(s, IE_BSS_LOAD, load, sizeof(load));
+	add(s, IE_HT_CAP, NULL, 26);
+	if (rand() % 4)
+		add(s, IE_RSN, rsn, sizeof(rsn));
+	add(s, 61, NULL, 22);		/* HT operation */
+	add(s, IE_EXT_CAP, NULL, 8);
+	if (rand() % 2) {
+		add(s, IE_VHT_CAP, NULL, 12);
+		add(s, 192, NULL, 5);	/* VHT operation */
+	}
+	if (rand() % 3 == 0)
+		add(s, IE_EXT, he, sizeof(he));
+	if (rand() % 2)
+		add(s, IE_RRM, NULL, 5);
+
+	for (i = rand() % 4; i > 0; i--)
+		add(s, IE_VEND_SPEC, (const uint8_t *)"\x00\x10\x18\x02\x00", 5);
+	add(s, IE_VEND_SPEC, wmm, sizeof(wmm));
+}
+
+static void parse_walk(struct scan_ies *s, struct parsed *p)
+{
+	wifi_oper_stds_set_from_ie(s->ies, s->len, &p->bss.oper_std);
+	wifi_ssid_advertised_set_from_ie(s->ies, s->len, &p->ssid_advertised);
+	wifi_get_bss_security_from_ies(&p->bss, s->ies, s->len);
+	wifi_apload_set_from_ie(s->ies, s->len, &p->bss.load);
+	p->ie[0] = wifi_find_ie(s->ies, s->len, IE_HT_CAP);
+	p->ie[1] = wifi_find_ie(s->ies, s->len, IE_VHT_CAP);
+	p->ie[2] = wifi_find_ie(s->ies, s->len, IE_EXT_CAP);
+	p->ie[3] = wifi_find_ie(s->ies, s->len, IE_RRM);
+	p->ie[4] = wifi_find_ie(s->ies, s->len, IE_MDE);
+	p->ie[5] = wifi_find_ie_ext(s->ies, s->len, IE_EXT_HE_CAP);
+	p->ie[6] = wifi_find_vsie(s->ies, s->len, ms_oui, 2, 1);
+}
+
+static void parse_index(struct scan_ies *s, struct parsed *p)
+{
+	struct wifi_ie_index idx;
+
+	wifi_ie_index_build(&idx, s->ies, s->len);
+	wifi_oper_stds_set_from_ie_index(&idx, &p->bss.oper_std);
+	wifi_ssid_advertised_set_from_ie_index(&idx, &p->ssid_advertised);
+	wifi_get_bss_security_from_ie_index(&p->bss, &idx);
+	wifi_apload_set_from_ie_index(&idx, &p->bss.load);
+	p->ie[0] = wifi_ie_index_find(&idx, IE_HT_CAP);
+	p->ie[1] = wifi_ie_index_find(&idx, IE_VHT_CAP);
+	p->ie[2] = wifi_ie_index_find(&idx, IE_EXT_CAP);
+	p->ie[3] = wifi_ie_index_find(&idx, IE_RRM);
+	p->ie[4] = wifi_ie_index_find(&idx, IE_MDE);
+	p->ie[5] = wifi_ie_index_find_ext(&idx, IE_EXT_HE_CAP);
+	p->ie[6] = wifi_ie_index_find_vsie(&idx, ms_oui, 2, 1);
+}
+
+static void run(int num, bool index)
+{
+	int i;
+
+	memset(res, 0, num * sizeof(res[0]));
+	for (i = 0; i < num; i++) {
+		if (index)
+			parse_index(&scan[i], &res[i]);
+		else
+			parse_walk(&scan[i], &res[i]);
+	}
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-n iterations] [-b bss]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+	static struct parsed ref[MAX_BSS];
+	uint64_t t_walk, t_index, t;
+	int num_bss = 500;
+	int iter = 2000;
+	int ch;
+	int i;
+
+	while ((ch = getopt(argc, argv, "n:b:h")) != -1) {
+		switch (ch) {
+		case 'n':
+			iter = atoi(optarg);
+			break;
+		case 'b':
+			num_bss = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return ch == 'h' ? 0 : 1;
+		}
+	}
+
+	if (iter <= 0 || num_bss <= 0 || num_bss > MAX_BSS) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	srand(1);
+	for (i = 0; i < num_bss; i++)
+		make_ies(&scan[i]);
+
+	run(num_bss, false);
+	memcpy(ref, res, num_bss * sizeof(res[0]));
+	run(num_bss, true);
+	if (memcmp(ref, res, num_bss * sizeof(res[0]))) {
+		fprintf(stderr, "parsed ies differ\n");
+		return 1;
+	}
+
+	t = now_usecs();
+	for (i = 0; i < iter; i++)
+		run(num_bss, false);
+	t_walk = now_usecs() - t;
+
+	t = now_usecs();
+	for (i = 0; i < iter; i++)
+		run(num_bss, true);
+	t_index = now_usecs() - t;
+
+	printf("%d bss, %zu bytes of ies each on average\n", num_bss,
+	       (size_t)(scan[0].len + scan[num_bss - 1].len) / 2);
+	printf("walk:   %8.2f usecs per scan\n", (double)t_walk / iter);
+	printf("index:  %8.2f usecs per scan\n", (double)t_index / iter);
+	printf("speedup: %7.2fx\n", t_index ? (double)t_walk / t_index : 0.0);
+
+	return 0;
+}
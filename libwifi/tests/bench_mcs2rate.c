@@ -0,0 +1,223 @@
+/*
+ * bench_mcs2rate.c - benchmark getting PHY rates of random station rates
+ * computed per call with float math, as wifi_mcs2rate() used to, against
+ * looking them up in its generated tables.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "easy.h"
+#include "wifiutils.h"
+
+#define NUM_RATES	4096
+
+struct rate {
+	uint32_t mcs;
+	uint32_t bw;
+	uint32_t nss;
+	enum wifi_guard gi;
+};
+
+static const struct {
+	uint8_t num_bpscs;
+	float coding_rate;
+} mcstab[] = {
+	{ 1, 1.0f / 2.0f },
+	{ 2, 1.0f / 2.0f },
+	{ 2, 3.0f / 4.0f },
+	{ 4, 1.0f / 2.0f },
+	{ 4, 3.0f / 4.0f },
+	{ 6, 2.0f / 3.0f },
+	{ 6, 3.0f / 4.0f },
+	{ 6, 5.0f / 6.0f },
+	{ 8, 3.0f / 4.0f },
+	{ 8, 5.0f / 6.0f },
+	{ 10, 3.0f / 4.0f },
+	{ 10, 5.0f / 6.0f },
+};
+
+static struct rate rates[NUM_RATES];
+
+static uint64_t now_usecs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int get_num_sd(uint32_t bw, bool he)
+{
+	switch (bw) {
+	case 20:
+		return he ? 234 : 52;
+	case 40:
+		return he ? 468 : 108;
+	case 80:
+		return he ? 980 : 234;
+	case 160:
+		return he ? 1960 : 468;
+	default:
+		return 0;
+	}
+}
+
+/* wifi_mcs2rate() as it was */
+static unsigned long mcs2rate_float(uint32_t mcs, uint32_t bw, uint32_t nss,
+				    enum wifi_guard gi)
+{
+	float duration;
+	int num_sd;
+
+	if (mcs > 11)
+		return 0;
+
+	switch (gi) {
+	case WIFI_SGI:
+		duration = 3.2f + 0.4f;
+		num_sd = get_num_sd(bw, false);
+		break;
+	case WIFI_LGI:
+		duration = 3.2f + 0.8f;
+		num_sd = get_num_sd(bw, false);
+		break;
+	case WIFI_1xLTF_GI800:
+	case WIFI_2xLTF_GI800:
+	case WIFI_4xLTF_GI800:
+		duration = 12.8f + 0.8f;
+		num_sd = get_num_sd(bw, true);
+		break;
+	case WIFI_1xLTF_GI1600:
+	case WIFI_2xLTF_GI1600:
+		duration = 12.8f + 1.6f;
+		num_sd = get_num_sd(bw, true);
+		break;
+	case WIFI_4xLTF_GI3200:
+		duration = 12.8f + 3.2f;
+		num_sd = get_num_sd(bw, true);
+		break;
+	default:
+		return 0;
+	}
+
+	if (num_sd == 0)
+		return 0;
+
+	return (unsigned long)((float)num_sd * mcstab[mcs].num_bpscs *
+			       (float)nss * mcstab[mcs].coding_rate / duration);
+}
+
+/* rates of 1-4 stream stations up to MCS 11 and 160MHz, as both cover */
+static void make_rates(void)
+{
+	const uint32_t bws[] = { 20, 40, 80, 160 };
+	int i;
+
+	for (i = 0; i < NUM_RATES; i++) {
+		rates[i].mcs = rand() % 12;
+		rates[i].bw = bws[rand() % ARRAY_SIZE(bws)];
+		rates[i].nss = 1 + rand() % 4;
+		rates[i].gi = rand() % WIFI_GI_UNKNOWN;
+	}
+}
+
+static unsigned long run(bool table)
+{
+	unsigned long sum = 0;
+	struct rate *r;
+	int i;
+
+	for (i = 0; i < NUM_RATES; i++) {
+		r = &rates[i];
+		if (table)
+			sum += wifi_mcs2rate(r->mcs, r->bw, r->nss, r->gi);
+		else
+			sum += mcs2rate_float(r->mcs, r->bw, r->nss, r->gi);
+	}
+
+	return sum;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-n iterations]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+	volatile unsigned long sink = 0;
+	uint64_t t_float, t_table, t;
+	unsigned long sum_float, sum_table;
+	int iter = 10000;
+	int ch;
+	int i;
+
+	while ((ch = getopt(argc, argv, "n:h")) != -1) {
+		switch (ch) {
+		case 'n':
+			iter = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return ch == 'h' ? 0 : 1;
+		}
+	}
+
+	if (iter <= 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	srand(1);
+	make_rates();
+
+	/* table rates may be 1Mbps above where float rounded a whole down */
+	sum_float = run(false);
+	sum_table = run(true);
+	if (sum_table < sum_float || sum_table - sum_float > NUM_RATES) {
+		fprintf(stderr, "rates differ\n");
+		return 1;
+	}
+
+	t = now_usecs();
+	for (i = 0; i < iter; i++)
+		sink += run(false);
+	t_float = now_usecs() - t;
+
+	t = now_usecs();
+	for (i = 0; i < iter; i++)
+		sink += run(true);
+	t_table = now_usecs() - t;
+
+	printf("%d rates per run\n", NUM_RATES);
+	printf("float:  %8.2f nsecs per rate\n",
+	       (double)t_float * 1000 / ((double)iter * NUM_RATES));
+	printf("table:  %8.2f nsecs per rate\n",
+	       (double)t_table * 1000 / ((double)iter * NUM_RATES));
+	printf("speedup: %7.2fx\n", t_table ? (double)t_float / t_table : 0.0);
+
+	return 0;
+}
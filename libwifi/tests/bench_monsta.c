@@ -0,0 +1,166 @@
+/*
+ * bench_monsta.c - benchmark tracking probe requests of many unassociated
+ * stas, and getting wifi_get_monitor_sta(s)() from them.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+#define IFNAME		"test5"
+
+static uint64_t now_usecs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-s stas] [-p probes per sta] [-m max stas]\n",
+		prog);
+}
+
+static void sta_mac(uint8_t *addr, int id)
+{
+	addr[0] = 0x02;
+	addr[1] = 0x00;
+	addr[2] = id >> 24;
+	addr[3] = id >> 16;
+	addr[4] = id >> 8;
+	addr[5] = id;
+}
+
+/* each of 'num_stas' stas probes 'probes' times, the stas in random order */
+static uint64_t run_probes(int num_stas, int probes)
+{
+	uint8_t addr[6];
+	uint64_t t;
+	int i;
+
+	srand(1);
+	t = now_usecs();
+	for (i = 0; i < num_stas * probes; i++) {
+		sta_mac(addr, rand() % num_stas);
+		wifi_monsta_add(IFNAME, addr, -40 - rand() % 50);
+	}
+
+	return now_usecs() - t;
+}
+
+static int bench(int num_stas, int probes, int max_stas,
+		 struct wifi_monsta *stas)
+{
+	struct wifi_monsta mon;
+	uint64_t t_add, t_get, t_all;
+	uint8_t addr[6];
+	int found = 0;
+	int num;
+	int i;
+
+	wifi_monsta_stop(IFNAME);
+	if (wifi_monsta_config(IFNAME, 25, max_stas))
+		return -1;
+
+	t_add = run_probes(num_stas, probes);
+
+	t_get = now_usecs();
+	for (i = 0; i < num_stas; i++) {
+		sta_mac(addr, i);
+		if (!wifi_get_monitor_sta(IFNAME, addr, &mon))
+			found++;
+	}
+	t_get = now_usecs() - t_get;
+
+	num = num_stas;
+	t_all = now_usecs();
+	if (wifi_get_monitor_stas(IFNAME, stas, &num))
+		return -1;
+	t_all = now_usecs() - t_all;
+
+	printf("%d stas, %d probes each, max %d kept:\n", num_stas, probes,
+	       max_stas);
+	printf("  probe:       %8.1f nsecs\n",
+	       (double)t_add * 1000 / ((double)num_stas * probes));
+	printf("  get sta:     %8.1f nsecs (%d of %d tracked)\n",
+	       (double)t_get * 1000 / num_stas, found, num_stas);
+	printf("  get all:     %8.1f usecs for %d stas\n", (double)t_all, num);
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	struct wifi_monsta *stas;
+	int num_stas = 10000;
+	int max_stas = 0;
+	int probes = 20;
+	int ret;
+	int ch;
+
+	while ((ch = getopt(argc, argv, "s:p:m:h")) != -1) {
+		switch (ch) {
+		case 's':
+			num_stas = atoi(optarg);
+			break;
+		case 'p':
+			probes = atoi(optarg);
+			break;
+		case 'm':
+			max_stas = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return ch == 'h' ? 0 : 1;
+		}
+	}
+
+	if (num_stas <= 0 || probes <= 0 || max_stas < 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	stas = calloc(num_stas, sizeof(*stas));
+	if (!stas)
+		return 1;
+
+	/* all stas kept, then a tenth of them, evicting on most probes */
+	ret = bench(num_stas, probes, max_stas ? max_stas : num_stas, stas);
+	if (!ret && !max_stas)
+		ret = bench(num_stas, probes, num_stas / 10 ? num_stas / 10 : 1,
+			    stas);
+
+	wifi_monsta_stop(IFNAME);
+	free(stas);
+
+	if (ret)
+		fprintf(stderr, "failed\n");
+
+	return ret ? 1 : 0;
+}
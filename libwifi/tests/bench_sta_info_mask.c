@@ -0,0 +1,135 @@
+/*
+ * bench_sta_info_mask.c - benchmark rssi-only sta info queries against full
+ * sta info queries on a live AP iface.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Run by hwsim_stats.sh on a mac80211_hwsim AP iface with at least one
+ * associated sta.
+ */
+#define MAX_STAS	32
+
+static uint64_t now_usecs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Time 'iter' queries of the sta's info; a mask of 0 is a full query */
+static int bench_run(const char *ifname, uint8_t *addr, uint32_t mask,
+		     int iter, uint64_t *elapsed)
+{
+	struct wifi_sta sta;
+	uint64_t t;
+	int ret;
+	int i;
+
+	t = now_usecs();
+	for (i = 0; i < iter; i++) {
+		memset(&sta, 0, sizeof(sta));
+		if (mask)
+			ret = wifi_get_sta_info_mask(ifname, addr, mask, &sta);
+		else
+			ret = wifi_get_sta_info(ifname, addr, &sta);
+
+		if (ret) {
+			fprintf(stderr, "query %d: mask 0x%x: ret %d\n", i,
+				mask, ret);
+			return ret;
+		}
+	}
+
+	*elapsed = now_usecs() - t;
+	return 0;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-n iterations] <ifname>\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+	uint8_t stas[MAX_STAS * 6];
+	uint64_t t_full, t_rssi;
+	int num = MAX_STAS;
+	const char *ifname;
+	int iter = 1000;
+	int ret;
+	int ch;
+
+	while ((ch = getopt(argc, argv, "n:h")) != -1) {
+		switch (ch) {
+		case 'n':
+			iter = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return ch == 'h' ? 0 : 1;
+		}
+	}
+
+	if (optind >= argc || iter <= 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	ifname = argv[optind];
+	ret = wifi_get_assoclist(ifname, stas, &num);
+	if (ret || num <= 0) {
+		fprintf(stderr, "%s: no associated sta\n", ifname);
+		return 1;
+	}
+
+	/* warm up the capability cache, as a long running caller would */
+	ret = bench_run(ifname, stas, 0, 1, &t_full);
+	if (!ret)
+		ret = bench_run(ifname, stas, 0, iter, &t_full);
+	if (!ret)
+		ret = bench_run(ifname, stas, WIFI_STA_F_RSSI, iter, &t_rssi);
+
+	if (ret) {
+		fprintf(stderr, "benchmark failed\n");
+		return 1;
+	}
+
+	printf("sta " MACFMT " on %s, %d queries\n", MAC2STR(stas), ifname,
+	       iter);
+	printf("%-20s %10llu us  (%llu us/query)\n", "full:",
+	       (unsigned long long)t_full,
+	       (unsigned long long)(t_full / iter));
+	printf("%-20s %10llu us  (%llu us/query, x%.1f)\n", "rssi only:",
+	       (unsigned long long)t_rssi,
+	       (unsigned long long)(t_rssi / iter),
+	       t_rssi ? (double)t_full / (double)t_rssi : 0.0);
+
+	return 0;
+}
@@ -0,0 +1,416 @@
+/*
+ * bench_vendor_pipeline.c - benchmark serial vs. pipelined nl80211 vendor
+ * commands against a scripted fake vendor responder.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <poll.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <netlink/genl/genl.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+#include "nlwifi.h"
+#include "nl80211_copy.h"
+#include "modules/intel/intel.h"
+
+/* The fake responder is a plain NETLINK_USERSOCK socket standing in for the
+ * driver. Every request is answered after a scripted 'latency' (time in
+ * flight, e.g. firmware mailbox round trip), while requests are served
+ * one after another taking 'service' time each, as a driver would do.
+ * A vendor reply carries 'payload' bytes, followed by an ack.
+ */
+#define FAKE_FAMILY	0x20
+#define FAKE_VID	0xAC9A96
+#define FAKE_SUBCMD	0x10
+#define FAKE_MAXQ	1024
+
+struct fake_req {
+	uint32_t seq;
+	uint32_t port;
+	uint8_t addr[6];
+	uint64_t due;
+};
+
+struct fake_responder {
+	int fd;
+	uint32_t port;
+	uint64_t latency;	/* usecs */
+	uint64_t service;	/* usecs */
+	int payload;
+	volatile int stop;
+	pthread_t thread;
+};
+
+static uint64_t now_usecs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void fake_send(struct fake_responder *f, uint32_t port, void *buf,
+		      int len)
+{
+	struct sockaddr_nl dst = {
+		.nl_family = AF_NETLINK,
+		.nl_pid = port,
+	};
+
+	if (sendto(f->fd, buf, len, 0, (struct sockaddr *)&dst, sizeof(dst)) < 0)
+		fprintf(stderr, "responder: sendto: %s\n", strerror(errno));
+}
+
+static void fake_reply(struct fake_responder *f, struct fake_req *r)
+{
+	struct {
+		struct nlmsghdr nlh;
+		struct nlmsgerr err;
+	} ack;
+	struct nlattr *data;
+	struct nl_msg *msg;
+	uint8_t *payload;
+
+	msg = nlmsg_alloc();
+	payload = calloc(1, f->payload);
+	if (!msg || !payload)
+		goto out;
+
+	/* reply payload begins with the sta address it was asked for */
+	memcpy(payload, r->addr, f->payload < 6 ? f->payload : 6);
+
+	genlmsg_put(msg, r->port, r->seq, FAKE_FAMILY, 0, 0,
+		    NL80211_CMD_VENDOR, 0);
+	data = nla_nest_start(msg, NL80211_ATTR_VENDOR_DATA);
+	nla_put(msg, 1, f->payload, payload);
+	nla_nest_end(msg, data);
+	fake_send(f, r->port, nlmsg_hdr(msg), nlmsg_hdr(msg)->nlmsg_len);
+
+	memset(&ack, 0, sizeof(ack));
+	ack.nlh.nlmsg_len = sizeof(ack);
+	ack.nlh.nlmsg_type = NLMSG_ERROR;
+	ack.nlh.nlmsg_seq = r->seq;
+	ack.nlh.nlmsg_pid = r->port;
+	ack.err.error = 0;
+	ack.err.msg.nlmsg_seq = r->seq;
+	ack.err.msg.nlmsg_pid = r->port;
+	fake_send(f, r->port, &ack, sizeof(ack));
+
+out:
+	free(payload);
+	nlmsg_free(msg);
+}
+
+static void fake_parse(struct fake_responder *f, uint8_t *buf, int len,
+		       struct fake_req *q, int *qlen, uint64_t *busy)
+{
+	struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+
+	for (; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+		struct nlattr *tb[NL80211_ATTR_MAX + 1];
+		struct fake_req *r;
+		uint64_t t;
+
+		if (*qlen >= FAKE_MAXQ)
+			break;
+
+		if (genlmsg_parse(nlh, 0, tb, NL80211_ATTR_MAX, NULL))
+			continue;
+
+		if (!tb[NL80211_ATTR_VENDOR_SUBCMD] ||
+		    nla_get_u32(tb[NL80211_ATTR_VENDOR_SUBCMD]) != FAKE_SUBCMD)
+			continue;
+
+		r = &q[(*qlen)++];
+		memset(r, 0, sizeof(*r));
+		r->seq = nlh->nlmsg_seq;
+		r->port = nlh->nlmsg_pid;
+		if (tb[NL80211_ATTR_VENDOR_DATA] &&
+		    nla_len(tb[NL80211_ATTR_VENDOR_DATA]) >= 6)
+			memcpy(r->addr, nla_data(tb[NL80211_ATTR_VENDOR_DATA]), 6);
+
+		/* in flight for 'latency', but served one at a time */
+		t = now_usecs() + f->latency;
+		if (t < *busy + f->service)
+			t = *busy + f->service;
+
+		r->due = t;
+		*busy = t;
+	}
+}
+
+static void *fake_responder_run(void *arg)
+{
+	struct fake_responder *f = arg;
+	struct fake_req *q;
+	uint8_t buf[8192];
+	uint64_t busy = 0;
+	int qlen = 0;
+	int head = 0;
+
+	q = calloc(FAKE_MAXQ, sizeof(*q));
+	if (!q)
+		return NULL;
+
+	while (!f->stop) {
+		struct pollfd pfd = { .fd = f->fd, .events = POLLIN };
+		struct timespec timeout = { .tv_nsec = 10000000 };
+		uint64_t now;
+		int len;
+
+		if (head < qlen) {
+			uint64_t wait = 0;
+
+			now = now_usecs();
+			if (q[head].due > now)
+				wait = q[head].due - now;
+
+			timeout.tv_sec = wait / 1000000;
+			timeout.tv_nsec = (wait % 1000000) * 1000;
+		}
+
+		if (ppoll(&pfd, 1, &timeout, NULL) > 0) {
+			len = recv(f->fd, buf, sizeof(buf), 0);
+			if (len > 0)
+				fake_parse(f, buf, len, q, &qlen, &busy);
+		}
+
+		now = now_usecs();
+		while (head < qlen && q[head].due <= now)
+			fake_reply(f, &q[head++]);
+
+		if (head == qlen)
+			head = qlen = 0;
+	}
+
+	free(q);
+	return NULL;
+}
+
+static int fake_responder_start(struct fake_responder *f)
+{
+	struct sockaddr_nl addr = { .nl_family = AF_NETLINK };
+	socklen_t alen = sizeof(addr);
+
+	f->fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_USERSOCK);
+	if (f->fd < 0)
+		return -errno;
+
+	if (bind(f->fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+	    getsockname(f->fd, (struct sockaddr *)&addr, &alen)) {
+		close(f->fd);
+		return -errno;
+	}
+
+	f->port = addr.nl_pid;
+	f->stop = 0;
+	return pthread_create(&f->thread, NULL, fake_responder_run, f);
+}
+
+static void fake_responder_stop(struct fake_responder *f)
+{
+	f->stop = 1;
+	pthread_join(f->thread, NULL);
+	close(f->fd);
+}
+
+static struct nl_sock *fake_client(struct fake_responder *f)
+{
+	struct nl_sock *sk;
+
+	sk = nl_socket_alloc();
+	if (!sk)
+		return NULL;
+
+	if (nl_connect(sk, NETLINK_USERSOCK)) {
+		nl_socket_free(sk);
+		return NULL;
+	}
+
+	nl_socket_set_peer_port(sk, f->port);
+	return sk;
+}
+
+/* Query 'num' stas with upto 'window' requests in flight. With 'fresh',
+ * every request goes on its own new socket, as nlwifi_vendor_cmd() does.
+ */
+static int bench_run(struct fake_responder *f, struct nlwifi_vendor_req *req,
+		     int num, int window, int fresh, uint64_t *elapsed)
+{
+	struct nl_sock *sk = NULL;
+	uint64_t start;
+	int ret = 0;
+	int i;
+
+	start = now_usecs();
+	if (fresh) {
+		for (i = 0; i < num && !ret; i++) {
+			sk = fake_client(f);
+			if (!sk)
+				return -1;
+
+			ret = nlwifi_vendor_cmd_pipeline(sk, FAKE_FAMILY, 1,
+							 FAKE_VID, &req[i], 1, 1);
+			nl_socket_free(sk);
+		}
+	} else {
+		sk = fake_client(f);
+		if (!sk)
+			return -1;
+
+		ret = nlwifi_vendor_cmd_pipeline(sk, FAKE_FAMILY, 1, FAKE_VID,
+						 req, num, window);
+		nl_socket_free(sk);
+	}
+	*elapsed = now_usecs() - start;
+
+	if (ret)
+		return ret;
+
+	for (i = 0; i < num; i++) {
+		if (req[i].status || req[i].olen != f->payload ||
+		    memcmp(req[i].out, req[i].in, 6)) {
+			fprintf(stderr, "req %d: status %d olen %d: bad reply\n",
+				i, req[i].status, req[i].olen);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"Usage: %s [-n stas] [-l latency_us] [-s service_us] [-p payload] [-w window]\n",
+		prog);
+}
+
+int main(int argc, char **argv)
+{
+	struct fake_responder f = {
+		.latency = 500,
+		.service = 20,
+		.payload = sizeof(mtlk_sta_info_t),
+	};
+	struct nlwifi_vendor_req *req;
+	uint8_t (*macs)[6];
+	uint8_t *out;
+	uint64_t t_fresh, t_serial, t_pipe;
+	int window = NLWIFI_VENDOR_WINDOW;
+	int num = 64;
+	int ret;
+	int ch;
+	int i;
+
+	while ((ch = getopt(argc, argv, "n:l:s:p:w:h")) != -1) {
+		switch (ch) {
+		case 'n':
+			num = atoi(optarg);
+			break;
+		case 'l':
+			f.latency = strtoull(optarg, NULL, 10);
+			break;
+		case 's':
+			f.service = strtoull(optarg, NULL, 10);
+			break;
+		case 'p':
+			f.payload = atoi(optarg);
+			break;
+		case 'w':
+			window = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return ch == 'h' ? 0 : 1;
+		}
+	}
+
+	if (num <= 0 || num > FAKE_MAXQ || f.payload < 6 || f.payload > 4096) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	req = calloc(num, sizeof(*req));
+	macs = calloc(num, sizeof(*macs));
+	out = calloc(num, f.payload);
+	if (!req || !macs || !out)
+		return 1;
+
+	for (i = 0; i < num; i++) {
+		macs[i][0] = 0x02;
+		macs[i][4] = (i >> 8) & 0xff;
+		macs[i][5] = i & 0xff;
+
+		req[i].subcmd = FAKE_SUBCMD;
+		req[i].in = macs[i];
+		req[i].ilen = 6;
+		req[i].out = out + i * f.payload;
+		req[i].osize = f.payload;
+	}
+
+	ret = fake_responder_start(&f);
+	if (ret) {
+		fprintf(stderr, "failed to start responder: %s\n", strerror(-ret));
+		return 1;
+	}
+
+	ret = bench_run(&f, req, num, 1, 1, &t_fresh);
+	if (!ret)
+		ret = bench_run(&f, req, num, 1, 0, &t_serial);
+	if (!ret)
+		ret = bench_run(&f, req, num, window, 0, &t_pipe);
+
+	fake_responder_stop(&f);
+
+	if (ret) {
+		fprintf(stderr, "benchmark failed\n");
+		return 1;
+	}
+
+	printf("stas %d, payload %d bytes, latency %llu us, service %llu us\n",
+	       num, f.payload, (unsigned long long)f.latency,
+	       (unsigned long long)f.service);
+	printf("%-28s %10llu us\n", "socket per request:",
+	       (unsigned long long)t_fresh);
+	printf("%-28s %10llu us\n", "one socket, serial:",
+	       (unsigned long long)t_serial);
+	printf("one socket, window %-9d %10llu us  (x%.1f)\n", window,
+	       (unsigned long long)t_pipe,
+	       t_pipe ? (double)t_fresh / (double)t_pipe : 0.0);
+
+	free(out);
+	free(macs);
+	free(req);
+	return 0;
+}
@@ -0,0 +1,33 @@
+#!/bin/sh
+#
+# hwsim_frames.sh - run test_hwsim_frames on a mac80211_hwsim IBSS iface,
+# with frames injected from a monitor iface of another radio.
+#
+# No hostapd here: it registers for the probe requests and action frames
+# the test subscribes to, and a frame is registered once per iface.
+#
+# Needs root, the mac80211_hwsim module, iw and a libwifi built with
+# WIFI_TYPE=MAC80211.
+
+set -e
+
+IF=wlan0
+MON=wlan1
+
+cleanup() {
+	rmmod mac80211_hwsim 2>/dev/null
+}
+trap cleanup EXIT
+
+modprobe mac80211_hwsim radios=2
+sleep 1
+
+iw dev $IF set type ibss
+ip link set $IF up
+iw dev $IF ibss join libwifi-hwsim 2437 fixed-freq 02:00:00:00:aa:00
+
+iw dev $MON set type monitor
+ip link set $MON up
+iw dev $MON set freq 2437
+
+LD_LIBRARY_PATH=..:../../libeasy ./test_hwsim_frames $IF $MON
@@ -0,0 +1,63 @@
+#!/bin/sh
+#
+# hwsim_stats.sh - run test_hwsim_stats and bench_sta_info_mask on a
+# mac80211_hwsim AP with one sta in its own network namespace, passing
+# traffic.
+#
+# Needs root, the mac80211_hwsim module, hostapd, wpa_supplicant, iw and
+# a libwifi built with WIFI_TYPE=MAC80211.
+
+set -e
+
+AP=wlan0
+STA=wlan1
+NS=libwifi-hwsim
+TMP=$(mktemp -d)
+
+cleanup() {
+	[ -f $TMP/hostapd.pid ] && kill $(cat $TMP/hostapd.pid) 2>/dev/null
+	ip netns pids $NS 2>/dev/null | xargs -r kill 2>/dev/null
+	ip netns del $NS 2>/dev/null
+	rmmod mac80211_hwsim 2>/dev/null
+	rm -rf $TMP
+}
+trap cleanup EXIT
+
+modprobe mac80211_hwsim radios=2
+sleep 1
+
+cat > $TMP/hostapd.conf <<EOF
+interface=$AP
+driver=nl80211
+ctrl_interface=/var/run/hostapd
+ssid=libwifi-hwsim
+hw_mode=g
+channel=6
+ieee80211n=1
+EOF
+
+cat > $TMP/wpa_supplicant.conf <<EOF
+network={
+	ssid="libwifi-hwsim"
+	key_mgmt=NONE
+}
+EOF
+
+hostapd -B -P $TMP/hostapd.pid $TMP/hostapd.conf
+ip addr add 192.168.77.1/24 dev $AP
+
+ip netns add $NS
+iw phy $(cat /sys/class/net/$STA/phy80211/name) set netns name $NS
+ip netns exec $NS ip link set $STA up
+ip netns exec $NS wpa_supplicant -B -i $STA -c $TMP/wpa_supplicant.conf
+ip netns exec $NS ip addr add 192.168.77.2/24 dev $STA
+
+for i in $(seq 1 20); do
+	ip netns exec $NS iw dev $STA link | grep -q Connected && break
+	sleep 1
+done
+
+ping -c 50 -i 0.05 192.168.77.2 > /dev/null
+
+LD_LIBRARY_PATH=..:../../libeasy ./test_hwsim_stats $AP
+LD_LIBRARY_PATH=..:../../libeasy ./bench_sta_info_mask $AP
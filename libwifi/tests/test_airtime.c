@@ -0,0 +1,157 @@
+/*
+ * test_airtime.c - check the per-sta airtime accounting against synthetic
+ * Tx/Rx duration counter sequences.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+#define IFNAME		"wlan0"
+
+static void sample(struct wifi_sta *sta, int id, uint64_t tx, uint64_t rx)
+{
+	memset(sta, 0, sizeof(*sta));
+	memcpy(sta->macaddr, "\x02\x00\x00\x00\x00\x00", 6);
+	sta->macaddr[5] = id;
+	sta->tx_duration = tx;
+	sta->rx_duration = rx;
+}
+
+static void test_sta(void)
+{
+	struct wifi_sta sta;
+
+	/* first sample only sets the baseline */
+	sample(&sta, 1, 5000000, 1000000);
+	wifi_airtime_update(IFNAME, &sta, 10000);
+	CHECK(sta.tx_airtime == 0 && sta.rx_airtime == 0 && sta.airtime == 0,
+	      "first sample has no airtime\n");
+
+	/* 200ms Tx and 100ms Rx over 1s */
+	sample(&sta, 1, 5200000, 1100000);
+	wifi_airtime_update(IFNAME, &sta, 11000);
+	CHECK(sta.tx_airtime == 200 && sta.rx_airtime == 100 &&
+	      sta.airtime == 30,
+	      "tx %" PRIu64 " rx %" PRIu64 " ms/s, %d%%\n",
+	      sta.tx_airtime, sta.rx_airtime, sta.airtime);
+
+	/* 100ms Tx over 2s */
+	sample(&sta, 1, 5300000, 1100000);
+	wifi_airtime_update(IFNAME, &sta, 13000);
+	CHECK(sta.tx_airtime == 50 && sta.rx_airtime == 0 && sta.airtime == 5,
+	      "tx %" PRIu64 " rx %" PRIu64 " ms/s over 2s\n",
+	      sta.tx_airtime, sta.rx_airtime);
+
+	/* sample at the same time is ignored */
+	sample(&sta, 1, 9000000, 9000000);
+	wifi_airtime_update(IFNAME, &sta, 13000);
+	CHECK(sta.tx_airtime == 0, "sample at same time ignored\n");
+
+	/* counters going back restart the accounting */
+	sample(&sta, 1, 1000, 1000);
+	wifi_airtime_update(IFNAME, &sta, 14000);
+	CHECK(sta.tx_airtime == 0 && sta.rx_airtime == 0,
+	      "counter reset has no airtime\n");
+
+	sample(&sta, 1, 401000, 1000);
+	wifi_airtime_update(IFNAME, &sta, 15000);
+	CHECK(sta.tx_airtime == 400 && sta.airtime == 40,
+	      "tx %" PRIu64 " ms/s after reset\n", sta.tx_airtime);
+
+	/* more than the interval's worth is capped at 100% */
+	sample(&sta, 1, 1401000, 501000);
+	wifi_airtime_update(IFNAME, &sta, 16000);
+	CHECK(sta.airtime == 100, "airtime capped at %d%%\n", sta.airtime);
+
+	wifi_airtime_flush();
+}
+
+static void test_bss(void)
+{
+	struct wifi_sta stas[3];
+	struct wifi_airtime a;
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		sample(&stas[i], i, 1000000, 1000000);
+		wifi_airtime_update(IFNAME, &stas[i], 20000);
+	}
+
+	/* sta on another iface is not accounted */
+	sample(&stas[0], 9, 1000000, 1000000);
+	wifi_airtime_update("wlan1", &stas[0], 20000);
+	sample(&stas[0], 9, 1500000, 1000000);
+	wifi_airtime_update("wlan1", &stas[0], 21000);
+
+	for (i = 0; i < 3; i++) {
+		sample(&stas[i], i, 1000000 + 100000 * (i + 1), 1050000);
+		wifi_airtime_update(IFNAME, &stas[i], 21000);
+	}
+
+	wifi_airtime_get_bss(IFNAME, &a, 21000);
+	CHECK(a.num_stas == 3 && a.tx_airtime == 600 && a.rx_airtime == 150 &&
+	      a.airtime == 75 && a.interval == 1000,
+	      "bss %d stas tx %u rx %u ms/s, %u%% over %ums\n", a.num_stas,
+	      a.tx_airtime, a.rx_airtime, a.airtime, a.interval);
+
+	/* stale samples are not accounted */
+	wifi_airtime_get_bss(IFNAME, &a, 60000);
+	CHECK(a.num_stas == 0 && a.airtime == 0, "stale samples dropped\n");
+
+	/* sta 1 disassociated */
+	sample(&stas[1], 2, 0, 0);
+	wifi_airtime_expire(IFNAME, stas, 2);
+	wifi_airtime_get_bss(IFNAME, &a, 21000);
+	CHECK(a.num_stas == 2 && a.tx_airtime == 400,
+	      "after expiry %d stas tx %u ms/s\n", a.num_stas, a.tx_airtime);
+
+	wifi_airtime_get_bss("wlan1", &a, 21000);
+	CHECK(a.num_stas == 1 && a.tx_airtime == 500,
+	      "other iface %d stas tx %u ms/s\n", a.num_stas, a.tx_airtime);
+
+	wifi_airtime_flush();
+}
+
+int main(int argc, char **argv)
+{
+	test_sta();
+	test_bss();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,200 @@
+/*
+ * test_bssdb.c - feed scan results of several radios into the BSS database,
+ * and check merging, RSSI EWMA, channel history, per-channel lists, TTL and
+ * size bounds.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+static void bss(struct wifi_bss *b, int id, enum wifi_band band,
+		uint8_t channel, int rssi)
+{
+	memset(b, 0, sizeof(*b));
+	memcpy(b->bssid, "\x02\x00\x00\x00\x00\x00", 6);
+	b->bssid[4] = id >> 8;
+	b->bssid[5] = id & 0xff;
+	snprintf((char *)b->ssid, sizeof(b->ssid), "bss%d", id);
+	b->band = band;
+	b->channel = channel;
+	b->rssi = rssi;
+}
+
+static int seen(int id, struct wifi_bssdb_entry *e)
+{
+	struct wifi_bss b;
+
+	bss(&b, id, BAND_5, 0, 0);
+	return wifi_bssdb_lookup(b.bssid, e);
+}
+
+static void test_merge(void)
+{
+	uint64_t now = time_monotonic_msecs();
+	struct wifi_bssdb_entry e[4];
+	struct wifi_bss b[2];
+	int num;
+
+	wifi_bssdb_flush(NULL);
+	CHECK(wifi_bssdb_need_refresh("wifi0", now), "refresh: needed first\n");
+
+	bss(&b[0], 1, BAND_5, 36, -60);
+	bss(&b[1], 2, BAND_5, 36, -70);
+	wifi_bssdb_update("wifi0", b, 2, true, now - 20);
+	CHECK(!wifi_bssdb_need_refresh("wifi0", now), "refresh: not needed after\n");
+	CHECK(wifi_bssdb_need_refresh("wifi1", now), "refresh: per radio\n");
+
+	bss(&b[0], 1, BAND_5, 36, -40);
+	bss(&b[1], 3, BAND_2, 1, -50);
+	wifi_bssdb_update("wifi1", b, 2, true, now - 10);
+
+	CHECK(seen(1, e) == 0 && e->num_seen == 2 &&
+	      e->first_seen == now - 20 && e->last_seen == now - 10 &&
+	      !strcmp(e->ifname, "wifi1") && e->bss.rssi == -40,
+	      "merge: seen by both radios\n");
+	CHECK(e->rssi_ewma == -55, "merge: rssi ewma %d\n", e->rssi_ewma);
+	CHECK(seen(4, e) == -ENOENT, "lookup: unknown bss\n");
+
+	num = ARRAY_SIZE(e);
+	CHECK(wifi_bssdb_get_channel(BAND_5, 36, e, &num) == 0 && num == 2,
+	      "channel 36: %d bss\n", num);
+	num = ARRAY_SIZE(e);
+	CHECK(wifi_bssdb_get_channel(BAND_6, 1, e, &num) == 0 && num == 0 &&
+	      wifi_bssdb_count(BAND_2, 1) == 1,
+	      "channel 1: only on its band\n");
+	CHECK(wifi_bssdb_count(BAND_5, 0) == 2, "band: 2 bss on 5GHz\n");
+
+	wifi_bssdb_stale("wifi0");
+	CHECK(wifi_bssdb_need_refresh("wifi0", now), "refresh: needed if stale\n");
+}
+
+static void test_channel_history(void)
+{
+	uint64_t now = time_monotonic_msecs();
+	static const uint8_t chans[] = { 40, 40, 44, 36, 48, 52 };
+	struct wifi_bssdb_entry e;
+	struct wifi_bss b;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(chans); i++) {
+		bss(&b, 1, BAND_5, chans[i], -60);
+		wifi_bssdb_update("wifi0", &b, 1, false, now);
+	}
+
+	CHECK(seen(1, &e) == 0 && e.num_channel == WIFI_BSSDB_CHAN_HISTORY &&
+	      e.channel[0] == 52 && e.channel[1] == 48 && e.channel[2] == 36 &&
+	      e.channel[3] == 44, "channel history: latest first\n");
+	CHECK(wifi_bssdb_count(BAND_5, 36) == 1 &&
+	      wifi_bssdb_count(BAND_5, 52) == 1,
+	      "channel history: moved off old channel\n");
+}
+
+static void test_ttl(void)
+{
+	uint64_t now = time_monotonic_msecs();
+	struct wifi_bssdb_entry e;
+	struct wifi_bss b;
+
+	CHECK(wifi_bssdb_config(1000, 16, 25) == 0, "ttl: 1000 msecs\n");
+	bss(&b, 5, BAND_5, 100, -80);
+	wifi_bssdb_update("wifi0", &b, 1, false, now - 2000);
+	bss(&b, 6, BAND_5, 100, -80);
+	wifi_bssdb_update("wifi0", &b, 1, false, now);
+
+	CHECK(seen(5, &e) == -ENOENT && seen(6, &e) == 0,
+	      "ttl: older bss dropped\n");
+	CHECK(wifi_bssdb_count(BAND_5, 100) == 1, "ttl: channel list updated\n");
+}
+
+static void test_bounds(void)
+{
+	uint64_t now = time_monotonic_msecs();
+	struct wifi_bssdb_entry e;
+	struct wifi_bss b;
+	int n = 0;
+	int i;
+
+	wifi_bssdb_flush(NULL);
+	CHECK(wifi_bssdb_config(60000, 4, 25) == 0, "bounds: up to 4 bss\n");
+	for (i = 0; i < 6; i++) {
+		bss(&b, 10 + i, BAND_5, 36, -60);
+		wifi_bssdb_update("wifi0", &b, 1, false, now + i);
+	}
+
+	for (i = 0; i < 6; i++)
+		n += seen(10 + i, &e) == 0;
+
+	CHECK(n == 4 && seen(10, &e) && seen(11, &e),
+	      "bounds: least recently seen dropped\n");
+	CHECK(wifi_bssdb_count(BAND_5, 36) == 4, "bounds: 4 on channel\n");
+
+	CHECK(wifi_bssdb_config(60000, 2048, 25) == 0, "bounds: up to 2048 bss\n");
+	for (i = 0; i < 2000; i++) {
+		bss(&b, 1000 + i, BAND_5, 36 + 4 * (i % 8), -60);
+		wifi_bssdb_update(i % 2 ? "wifi0" : "wifi1", &b, 1, false, now);
+	}
+
+	n = 0;
+	for (i = 0; i < 2000; i++)
+		n += seen(1000 + i, &e) == 0;
+
+	CHECK(n == 2000 && wifi_bssdb_count(BAND_5, 0) == 2004,
+	      "bounds: %d bss found\n", n);
+
+	wifi_bssdb_flush("wifi1");
+	CHECK(wifi_bssdb_count(BAND_5, 0) == 1004 && seen(1000, &e) &&
+	      seen(1001, &e) == 0, "flush: bss of a radio\n");
+	wifi_bssdb_flush(NULL);
+	CHECK(wifi_bssdb_count(BAND_5, 0) == 0, "flush: all bss\n");
+}
+
+int main(int argc, char **argv)
+{
+	CHECK(wifi_bssdb_config(0, 16, 25) == -EINVAL &&
+	      wifi_bssdb_config(1000, 16, 0) == -EINVAL,
+	      "config: invalid values\n");
+
+	test_merge();
+	test_channel_history();
+	test_ttl();
+	test_bounds();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,249 @@
+/*
+ * test_chscore.c - get noise, busy, score and neighbours of wider channels
+ * from the per 20MHz channel aggregates, and check them against walking
+ * the channel list and the BSS database for each member channel.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+/* member channels as chan2list() and the 2.4GHz lists give them */
+static const int members[][12] = {
+	{ 36, 0 },
+	{ 36, 40, 0 },
+	{ 36, 40, 44, 48, 0 },
+	{ 36, 40, 44, 48, 52, 56, 60, 64, 0 },
+	{ 100, 104, 108, 112, 0 },
+	{ 149, 153, 157, 161, 0 },
+	{ 165, 0 },
+	{ 1, 2, 3, 4, 5, 0 },
+	{ 13, 14, 8, 9, 10, 11, 12, 0 },
+	{ 6, 10, 0 },
+	{ 1, 5, 9, 13, 0 },
+	{ 40, 36, 0 },
+	{ 233, 0 },
+};
+
+#define NUM_CHAN	128
+
+static struct chan_entry chan[NUM_CHAN];
+static int chan_num;
+
+/* 2.4, 5 and 6GHz channels, with 6GHz ones reusing 2.4GHz numbers */
+static void make_channels(unsigned int seed)
+{
+	static const int chans5[] = {
+		36, 40, 44, 48, 52, 56, 60, 64, 100, 104, 108, 112, 116, 120,
+		124, 128, 132, 136, 140, 144, 149, 153, 157, 161, 165,
+	};
+	int i;
+
+	srand(seed);
+	memset(chan, 0, sizeof(chan));
+	chan_num = 0;
+
+	for (i = 1; i <= 14; i++) {
+		chan[chan_num].channel = i;
+		chan[chan_num++].band = BAND_2;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(chans5); i++) {
+		chan[chan_num].channel = chans5[i];
+		chan[chan_num++].band = BAND_5;
+	}
+
+	for (i = 1; i <= 233; i += 4) {
+		chan[chan_num].channel = i;
+		chan[chan_num++].band = BAND_6;
+	}
+
+	for (i = 0; i < chan_num; i++) {
+		chan[i].noise = -100 + rand() % 20;
+		chan[i].busy = rand() % 8 ? rand() % 101 : 255;
+		chan[i].score = rand() % 8 ? rand() % 101 : 255;
+	}
+}
+
+static struct chan_entry *first(int channel)
+{
+	int i;
+
+	for (i = 0; i < chan_num; i++) {
+		if (chan[i].channel == channel)
+			return &chan[i];
+	}
+
+	return NULL;
+}
+
+static int ref_noise(const int *c)
+{
+	struct chan_entry *ch;
+	int noise = -255;
+
+	for (; *c; c++) {
+		ch = first(*c);
+		if (ch && ch->noise > noise)
+			noise = ch->noise;
+	}
+
+	return noise;
+}
+
+static uint8_t ref_avg(const int *c, bool busy)
+{
+	struct chan_entry *ch;
+	int sum = 0;
+	int n = 0;
+	int v;
+
+	for (; *c; c++) {
+		ch = first(*c);
+		if (!ch)
+			continue;
+
+		v = busy ? ch->busy : ch->score;
+		if ((busy && v > 100) || v == 255)
+			return 255;
+
+		sum += v;
+		n++;
+	}
+
+	return n ? sum / n : 255;
+}
+
+static int ref_bss(enum wifi_band band, const int *c)
+{
+	int n = 0;
+
+	for (; *c; c++)
+		n += wifi_bssdb_count(band, (uint8_t)*c);
+
+	return n;
+}
+
+static void add_bss(int num)
+{
+	static const enum wifi_band bands[] = { BAND_2, BAND_5, BAND_6 };
+	uint64_t now = time_monotonic_msecs();
+	struct wifi_bss b;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		memset(&b, 0, sizeof(b));
+		memcpy(b.bssid, "\x02\x00\x00\x00\x00\x00", 6);
+		b.bssid[3] = i >> 16;
+		b.bssid[4] = i >> 8;
+		b.bssid[5] = i & 0xff;
+		b.band = bands[rand() % 3];
+		b.channel = chan[rand() % chan_num].channel;
+		b.rssi = -60;
+		wifi_bssdb_update("wifi0", &b, 1, false, now);
+	}
+}
+
+static void test_members(unsigned int seed, int num_bss)
+{
+	static const enum wifi_band bands[] = { BAND_2, BAND_5, BAND_6 };
+	struct chscore *cs;
+	int ok[4] = { 1, 1, 1, 1 };
+	int i, b;
+
+	cs = calloc(1, sizeof(*cs));
+	if (!cs)
+		return;
+
+	make_channels(seed);
+	wifi_bssdb_flush(NULL);
+	add_bss(num_bss);
+	wifi_chscore_init(cs, chan, chan_num);
+
+	for (i = 0; i < ARRAY_SIZE(members); i++) {
+		ok[0] &= wifi_chscore_noise(cs, members[i]) == ref_noise(members[i]);
+		ok[1] &= wifi_chscore_busy(cs, members[i]) == ref_avg(members[i], true);
+		ok[2] &= wifi_chscore_score(cs, members[i]) == ref_avg(members[i], false);
+		for (b = 0; b < ARRAY_SIZE(bands); b++) {
+			ok[3] &= wifi_chscore_bss_num(cs, bands[b], members[i]) ==
+				 ref_bss(bands[b], members[i]);
+		}
+	}
+
+	CHECK(ok[0] && ok[1] && ok[2],
+	      "seed %u: noise, busy and score of member channels\n", seed);
+	CHECK(ok[3] && wifi_chscore_band_bss_num(cs, BAND_6) ==
+		       wifi_bssdb_count(BAND_6, 0),
+	      "seed %u: %d neighbours on member channels\n", seed, num_bss);
+
+	free(cs);
+}
+
+static void test_empty(void)
+{
+	struct chscore *cs;
+
+	cs = calloc(1, sizeof(*cs));
+	if (!cs)
+		return;
+
+	wifi_bssdb_flush(NULL);
+	wifi_chscore_init(cs, chan, 0);
+	CHECK(wifi_chscore_noise(cs, members[2]) == -255 &&
+	      wifi_chscore_busy(cs, members[2]) == 255 &&
+	      wifi_chscore_score(cs, members[2]) == 255 &&
+	      wifi_chscore_bss_num(cs, BAND_5, members[2]) == 0 &&
+	      wifi_chscore_busy(cs, NULL) == 255,
+	      "no channels: nothing known\n");
+
+	free(cs);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int seed;
+
+	wifi_bssdb_config(60000, 4096, 25);
+	for (seed = 1; seed <= 8; seed++)
+		test_members(seed, seed * 300);
+
+	test_empty();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,209 @@
+/*
+ * test_coalesce.c - hammer the test driver from many threads with identical
+ * queries, and check coalesced results and hit/miss counters.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST */
+#define RADIO		"test5"
+#define AP		"test2"
+#define NUM_THREADS	16
+#define NUM_ITER	2000
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+static struct wifi_radio_stats ref_radio;
+static struct wifi_ap_stats ref_ap;
+static uint8_t ref_stas[64 * 6];
+static int ref_num;
+
+static pthread_barrier_t start;
+
+/* results differing from the reference, per thread */
+static int mismatch[NUM_THREADS];
+
+static void *hammer(void *arg)
+{
+	int *bad = arg;
+	int i;
+
+	pthread_barrier_wait(&start);
+
+	for (i = 0; i < NUM_ITER; i++) {
+		struct wifi_radio_stats rs;
+		struct wifi_ap_stats as;
+		uint8_t stas[64 * 6];
+		int num = 64;
+
+		memset(&rs, 0xff, sizeof(rs));
+		if (wifi_radio_get_stats(RADIO, &rs) ||
+		    memcmp(&rs, &ref_radio, sizeof(rs)))
+			(*bad)++;
+
+		memset(&as, 0xff, sizeof(as));
+		if (wifi_ap_get_stats(AP, &as) ||
+		    memcmp(&as, &ref_ap, sizeof(as)))
+			(*bad)++;
+
+		memset(stas, 0xff, sizeof(stas));
+		if (wifi_get_assoclist(AP, stas, &num) || num != ref_num ||
+		    memcmp(stas, ref_stas, num * 6))
+			(*bad)++;
+	}
+
+	return NULL;
+}
+
+static int run_threads(void)
+{
+	pthread_t t[NUM_THREADS];
+	int bad = 0;
+	int i;
+
+	memset(mismatch, 0, sizeof(mismatch));
+	pthread_barrier_init(&start, NULL, NUM_THREADS);
+
+	for (i = 0; i < NUM_THREADS; i++)
+		pthread_create(&t[i], NULL, hammer, &mismatch[i]);
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		pthread_join(t[i], NULL);
+		bad += mismatch[i];
+	}
+
+	pthread_barrier_destroy(&start);
+	return bad;
+}
+
+static void get_stats(struct wifi_coalesce_stats *s)
+{
+	enum wifi_coalesce_op op;
+
+	for (op = 0; op < WIFI_COALESCE_NUM_OPS; op++)
+		wifi_get_coalesce_stats(op, &s[op]);
+}
+
+static void test_reference(void)
+{
+	int ret;
+
+	ret = wifi_radio_get_stats(RADIO, &ref_radio);
+	ret |= wifi_ap_get_stats(AP, &ref_ap);
+	ref_num = 64;
+	ret |= wifi_get_assoclist(AP, ref_stas, &ref_num);
+	CHECK(ret == 0 && ref_num > 0, "reference results, %d stas\n", ref_num);
+}
+
+static void test_disabled(void)
+{
+	struct wifi_coalesce_stats s[WIFI_COALESCE_NUM_OPS];
+	int bad;
+
+	bad = run_threads();
+	get_stats(s);
+	CHECK(bad == 0, "disabled: %d bad results\n", bad);
+	CHECK(s[WIFI_COALESCE_RADIO_STATS].hit == 0 &&
+	      s[WIFI_COALESCE_RADIO_STATS].miss == 0,
+	      "disabled: nothing counted\n");
+}
+
+static void test_inflight(void)
+{
+	struct wifi_coalesce_stats b[WIFI_COALESCE_NUM_OPS];
+	struct wifi_coalesce_stats s[WIFI_COALESCE_NUM_OPS];
+	const uint64_t total = NUM_THREADS * NUM_ITER;
+	enum wifi_coalesce_op op;
+	int bad;
+
+	wifi_coalesce_config(true, 0);
+	get_stats(b);
+	bad = run_threads();
+	get_stats(s);
+	CHECK(bad == 0, "in flight: %d bad results\n", bad);
+
+	for (op = 0; op < WIFI_COALESCE_NUM_OPS; op++) {
+		uint64_t hit = s[op].hit - b[op].hit;
+		uint64_t miss = s[op].miss - b[op].miss;
+
+		if (op != WIFI_COALESCE_RADIO_STATS &&
+		    op != WIFI_COALESCE_AP_STATS &&
+		    op != WIFI_COALESCE_ASSOCLIST)
+			continue;
+
+		/* no reuse window: only waiters share */
+		CHECK(hit + miss == total && s[op].wait - b[op].wait == hit,
+		      "in flight: op %d hit %" PRIu64 " miss %" PRIu64 "\n",
+		      op, hit, miss);
+	}
+}
+
+static void test_ttl(void)
+{
+	struct wifi_coalesce_stats b[WIFI_COALESCE_NUM_OPS];
+	struct wifi_coalesce_stats s[WIFI_COALESCE_NUM_OPS];
+	const uint64_t total = NUM_THREADS * NUM_ITER;
+	int bad;
+
+	/* long enough for the whole run */
+	wifi_coalesce_config(true, 60000);
+	get_stats(b);
+	bad = run_threads();
+	get_stats(s);
+	CHECK(bad == 0, "ttl: %d bad results\n", bad);
+	CHECK(s[WIFI_COALESCE_RADIO_STATS].miss -
+	      b[WIFI_COALESCE_RADIO_STATS].miss == 1 &&
+	      s[WIFI_COALESCE_RADIO_STATS].hit -
+	      b[WIFI_COALESCE_RADIO_STATS].hit == total - 1,
+	      "ttl: radio stats queried once\n");
+	CHECK(s[WIFI_COALESCE_ASSOCLIST].miss -
+	      b[WIFI_COALESCE_ASSOCLIST].miss == 1,
+	      "ttl: assoclist queried once\n");
+
+	wifi_coalesce_config(false, 0);
+}
+
+int main(int argc, char **argv)
+{
+	test_reference();
+	test_disabled();
+	test_inflight();
+	test_ttl();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
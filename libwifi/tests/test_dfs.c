@@ -0,0 +1,181 @@
+/*
+ * test_dfs.c - track DFS state of the test driver's radios from a script
+ * of DFS events, and check their preferred operating classes follow.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST. Its 5GHz channels 52-144
+ * are DFS and available; events are replayed from LIBWIFI_TEST_DFS.
+ */
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+#define SCRIPT	"test5 cac_started 100/80;" \
+		"test5 cac_finished 100/80;" \
+		"test5 radar 104/20;" \
+		"test5 cac_started 52/20;" \
+		"test5 cac_aborted 52/20;" \
+		"test5 radar 60/20;" \
+		"test5 nop_finished 60/20;" \
+		"test5 lost"
+
+static enum dfs_state state(uint32_t channel, enum wifi_bw bw,
+			    uint32_t *nop_time)
+{
+	enum dfs_state s = WIFI_DFS_STATE_NONE;
+
+	if (wifi_dfs_get_state("test5", channel, bw, &s, NULL, nop_time))
+		return -1;
+
+	return s;
+}
+
+/* Replay the script up to 'n' events */
+static void step(int n)
+{
+	char script[sizeof(SCRIPT)];
+	char *p = script;
+	int i;
+
+	memcpy(script, SCRIPT, sizeof(script));
+	for (i = 0; i < n && p; i++) {
+		p = strchr(p, ';');
+		if (p)
+			p++;
+	}
+
+	if (p)
+		p[-1] = '\0';
+
+	setenv("LIBWIFI_TEST_DFS", script, 1);
+}
+
+static enum dfs_state opclass_state(uint32_t g_opclass, uint32_t channel)
+{
+	static struct wifi_opclass o[64];
+	int num = ARRAY_SIZE(o);
+	int i, j;
+
+	if (wifi_get_opclass_pref("test5", &num, o))
+		return -1;
+
+	for (i = 0; i < num; i++) {
+		if (o[i].g_opclass != g_opclass)
+			continue;
+
+		for (j = 0; j < o[i].opchannel.num; j++) {
+			if (o[i].opchannel.ch[j].channel == channel)
+				return o[i].opchannel.ch[j].dfs_state;
+		}
+	}
+
+	return -1;
+}
+
+static void test_events(void)
+{
+	uint32_t nop = 0;
+
+	wifi_dfs_config(300);
+
+	/* seeded from the channels */
+	CHECK(state(100, BW80, NULL) == WIFI_DFS_STATE_AVAILABLE &&
+	      state(36, BW20, NULL) == WIFI_DFS_STATE_NONE &&
+	      opclass_state(121, 100) == WIFI_DFS_STATE_AVAILABLE,
+	      "seed: 100 available, 36 not DFS\n");
+
+	step(1);
+	CHECK(state(100, BW80, NULL) == WIFI_DFS_STATE_CAC &&
+	      state(108, BW20, NULL) == WIFI_DFS_STATE_CAC &&
+	      state(52, BW20, NULL) == WIFI_DFS_STATE_AVAILABLE,
+	      "cac started: 100-112\n");
+
+	CHECK(opclass_state(121, 104) == WIFI_DFS_STATE_CAC,
+	      "cac started: in opclass 121\n");
+
+	step(2);
+	CHECK(state(100, BW80, NULL) == WIFI_DFS_STATE_AVAILABLE,
+	      "cac finished: 100-112 available\n");
+
+	step(3);
+	CHECK(state(104, BW20, &nop) == WIFI_DFS_STATE_UNAVAILABLE && nop == 1 &&
+	      state(100, BW80, NULL) == WIFI_DFS_STATE_UNAVAILABLE &&
+	      state(100, BW20, NULL) == WIFI_DFS_STATE_AVAILABLE,
+	      "radar: 104 unavailable, %u secs\n", nop);
+
+	CHECK(opclass_state(121, 104) == WIFI_DFS_STATE_UNAVAILABLE,
+	      "radar: in opclass 121\n");
+
+	usleep(400000);
+	CHECK(state(104, BW20, &nop) == WIFI_DFS_STATE_USABLE && nop == 0 &&
+	      opclass_state(121, 104) == WIFI_DFS_STATE_USABLE,
+	      "nop: 104 usable after it\n");
+
+	/* 100-112 a mix of usable and available */
+	CHECK(state(100, BW80, NULL) == WIFI_DFS_STATE_USABLE &&
+	      !wifi_is_dfs_usable("test5", 100, BW80) &&
+	      wifi_is_dfs_usable("test5", 104, BW20) &&
+	      wifi_is_dfs_usable("test5", 36, BW20),
+	      "usable: only if all of 100-112 are\n");
+
+	step(5);
+	CHECK(state(52, BW20, NULL) == WIFI_DFS_STATE_USABLE,
+	      "cac aborted: 52 usable\n");
+
+	step(7);
+	CHECK(state(60, BW20, NULL) == WIFI_DFS_STATE_USABLE,
+	      "nop finished: 60 usable\n");
+
+	/* started over from the channels */
+	step(8);
+	CHECK(state(52, BW20, NULL) == WIFI_DFS_STATE_AVAILABLE &&
+	      state(104, BW20, NULL) == WIFI_DFS_STATE_AVAILABLE,
+	      "lost: seeded again\n");
+
+	unsetenv("LIBWIFI_TEST_DFS");
+	state(36, BW20, NULL);
+}
+
+int main(int argc, char **argv)
+{
+	test_events();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
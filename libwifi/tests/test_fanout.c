@@ -0,0 +1,143 @@
+/*
+ * test_fanout.c - check wifi_fanout() keeps to a bounded pool of workers
+ * across calls, and doesn't queue queries behind a radio still busy with
+ * one that timed out.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST. Each query of the test driver
+ * takes LATENCY usecs.
+ */
+#define LATENCY		"100000"
+#define NUM_RADIOS	6
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+static int num_threads(void)
+{
+	struct dirent *d;
+	DIR *dir;
+	int num = 0;
+
+	dir = opendir("/proc/self/task");
+	if (!dir)
+		return -1;
+
+	while ((d = readdir(dir))) {
+		if (d->d_name[0] != '.')
+			num++;
+	}
+	closedir(dir);
+
+	return num;
+}
+
+/* radio stats of 'num' radios, test2.0, test2.1 ... */
+static int radio_stats(struct wifi_fanout_req *req,
+		       struct wifi_radio_stats *out, int num, int timeout)
+{
+	int i;
+
+	memset(req, 0, num * sizeof(*req));
+	for (i = 0; i < num; i++) {
+		req[i].op = WIFI_FANOUT_RADIO_STATS;
+		snprintf(req[i].ifname, sizeof(req[i].ifname), "test2.%d", i);
+		req[i].out = &out[i];
+	}
+
+	return wifi_fanout(req, num, timeout);
+}
+
+static void test_pool(void)
+{
+	struct wifi_fanout_req req[NUM_RADIOS];
+	struct wifi_radio_stats out[NUM_RADIOS];
+	uint64_t t;
+	int threads;
+	int ret;
+	int i;
+
+	/* 6 radios on 4 workers take two rounds of queries */
+	t = time_monotonic_msecs();
+	ret = radio_stats(req, out, NUM_RADIOS, 0);
+	t = time_monotonic_msecs() - t;
+	CHECK(ret == 0 && req[NUM_RADIOS - 1].status == 0 && t >= 200,
+	      "%d radios in %u msecs\n", NUM_RADIOS, (unsigned int)t);
+
+	threads = num_threads();
+	for (i = 0; i < 3; i++) {
+		ret = radio_stats(req, out, NUM_RADIOS, 0);
+		CHECK(ret == 0, "round %d: %d\n", i, ret);
+	}
+
+	CHECK(num_threads() == threads, "workers kept: %d threads\n",
+	      num_threads());
+}
+
+static void test_busy(void)
+{
+	struct wifi_fanout_req req[2];
+	struct wifi_radio_stats out[2];
+	int ret;
+
+	/* test2.0 is left running its query */
+	ret = radio_stats(req, out, 1, 20);
+	CHECK(ret == -ETIMEDOUT && req[0].status == -ETIMEDOUT,
+	      "timed out: %d\n", ret);
+
+	ret = radio_stats(req, out, 2, 0);
+	CHECK(ret == 0 && req[0].status == -EBUSY && req[1].status == 0,
+	      "busy radio: %d, other radio: %d\n", req[0].status,
+	      req[1].status);
+
+	usleep(150000);
+	ret = radio_stats(req, out, 1, 0);
+	CHECK(ret == 0 && req[0].status == 0, "done: %d\n", req[0].status);
+}
+
+int main(int argc, char **argv)
+{
+	setenv("LIBWIFI_TEST_LATENCY", LATENCY, 1);
+
+	test_pool();
+	test_busy();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
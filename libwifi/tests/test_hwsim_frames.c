@@ -0,0 +1,296 @@
+/*
+ * test_hwsim_frames.c - check probe requests and action frames injected
+ * over mac80211_hwsim come out of a frame subscription of the mac80211
+ * driver, deduplicated and rate limited.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <poll.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Run by hwsim_frames.sh with an IBSS iface on 2437MHz, which gets the
+ * frames, and a monitor iface on another radio on the same channel, which
+ * sends them.
+ */
+#define IBSS_BSSID	"\x02\x00\x00\x00\xaa\x00"
+#define FREQ		2437
+#define BATCH		4
+#define MAX_FRAMES	64
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+static int inject_sock = -1;
+
+/* test frames are sent from 02:00:00:00:77:<n> */
+static void sa(uint8_t *a, int n)
+{
+	memcpy(a, "\x02\x00\x00\x00\x77", 5);
+	a[5] = n;
+}
+
+static int inject(const uint8_t *frame, size_t len)
+{
+	/* radiotap header without fields */
+	uint8_t buf[8 + 256] = { 0x00, 0x00, 0x08, 0x00 };
+
+	memcpy(buf + 8, frame, len);
+	if (send(inject_sock, buf, 8 + len, 0) < 0) {
+		perror("send");
+		return -1;
+	}
+
+	usleep(10000);
+	return 0;
+}
+
+static void inject_probe_req(int n, const char *ssid)
+{
+	uint8_t f[64] = { 0x40, 0x00 };
+	size_t len = 24;
+
+	memset(&f[4], 0xff, 6);
+	sa(&f[10], n);
+	memset(&f[16], 0xff, 6);
+
+	f[len++] = IE_SSID;
+	f[len++] = strlen(ssid);
+	memcpy(&f[len], ssid, strlen(ssid));
+	len += strlen(ssid);
+
+	/* supported rates */
+	memcpy(&f[len], "\x01\x04\x02\x04\x0b\x16", 6);
+	len += 6;
+
+	inject(f, len);
+}
+
+static void inject_action(const uint8_t *da, int n, uint8_t category)
+{
+	uint8_t f[32] = { 0xd0, 0x00 };
+	size_t len = 24;
+
+	memcpy(&f[4], da, 6);
+	sa(&f[10], n);
+	memcpy(&f[16], IBSS_BSSID, 6);
+
+	f[len++] = category;
+	f[len++] = 0;	/* action */
+	f[len++] = n;	/* dialog token */
+
+	inject(f, len);
+}
+
+/* poll and drain frames from test stas, BATCH at a time */
+static int get_frames(const char *ifname, struct wifi_rx_frame *out, int max)
+{
+	struct wifi_rx_frame f[BATCH];
+	struct pollfd pfd = { .events = POLLIN };
+	int got = 0;
+	int num;
+	int ret;
+	int i;
+
+	ret = wifi_get_frames_fd(ifname, &pfd.fd);
+	CHECK(ret == 0 && pfd.fd >= 0, "wifi_get_frames_fd() = %d\n", ret);
+	if (ret)
+		return 0;
+
+	while (poll(&pfd, 1, 500) > 0) {
+		do {
+			num = BATCH;
+			ret = wifi_get_frames(ifname, f, &num);
+			if (ret)
+				return got;
+
+			for (i = 0; i < num; i++) {
+				if (f[i].len < 24 ||
+				    memcmp(&f[i].frame[10], "\x02\x00\x00\x00\x77", 5))
+					continue;
+
+				if (got < max)
+					out[got++] = f[i];
+			}
+		} while (num == BATCH);
+	}
+
+	return got;
+}
+
+static int count_from(struct wifi_rx_frame *f, int num, uint16_t fc, int n)
+{
+	int c = 0;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		if (f[i].frame[0] == (fc & 0xff) && f[i].frame[15] == n)
+			c++;
+	}
+
+	return c;
+}
+
+static void test_probe_req(const char *ifname, struct wifi_rx_frame *f)
+{
+	struct wifi_frame_sub sub = {0};
+	uint64_t now;
+	int num;
+	int ret;
+	int i;
+
+	sub.flag = WIFI_FRAME_SUB_PROBE_REQ;
+	sub.dedup = true;
+	ret = wifi_subscribe_frames(ifname, &sub);
+	CHECK(ret == 0, "wifi_subscribe_frames(probe req) = %d\n", ret);
+	if (ret)
+		return;
+
+	/* sta 1 probes for one ssid three times, sta 2 for three ssids */
+	now = time_monotonic_msecs();
+	inject_probe_req(1, "libwifi-hwsim");
+	inject_probe_req(1, "libwifi-hwsim");
+	inject_probe_req(1, "libwifi-hwsim");
+	inject_probe_req(2, "a");
+	inject_probe_req(2, "b");
+	inject_probe_req(2, "c");
+
+	num = get_frames(ifname, f, MAX_FRAMES);
+	CHECK(num == 4, "probe req: %d frames\n", num);
+	CHECK(count_from(f, num, 0x40, 1) == 1, "dedup: 1 of 3 the same\n");
+	CHECK(count_from(f, num, 0x40, 2) == 3, "dedup: 3 of 3 changed\n");
+
+	for (i = 0; i < num; i++) {
+		CHECK(f[i].freq == FREQ && f[i].rssi < 0 && f[i].rssi > -100 &&
+		      f[i].rx_time >= now && !f[i].truncated,
+		      "frame %d: %u MHz, %d dBm\n", i, f[i].freq, f[i].rssi);
+	}
+
+	/* sta 3 probes for three ssids within the rate limit */
+	sub.dedup = false;
+	sub.ratelimit = 5000;
+	ret = wifi_subscribe_frames(ifname, &sub);
+	CHECK(ret == 0, "wifi_subscribe_frames(ratelimit) = %d\n", ret);
+
+	inject_probe_req(3, "a");
+	inject_probe_req(3, "b");
+	inject_probe_req(3, "c");
+
+	num = get_frames(ifname, f, MAX_FRAMES);
+	CHECK(num == 1 && count_from(f, num, 0x40, 3) == 1,
+	      "ratelimit: %d of 3\n", num);
+
+	wifi_unsubscribe_frames(ifname);
+}
+
+static void test_action(const char *ifname, struct wifi_rx_frame *f)
+{
+	struct wifi_frame_sub sub = {0};
+	uint8_t macaddr[6] = {0};
+	int num;
+	int ret;
+
+	if (if_gethwaddr(ifname, macaddr)) {
+		failed++;
+		return;
+	}
+
+	/* radio measurement and wnm, not public */
+	sub.flag = WIFI_FRAME_SUB_ACTION;
+	sub.num_category = 2;
+	sub.category[0] = 5;
+	sub.category[1] = 10;
+	ret = wifi_subscribe_frames(ifname, &sub);
+	CHECK(ret == 0, "wifi_subscribe_frames(action) = %d\n", ret);
+	if (ret)
+		return;
+
+	inject_action(macaddr, 4, 5);
+	inject_action(macaddr, 4, 10);
+	inject_action(macaddr, 4, 4);
+	inject_probe_req(4, "libwifi-hwsim");
+
+	num = get_frames(ifname, f, MAX_FRAMES);
+	CHECK(num == 2 && count_from(f, num, 0xd0, 4) == 2,
+	      "action: %d frames\n", num);
+	CHECK(num == 2 && f[0].frame[24] == 5 && f[1].frame[24] == 10,
+	      "action: categories in order\n");
+
+	wifi_unsubscribe_frames(ifname);
+
+	ret = wifi_get_frames_fd(ifname, &num);
+	CHECK(ret != 0, "unsubscribed: wifi_get_frames_fd() = %d\n", ret);
+}
+
+int main(int argc, char **argv)
+{
+	struct sockaddr_ll ll = {0};
+	struct wifi_rx_frame *f;
+
+	if (argc < 3) {
+		fprintf(stderr, "Usage: %s <ifname> <monitor ifname>\n", argv[0]);
+		return 1;
+	}
+
+	inject_sock = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+	if (inject_sock < 0) {
+		perror("socket");
+		return 1;
+	}
+
+	ll.sll_family = AF_PACKET;
+	ll.sll_protocol = htons(ETH_P_ALL);
+	ll.sll_ifindex = if_nametoindex(argv[2]);
+	if (bind(inject_sock, (struct sockaddr *)&ll, sizeof(ll)) < 0) {
+		perror("bind");
+		return 1;
+	}
+
+	f = calloc(MAX_FRAMES, sizeof(*f));
+	if (!f)
+		return 1;
+
+	test_probe_req(argv[1], f);
+	test_action(argv[1], f);
+
+	free(f);
+	close(inject_sock);
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+/*
+ * test_hwsim_stats.c - check AP and per-sta stats of the mac80211 driver
+ * against the kernel's netdev counters.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Run by hwsim_stats.sh on a mac80211_hwsim AP iface with traffic going
+ * to at least one associated sta.
+ */
+#define MAX_STAS	32
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+static uint64_t sysfs_stat(const char *ifname, const char *stat)
+{
+	char path[256];
+	unsigned long long v = 0;
+	FILE *f;
+
+	snprintf(path, sizeof(path), "/sys/class/net/%s/statistics/%s",
+		 ifname, stat);
+	f = fopen(path, "r");
+	if (!f)
+		return 0;
+
+	if (fscanf(f, "%llu", &v) != 1)
+		v = 0;
+
+	fclose(f);
+	return v;
+}
+
+static void test_ap_stats(const char *ifname, struct wifi_ap_stats *s)
+{
+	uint64_t tx_bytes_b, rx_bytes_b, tx_pkts_b, rx_pkts_b;
+	int ret;
+
+	tx_bytes_b = sysfs_stat(ifname, "tx_bytes");
+	rx_bytes_b = sysfs_stat(ifname, "rx_bytes");
+	tx_pkts_b = sysfs_stat(ifname, "tx_packets");
+	rx_pkts_b = sysfs_stat(ifname, "rx_packets");
+
+	ret = wifi_ap_get_stats(ifname, s);
+	CHECK(ret == 0, "wifi_ap_get_stats() = %d\n", ret);
+
+	/* counters only grow; the api read lies between two sysfs reads */
+	CHECK(s->tx_bytes >= tx_bytes_b &&
+	      s->tx_bytes <= sysfs_stat(ifname, "tx_bytes"),
+	      "ap tx_bytes %" PRIu64 "\n", s->tx_bytes);
+	CHECK(s->rx_bytes >= rx_bytes_b &&
+	      s->rx_bytes <= sysfs_stat(ifname, "rx_bytes"),
+	      "ap rx_bytes %" PRIu64 "\n", s->rx_bytes);
+	CHECK(s->tx_pkts >= tx_pkts_b &&
+	      s->tx_pkts <= sysfs_stat(ifname, "tx_packets"),
+	      "ap tx_pkts %" PRIu64 "\n", s->tx_pkts);
+	CHECK(s->rx_pkts >= rx_pkts_b &&
+	      s->rx_pkts <= sysfs_stat(ifname, "rx_packets"),
+	      "ap rx_pkts %" PRIu64 "\n", s->rx_pkts);
+
+	CHECK(s->tx_ucast_pkts > 0, "ap tx_ucast_pkts %" PRIu64 "\n",
+	      s->tx_ucast_pkts);
+	CHECK(s->rx_ucast_pkts > 0, "ap rx_ucast_pkts %" PRIu64 "\n",
+	      s->rx_ucast_pkts);
+}
+
+static void test_sta_stats(const char *ifname, struct wifi_ap_stats *ap)
+{
+	uint8_t stas[MAX_STAS * 6] = {0};
+	uint64_t sum_tx = 0, sum_rx = 0;
+	int num = MAX_STAS;
+	int ret;
+	int i;
+
+	ret = wifi_get_assoclist(ifname, stas, &num);
+	CHECK(ret == 0 && num > 0, "wifi_get_assoclist() = %d, %d stas\n",
+	      ret, num);
+
+	for (i = 0; i < num; i++) {
+		struct wifi_sta_stats s1 = {0}, s2 = {0};
+		uint8_t *macaddr = &stas[i * 6];
+
+		ret = wifi_get_sta_stats(ifname, macaddr, &s1);
+		ret |= wifi_get_sta_stats(ifname, macaddr, &s2);
+		CHECK(ret == 0, "wifi_get_sta_stats(" MACFMT ") = %d\n",
+		      MAC2STR(macaddr), ret);
+
+		CHECK(s1.tx_pkts > 0 && s1.rx_pkts > 0 &&
+		      s1.tx_bytes > 0 && s1.rx_bytes > 0,
+		      "sta " MACFMT " tx %" PRIu64 "/%" PRIu64
+		      " rx %" PRIu64 "/%" PRIu64 " pkts/bytes\n",
+		      MAC2STR(macaddr), s1.tx_pkts, s1.tx_bytes,
+		      s1.rx_pkts, s1.rx_bytes);
+
+		CHECK(s2.tx_pkts >= s1.tx_pkts && s2.rx_pkts >= s1.rx_pkts &&
+		      s2.tx_bytes >= s1.tx_bytes && s2.rx_bytes >= s1.rx_bytes,
+		      "sta " MACFMT " counters monotonic\n", MAC2STR(macaddr));
+
+		sum_tx += s2.tx_pkts;
+		sum_rx += s2.rx_pkts;
+	}
+
+	/* ap unicast counts are the sum over its stas, read earlier */
+	CHECK(sum_tx >= ap->tx_ucast_pkts && sum_rx >= ap->rx_ucast_pkts,
+	      "sum of sta pkts tx %" PRIu64 " rx %" PRIu64 " >= ap ucast\n",
+	      sum_tx, sum_rx);
+
+	ret = wifi_get_sta_stats(ifname, (uint8_t *)"\x02\x00\x00\x00\x00\x00",
+				 &(struct wifi_sta_stats){0});
+	CHECK(ret != 0, "wifi_get_sta_stats(unknown sta) = %d\n", ret);
+}
+
+int main(int argc, char **argv)
+{
+	struct wifi_ap_stats ap = {0};
+
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s <ap-ifname>\n", argv[0]);
+		return 1;
+	}
+
+	test_ap_stats(argv[1], &ap);
+	test_sta_stats(argv[1], &ap);
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,195 @@
+/*
+ * test_ie_index.c - check elements found through an IE index are the ones
+ * found walking the IE buffer, and that the parsers get the same from
+ * either.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "easy.h"
+#include "wifiutils.h"
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+static uint8_t ies[1024];
+static size_t ies_len;
+
+static void add(const uint8_t *ie, size_t len)
+{
+	memcpy(ies + ies_len, ie, len);
+	ies_len += len;
+}
+
+#define ADD(...)						\
+do {								\
+	const uint8_t _ie[] = { __VA_ARGS__ };			\
+	add(_ie, sizeof(_ie));					\
+} while (0)
+
+/* beacon ies of a WPA/WPA2 AP on channel 36 */
+static void make_ies(void)
+{
+	uint8_t ht_cap[28] = { IE_HT_CAP, 26, 0xef, 0x01 };
+	uint8_t vht_cap[14] = { IE_VHT_CAP, 12, 0x92, 0x01, 0x80, 0x33 };
+	uint8_t he_cap[24] = { IE_EXT, 22, IE_EXT_HE_CAP, 0x05 };
+
+	ies_len = 0;
+	ADD(IE_SSID, 4, 't', 'e', 's', 't');
+	ADD(IE_SUPP_RATES, 8, 0x8c, 0x12, 0x98, 0x24, 0xb0, 0x48, 0x60, 0x6c);
+	ADD(IE_DS_PARAM, 1, 36);
+	ADD(IE_BSS_LOAD, 5, 3, 0, 40, 0x10, 0x27);
+	add(ht_cap, sizeof(ht_cap));
+	/* WPA */
+	ADD(IE_VEND_SPEC, 22, 0x00, 0x50, 0xf2, 0x01, 0x01, 0x00,
+	    0x00, 0x50, 0xf2, 0x02, 0x01, 0x00, 0x00, 0x50, 0xf2, 0x02,
+	    0x01, 0x00, 0x00, 0x50, 0xf2, 0x02);
+	/* RSN */
+	ADD(IE_RSN, 20, 0x01, 0x00, 0x00, 0x0f, 0xac, 0x04, 0x01, 0x00,
+	    0x00, 0x0f, 0xac, 0x04, 0x01, 0x00, 0x00, 0x0f, 0xac, 0x02,
+	    0x00, 0x00);
+	ADD(IE_EXT_CAP, 8, 0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x40);
+	add(vht_cap, sizeof(vht_cap));
+	add(he_cap, sizeof(he_cap));
+	/* WMM parameter */
+	ADD(IE_VEND_SPEC, 24, 0x00, 0x50, 0xf2, 0x02, 0x01, 0x01, 0x80, 0x00,
+	    0x03, 0xa4, 0x00, 0x00, 0x27, 0xa4, 0x00, 0x00, 0x42, 0x43,
+	    0x5e, 0x00, 0x62, 0x32, 0x2f, 0x00);
+	/* second ssid and an element cut short */
+	ADD(IE_SSID, 2, 'x', 'y');
+	ADD(IE_RRM, 5, 0x73, 0xd0);
+}
+
+static void test_find(void)
+{
+	uint8_t wfa_oui[3] = { 0x50, 0x6f, 0x9a };
+	uint8_t ms_oui[3] = { 0x00, 0x50, 0xf2 };
+	struct wifi_ie_index idx;
+	int diff = 0;
+	int i;
+
+	make_ies();
+	wifi_ie_index_build(&idx, ies, ies_len);
+
+	for (i = 0; i < 256; i++) {
+		diff += wifi_ie_index_find(&idx, i) != wifi_find_ie(ies, ies_len, i);
+		diff += wifi_ie_index_find_ext(&idx, i) !=
+			wifi_find_ie_ext(ies, ies_len, i);
+	}
+
+	CHECK(diff == 0 && wifi_ie_index_find(&idx, IE_SSID) == ies &&
+	      !wifi_ie_index_find(&idx, IE_RRM),
+	      "ids: first element found, none past the cut\n");
+
+	CHECK(wifi_ie_index_find_vsie(&idx, ms_oui, 1, 0xff) ==
+	      wifi_find_vsie(ies, ies_len, ms_oui, 1, 0xff) &&
+	      wifi_ie_index_find_vsie(&idx, ms_oui, 2, 1) ==
+	      wifi_find_vsie(ies, ies_len, ms_oui, 2, 1) &&
+	      wifi_ie_index_find_vsie(&idx, ms_oui, 0xff, 0xff) ==
+	      wifi_find_vsie(ies, ies_len, ms_oui, 0xff, 0xff) &&
+	      wifi_ie_index_find_vsie(&idx, ms_oui, 2, 1) != NULL &&
+	      !wifi_ie_index_find_vsie(&idx, ms_oui, 2, 0) &&
+	      !wifi_ie_index_find_vsie(&idx, wfa_oui, 0xff, 0xff),
+	      "vendor: by oui, type and subtype\n");
+
+	wifi_ie_index_build(&idx, NULL, 0);
+	CHECK(!wifi_ie_index_find(&idx, IE_SSID) &&
+	      !wifi_ie_index_find_vsie(&idx, ms_oui, 0xff, 0xff),
+	      "empty: nothing found\n");
+}
+
+/* more vendor elements than indexed */
+static void test_vendor_more(void)
+{
+	uint8_t wfa_oui[3] = { 0x50, 0x6f, 0x9a };
+	struct wifi_ie_index idx;
+	uint8_t *last;
+	int i;
+
+	ies_len = 0;
+	for (i = 0; i < WIFI_IE_INDEX_VSIE_MAX + 4; i++)
+		ADD(IE_VEND_SPEC, 5, 0x00, 0x10, 0x18, i, 0);
+
+	last = ies + ies_len;
+	ADD(IE_VEND_SPEC, 5, 0x50, 0x6f, 0x9a, 0x10, 0);
+
+	wifi_ie_index_build(&idx, ies, ies_len);
+	CHECK(idx.vsie_more && wifi_ie_index_find_vsie(&idx, wfa_oui, 0x10, 0xff) == last &&
+	      wifi_ie_index_find_vsie(&idx, (uint8_t *)"\x00\x10\x18",
+				      WIFI_IE_INDEX_VSIE_MAX + 2, 0xff) ==
+	      wifi_find_vsie(ies, ies_len, (uint8_t *)"\x00\x10\x18",
+			     WIFI_IE_INDEX_VSIE_MAX + 2, 0xff),
+	      "vendor: found past the %d indexed\n", WIFI_IE_INDEX_VSIE_MAX);
+}
+
+static void test_parsers(void)
+{
+	struct wifi_bss a = {0}, b = {0};
+	struct wifi_ie_index idx;
+	bool adv_a = false, adv_b = true;
+	uint8_t std_a = 0, std_b = 0;
+
+	make_ies();
+	wifi_ie_index_build(&idx, ies, ies_len);
+
+	CHECK(wifi_oper_stds_set_from_ie(ies, ies_len, &std_a) == 0 &&
+	      wifi_oper_stds_set_from_ie_index(&idx, &std_b) == 0 &&
+	      std_a == std_b && std_a == (WIFI_A | WIFI_N | WIFI_AC | WIFI_AX),
+	      "oper stds: 0x%x\n", std_b);
+
+	CHECK(wifi_ssid_advertised_set_from_ie(ies, ies_len, &adv_a) == 0 &&
+	      wifi_ssid_advertised_set_from_ie_index(&idx, &adv_b) == 0 &&
+	      adv_a && adv_b, "ssid advertised\n");
+
+	CHECK(wifi_apload_set_from_ie(ies, ies_len, &a.load) == 0 &&
+	      wifi_apload_set_from_ie_index(&idx, &b.load) == 0 &&
+	      b.load.sta_count == 3 && b.load.utilization == 40 &&
+	      !memcmp(&a.load, &b.load, sizeof(a.load)),
+	      "bss load: %u stas\n", b.load.sta_count);
+
+	CHECK(wifi_get_bss_security_from_ies(&a, ies, ies_len) == 0 &&
+	      wifi_get_bss_security_from_ie_index(&b, &idx) == 0 &&
+	      !memcmp(&a.rsn, &b.rsn, sizeof(a.rsn)) &&
+	      a.security == b.security &&
+	      b.rsn.wpa_versions == (WPA_VERSION1 | WPA_VERSION2),
+	      "security: 0x%x\n", b.security);
+}
+
+int main(int argc, char **argv)
+{
+	test_find();
+	test_vendor_more();
+	test_parsers();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
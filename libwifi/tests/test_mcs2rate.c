@@ -0,0 +1,227 @@
+/*
+ * test_mcs2rate.c - check the PHY rates looked up by wifi_mcs2rate()
+ * against the rates computed per call as it used to, for every MCS,
+ * bandwidth, number of streams and guard interval both cover, and the
+ * rates of 802.11ax/be MCSs and bandwidths beyond.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "easy.h"
+#include "wifiutils.h"
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+static const struct {
+	uint8_t num_bpscs;
+	uint8_t rate_n;		/* coding rate */
+	uint8_t rate_d;
+} mcstab[] = {
+	{ 1, 1, 2 },
+	{ 2, 1, 2 },
+	{ 2, 3, 4 },
+	{ 4, 1, 2 },
+	{ 4, 3, 4 },
+	{ 6, 2, 3 },
+	{ 6, 3, 4 },
+	{ 6, 5, 6 },
+	{ 8, 3, 4 },
+	{ 8, 5, 6 },
+	{ 10, 3, 4 },
+	{ 10, 5, 6 },
+};
+
+/* wifi_mcs2rate() as it was, up to MCS 11 and 160MHz. Sets 'whole' if
+ * the rate is a whole number of Mbps, which the float math may round
+ * down to one less.
+ */
+static unsigned long mcs2rate_float(uint32_t mcs, uint32_t bw, uint32_t nss,
+				    enum wifi_guard gi, bool *whole)
+{
+	bool he = gi != WIFI_SGI && gi != WIFI_LGI;
+	uint64_t n, d;
+	float duration;
+	int num_sd;
+	int sym;	/* 100ns */
+
+	switch (bw) {
+	case 20:
+		num_sd = he ? 234 : 52;
+		break;
+	case 40:
+		num_sd = he ? 468 : 108;
+		break;
+	case 80:
+		num_sd = he ? 980 : 234;
+		break;
+	case 160:
+		num_sd = he ? 1960 : 468;
+		break;
+	default:
+		return 0;
+	}
+
+	switch (gi) {
+	case WIFI_SGI:
+		duration = 3.2f + 0.4f;
+		sym = 36;
+		break;
+	case WIFI_LGI:
+		duration = 3.2f + 0.8f;
+		sym = 40;
+		break;
+	case WIFI_1xLTF_GI800:
+	case WIFI_2xLTF_GI800:
+	case WIFI_4xLTF_GI800:
+		duration = 12.8f + 0.8f;
+		sym = 136;
+		break;
+	case WIFI_1xLTF_GI1600:
+	case WIFI_2xLTF_GI1600:
+		duration = 12.8f + 1.6f;
+		sym = 144;
+		break;
+	case WIFI_4xLTF_GI3200:
+		duration = 12.8f + 3.2f;
+		sym = 160;
+		break;
+	default:
+		return 0;
+	}
+
+	n = (uint64_t)num_sd * mcstab[mcs].num_bpscs * mcstab[mcs].rate_n * nss * 10;
+	d = (uint64_t)mcstab[mcs].rate_d * sym;
+	*whole = n % d == 0;
+
+	return (unsigned long)((float)num_sd * mcstab[mcs].num_bpscs *
+			       (float)nss *
+			       ((float)mcstab[mcs].rate_n / mcstab[mcs].rate_d) /
+			       duration);
+}
+
+static void test_formula(void)
+{
+	const uint32_t bws[] = { 20, 40, 80, 160 };
+	unsigned long ref, rate;
+	int num = 0, diff = 0;
+	int rounded = 0;
+	bool whole = false;
+	uint32_t mcs, nss;
+	int b, gi;
+
+	for (gi = WIFI_GI400; gi < WIFI_GI_UNKNOWN; gi++) {
+		for (b = 0; b < ARRAY_SIZE(bws); b++) {
+			for (nss = 1; nss <= 16; nss++) {
+				for (mcs = 0; mcs <= 11; mcs++) {
+					ref = mcs2rate_float(mcs, bws[b], nss, gi, &whole);
+					rate = wifi_mcs2rate(mcs, bws[b], nss, gi);
+					num++;
+					if (rate == ref)
+						continue;
+
+					if (whole && rate == ref + 1) {
+						rounded++;
+						continue;
+					}
+
+					diff++;
+					printf("mcs %u %uMHz %u ss gi %d: %lu != %lu\n",
+					       mcs, bws[b], nss, gi, rate, ref);
+				}
+			}
+		}
+	}
+
+	CHECK(diff == 0, "formula: %d rates, %d differ, %d whole Mbps rounded down before\n",
+	      num, diff, rounded);
+}
+
+static void test_rates(void)
+{
+	CHECK(wifi_mcs2rate_kbps(WIFI_N, 7, 20, 1, WIFI_SGI, false) == 72222 &&
+	      wifi_mcs2rate_kbps(WIFI_N, 7, 40, 4, WIFI_LGI, false) == 540000,
+	      "11n: 72.2 and 540Mbps\n");
+
+	CHECK(wifi_mcs2rate_kbps(WIFI_AC, 9, 80, 2, WIFI_SGI, false) == 866666 &&
+	      wifi_mcs2rate_kbps(WIFI_AC, 9, 160, 8, WIFI_SGI, false) == 6933333,
+	      "11ac: 866.7 and 6933.3Mbps\n");
+
+	CHECK(wifi_mcs2rate_kbps(WIFI_AX, 11, 80, 2, WIFI_1xLTF_GI800, false) == 1200980 &&
+	      wifi_mcs2rate_kbps(WIFI_AX, 11, 160, 8, WIFI_2xLTF_GI800, false) == 9607843 &&
+	      wifi_mcs2rate_kbps(WIFI_AX, 0, 20, 1, WIFI_4xLTF_GI3200, false) == 7312,
+	      "11ax: 1201, 9607.8 and 7.3Mbps\n");
+
+	CHECK(wifi_mcs2rate_kbps(WIFI_BE, 13, 320, 1, WIFI_1xLTF_GI800, false) == 2882352 &&
+	      wifi_mcs2rate_kbps(WIFI_BE, 13, 320, 16, WIFI_1xLTF_GI800, false) == 46117647 &&
+	      wifi_mcs2rate(13, 320, 16, WIFI_1xLTF_GI800) == 46117,
+	      "11be: 2882.4 and 46117.6Mbps at 320MHz\n");
+
+	CHECK(wifi_mcs2rate_kbps(WIFI_AX, 0, 20, 1, WIFI_1xLTF_GI800, true) == 4301 &&
+	      wifi_mcs2rate_kbps(WIFI_AX, 4, 160, 2, WIFI_4xLTF_GI3200, true) == 367500 &&
+	      !wifi_mcs2rate_kbps(WIFI_AX, 2, 20, 1, WIFI_1xLTF_GI800, true) &&
+	      !wifi_mcs2rate_kbps(WIFI_AX, 0, 20, 3, WIFI_1xLTF_GI800, true),
+	      "dcm: half rate of MCS 0, 1, 3 and 4 up to 2 ss\n");
+}
+
+static void test_invalid(void)
+{
+	CHECK(!wifi_mcs2rate_kbps(WIFI_N, 8, 20, 1, WIFI_SGI, false) &&
+	      !wifi_mcs2rate_kbps(WIFI_N, 7, 80, 1, WIFI_SGI, false) &&
+	      !wifi_mcs2rate_kbps(WIFI_AC, 10, 80, 1, WIFI_SGI, false) &&
+	      !wifi_mcs2rate_kbps(WIFI_AC, 9, 320, 1, WIFI_SGI, false) &&
+	      !wifi_mcs2rate_kbps(WIFI_AX, 12, 80, 1, WIFI_1xLTF_GI800, false) &&
+	      !wifi_mcs2rate_kbps(WIFI_AX, 11, 80, 9, WIFI_1xLTF_GI800, false) &&
+	      !wifi_mcs2rate_kbps(WIFI_BE, 14, 320, 1, WIFI_1xLTF_GI800, false),
+	      "MCS, bandwidth and streams beyond the standard\n");
+
+	CHECK(!wifi_mcs2rate_kbps(WIFI_AC, 0, 20, 1, WIFI_1xLTF_GI800, false) &&
+	      !wifi_mcs2rate_kbps(WIFI_BE, 0, 20, 1, WIFI_SGI, false) &&
+	      !wifi_mcs2rate_kbps(WIFI_AC, 0, 20, 1, WIFI_SGI, true) &&
+	      !wifi_mcs2rate_kbps(WIFI_AX | WIFI_BE, 0, 20, 1, WIFI_1xLTF_GI800, false),
+	      "guard interval or dcm not of the standard\n");
+
+	CHECK(!wifi_mcs2rate(0, 20, 0, WIFI_SGI) && !wifi_mcs2rate(0, 20, 17, WIFI_SGI) &&
+	      !wifi_mcs2rate(14, 20, 1, WIFI_SGI) && !wifi_mcs2rate(0, 60, 1, WIFI_SGI) &&
+	      !wifi_mcs2rate(0, 320, 1, WIFI_SGI) && !wifi_mcs2rate(0, 20, 1, WIFI_AUTOGI),
+	      "no rate of 0 or 17 ss, MCS 14, 60MHz or unknown GI\n");
+}
+
+int main(int argc, char **argv)
+{
+	test_formula();
+	test_rates();
+	test_invalid();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * test_monsta.c - check unassociated stas tracked from probe requests: rssi
+ * EWMA and probe counts, eviction of the least recently seen, and
+ * wifi_get_monitor_sta(s)() got from them.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST. Its "test5" and "test2"
+ * ifaces have monitored stas of their own, and don't track probe requests.
+ */
+#define IFNAME		"test5"
+#define IFNAME2		"test2"
+#define MAX_STAS	8
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+static uint8_t *mac(int id)
+{
+	static uint8_t addr[6];
+
+	memcpy(addr, "\x02\x00\x00\x00\x00\x00", 6);
+	addr[5] = id;
+	return addr;
+}
+
+static void test_ewma(void)
+{
+	struct wifi_monsta stas[MAX_STAS];
+	struct wifi_monsta mon;
+	int num = MAX_STAS;
+	int ret;
+
+	ret = wifi_monsta_config(IFNAME, 50, 4);
+	CHECK(ret == 0, "config: %d without frame subscription\n", ret);
+
+	/* the driver's monitored stas until a probe request is added */
+	ret = wifi_get_monitor_stas(IFNAME, stas, &num);
+	CHECK(ret == 0 && num > 0 &&
+	      !memcmp(stas[0].macaddr, "\x15\x25\x35\x45\x55\x65", 6),
+	      "nothing added: %d stas from the driver\n", num);
+
+	/* alpha 50%: -60 -> -70 */
+	wifi_monsta_add(IFNAME, mac(1), -60);
+	wifi_monsta_add(IFNAME, mac(1), -80);
+	ret = wifi_get_monitor_sta(IFNAME, mac(1), &mon);
+	CHECK(ret == 0 && mon.rssi_avg == -70 && mon.rssi[0] == -80 &&
+	      mon.num_probes == 2 && mon.last_seen == 0,
+	      "ewma: rssi %d/%d, %u probes\n", mon.rssi[0], mon.rssi_avg,
+	      mon.num_probes);
+
+	/* counted, but unknown rssi leaves it as is */
+	wifi_monsta_add(IFNAME, mac(1), 0);
+	ret = wifi_get_monitor_sta(IFNAME, mac(1), &mon);
+	CHECK(ret == 0 && mon.rssi_avg == -70 && mon.num_probes == 3,
+	      "no rssi: rssi %d, %u probes\n", mon.rssi_avg, mon.num_probes);
+
+	ret = wifi_get_monitor_sta(IFNAME, mac(9), &mon);
+	CHECK(ret == -ENOENT, "unknown sta: %d\n", ret);
+}
+
+static void test_lru(void)
+{
+	struct wifi_monsta stas[MAX_STAS];
+	struct wifi_monsta mon;
+	int num;
+	int ret;
+
+	/* 1 is seen again after 2, 3 and 4, so 2 makes room for 5 */
+	wifi_monsta_add(IFNAME, mac(2), -50);
+	wifi_monsta_add(IFNAME, mac(3), -51);
+	wifi_monsta_add(IFNAME, mac(4), -52);
+	wifi_monsta_add(IFNAME, mac(1), -70);
+	wifi_monsta_add(IFNAME, mac(5), -53);
+
+	ret = wifi_get_monitor_sta(IFNAME, mac(2), &mon);
+	CHECK(ret == -ENOENT, "evicted: least recently seen\n");
+
+	num = MAX_STAS;
+	ret = wifi_get_monitor_stas(IFNAME, stas, &num);
+	CHECK(ret == 0 && num == 4 &&
+	      stas[0].macaddr[5] == 5 && stas[1].macaddr[5] == 1 &&
+	      stas[2].macaddr[5] == 4 && stas[3].macaddr[5] == 3,
+	      "stas: %d, most recently seen first\n", num);
+
+	num = 2;
+	ret = wifi_get_monitor_stas(IFNAME, stas, &num);
+	CHECK(ret == 0 && num == 2 && stas[0].macaddr[5] == 5 &&
+	      stas[1].macaddr[5] == 1, "stas: %d of 4\n", num);
+
+	/* shrink keeps the most recently seen */
+	wifi_monsta_config(IFNAME, 50, 2);
+	num = MAX_STAS;
+	ret = wifi_get_monitor_stas(IFNAME, stas, &num);
+	CHECK(ret == 0 && num == 2 && stas[0].macaddr[5] == 5 &&
+	      stas[1].macaddr[5] == 1 && stas[1].num_probes == 4,
+	      "shrunk: %d stas\n", num);
+}
+
+static void test_frames(void)
+{
+	struct wifi_rx_frame f[3];
+	struct wifi_monsta mon;
+	int ret;
+	int k;
+
+	memset(f, 0, sizeof(f));
+	for (k = 0; k < 3; k++) {
+		f[k].rx_time = time_monotonic_msecs();
+		f[k].rssi = -45;
+		f[k].freq = 2437;
+		f[k].len = 30;
+		memset(&f[k].frame[4], 0xff, 6);
+		memcpy(&f[k].frame[10], mac(6), 6);
+	}
+
+	/* a probe request, an action frame and one from a group address */
+	f[0].frame[0] = 0x40;
+	f[1].frame[0] = 0xd0;
+	f[2].frame[0] = 0x40;
+	f[2].frame[10] = 0x03;
+
+	wifi_monsta_record_frames(IFNAME, f, 3);
+	ret = wifi_get_monitor_sta(IFNAME, mac(6), &mon);
+	CHECK(ret == 0 && mon.rssi_avg == -45 && mon.num_probes == 1,
+	      "frames: %u of 3 a probe request\n", mon.num_probes);
+
+	/* untracked iface */
+	wifi_monsta_record_frames(IFNAME2, f, 1);
+	ret = wifi_monsta_add(IFNAME2, mac(6), -40);
+	CHECK(ret == -ENOENT, "untracked: add %d\n", ret);
+}
+
+static void test_ifaces(void)
+{
+	struct wifi_monsta stas[MAX_STAS];
+	struct wifi_monsta a, b;
+	int num;
+	int ret;
+
+	/* the same sta kept apart per iface */
+	wifi_monsta_config(IFNAME2, 0, 0);
+	wifi_monsta_add(IFNAME2, mac(6), -80);
+	ret = wifi_get_monitor_sta(IFNAME, mac(6), &a);
+	ret |= wifi_get_monitor_sta(IFNAME2, mac(6), &b);
+	CHECK(ret == 0 && a.rssi_avg == -45 && b.rssi_avg == -80,
+	      "per iface: rssi %d and %d\n", a.rssi_avg, b.rssi_avg);
+
+	/* stopped, the driver's monitored stas again */
+	wifi_monsta_stop(IFNAME);
+	wifi_monsta_stop(IFNAME2);
+	num = MAX_STAS;
+	ret = wifi_get_monitor_stas(IFNAME, stas, &num);
+	CHECK(ret == 0 && num > 0 && stas[0].num_probes == 0 &&
+	      !memcmp(stas[0].macaddr, "\x15\x25\x35\x45\x55\x65", 6),
+	      "stopped: %d stas from the driver\n", num);
+}
+
+int main(int argc, char **argv)
+{
+	test_ewma();
+	test_lru();
+	test_frames();
+	test_ifaces();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * test_opclass_6g.c - get channels, operating classes and neighbours of the
+ * test driver's tri-band radio, which has more of them than fixed size
+ * arrays used to hold, and check none are cut off.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST. Its "test6" radio has 59
+ * 6GHz channels besides 26 others, and 300 neighbours on 6GHz.
+ */
+#define RADIO		"test6"
+#define MAX_OPCLASS	64
+#define NUM_6G_CHANNELS	59
+#define NUM_6G_BSS	300
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+struct opclass_table {
+	int num;
+	struct wifi_opclass o[MAX_OPCLASS];
+};
+
+static int get(bool pref, struct opclass_table *t)
+{
+	memset(t, 0, sizeof(*t));
+	t->num = MAX_OPCLASS;
+
+	if (pref)
+		return wifi_get_opclass_pref(RADIO, &t->num, t->o);
+
+	return wifi_get_supported_opclass(RADIO, &t->num, t->o);
+}
+
+static struct wifi_opclass *find(struct opclass_table *t, uint8_t id)
+{
+	int i;
+
+	for (i = 0; i < t->num; i++) {
+		if (t->o[i].g_opclass == id)
+			return &t->o[i];
+	}
+
+	return NULL;
+}
+
+static void test_channels(void)
+{
+	struct chan_entry ch[128];
+	int num = ARRAY_SIZE(ch);
+	int n6 = 0;
+	int i;
+
+	CHECK(wifi_channels_info(RADIO, ch, &num) == 0 && num > 64,
+	      "channels: %d\n", num);
+
+	for (i = 0; i < num; i++)
+		n6 += ch[i].band == BAND_6;
+
+	CHECK(n6 == NUM_6G_CHANNELS, "channels: %d on 6GHz\n", n6);
+	CHECK(wifi_is_dfs_channel(RADIO, 100, 20) &&
+	      !wifi_is_dfs_channel(RADIO, 36, 20),
+	      "channels: dfs state\n");
+}
+
+static void test_opclass(struct opclass_table t[2][2])
+{
+	struct wifi_opclass *o;
+	int cached, p;
+
+	for (cached = 0; cached < 2; cached++) {
+		wifi_opclass_cache_config(cached);
+		for (p = 0; p < 2; p++) {
+			CHECK(get(p, &t[cached][p]) == 0,
+			      "%s %s: %d opclasses\n",
+			      cached ? "cached" : "uncached",
+			      p ? "preferred" : "supported", t[cached][p].num);
+
+			o = find(&t[cached][p], 131);
+			CHECK(o && o->opchannel.num == NUM_6G_CHANNELS,
+			      "%s %s: opclass 131 has %d channels\n",
+			      cached ? "cached" : "uncached",
+			      p ? "preferred" : "supported",
+			      o ? o->opchannel.num : 0);
+		}
+	}
+
+	for (p = 0; p < 2; p++) {
+		CHECK(t[0][p].num == t[1][p].num &&
+		      !memcmp(t[0][p].o, t[1][p].o,
+			      t[0][p].num * sizeof(struct wifi_opclass)),
+		      "%s: cached same as uncached\n",
+		      p ? "preferred" : "supported");
+	}
+}
+
+static void test_best(struct opclass_table *pref)
+{
+	struct wifi_channel_rank r[NUM_6G_CHANNELS];
+	int num = ARRAY_SIZE(r);
+	bool sorted = true;
+	int i;
+
+	/* the 13 5GHz channels, in 3 opclasses */
+	CHECK(wifi_get_best_channels(RADIO, BAND_5, BW20, r, &num) == 0 &&
+	      num == 13, "best: %d 5GHz channels\n", num);
+
+	for (i = 0; i < num; i++) {
+		if (i && r[i].score > r[i - 1].score)
+			sorted = false;
+		if (!r[i].score || r[i].score == 255 || !find(pref, r[i].opclass))
+			sorted = false;
+	}
+
+	CHECK(sorted, "best: ranked by score\n");
+
+	num = 3;
+	CHECK(wifi_get_best_channels(RADIO, BAND_5, BW80, r, &num) == 0 &&
+	      num == 3 && r[0].score >= r[1].score && r[0].opclass == 128,
+	      "best: top 3 80MHz channels\n");
+}
+
+static int count_cb(struct wifi_bss *bss, void *priv)
+{
+	(*(int *)priv)++;
+	return 0;
+}
+
+static void test_neighbors(void)
+{
+	struct wifi_bssdb_entry *e;
+	int max = NUM_6G_BSS;
+	int total = 0;
+	int seen = 0;
+	int num;
+	int c;
+
+	e = calloc(max, sizeof(*e));
+	if (!e)
+		return;
+
+	/* preferred opclasses got the neighbours in */
+	for (c = 1; c <= 233; c += 4) {
+		num = max;
+		if (!wifi_bssdb_get_channel(BAND_6, c, e, &num))
+			total += num;
+	}
+
+	CHECK(total == NUM_6G_BSS, "bssdb: %d neighbours on 6GHz\n", total);
+
+	CHECK(wifi_iterate_scan_results(RADIO, NULL, count_cb, &seen) == 0 &&
+	      seen == NUM_6G_BSS, "iterate: %d neighbours\n", seen);
+
+	free(e);
+}
+
+int main(int argc, char **argv)
+{
+	struct opclass_table (*t)[2];
+
+	t = calloc(2, sizeof(*t));
+	if (!t)
+		return 1;
+
+	test_channels();
+	test_opclass(t);
+	test_best(&t[1][1]);
+	test_neighbors();
+
+	free(t);
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
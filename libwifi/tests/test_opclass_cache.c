@@ -0,0 +1,179 @@
+/*
+ * test_opclass_cache.c - get operating classes of the test driver's radios
+ * with and without the cache, and check both give the same, and when the
+ * cache is dropped.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST. The test driver's channel
+ * state changes as LIBWIFI_TEST_CHAN_GEN does.
+ */
+#define MAX_OPCLASS	32
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+struct opclass_table {
+	int num;
+	struct wifi_opclass o[MAX_OPCLASS];
+};
+
+static int get(const char *name, bool pref, int max, struct opclass_table *t)
+{
+	memset(t, 0, sizeof(*t));
+	t->num = max;
+
+	if (pref)
+		return wifi_get_opclass_pref(name, &t->num, t->o);
+
+	return wifi_get_supported_opclass(name, &t->num, t->o);
+}
+
+static bool same(struct opclass_table *a, struct opclass_table *b)
+{
+	return a->num == b->num &&
+	       !memcmp(a->o, b->o, a->num * sizeof(a->o[0]));
+}
+
+static struct opclass_table uncached[2][2];
+
+static void test_uncached(void)
+{
+	const char *radios[] = { "test5", "test2" };
+	int r, p;
+
+	wifi_opclass_cache_config(false);
+	for (r = 0; r < 2; r++) {
+		for (p = 0; p < 2; p++) {
+			CHECK(get(radios[r], p, MAX_OPCLASS, &uncached[r][p]) == 0 &&
+			      uncached[r][p].num > 0,
+			      "%s: %d %s opclasses\n", radios[r],
+			      uncached[r][p].num, p ? "preferred" : "supported");
+		}
+	}
+	wifi_opclass_cache_config(true);
+}
+
+static void test_cached(void)
+{
+	const char *radios[] = { "test5", "test2" };
+	struct wifi_opclass_cache_stats st;
+	struct opclass_table *t;
+	int r, p, i;
+	bool ok;
+
+	t = calloc(1, sizeof(*t));
+	if (!t)
+		return;
+
+	for (r = 0; r < 2; r++) {
+		for (p = 0; p < 2; p++) {
+			ok = true;
+			for (i = 0; i < 3; i++) {
+				ok &= get(radios[r], p, MAX_OPCLASS, t) == 0 &&
+				      same(t, &uncached[r][p]);
+			}
+
+			CHECK(ok, "%s: cached %s opclasses same as uncached\n",
+			      radios[r], p ? "preferred" : "supported");
+		}
+	}
+
+	/* 'test5' got its channels, then 2 tables, missing once each */
+	CHECK(wifi_get_opclass_cache_stats("test5", &st) == 0 &&
+	      st.miss == 3 && st.hit >= 4 && st.flush == 0,
+	      "test5: %llu hit, %llu miss\n", (unsigned long long)st.hit,
+	      (unsigned long long)st.miss);
+
+	free(t);
+}
+
+static void test_invalidate(void)
+{
+	struct wifi_opclass_cache_stats a, b;
+	struct opclass_table *t;
+
+	t = calloc(1, sizeof(*t));
+	if (!t)
+		return;
+
+	wifi_get_opclass_cache_stats("test5", &a);
+	setenv("LIBWIFI_TEST_CHAN_GEN", "1", 1);
+	CHECK(get("test5", false, MAX_OPCLASS, t) == 0 &&
+	      same(t, &uncached[0][0]), "event: same opclasses got again\n");
+	wifi_get_opclass_cache_stats("test5", &b);
+	CHECK(b.miss > a.miss && b.flush == a.flush + 3,
+	      "event: cache dropped\n");
+
+	get("test5", false, MAX_OPCLASS, t);
+	wifi_get_opclass_cache_stats("test5", &a);
+	CHECK(a.hit == b.hit + 1, "event: cached again after\n");
+
+	wifi_get_opclass_cache_stats("test5", &b);
+	wifi_opclass_cache_flush("test2");
+	get("test5", false, MAX_OPCLASS, t);
+	wifi_get_opclass_cache_stats("test5", &a);
+	CHECK(a.hit == b.hit + 1 && a.miss == b.miss,
+	      "flush: other radio kept\n");
+
+	wifi_get_opclass_cache_stats("test2", &b);
+	get("test2", false, MAX_OPCLASS, t);
+	wifi_get_opclass_cache_stats("test2", &a);
+	CHECK(a.miss > b.miss, "flush: radio dropped\n");
+
+	/* a table cut short isn't given for a larger one */
+	wifi_opclass_cache_flush(NULL);
+	get("test5", false, 2, t);
+	CHECK(t->num <= 2, "short: up to 2 opclasses\n");
+	CHECK(get("test5", false, MAX_OPCLASS, t) == 0 &&
+	      same(t, &uncached[0][0]), "short: all opclasses after\n");
+	CHECK(get("test5", false, MAX_OPCLASS - 1, t) == 0 &&
+	      same(t, &uncached[0][0]), "short: all opclasses in less room\n");
+
+	unsetenv("LIBWIFI_TEST_CHAN_GEN");
+	free(t);
+}
+
+int main(int argc, char **argv)
+{
+	test_uncached();
+	test_cached();
+	test_invalidate();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * test_regdb.c - check channels and bandwidths of the test driver's radios
+ * against its regulatory rules, and that the rules are cached until the
+ * channel state changes.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST. Its radios have ETSI like
+ * rules, or FCC like ones if LIBWIFI_TEST_REG is "US".
+ */
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+static bool valid(const char *name, enum wifi_band band, uint32_t channel,
+		  enum wifi_bw bw)
+{
+	return wifi_regdb_check_channel(name, band, channel, bw, NULL) == 0;
+}
+
+static void test_channels(void)
+{
+	struct wifi_reg_rule r;
+	int eirp = 0;
+
+	CHECK(valid("test5", BAND_5, 36, BW20) && valid("test5", BAND_5, 36, BW80),
+	      "36: valid at 20 and 80MHz\n");
+	CHECK(wifi_regdb_get_max_power("test5", BAND_5, 36, BW20, &eirp) == 0 &&
+	      eirp == 23, "36: %d dBm\n", eirp);
+
+	CHECK(wifi_regdb_check_channel("test5", BAND_5, 52, BW80, &r) == 0 &&
+	      (r.flags & WIFI_REG_RULE_DFS) && r.cac_time == 60000,
+	      "52: dfs at 80MHz\n");
+
+	/* 36-64 span two rules of auto bandwidth */
+	CHECK(wifi_regdb_check_channel("test5", BAND_5, 60, BW160, &r) == 0 &&
+	      (r.flags & WIFI_REG_RULE_DFS) && r.max_eirp == 2000,
+	      "60: valid at 160MHz, %d mBm\n", r.max_eirp);
+
+	CHECK(valid("test5", BAND_5, 100, BW160) &&
+	      !valid("test5", BAND_5, 132, BW80) &&
+	      !valid("test5", BAND_5, 149, BW20),
+	      "100: valid at 160MHz, 132 and 149 not\n");
+
+	CHECK(valid("test2", BAND_2, 13, BW20) && !valid("test2", BAND_2, 14, BW20) &&
+	      valid("test2", BAND_2, 1, BW40) && valid("test2", BAND_2, 13, BW40),
+	      "2.4GHz: 1-13\n");
+
+	CHECK(valid("test6", BAND_6, 1, BW160) && valid("test6", BAND_6, 93, BW20) &&
+	      !valid("test6", BAND_6, 97, BW20),
+	      "6GHz: 1-93\n");
+}
+
+static void test_valid_channels(void)
+{
+	const uint32_t ch80[] = { 36, 40, 44, 48, 52, 56, 60, 64,
+				  100, 104, 108, 112 };
+	uint32_t ch[64];
+	int num = ARRAY_SIZE(ch);
+
+	/* tdwr channel groups are left out */
+	CHECK(wifi_get_valid_channels("test5", BAND_5, BW80, "", ch, &num) == 0 &&
+	      num == ARRAY_SIZE(ch80) && !memcmp(ch, ch80, sizeof(ch80)),
+	      "valid channels: %d at 80MHz\n", num);
+
+	num = ARRAY_SIZE(ch);
+	CHECK(wifi_get_valid_channels("test5", BAND_5, BW20, "EU", ch, &num) == 0 &&
+	      num == 16 && ch[num - 1] == 140,
+	      "valid channels: %d at 20MHz\n", num);
+}
+
+static void test_refresh(void)
+{
+	struct wifi_reg_rule r[WIFI_REG_RULES_MAX];
+	char alpha2[3] = {0};
+	int num = ARRAY_SIZE(r);
+
+	CHECK(wifi_regdb_get_rules("test5", alpha2, r, &num) == 0 &&
+	      !strcmp(alpha2, "EU") && num == 5 &&
+	      r[0].start_freq == 2400000 && r[4].end_freq == 6425000,
+	      "rules: %d of %s\n", num, alpha2);
+
+	setenv("LIBWIFI_TEST_REG", "US", 1);
+	num = ARRAY_SIZE(r);
+	CHECK(wifi_regdb_get_rules("test5", alpha2, r, &num) == 0 &&
+	      !strcmp(alpha2, "EU") && !valid("test5", BAND_5, 149, BW20),
+	      "cached: rules of %s kept\n", alpha2);
+
+	setenv("LIBWIFI_TEST_CHAN_GEN", "1", 1);
+	num = ARRAY_SIZE(r);
+	CHECK(wifi_regdb_get_rules("test5", alpha2, r, &num) == 0 &&
+	      !strcmp(alpha2, "US") && num == 6 &&
+	      valid("test5", BAND_5, 149, BW80) &&
+	      valid("test2", BAND_5, 149, BW20),
+	      "event: rules of %s got\n", alpha2);
+
+	unsetenv("LIBWIFI_TEST_REG");
+	wifi_regdb_flush("test2");
+	CHECK(valid("test5", BAND_5, 149, BW20) && !valid("test2", BAND_5, 149, BW20),
+	      "flush: radio dropped, other one kept\n");
+
+	unsetenv("LIBWIFI_TEST_CHAN_GEN");
+}
+
+int main(int argc, char **argv)
+{
+	test_channels();
+	test_valid_channels();
+	test_refresh();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
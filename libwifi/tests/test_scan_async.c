@@ -0,0 +1,187 @@
+/*
+ * test_scan_async.c - run non-blocking scans on the test driver, and check
+ * completion, ordering, dense results, abort, timeout and cancellation.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <poll.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST. The test driver finishes a
+ * scan at once, unless LIBWIFI_TEST_SCAN says otherwise.
+ */
+#define MAX_DONE	8
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+/* callbacks run, in order */
+struct scan_done {
+	int id;
+	int status;
+	int num;
+};
+
+static struct scan_done done[MAX_DONE];
+static int num_done;
+
+static int ref_num;
+
+static void scan_cb(struct wifi_scan_req *req, int status,
+		    struct wifi_bss *bss, int num, void *userdata)
+{
+	if (num_done >= MAX_DONE)
+		return;
+
+	done[num_done].id = (int)(intptr_t)userdata;
+	done[num_done].status = status;
+	done[num_done].num = num;
+	num_done++;
+}
+
+/* Run the event loop until 'n' callbacks ran, or for 'msecs' */
+static void run_loop(int n, int msecs)
+{
+	struct pollfd pfd = { .fd = wifi_scan_async_fd(), .events = POLLIN };
+
+	while (num_done < n && poll(&pfd, 1, msecs) > 0)
+		wifi_scan_async_process();
+}
+
+static void test_order(void)
+{
+	struct wifi_bss bss[128];
+	int ret = 0;
+
+	ref_num = 128;
+	wifi_get_scan_results("test5", bss, &ref_num);
+
+	num_done = 0;
+	unsetenv("LIBWIFI_TEST_SCAN");
+	ret |= !wifi_scan_async("test5", NULL, 1000, scan_cb, (void *)1);
+	ret |= !wifi_scan_async("test5", NULL, 1000, scan_cb, (void *)2);
+	ret |= !wifi_scan_async("test2", NULL, 1000, scan_cb, (void *)3);
+	CHECK(ret == 0 && num_done == 0, "scans requested, none done yet\n");
+
+	run_loop(3, 1000);
+	CHECK(num_done == 3, "three scans done\n");
+	CHECK(done[0].status == 0 && done[1].status == 0 &&
+	      done[2].status == 0, "all succeeded\n");
+	CHECK((done[0].id == 1 && done[1].id == 2) ||
+	      (done[0].id == 1 && done[2].id == 2) ||
+	      (done[1].id == 1 && done[2].id == 2),
+	      "scans of an ifname done in order\n");
+	CHECK(done[0].id != 1 || done[0].num == ref_num,
+	      "results of the scan: %d bss\n", done[0].num);
+}
+
+/* all of a dense scan, not only as many as first made room for */
+static void test_dense(void)
+{
+	num_done = 0;
+	unsetenv("LIBWIFI_TEST_SCAN");
+	CHECK(wifi_scan_async("test6", NULL, 1000, scan_cb, (void *)1) != NULL,
+	      "dense: scan requested\n");
+	run_loop(1, 1000);
+	CHECK(num_done == 1 && done[0].status == 0 && done[0].num == 300,
+	      "dense: %d bss\n", done[0].num);
+}
+
+static void test_abort(void)
+{
+	num_done = 0;
+	setenv("LIBWIFI_TEST_SCAN", "abort", 1);
+	CHECK(wifi_scan_async("test5", NULL, 1000, scan_cb, (void *)1) != NULL,
+	      "abort: scan requested\n");
+	run_loop(1, 1000);
+	CHECK(num_done == 1 && done[0].status == -ECONNABORTED &&
+	      done[0].num == 0, "abort: reported as aborted\n");
+}
+
+static void test_timeout(void)
+{
+	uint64_t t = time_monotonic_msecs();
+
+	num_done = 0;
+	setenv("LIBWIFI_TEST_SCAN", "none", 1);
+	CHECK(wifi_scan_async("test5", NULL, 50, scan_cb, (void *)1) != NULL &&
+	      wifi_scan_async("test5", NULL, 100, scan_cb, (void *)2) != NULL,
+	      "timeout: scans requested\n");
+	run_loop(2, 1000);
+	t = time_monotonic_msecs() - t;
+	CHECK(num_done == 2 && done[0].status == -ETIMEDOUT &&
+	      done[1].status == -ETIMEDOUT && done[0].id == 1,
+	      "timeout: both timed out, first one first\n");
+	CHECK(t >= 100 && t < 1000, "timeout: after %llu msecs\n",
+	      (unsigned long long)t);
+}
+
+static void test_cancel(void)
+{
+	struct wifi_scan_req *a, *b;
+
+	num_done = 0;
+	setenv("LIBWIFI_TEST_SCAN", "none", 1);
+	a = wifi_scan_async("test5", NULL, 50, scan_cb, (void *)1);
+	b = wifi_scan_async("test5", NULL, 50, scan_cb, (void *)2);
+	CHECK(a && b, "cancel: scans requested\n");
+
+	CHECK(wifi_scan_async_cancel(b) == 0, "cancel: queued scan\n");
+	CHECK(wifi_scan_async_cancel(a) == 0, "cancel: running scan\n");
+	CHECK(wifi_scan_async_cancel(b) == -ENOENT, "cancel: only once\n");
+
+	/* the running one is dropped on its timeout */
+	run_loop(1, 200);
+	CHECK(num_done == 0, "cancel: no callback\n");
+
+	/* and the ifname is free to scan again */
+	unsetenv("LIBWIFI_TEST_SCAN");
+	CHECK(wifi_scan_async("test5", NULL, 1000, scan_cb, (void *)3) != NULL,
+	      "cancel: scan requested after\n");
+	run_loop(1, 1000);
+	CHECK(num_done == 1 && done[0].id == 3 && done[0].status == 0,
+	      "cancel: next scan done\n");
+}
+
+int main(int argc, char **argv)
+{
+	test_order();
+	test_dense();
+	test_abort();
+	test_timeout();
+	test_cancel();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * test_scan_filter.c - get filtered scan results from the test driver, and
+ * check them against the unfiltered ones.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST */
+#define RADIO		"test5"
+#define MAX_BSS		64
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+static struct wifi_bss all[MAX_BSS];
+static int num_all;
+
+/* Number of unfiltered results passing a check */
+static int count(bool (*match)(struct wifi_bss *b, struct wifi_scan_filter *f),
+		 struct wifi_scan_filter *f)
+{
+	int n = 0;
+	int i;
+
+	for (i = 0; i < num_all; i++)
+		n += match(&all[i], f);
+
+	return n;
+}
+
+static bool match_ssid(struct wifi_bss *b, struct wifi_scan_filter *f)
+{
+	return !strcmp((char *)b->ssid, f->ssid);
+}
+
+static bool match_rssi(struct wifi_bss *b, struct wifi_scan_filter *f)
+{
+	return b->rssi >= f->rssi;
+}
+
+static bool match_channel_rssi(struct wifi_bss *b, struct wifi_scan_filter *f)
+{
+	return b->channel == f->channel[0] && b->rssi >= f->rssi;
+}
+
+/* Get filtered results, and check each one matches */
+static int get_filtered(struct wifi_scan_filter *f,
+			bool (*match)(struct wifi_bss *b, struct wifi_scan_filter *f))
+{
+	struct wifi_bss bss[MAX_BSS];
+	int num = MAX_BSS;
+	int i;
+
+	if (wifi_get_scan_results_filtered(RADIO, f, bss, &num))
+		return -1;
+
+	for (i = 0; i < num; i++) {
+		if (match && !match(&bss[i], f))
+			return -1;
+	}
+
+	return num;
+}
+
+static void test_unfiltered(void)
+{
+	int num = MAX_BSS;
+	int ret;
+
+	num_all = MAX_BSS;
+	ret = wifi_get_scan_results(RADIO, all, &num_all);
+	CHECK(ret == 0 && num_all > 1, "unfiltered: %d bss\n", num_all);
+
+	ret = wifi_get_scan_results_filtered(RADIO, NULL, all, &num);
+	CHECK(ret == 0 && num == num_all, "no filter: all bss\n");
+}
+
+static void test_criteria(void)
+{
+	struct wifi_scan_filter f;
+	int n;
+
+	memset(&f, 0, sizeof(f));
+	f.flag = WIFI_SCAN_FILTER_SSID;
+	memcpy(f.ssid, all[1].ssid, sizeof(f.ssid));
+	n = get_filtered(&f, match_ssid);
+	CHECK(n > 0 && n == count(match_ssid, &f), "ssid: %d bss\n", n);
+
+	memset(&f, 0, sizeof(f));
+	f.flag = WIFI_SCAN_FILTER_BSSID;
+	f.num_bssid = 2;
+	memcpy(f.bssid[0], all[0].bssid, 6);
+	memcpy(f.bssid[1], all[num_all - 1].bssid, 6);
+	n = get_filtered(&f, NULL);
+	CHECK(n == 2, "bssid list: %d bss\n", n);
+
+	memset(&f, 0, sizeof(f));
+	f.flag = WIFI_SCAN_FILTER_BAND;
+	f.band = BAND_2;
+	n = get_filtered(&f, NULL);
+	CHECK(n == 0, "other band: %d bss\n", n);
+	f.band = BAND_2 | BAND_5;
+	n = get_filtered(&f, NULL);
+	CHECK(n == num_all, "any band: %d bss\n", n);
+
+	memset(&f, 0, sizeof(f));
+	f.flag = WIFI_SCAN_FILTER_RSSI;
+	f.rssi = all[0].rssi;
+	n = get_filtered(&f, match_rssi);
+	CHECK(n > 0 && n == count(match_rssi, &f), "min rssi %d: %d bss\n",
+	      f.rssi, n);
+
+	/* criteria combine */
+	f.flag |= WIFI_SCAN_FILTER_CHANNEL;
+	f.num_channel = 1;
+	f.channel[0] = all[0].channel;
+	n = get_filtered(&f, match_channel_rssi);
+	CHECK(n > 0 && n == count(match_channel_rssi, &f),
+	      "channel %d and min rssi: %d bss\n", f.channel[0], n);
+
+	memset(&f, 0, sizeof(f));
+	f.flag = WIFI_SCAN_FILTER_SECURITY;
+	f.security = all[0].security;
+	n = get_filtered(&f, NULL);
+	CHECK(n > 0, "security: %d bss\n", n);
+
+	/* a criterion without its flag set is ignored */
+	memset(&f, 0, sizeof(f));
+	f.rssi = 0;
+	f.band = BAND_2;
+	n = get_filtered(&f, NULL);
+	CHECK(n == num_all, "unflagged criteria ignored\n");
+}
+
+struct iter_ctx {
+	int seen;
+	int stop_after;
+};
+
+static int iter_cb(struct wifi_bss *bss, void *priv)
+{
+	struct iter_ctx *c = priv;
+
+	c->seen++;
+	return c->seen >= c->stop_after;
+}
+
+static void test_iterate(void)
+{
+	struct iter_ctx c = { .stop_after = 1 };
+	struct wifi_bss bss[1];
+	int num = 1;
+	int ret;
+
+	ret = wifi_iterate_scan_results(RADIO, NULL, iter_cb, &c);
+	CHECK(ret == 0 && c.seen == 1, "iterate: stops when told\n");
+
+	c.seen = 0;
+	c.stop_after = MAX_BSS;
+	ret = wifi_iterate_scan_results(RADIO, NULL, iter_cb, &c);
+	CHECK(ret == 0 && c.seen == num_all, "iterate: all %d bss\n", c.seen);
+
+	ret = wifi_get_scan_results_filtered(RADIO, NULL, bss, &num);
+	CHECK(ret == 0 && num == 1, "array: no more than its size\n");
+
+	CHECK(wifi_iterate_scan_results(RADIO, NULL, NULL, NULL) == -EINVAL,
+	      "iterate: needs a callback\n");
+}
+
+int main(int argc, char **argv)
+{
+	test_unfiltered();
+	test_criteria();
+	test_iterate();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
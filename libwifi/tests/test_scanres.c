@@ -0,0 +1,170 @@
+/*
+ * test_scanres.c - check scan results got in compact form decode as the
+ * full ones, and the memory they take against struct wifi_bss_detail.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST. Its "test6" radio passes the
+ * IEs of its 300 neighbours; the other radios don't.
+ */
+#define MAX_BSS		64
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+static void test_ies(void)
+{
+	struct wifi_scanres r = {0};
+	struct wifi_bssdb_entry e;
+	struct wifi_bss_detail *d;
+	struct wifi_bss bss;
+	size_t detail, size;
+	size_t len = 0;
+	uint8_t *ies;
+	int ret;
+
+	ret = wifi_get_scanres("test6", NULL, &r);
+	CHECK(ret == 0 && r.num == 300, "test6: %d scan results\n", r.num);
+	if (ret || r.num != 300)
+		goto out;
+
+	ies = wifi_scanres_get_ies(&r, 7, &len);
+	CHECK(ies && len > 180 && ies[0] == IE_SSID, "ies: %zu bytes\n", len);
+
+	ret = wifi_scanres_get_bss(&r, 7, &bss);
+	CHECK(ret == 0 && !strcmp((char *)bss.ssid, "Test SSID 6Ghz 7") &&
+	      bss.bssid[5] == 7 && bss.channel == 29 && bss.band == BAND_6 &&
+	      bss.rssi == -57 && bss.beacon_int == 100,
+	      "decoded: %s on %d\n", bss.ssid, bss.channel);
+
+	CHECK((bss.security & (1 << WIFI_SECURITY_WPA3PSK)) &&
+	      (bss.caps.valid & WIFI_CAP_BASIC_VALID) &&
+	      (bss.caps.valid & WIFI_CAP_EXT_VALID) &&
+	      (bss.caps.valid & WIFI_CAP_RM_VALID) &&
+	      bss.load.sta_count == 7 && bss.load.utilization == 49,
+	      "decoded: security 0x%x, caps 0x%x\n", bss.security, bss.caps.valid);
+
+	/* recorded in the BSS database as decoded from its IEs */
+	ret = wifi_bssdb_lookup(bss.bssid, &e);
+	CHECK(ret == 0 && !strcmp(e.ifname, "test6") &&
+	      !strcmp((char *)e.bss.ssid, "Test SSID 6Ghz 7") &&
+	      e.bss.security == bss.security,
+	      "bssdb: %s from %s\n", e.bss.ssid, e.ifname);
+
+	d = calloc(1, sizeof(*d));
+	if (d) {
+		ret = wifi_scanres_get_bss_detail(&r, 7, d);
+		CHECK(ret == 0 && d->ielen == len && !memcmp(d->ie, ies, len) &&
+		      !memcmp(&d->basic, &bss, sizeof(bss)),
+		      "detail: %u bytes of ies\n", d->ielen);
+		free(d);
+	}
+
+	/* a dense scan as an array of struct wifi_bss_detail */
+	detail = r.num * sizeof(struct wifi_bss_detail);
+	size = wifi_scanres_size(&r);
+	CHECK(size * 4 < detail, "memory: %zu bytes, %zu as wifi_bss_detail (%zu ies)\n",
+	      size, detail, r.arena_len);
+
+	ret = wifi_get_scanres("test6", NULL, &r);
+	CHECK(ret == 0 && r.num == 300 && wifi_scanres_size(&r) == size,
+	      "again: memory reused\n");
+
+out:
+	wifi_scanres_free(&r);
+}
+
+static void test_filter(void)
+{
+	struct wifi_scanres r = {0};
+	struct wifi_scan_filter f = {0};
+	struct wifi_bss bss;
+	int ret;
+
+	f.flag = WIFI_SCAN_FILTER_SSID;
+	strcpy(f.ssid, "Test SSID 6Ghz 42");
+	ret = wifi_get_scanres("test6", &f, &r);
+	CHECK(ret == 0 && r.num == 1 && !wifi_scanres_get_bss(&r, 0, &bss) &&
+	      bss.bssid[5] == 42, "filter: %d by ssid\n", r.num);
+
+	f.flag = WIFI_SCAN_FILTER_CHANNEL;
+	f.num_channel = 1;
+	f.channel[0] = 5;
+	ret = wifi_get_scanres("test6", &f, &r);
+	CHECK(ret == 0 && r.num == 6, "filter: %d on channel 5\n", r.num);
+
+	wifi_scanres_free(&r);
+}
+
+/* a driver without the IEs has its struct wifi_bss kept as is */
+static void test_no_ies(void)
+{
+	struct wifi_scanres r = {0};
+	struct wifi_bss all[MAX_BSS];
+	struct wifi_bss bss;
+	int num = MAX_BSS;
+	int same = 0;
+	int ret;
+	int i;
+
+	memset(all, 0, sizeof(all));
+	ret = wifi_get_scan_results("test5", all, &num);
+	CHECK(ret == 0 && num > 0, "test5: %d scan results\n", num);
+
+	ret = wifi_get_scanres("test5", NULL, &r);
+	CHECK(ret == 0 && r.num == num && !wifi_scanres_get_ies(&r, 0, NULL),
+	      "test5: %d in compact form, without ies\n", r.num);
+
+	for (i = 0; i < r.num && i < num; i++) {
+		if (!wifi_scanres_get_bss(&r, i, &bss) &&
+		    !memcmp(&bss, &all[i], sizeof(bss)))
+			same++;
+	}
+	CHECK(same == num, "test5: %d of %d the same\n", same, num);
+
+	wifi_scanres_free(&r);
+}
+
+int main(int argc, char **argv)
+{
+	test_ies();
+	test_filter();
+	test_no_ies();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
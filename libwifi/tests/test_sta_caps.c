@@ -0,0 +1,207 @@
+/*
+ * test_sta_caps.c - check the cache of sta capabilities parsed at
+ * association.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+#define IFNAME		"wlan0"
+
+static uint8_t sta1[6] = {0x02, 0, 0, 0, 0, 0x01};
+static uint8_t sta2[6] = {0x02, 0, 0, 0, 0, 0x21};	/* same hash bucket */
+
+/* a sta as returned by a driver's station query, before caps parsing */
+static void sta_info(struct wifi_sta *sta, uint8_t *addr, uint32_t conn_time)
+{
+	memset(sta, 0, sizeof(*sta));
+	memcpy(sta->macaddr, addr, 6);
+	sta->conn_time = conn_time;
+	sta->caps.valid = WIFI_CAP_BASIC_VALID;
+	wifi_cap_set(sta->cbitmap, WIFI_CAP_WMM);
+}
+
+static void test_cache(void)
+{
+	struct wifi_sta caps, sta;
+	uint64_t now = 100000;
+	int ret;
+
+	sta_info(&sta, sta1, 10);
+	ret = wifi_sta_caps_get(IFNAME, &sta, now);
+	CHECK(ret == -ENOENT, "miss before association is parsed\n");
+
+	memset(&caps, 0, sizeof(caps));
+	caps.caps.valid = WIFI_CAP_HT_VALID | WIFI_CAP_VHT_VALID;
+	caps.caps.ht.supp_mcs[0] = 0xff;
+	wifi_cap_set(caps.cbitmap, WIFI_CAP_SGI20);
+	caps.maxrate = 866;
+	wifi_sta_caps_put(IFNAME, sta1, 10, &caps, now);
+
+	/* 10s later, the same association: started at 90s */
+	now += 10000;
+	sta_info(&sta, sta1, 20);
+	ret = wifi_sta_caps_get(IFNAME, &sta, now);
+	CHECK(ret == 0 && sta.maxrate == 866 &&
+	      sta.caps.ht.supp_mcs[0] == 0xff &&
+	      sta.caps.valid == (WIFI_CAP_BASIC_VALID | WIFI_CAP_HT_VALID |
+				 WIFI_CAP_VHT_VALID),
+	      "hit merges caps, valid 0x%x\n", sta.caps.valid);
+	CHECK(wifi_cap_isset(sta.cbitmap, WIFI_CAP_SGI20) &&
+	      wifi_cap_isset(sta.cbitmap, WIFI_CAP_WMM),
+	      "hit merges cbitmap\n");
+
+	/* conn_time in whole secs, off by one */
+	now += 1999;
+	sta_info(&sta, sta1, 20);
+	ret = wifi_sta_caps_get(IFNAME, &sta, now);
+	CHECK(ret == 0, "conn_time rounding tolerated\n");
+
+	sta_info(&sta, sta1, 20);
+	ret = wifi_sta_caps_get("wlan1", &sta, now);
+	CHECK(ret == -ENOENT, "other iface misses\n");
+
+	/* conn_time went back: reassociated, caps may have changed */
+	sta_info(&sta, sta1, 5);
+	ret = wifi_sta_caps_get(IFNAME, &sta, now);
+	CHECK(ret == -ENOENT && sta.maxrate == 0,
+	      "reassociation invalidates\n");
+	ret = wifi_sta_caps_get(IFNAME, &sta, now);
+	CHECK(ret == -ENOENT, "entry dropped on reassociation\n");
+
+	/* reassociated, and has been for longer than it was seen before */
+	wifi_sta_caps_put(IFNAME, sta1, 5, &caps, now);
+	now += 60000;
+	sta_info(&sta, sta1, 30);
+	ret = wifi_sta_caps_get(IFNAME, &sta, now);
+	CHECK(ret == -ENOENT && sta.maxrate == 0,
+	      "reassociation with later conn_time invalidates\n");
+
+	/* no conn_time from the driver: kept until the sta is gone */
+	wifi_sta_caps_put(IFNAME, sta1, 0, &caps, now);
+	now += 60000;
+	sta_info(&sta, sta1, 0);
+	ret = wifi_sta_caps_get(IFNAME, &sta, now);
+	CHECK(ret == 0, "unknown conn_time hits\n");
+
+	wifi_sta_caps_put(IFNAME, sta1, 5, &caps, now);
+	wifi_sta_caps_put(IFNAME, sta2, 5, &caps, now);
+	wifi_sta_caps_put("wlan1", sta2, 5, &caps, now);
+
+	/* sta1 is gone from the interface */
+	sta_info(&sta, sta2, 6);
+	wifi_sta_caps_expire(IFNAME, &sta, 1);
+	now += 1000;
+	sta_info(&sta, sta1, 6);
+	ret = wifi_sta_caps_get(IFNAME, &sta, now);
+	CHECK(ret == -ENOENT, "disassociated sta expired\n");
+	sta_info(&sta, sta2, 6);
+	ret = wifi_sta_caps_get(IFNAME, &sta, now);
+	CHECK(ret == 0, "associated sta kept\n");
+
+	wifi_sta_caps_del(IFNAME, sta2);
+	ret = wifi_sta_caps_get(IFNAME, &sta, now);
+	CHECK(ret == -ENOENT, "disconnected sta dropped\n");
+	ret = wifi_sta_caps_get("wlan1", &sta, now);
+	CHECK(ret == 0, "same sta on other iface kept\n");
+
+	wifi_sta_caps_del("wlan1", NULL);
+	ret = wifi_sta_caps_get("wlan1", &sta, now);
+	CHECK(ret == -ENOENT, "all stas of iface dropped\n");
+}
+
+/* more stas than kept per iface; the least recently used make room */
+static void test_max_stas(void)
+{
+	struct wifi_sta caps, sta;
+	uint64_t now = 100000;
+	uint8_t addr[6];
+	int hits = 0;
+	int ret;
+	int i;
+
+	memset(&caps, 0, sizeof(caps));
+	caps.maxrate = 866;
+	memcpy(addr, sta1, 6);
+
+	for (i = 0; i < 200; i++) {
+		addr[4] = (uint8_t)i;
+		wifi_sta_caps_put("wlan2", addr, 10, &caps, now);
+		if (i == 0) {
+			/* the first sta is used all along */
+			now += 10;
+			continue;
+		}
+		addr[4] = 0;
+		sta_info(&sta, addr, 10);
+		wifi_sta_caps_get("wlan2", &sta, now);
+		now++;
+	}
+
+	for (i = 0; i < 200; i++) {
+		addr[4] = (uint8_t)i;
+		sta_info(&sta, addr, 10);
+		if (!wifi_sta_caps_get("wlan2", &sta, now))
+			hits++;
+	}
+	CHECK(hits == 128, "%d of 200 stas kept\n", hits);
+
+	addr[4] = 0;
+	sta_info(&sta, addr, 10);
+	ret = wifi_sta_caps_get("wlan2", &sta, now);
+	CHECK(ret == 0, "recently used sta kept\n");
+	addr[4] = 1;
+	sta_info(&sta, addr, 10);
+	ret = wifi_sta_caps_get("wlan2", &sta, now);
+	CHECK(ret == -ENOENT, "least recently used sta evicted\n");
+	addr[4] = 199;
+	sta_info(&sta, addr, 10);
+	ret = wifi_sta_caps_get("wlan2", &sta, now);
+	CHECK(ret == 0, "newest sta kept\n");
+
+	wifi_sta_caps_del("wlan2", NULL);
+}
+
+int main(int argc, char **argv)
+{
+	test_cache();
+	test_max_stas();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * test_sta_history.c - check the per-sta rssi/snr/rate history, its EWMA,
+ * the per-interface bound and eviction of stas.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+#include "wifiutils.h"
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+#define IFNAME		"wlan0"
+
+static void sample(struct wifi_sta *sta, int id, int8_t rssi, int8_t noise,
+		   uint32_t rate)
+{
+	memset(sta, 0, sizeof(*sta));
+	memcpy(sta->macaddr, "\x02\x00\x00\x00\x00\x00", 6);
+	sta->macaddr[5] = id;
+	sta->rssi_avg = rssi;
+	sta->noise_avg = noise;
+	sta->tx_rate.rate = rate;
+	sta->rx_rate.rate = rate / 2;
+}
+
+static void test_ewma_ring(void)
+{
+	struct wifi_sta_history h;
+	struct wifi_sta sta;
+	int ret;
+	int i;
+
+	wifi_sta_history_config(IFNAME, 50, 4);
+
+	sample(&sta, 1, -60, -90, 400);
+	wifi_sta_history_record(IFNAME, &sta, 1000);
+	ret = wifi_get_sta_history(IFNAME, sta.macaddr, &h);
+	CHECK(ret == 0 && h.num == 1 && h.rssi_ewma == -60 &&
+	      h.snr_ewma == 30 && h.tx_rate_ewma == 400 &&
+	      h.rx_rate_ewma == 200,
+	      "first sample: rssi %d snr %d rate %u/%u\n", h.rssi_ewma,
+	      h.snr_ewma, h.tx_rate_ewma, h.rx_rate_ewma);
+
+	/* alpha 50%: -60 -> -70 -> -75 */
+	sample(&sta, 1, -80, -90, 200);
+	wifi_sta_history_record(IFNAME, &sta, 2000);
+	sample(&sta, 1, -80, -90, 200);
+	wifi_sta_history_record(IFNAME, &sta, 3000);
+	wifi_get_sta_history(IFNAME, sta.macaddr, &h);
+	CHECK(h.rssi_ewma == -75 && h.snr_ewma == 15 && h.tx_rate_ewma == 250,
+	      "ewma: rssi %d snr %d tx rate %u\n", h.rssi_ewma, h.snr_ewma,
+	      h.tx_rate_ewma);
+
+	/* ring keeps the most recent samples, oldest first */
+	for (i = 0; i < WIFI_STA_HISTORY_LEN + 5; i++) {
+		sample(&sta, 1, (int8_t)(-50 - i), 0, 100);
+		wifi_sta_history_record(IFNAME, &sta, 4000 + i);
+	}
+
+	wifi_get_sta_history(IFNAME, sta.macaddr, &h);
+	CHECK(h.num == WIFI_STA_HISTORY_LEN &&
+	      h.num_samples == WIFI_STA_HISTORY_LEN + 8 &&
+	      h.sample[0].rssi == -55 && h.sample[0].tstamp == 4005 &&
+	      h.sample[h.num - 1].rssi == -50 - WIFI_STA_HISTORY_LEN - 4,
+	      "ring: %d samples of %u, oldest %d newest %d\n", h.num,
+	      h.num_samples, h.sample[0].rssi, h.sample[h.num - 1].rssi);
+	CHECK(h.sample[0].snr == 0, "snr unknown without noise\n");
+
+	/* no rssi, no sample */
+	sample(&sta, 2, 0, 0, 100);
+	wifi_sta_history_record(IFNAME, &sta, 5000);
+	ret = wifi_get_sta_history(IFNAME, sta.macaddr, &h);
+	CHECK(ret == -ENOENT, "sta without rssi not tracked\n");
+
+	wifi_sta_history_del(IFNAME, NULL);
+}
+
+static void test_bound(void)
+{
+	struct wifi_sta_history h;
+	struct wifi_sta stas[6];
+	int ret;
+	int i;
+
+	wifi_sta_history_config(IFNAME, 25, 4);
+
+	for (i = 0; i < 4; i++) {
+		sample(&stas[i], i, -60, 0, 100);
+		wifi_sta_history_record(IFNAME, &stas[i], 1000 + i);
+	}
+
+	/* sta 0 is sampled again; sta 1 is now the least recent */
+	wifi_sta_history_record(IFNAME, &stas[0], 2000);
+
+	sample(&stas[4], 4, -60, 0, 100);
+	wifi_sta_history_record(IFNAME, &stas[4], 3000);
+
+	ret = wifi_get_sta_history(IFNAME, stas[1].macaddr, &h);
+	CHECK(ret == -ENOENT, "least recent sta evicted at the bound\n");
+	ret = wifi_get_sta_history(IFNAME, stas[0].macaddr, &h);
+	ret |= wifi_get_sta_history(IFNAME, stas[4].macaddr, &h);
+	CHECK(ret == 0, "recent stas kept\n");
+
+	/* bound is per interface */
+	sample(&stas[5], 5, -60, 0, 100);
+	wifi_sta_history_record("wlan1", &stas[5], 3000);
+	ret = wifi_get_sta_history(IFNAME, stas[0].macaddr, &h);
+	CHECK(ret == 0, "other iface does not evict\n");
+
+	/* lowering the bound evicts */
+	wifi_sta_history_config(IFNAME, 25, 2);
+	ret = wifi_get_sta_history(IFNAME, stas[2].macaddr, &h);
+	CHECK(ret == -ENOENT, "lower bound evicts\n");
+
+	/* disassociated stas are dropped */
+	wifi_sta_history_expire(IFNAME, &stas[4], 1);
+	ret = wifi_get_sta_history(IFNAME, stas[0].macaddr, &h);
+	CHECK(ret == -ENOENT, "sta not in assoclist dropped\n");
+	ret = wifi_get_sta_history(IFNAME, stas[4].macaddr, &h);
+	CHECK(ret == 0, "sta in assoclist kept\n");
+
+	wifi_sta_history_del(IFNAME, stas[4].macaddr);
+	ret = wifi_get_sta_history(IFNAME, stas[4].macaddr, &h);
+	CHECK(ret == -ENOENT, "deleted sta dropped\n");
+	ret = wifi_get_sta_history("wlan1", stas[5].macaddr, &h);
+	CHECK(ret == 0, "other iface untouched\n");
+
+	ret = wifi_sta_history_config(IFNAME, 0, 2);
+	CHECK(ret == -EINVAL, "alpha 0 rejected\n");
+
+	wifi_sta_history_del("wlan1", NULL);
+}
+
+int main(int argc, char **argv)
+{
+	test_ewma_ring();
+	test_bound();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
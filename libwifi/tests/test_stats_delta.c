@@ -0,0 +1,206 @@
+/*
+ * test_stats_delta.c - check stats snapshots and the per-second rates
+ * between them, including 32-bit counter wraparound and counter resets.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+/* stats.c is linked in alone; these stand in for the driver queries */
+static struct wifi_radio_stats radio_stats;
+static struct wifi_ap_stats ap_stats;
+static struct wifi_sta_stats sta_stats;
+static struct wifi_bss_wmm_stats wmm_stats[2];
+static int counter_bits = 64;
+
+int wifi_get_counter_bits(const char *name)
+{
+	return counter_bits;
+}
+
+int wifi_radio_get_stats(const char *name, struct wifi_radio_stats *s)
+{
+	memcpy(s, &radio_stats, sizeof(*s));
+	return 0;
+}
+
+int wifi_ap_get_stats(const char *ifname, struct wifi_ap_stats *s)
+{
+	memcpy(s, &ap_stats, sizeof(*s));
+	return 0;
+}
+
+int wifi_get_sta_stats(const char *ifname, uint8_t *addr,
+		       struct wifi_sta_stats *s)
+{
+	memcpy(s, &sta_stats, sizeof(*s));
+	return 0;
+}
+
+int wifi_radio_get_wmm_stats(const char *name, struct wifi_bss_wmm_stats *bss,
+			     int *num)
+{
+	memcpy(bss, wmm_stats, sizeof(wmm_stats));
+	*num = 2;
+	return 0;
+}
+
+static void test_radio(void)
+{
+	struct wifi_stats_snapshot s1, s2, r;
+	int ret;
+
+	radio_stats.tx_bytes = 1000;
+	radio_stats.rx_pkts = UINT32_MAX - 99;
+	radio_stats.tx_err_pkts = 5000000000ULL;
+	radio_stats.noise = -90;
+	wifi_radio_stats_snapshot("wlan0", &s1);
+
+	radio_stats.tx_bytes = 3001000;
+	radio_stats.rx_pkts = 100;		/* wrapped, or reset */
+	radio_stats.tx_err_pkts = 10;		/* reset */
+	radio_stats.noise = -85;
+	wifi_radio_stats_snapshot("wlan0", &s2);
+
+	CHECK(s1.type == WIFI_STATS_RADIO && s2.tstamp >= s1.tstamp &&
+	      s1.counter_bits == 64,
+	      "radio snapshots timestamped\n");
+
+	/* snapshots are taken back to back; fix up the interval */
+	s2.tstamp = s1.tstamp + 2000;
+	ret = wifi_stats_delta(&s1, &s2, &r);
+	CHECK(ret == 0 && r.tstamp == 2000, "radio delta over %" PRIu64 "ms\n",
+	      r.tstamp);
+	CHECK(r.radio.tx_bytes == 1500000, "tx_bytes %" PRIu64 "/s\n",
+	      r.radio.tx_bytes);
+	CHECK(r.radio.rx_pkts == 50, "rx_pkts %" PRIu64 "/s after reset\n",
+	      r.radio.rx_pkts);
+	CHECK(r.radio.tx_err_pkts == 5, "tx_err_pkts %" PRIu64 "/s after reset\n",
+	      r.radio.tx_err_pkts);
+
+	/* of a 32-bit source */
+	s1.counter_bits = 32;
+	s2.counter_bits = 32;
+	ret = wifi_stats_delta(&s1, &s2, &r);
+	CHECK(ret == 0 && r.radio.rx_pkts == 100,
+	      "rx_pkts %" PRIu64 "/s across 32-bit wrap\n", r.radio.rx_pkts);
+	CHECK(r.radio.tx_err_pkts == 5, "tx_err_pkts %" PRIu64 "/s after reset\n",
+	      r.radio.tx_err_pkts);
+	CHECK(r.radio.noise == -85, "noise %d from current sample\n",
+	      r.radio.noise);
+
+	ret = wifi_stats_delta(&s2, &s1, &r);
+	CHECK(ret == -EINVAL, "delta back in time rejected\n");
+}
+
+static void test_ap_sta(void)
+{
+	struct wifi_stats_snapshot s1, s2, r;
+	uint8_t addr[6] = {0x02, 0, 0, 0, 0, 1};
+	int ret;
+
+	ap_stats.tx_ucast_pkts = 100;
+	wifi_ap_stats_snapshot("wlan0", &s1);
+	ap_stats.tx_ucast_pkts = 600;
+	wifi_ap_stats_snapshot("wlan0", &s2);
+	s2.tstamp = s1.tstamp + 500;
+
+	ret = wifi_stats_delta(&s1, &s2, &r);
+	CHECK(ret == 0 && r.ap.tx_ucast_pkts == 1000,
+	      "ap tx_ucast_pkts %" PRIu64 "/s\n", r.ap.tx_ucast_pkts);
+
+	sta_stats.rx_bytes = 10;
+	wifi_sta_stats_snapshot("wlan0", addr, &s2);
+	ret = wifi_stats_delta(&s1, &s2, &r);
+	CHECK(ret == -EINVAL, "delta of different stats rejected\n");
+
+	s1 = s2;
+	sta_stats.rx_bytes = 10010;
+	wifi_sta_stats_snapshot("wlan0", addr, &s2);
+	s2.tstamp = s1.tstamp + 1000;
+	ret = wifi_stats_delta(&s1, &s2, &r);
+	CHECK(ret == 0 && r.sta.rx_bytes == 10000,
+	      "sta rx_bytes %" PRIu64 "/s\n", r.sta.rx_bytes);
+
+	/* a sta reassociated: its 64-bit counters start again */
+	s1 = s2;
+	sta_stats.rx_bytes = 500;
+	wifi_sta_stats_snapshot("wlan0", addr, &s2);
+	s2.tstamp = s1.tstamp + 1000;
+	ret = wifi_stats_delta(&s1, &s2, &r);
+	CHECK(ret == 0 && r.sta.rx_bytes == 500,
+	      "sta rx_bytes %" PRIu64 "/s after reassociation\n", r.sta.rx_bytes);
+}
+
+static void test_wmm(void)
+{
+	struct wifi_stats_snapshot s1, s2, r;
+	int ret;
+
+	/* of a driver with 32-bit counters */
+	counter_bits = 32;
+	strcpy(wmm_stats[0].ifname, "wlan0");
+	strcpy(wmm_stats[1].ifname, "wlan0.1");
+	wmm_stats[1].ac[VI].tx_pkts = UINT32_MAX;
+	ret = wifi_wmm_stats_snapshot("wlan0", "wlan0.1", &s1);
+	CHECK(ret == 0 && !strcmp(s1.wmm.ifname, "wlan0.1") &&
+	      s1.counter_bits == 32, "wmm snapshot of %s, %d-bit\n",
+	      s1.wmm.ifname, s1.counter_bits);
+
+	wmm_stats[1].ac[VI].tx_pkts = 999;
+	wifi_wmm_stats_snapshot("wlan0", "wlan0.1", &s2);
+	s2.tstamp = s1.tstamp + 1000;
+	ret = wifi_stats_delta(&s1, &s2, &r);
+	CHECK(ret == 0 && r.wmm.ac[VI].tx_pkts == 1000 &&
+	      r.wmm.ac[BE].tx_pkts == 0,
+	      "VI tx_pkts %" PRIu64 "/s across wrap\n", r.wmm.ac[VI].tx_pkts);
+
+	ret = wifi_wmm_stats_snapshot("wlan0", "wlan1", &s1);
+	CHECK(ret == -ENODEV, "wmm snapshot of unknown iface = %d\n", ret);
+	counter_bits = 64;
+}
+
+int main(int argc, char **argv)
+{
+	test_radio();
+	test_ap_sta();
+	test_wmm();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
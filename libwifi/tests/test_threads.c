@@ -0,0 +1,226 @@
+/*
+ * test_threads.c - hammer the test driver from many threads at once, on
+ * both its radios, and check every result against a single threaded run.
+ * Built with -fsanitize=thread by the 'tsan' target.
+ *
+ * Copyright (C) 2020 iopsys Software Solutions AB. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "easy.h"
+#include "wifi.h"
+
+/* Needs a libwifi built with WIFI_TYPE=TEST */
+#define NUM_THREADS	8
+#define NUM_ITER	500
+#define MAX_STAS	16
+#define MAX_CHANNELS	64
+
+static int failed;
+
+#define CHECK(cond, ...)					\
+do {								\
+	if (!(cond)) {						\
+		failed++;					\
+		printf("FAIL: " __VA_ARGS__);			\
+	} else {						\
+		printf("PASS: " __VA_ARGS__);			\
+	}							\
+} while (0)
+
+/* results of a single threaded run on a radio */
+struct reference {
+	const char *ifname;
+	enum wifi_band band;
+	struct wifi_radio_stats radio;
+	uint8_t stas[MAX_STAS * 6];
+	int num_stas;
+	struct wifi_sta sta;
+	uint32_t ch20[MAX_CHANNELS];
+	int num_ch20;
+	uint32_t ch80[MAX_CHANNELS];
+	int num_ch80;
+};
+
+static struct reference ref[2] = {
+	{ .ifname = "test2", .band = BAND_2 },
+	{ .ifname = "test5", .band = BAND_5 },
+};
+
+static pthread_barrier_t start;
+
+static int get_reference(struct reference *r)
+{
+	int ret;
+
+	ret = wifi_radio_get_stats(r->ifname, &r->radio);
+	r->num_stas = MAX_STAS;
+	ret |= wifi_get_assoclist(r->ifname, r->stas, &r->num_stas);
+	if (ret || r->num_stas <= 0)
+		return -1;
+
+	ret = wifi_get_sta_info(r->ifname, r->stas, &r->sta);
+	r->num_ch20 = MAX_CHANNELS;
+	ret |= wifi_get_valid_channels(r->ifname, r->band, BW20, "DE",
+				       r->ch20, &r->num_ch20);
+	r->num_ch80 = MAX_CHANNELS;
+	ret |= wifi_get_valid_channels(r->ifname, r->band, BW80, "DE",
+				       r->ch80, &r->num_ch80);
+
+	return ret;
+}
+
+/* A round of queries on a radio; returns number of unexpected results */
+static int hammer_once(struct reference *r, int tid, int iter)
+{
+	struct wifi_sta stas[MAX_STAS];
+	struct wifi_radio_stats rs;
+	struct wifi_sta_history h;
+	uint32_t ch[MAX_CHANNELS];
+	uint8_t macs[MAX_STAS * 6];
+	struct wifi_airtime a;
+	struct wifi_sta sta;
+	int bad = 0;
+	int num;
+
+	memset(&rs, 0, sizeof(rs));
+	if (wifi_radio_get_stats(r->ifname, &rs) ||
+	    rs.tx_bytes != r->radio.tx_bytes || rs.rx_pkts != r->radio.rx_pkts)
+		bad++;
+
+	num = MAX_STAS;
+	if (wifi_get_assoclist(r->ifname, macs, &num) || num != r->num_stas ||
+	    memcmp(macs, r->stas, num * 6))
+		bad++;
+
+	num = MAX_STAS;
+	if (wifi_get_stas_info(r->ifname, stas, &num) || num != r->num_stas ||
+	    memcmp(stas[0].macaddr, r->stas, 6))
+		bad++;
+
+	memset(&sta, 0, sizeof(sta));
+	if (wifi_get_sta_info(r->ifname, r->stas, &sta) ||
+	    sta.rssi_avg != r->sta.rssi_avg || sta.maxrate != r->sta.maxrate)
+		bad++;
+
+	if (r->sta.rssi_avg &&
+	    wifi_get_sta_history(r->ifname, r->stas, &h) == 0 &&
+	    h.rssi_ewma != r->sta.rssi_avg)
+		bad++;
+
+	/* mix up the widths, which used to change the channel tables */
+	num = MAX_CHANNELS;
+	if ((iter + tid) % 2) {
+		if (wifi_get_valid_channels(r->ifname, r->band, BW80, "DE",
+					    ch, &num) ||
+		    num != r->num_ch80 || memcmp(ch, r->ch80, num * 4))
+			bad++;
+	} else {
+		if (wifi_get_valid_channels(r->ifname, r->band, BW20, "DE",
+					    ch, &num) ||
+		    num != r->num_ch20 || memcmp(ch, r->ch20, num * 4))
+			bad++;
+	}
+
+	wifi_ap_get_airtime(r->ifname, &a);
+
+	if (tid == 0 && iter % 50 == 0) {
+		wifi_sta_history_config(r->ifname, 25 + iter % 50, MAX_STAS);
+		wifi_coalesce_config(iter % 100 == 0, 0);
+	}
+
+	return bad;
+}
+
+struct worker {
+	pthread_t thread;
+	int tid;
+	int bad;
+};
+
+static void *hammer(void *arg)
+{
+	struct worker *w = arg;
+	int i;
+
+	pthread_barrier_wait(&start);
+
+	for (i = 0; i < NUM_ITER; i++)
+		w->bad += hammer_once(&ref[(i + w->tid) % 2], w->tid, i);
+
+	return NULL;
+}
+
+static void test_reference(void)
+{
+	uint32_t ch[MAX_CHANNELS];
+	int num = MAX_CHANNELS;
+	int ret;
+
+	ret = get_reference(&ref[0]);
+	ret |= get_reference(&ref[1]);
+	CHECK(ret == 0, "reference results, %d and %d stas\n",
+	      ref[0].num_stas, ref[1].num_stas);
+
+	/* a query for a wider channel doesn't shrink the narrower ones */
+	ret = wifi_get_valid_channels(ref[1].ifname, BAND_5, BW20, "DE", ch,
+				      &num);
+	CHECK(ret == 0 && num == ref[1].num_ch20 &&
+	      ref[1].num_ch80 <= ref[1].num_ch20,
+	      "5GHz channels: %d at 20MHz, %d at 80MHz\n", num,
+	      ref[1].num_ch80);
+}
+
+static void test_threads(void)
+{
+	struct worker w[NUM_THREADS];
+	int bad = 0;
+	int i;
+
+	pthread_barrier_init(&start, NULL, NUM_THREADS);
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		w[i].tid = i;
+		w[i].bad = 0;
+		pthread_create(&w[i].thread, NULL, hammer, &w[i]);
+	}
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		pthread_join(w[i].thread, NULL);
+		bad += w[i].bad;
+	}
+
+	pthread_barrier_destroy(&start);
+	wifi_coalesce_config(false, 0);
+
+	CHECK(bad == 0, "%d threads x %d rounds: %d bad results\n",
+	      NUM_THREADS, NUM_ITER, bad);
+}
+
+int main(int argc, char **argv)
+{
+	test_reference();
+	test_threads();
+
+	printf("%s: %d failed\n", failed ? "FAILED" : "OK", failed);
+	return failed ? 1 : 0;
+}
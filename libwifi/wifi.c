@@ -36,10 +36,19 @@
 #include "easy.h"
 #include "debug.h"
 #include "wifi.h"
+#include "wifiutils.h"
 
 extern const struct wifi_driver *wifi_drivers[];
 extern uint32_t num_wifi_drivers;
 
+/* args of a query run through wifi_coalesce() */
+struct wifi_query {
+	const char *ifname;
+	uint8_t *addr;
+	void *out;
+	int *num;
+};
+
 const struct wifi_driver *get_wifi_driver(const char *ifname)
 {
 	int i;
@@ -97,6 +106,9 @@ int wifi_scan(const char *ifname, struct scan_param *p)
 	if (drv && drv->scan)
 		ret = drv->scan(ifname, p);
 
+	if (!ret)
+		wifi_bssdb_stale(ifname);
+
 	EXIT(ret);
 	return ret;
 }
@@ -110,6 +122,9 @@ int wifi_scan_ex(const char *ifname, struct scan_param_ex *sp)
 	if (drv && drv->scan_ex)
 		ret = drv->scan_ex(ifname, sp);
 
+	if (!ret)
+		wifi_bssdb_stale(ifname);
+
 	EXIT(ret);
 	return ret;
 }
@@ -123,10 +138,188 @@ int wifi_get_scan_results(const char *ifname, struct wifi_bss *bsss, int *nr)
 	if (drv && drv->get_scan_results)
 		ret = drv->get_scan_results(ifname, bsss, nr);
 
+	if (!ret)
+		wifi_bssdb_update(ifname, bsss, *nr, true, time_monotonic_msecs());
+
+	EXIT(ret);
+	return ret;
+}
+
+#define WIFI_SCAN_RESULTS_NUM	256
+#define WIFI_SCAN_RESULTS_MAX	4096
+
+/* Filter the scan results of a driver which can't do it while getting them.
+ * A driver which filled the array may have more, so it is asked again with
+ * twice the room.
+ */
+static int wifi_iterate_scan_results_all(const char *ifname,
+					 struct wifi_scan_filter *f,
+					 int (*cb)(struct wifi_bss *bss, void *priv),
+					 void *priv)
+{
+	struct wifi_bss *bsss = NULL;
+	struct wifi_bss *n;
+	int max = WIFI_SCAN_RESULTS_NUM;
+	int num;
+	int ret;
+	int i;
+
+	for (;;) {
+		n = realloc(bsss, (size_t)max * sizeof(*bsss));
+		if (!n) {
+			free(bsss);
+			return -ENOMEM;
+		}
+
+		bsss = n;
+		memset(bsss, 0, (size_t)max * sizeof(*bsss));
+		num = max;
+		ret = wifi_get_scan_results(ifname, bsss, &num);
+		if (ret || num < max || max >= WIFI_SCAN_RESULTS_MAX)
+			break;
+
+		max *= 2;
+	}
+
+	for (i = 0; !ret && i < num; i++) {
+		if (!wifi_scan_filter_match(f, UINT32_MAX, &bsss[i], -1))
+			continue;
+
+		if (cb(&bsss[i], priv))
+			break;
+	}
+
+	free(bsss);
+	return ret;
+}
+
+struct wifi_scan_iter {
+	const char *ifname;
+	uint64_t now;
+	int (*cb)(struct wifi_bss *bss, void *priv);
+	void *priv;
+};
+
+/* Record each scan result passed to the caller in the BSS database */
+static int wifi_scan_iter_cb(struct wifi_bss *bss, void *priv)
+{
+	struct wifi_scan_iter *it = priv;
+
+	wifi_bssdb_update(it->ifname, bss, 1, false, it->now);
+	return it->cb(bss, it->priv);
+}
+
+int wifi_iterate_scan_results(const char *ifname, struct wifi_scan_filter *f,
+			      int (*cb)(struct wifi_bss *bss, void *priv),
+			      void *priv)
+{
+	const struct wifi_driver *drv = get_wifi_driver(ifname);
+	struct wifi_scan_iter it = {
+		.ifname = ifname,
+		.now = time_monotonic_msecs(),
+		.cb = cb,
+		.priv = priv,
+	};
+	int ret = -ENOTSUP;
+
+	if (!cb)
+		return -EINVAL;
+
+	ENTER();
+	if (drv && drv->iterate_scan_results)
+		ret = drv->iterate_scan_results(ifname, f, wifi_scan_iter_cb, &it);
+	else if (drv && drv->get_scan_results)
+		ret = wifi_iterate_scan_results_all(ifname, f, cb, priv);
+
+	EXIT(ret);
+	return ret;
+}
+
+struct wifi_scan_ies_iter {
+	const char *ifname;
+	uint64_t now;
+	int (*cb)(struct wifi_bss *bss, uint8_t *ies, size_t ies_len,
+		  void *priv);
+	void *priv;
+};
+
+/* Record each scan result passed to the caller in the BSS database, with
+ * what the database keeps of it decoded from its IEs.
+ */
+static int wifi_scan_ies_iter_cb(struct wifi_bss *bss, uint8_t *ies,
+				 size_t ies_len, void *priv)
+{
+	struct wifi_scan_ies_iter *it = priv;
+	struct wifi_ie_index idx;
+	struct wifi_bss b;
+
+	memcpy(&b, bss, sizeof(b));
+	wifi_ie_index_build(&idx, ies, ies_len);
+	wifi_bss_set_from_ie_index(&b, &idx);
+	wifi_bssdb_update(it->ifname, &b, 1, false, it->now);
+
+	return it->cb(bss, ies, ies_len, it->priv);
+}
+
+int wifi_iterate_scan_ies(const char *ifname, struct wifi_scan_filter *f,
+			  int (*cb)(struct wifi_bss *bss, uint8_t *ies,
+				    size_t ies_len, void *priv),
+			  void *priv)
+{
+	const struct wifi_driver *drv = get_wifi_driver(ifname);
+	struct wifi_scan_ies_iter it = {
+		.ifname = ifname,
+		.now = time_monotonic_msecs(),
+		.cb = cb,
+		.priv = priv,
+	};
+	int ret = -ENOTSUP;
+
+	if (!cb)
+		return -EINVAL;
+
+	ENTER();
+	if (drv && drv->iterate_scan_ies)
+		ret = drv->iterate_scan_ies(ifname, f, wifi_scan_ies_iter_cb, &it);
+
 	EXIT(ret);
 	return ret;
 }
 
+struct wifi_scan_results {
+	struct wifi_bss *bsss;
+	int num;
+	int max;
+};
+
+static int wifi_scan_results_add(struct wifi_bss *bss, void *priv)
+{
+	struct wifi_scan_results *r = priv;
+
+	memcpy(&r->bsss[r->num++], bss, sizeof(*bss));
+	return r->num >= r->max;
+}
+
+int wifi_get_scan_results_filtered(const char *ifname,
+				   struct wifi_scan_filter *f,
+				   struct wifi_bss *bsss, int *num)
+{
+	struct wifi_scan_results r = {
+		.bsss = bsss,
+		.max = *num,
+	};
+	int ret;
+
+	if (*num <= 0)
+		return -EINVAL;
+
+	ret = wifi_iterate_scan_results(ifname, f, wifi_scan_results_add, &r);
+	if (!ret)
+		*num = r.num;
+
+	return ret;
+}
+
 int wifi_get_bss_scan_result(const char *ifname, uint8_t *bssid,
 						struct wifi_bss_detail *b)
 {
@@ -308,6 +501,80 @@ int wifi_unsubscribe_frame(const char *ifname, uint8_t type, uint8_t stype)
 	return ret;
 }
 
+int wifi_subscribe_frames(const char *ifname, struct wifi_frame_sub *sub)
+{
+	const struct wifi_driver *drv = get_wifi_driver(ifname);
+	int ret = -ENOTSUP;
+
+	if (!sub)
+		return -EINVAL;
+
+	ENTER();
+	if (drv && drv->iface.subscribe_frames)
+		ret = drv->iface.subscribe_frames(ifname, sub);
+
+	EXIT(ret);
+	return ret;
+}
+
+int wifi_unsubscribe_frames(const char *ifname)
+{
+	const struct wifi_driver *drv = get_wifi_driver(ifname);
+	int ret = -ENOTSUP;
+
+	ENTER();
+	if (drv && drv->iface.unsubscribe_frames)
+		ret = drv->iface.unsubscribe_frames(ifname);
+
+	EXIT(ret);
+	return ret;
+}
+
+int wifi_get_frames_fd(const char *ifname, int *fd)
+{
+	const struct wifi_driver *drv = get_wifi_driver(ifname);
+	int ret = -ENOTSUP;
+
+	if (!fd)
+		return -EINVAL;
+
+	ENTER();
+	if (drv && drv->iface.get_frames_fd)
+		ret = drv->iface.get_frames_fd(ifname, fd);
+
+	EXIT(ret);
+	return ret;
+}
+
+int wifi_get_frames(const char *ifname, struct wifi_rx_frame *f, int *num)
+{
+	const struct wifi_driver *drv = get_wifi_driver(ifname);
+	int ret = -ENOTSUP;
+
+	if (!f || !num || *num <= 0)
+		return -EINVAL;
+
+	ENTER();
+	if (drv && drv->iface.get_frames)
+		ret = drv->iface.get_frames(ifname, f, num);
+
+	EXIT(ret);
+	return ret;
+}
+
+int wifi_track_probe_req(const char *ifname, bool enable)
+{
+	const struct wifi_driver *drv = get_wifi_driver(ifname);
+	int ret = -ENOTSUP;
+
+	ENTER();
+	if (drv && drv->iface.track_probe_req)
+		ret = drv->iface.track_probe_req(ifname, enable);
+
+	EXIT(ret);
+	return ret;
+}
+
 int wifi_set_4addr(const char *ifname, bool enable)
 {
 	const struct wifi_driver *drv = get_wifi_driver(ifname);
@@ -616,7 +883,11 @@ int wifi_get_noise(const char *ifname, int *noise)
 	return ret;
 }
 
-int wifi_radio_get_stats(const char *ifname, struct wifi_radio_stats *s)
+static int wifi_radio_airtime(const char *name, struct wifi_airtime *a,
+			      bool sample);
+
+static int _wifi_radio_get_stats(const char *ifname,
+				 struct wifi_radio_stats *s)
 {
 	const struct wifi_driver *drv = get_wifi_driver(ifname);
 	int ret = -ENOTSUP;
@@ -625,10 +896,35 @@ int wifi_radio_get_stats(const char *ifname, struct wifi_radio_stats *s)
 	if (drv && drv->radio.get_stats)
 		ret = drv->radio.get_stats(ifname, s);
 
+	if (!ret)
+		wifi_radio_airtime(ifname, &s->airtime, false);
+
 	EXIT(ret);
 	return ret;
 }
 
+static int wifi_query_radio_stats(void *ctx)
+{
+	struct wifi_query *q = ctx;
+
+	return _wifi_radio_get_stats(q->ifname, q->out);
+}
+
+int wifi_radio_get_stats(const char *ifname, struct wifi_radio_stats *s)
+{
+	struct wifi_query q = { .ifname = ifname, .out = s };
+
+	return wifi_coalesce(WIFI_COALESCE_RADIO_STATS, ifname, NULL, 0,
+			     s, sizeof(*s), NULL, wifi_query_radio_stats, &q);
+}
+
+int wifi_get_counter_bits(const char *name)
+{
+	const struct wifi_driver *drv = get_wifi_driver(name);
+
+	return drv && drv->counter_bits == 32 ? 32 : 64;
+}
+
 int wifi_radio_list(struct radio_entry *radio, int *num)
 {
 	const struct wifi_driver *drv;
@@ -708,7 +1004,7 @@ int wifi_ap_info(const char *ifname, struct wifi_ap *info)
 	return ret;
 }
 
-int wifi_ap_get_stats(const char *ifname, struct wifi_ap_stats *s)
+static int _wifi_ap_get_stats(const char *ifname, struct wifi_ap_stats *s)
 {
 	const struct wifi_driver *drv = get_wifi_driver(ifname);
 	int ret = -ENOTSUP;
@@ -717,10 +1013,28 @@ int wifi_ap_get_stats(const char *ifname, struct wifi_ap_stats *s)
 	if (drv && drv->iface.get_stats)
 		ret = drv->iface.get_stats(ifname, s);
 
+	if (!ret)
+		wifi_airtime_get_bss(ifname, &s->airtime, time_monotonic_msecs());
+
 	EXIT(ret);
 	return ret;
 }
 
+static int wifi_query_ap_stats(void *ctx)
+{
+	struct wifi_query *q = ctx;
+
+	return _wifi_ap_get_stats(q->ifname, q->out);
+}
+
+int wifi_ap_get_stats(const char *ifname, struct wifi_ap_stats *s)
+{
+	struct wifi_query q = { .ifname = ifname, .out = s };
+
+	return wifi_coalesce(WIFI_COALESCE_AP_STATS, ifname, NULL, 0,
+			     s, sizeof(*s), NULL, wifi_query_ap_stats, &q);
+}
+
 int wifi_get_beacon_ies(const char *ifname, uint8_t *ies, int *len)
 {
 	const struct wifi_driver *drv = get_wifi_driver(ifname);
@@ -747,7 +1061,7 @@ int wifi_acs(const char *ifname, struct acs_param *p)
 	return ret;
 }
 
-int wifi_get_assoclist(const char *ifname, uint8_t *stas, int *num)
+static int _wifi_get_assoclist(const char *ifname, uint8_t *stas, int *num)
 {
 	const struct wifi_driver *drv = get_wifi_driver(ifname);
 	int ret = -ENOTSUP;
@@ -760,7 +1074,25 @@ int wifi_get_assoclist(const char *ifname, uint8_t *stas, int *num)
 	return ret;
 }
 
-int wifi_get_sta_info(const char *ifname, uint8_t *addr, struct wifi_sta *info)
+static int wifi_query_assoclist(void *ctx)
+{
+	struct wifi_query *q = ctx;
+
+	return _wifi_get_assoclist(q->ifname, q->out, q->num);
+}
+
+int wifi_get_assoclist(const char *ifname, uint8_t *stas, int *num)
+{
+	struct wifi_query q = { .ifname = ifname, .out = stas, .num = num };
+
+	/* size of 'stas' is part of the key */
+	return wifi_coalesce(WIFI_COALESCE_ASSOCLIST, ifname, NULL, 0,
+			     stas, (size_t)*num * 6, num,
+			     wifi_query_assoclist, &q);
+}
+
+static int _wifi_get_sta_info(const char *ifname, uint8_t *addr,
+			      struct wifi_sta *info)
 {
 	const struct wifi_driver *drv = get_wifi_driver(ifname);
 	int ret = -ENOTSUP;
@@ -769,6 +1101,55 @@ int wifi_get_sta_info(const char *ifname, uint8_t *addr, struct wifi_sta *info)
 	if (drv && drv->get_sta_info)
 		ret = drv->get_sta_info(ifname, addr, info);
 
+	if (!ret) {
+		uint64_t now = time_monotonic_msecs();
+
+		wifi_airtime_update(ifname, info, now);
+		wifi_sta_history_record(ifname, info, now);
+	}
+
+	EXIT(ret);
+	return ret;
+}
+
+static int wifi_query_sta_info(void *ctx)
+{
+	struct wifi_query *q = ctx;
+
+	return _wifi_get_sta_info(q->ifname, q->addr, q->out);
+}
+
+int wifi_get_sta_info(const char *ifname, uint8_t *addr, struct wifi_sta *info)
+{
+	struct wifi_query q = { .ifname = ifname, .addr = addr, .out = info };
+
+	return wifi_coalesce(WIFI_COALESCE_STA_INFO, ifname, addr, 6,
+			     info, sizeof(*info), NULL, wifi_query_sta_info, &q);
+}
+
+int wifi_get_sta_info_mask(const char *ifname, uint8_t *addr, uint32_t mask,
+			   struct wifi_sta *info)
+{
+	const struct wifi_driver *drv = get_wifi_driver(ifname);
+	int ret;
+
+	if (!drv || !drv->get_sta_info_mask || mask == WIFI_STA_F_ALL)
+		return wifi_get_sta_info(ifname, addr, info);
+
+	ENTER();
+	ret = drv->get_sta_info_mask(ifname, addr, mask, info);
+	if (!ret) {
+		uint64_t now = time_monotonic_msecs();
+
+		if (mask & WIFI_STA_F_AIRTIME)
+			wifi_airtime_update(ifname, info, now);
+
+		/* history samples rssi and rates together */
+		if ((mask & (WIFI_STA_F_RSSI | WIFI_STA_F_RATE)) ==
+		    (WIFI_STA_F_RSSI | WIFI_STA_F_RATE))
+			wifi_sta_history_record(ifname, info, now);
+	}
+
 	EXIT(ret);
 	return ret;
 }
@@ -892,17 +1273,72 @@ int wifi_simulate_radar(const char *name, struct wifi_radar_args *radar)
 	return ret;
 }
 
-#if 0
+int wifi_radio_get_wmm_stats(const char *name, struct wifi_bss_wmm_stats *bss,
+			     int *num)
+{
+	const struct wifi_driver *drv = get_wifi_driver(name);
+	int ret = -ENOTSUP;
+
+	ENTER();
+	if (drv && drv->get_wmm_stats)
+		ret = drv->get_wmm_stats(name, bss, num);
+
+	EXIT(ret);
+	return ret;
+}
+
+int wifi_get_chan_gen(const char *name, uint32_t *gen)
+{
+	const struct wifi_driver *drv = get_wifi_driver(name);
+	int ret = -ENOTSUP;
+
+	ENTER();
+	if (drv && drv->get_chan_gen)
+		ret = drv->get_chan_gen(name, gen);
+
+	EXIT(ret);
+	return ret;
+}
+
+int wifi_get_reg_rules(const char *name, char *alpha2,
+		       struct wifi_reg_rule *rules, int *num)
+{
+	const struct wifi_driver *drv = get_wifi_driver(name);
+	int ret = -ENOTSUP;
+
+	ENTER();
+	if (drv && drv->get_reg_rules)
+		ret = drv->get_reg_rules(name, alpha2, rules, num);
+
+	EXIT(ret);
+	return ret;
+}
+
+int wifi_get_dfs_events(const char *name, struct wifi_dfs_event *ev, int *num)
+{
+	const struct wifi_driver *drv = get_wifi_driver(name);
+	int ret = -ENOTSUP;
+
+	ENTER();
+	if (drv && drv->get_dfs_events)
+		ret = drv->get_dfs_events(name, ev, num);
+
+	EXIT(ret);
+	return ret;
+}
+
 int wifi_get_sta_stats(const char *ifname, uint8_t *addr, struct wifi_sta_stats *sts)
 {
 	const struct wifi_driver *drv = get_wifi_driver(ifname);
+	int ret = -ENOTSUP;
 
+	ENTER();
 	if (drv && drv->get_sta_stats)
-		return drv->get_sta_stats(ifname, addr, sts);
+		ret = drv->get_sta_stats(ifname, addr, sts);
 
-	return -1;
+	EXIT(ret);
+	return ret;
 }
-#endif
 
 int wifi_disconnect_sta(const char *ifname, uint8_t *sta, uint16_t reason)
 {
@@ -913,6 +1349,11 @@ int wifi_disconnect_sta(const char *ifname, uint8_t *sta, uint16_t reason)
 	if (drv && drv->disconnect_sta)
 		ret = drv->disconnect_sta(ifname, sta, reason);
 
+	if (!ret) {
+		wifi_sta_history_del(ifname, sta);
+		wifi_sta_caps_del(ifname, sta);
+	}
+
 	EXIT(ret);
 	return ret;
 }
@@ -936,7 +1377,9 @@ int wifi_get_monitor_sta(const char *ifname, uint8_t *sta, struct wifi_monsta *m
 	int ret = -ENOTSUP;
 
 	ENTER();
-	if (drv && drv->get_monitor_sta)
+	if (wifi_monsta_tracked(ifname))
+		ret = wifi_monsta_get(ifname, sta, mon);
+	else if (drv && drv->get_monitor_sta)
 		ret = drv->get_monitor_sta(ifname, sta, mon);
 
 	EXIT(ret);
@@ -949,7 +1392,9 @@ int wifi_get_monitor_stas(const char *ifname, struct wifi_monsta *stas, int *num
 	int ret = -ENOTSUP;
 
 	ENTER();
-	if (drv && drv->get_monitor_stas)
+	if (wifi_monsta_tracked(ifname))
+		ret = wifi_monsta_get_all(ifname, stas, num_stas);
+	else if (drv && drv->get_monitor_stas)
 		ret = drv->get_monitor_stas(ifname, stas, num_stas);
 
 	EXIT(ret);
@@ -1197,6 +1642,151 @@ int wifi_sta_disconnect_ap(const char *ifname, uint32_t reason)
 	return ret;
 }
 
+static int wifi_get_stas_info_default(const struct wifi_driver *drv,
+				      const char *ifname,
+				      struct wifi_sta *stas, int *num)
+{
+	uint8_t *macs;
+	int num_macs = *num;
+	int ret;
+	int i;
+
+	macs = calloc((size_t)num_macs, 6);
+	if (!macs)
+		return -ENOMEM;
+
+	ret = drv->get_assoclist(ifname, macs, &num_macs);
+	if (ret)
+		goto out;
+
+	*num = 0;
+	for (i = 0; i < num_macs; i++) {
+		memset(&stas[*num], 0, sizeof(struct wifi_sta));
+		if (drv->get_sta_info(ifname, &macs[i * 6], &stas[*num]))
+			continue;
+
+		*num += 1;
+	}
+
+out:
+	free(macs);
+	return ret;
+}
+
+static int _wifi_get_stas_info(const char *ifname, struct wifi_sta *stas,
+			       int *num)
+{
+	const struct wifi_driver *drv = get_wifi_driver(ifname);
+	int ret = -ENOTSUP;
+
+	ENTER();
+	if (drv && drv->get_stas_info)
+		ret = drv->get_stas_info(ifname, stas, num);
+	else if (drv && drv->get_assoclist && drv->get_sta_info)
+		ret = wifi_get_stas_info_default(drv, ifname, stas, num);
+
+	if (!ret) {
+		uint64_t now = time_monotonic_msecs();
+		int i;
+
+		for (i = 0; i < *num; i++) {
+			wifi_airtime_update(ifname, &stas[i], now);
+			wifi_sta_history_record(ifname, &stas[i], now);
+		}
+
+		wifi_airtime_expire(ifname, stas, *num);
+		wifi_sta_history_expire(ifname, stas, *num);
+		wifi_sta_caps_expire(ifname, stas, *num);
+	}
+
+	EXIT(ret);
+	return ret;
+}
+
+static int wifi_query_stas_info(void *ctx)
+{
+	struct wifi_query *q = ctx;
+
+	return _wifi_get_stas_info(q->ifname, q->out, q->num);
+}
+
+int wifi_get_stas_info(const char *ifname, struct wifi_sta *stas, int *num)
+{
+	struct wifi_query q = { .ifname = ifname, .out = stas, .num = num };
+
+	return wifi_coalesce(WIFI_COALESCE_STAS_INFO, ifname, NULL, 0,
+			     stas, (size_t)*num * sizeof(*stas), num,
+			     wifi_query_stas_info, &q);
+}
+
+int wifi_ap_get_airtime(const char *ifname, struct wifi_airtime *a)
+{
+	struct wifi_sta *stas;
+	int num = 128;
+	int ret;
+
+	stas = calloc((size_t)num, sizeof(struct wifi_sta));
+	if (!stas)
+		return -ENOMEM;
+
+	/* sample the duration counters of all stas */
+	ret = wifi_get_stas_info(ifname, stas, &num);
+	if (!ret)
+		wifi_airtime_get_bss(ifname, a, time_monotonic_msecs());
+
+	free(stas);
+	return ret;
+}
+
+/* Sum up the airtime of the AP ifaces of a radio; sample the stas first if
+ * 'sample' is set, else use what was tracked on the last sta queries.
+ */
+static int wifi_radio_airtime(const char *name, struct wifi_airtime *a,
+			      bool sample)
+{
+	struct iface_entry iface[16];
+	struct wifi_airtime b;
+	int num = ARRAY_SIZE(iface);
+	uint32_t total;
+	int ret;
+	int i;
+
+	memset(a, 0, sizeof(*a));
+	ret = wifi_list_iface(name, iface, &num);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < num; i++) {
+		if (iface[i].mode != WIFI_MODE_AP)
+			continue;
+
+		memset(&b, 0, sizeof(b));
+		if (sample) {
+			if (wifi_ap_get_airtime(iface[i].name, &b))
+				continue;
+		} else {
+			wifi_airtime_get_bss(iface[i].name, &b,
+					     time_monotonic_msecs());
+		}
+
+		a->tx_airtime += b.tx_airtime;
+		a->rx_airtime += b.rx_airtime;
+		a->num_stas += b.num_stas;
+		if (b.interval > a->interval)
+			a->interval = b.interval;
+	}
+
+	total = a->tx_airtime + a->rx_airtime;
+	a->airtime = total >= 1000 ? 100 : (uint8_t)(total / 10);
+
+	return 0;
+}
+
+int wifi_radio_get_airtime(const char *name, struct wifi_airtime *a)
+{
+	return wifi_radio_airtime(name, a, true);
+}
+
 int wifi_register_event(const char *ifname, struct event_struct *ev, void **handle)
 {
 	const struct wifi_driver *drv;
@@ -1445,6 +2035,9 @@ const char *libwifi_apis[] = {
 	"wifi_scan",
 	"wifi_scan_ex",
 	"wifi_get_scan_results",
+	"wifi_get_scan_results_filtered",
+	"wifi_iterate_scan_results",
+	"wifi_iterate_scan_ies",
 	"wifi_get_bss_scan_result",
 	"wifi_get_noise",
 	"wifi_acs",
@@ -1459,6 +2052,10 @@ const char *libwifi_apis[] = {
 	"wifi_stop_cac",
 	"wifi_get_opclass_preferences",
 	"wifi_simulate_radar",
+	"wifi_radio_get_wmm_stats",
+	"wifi_get_chan_gen",
+	"wifi_get_reg_rules",
+	"wifi_get_dfs_events",
 
 
 	/*
@@ -1481,6 +2078,10 @@ const char *libwifi_apis[] = {
 	"wifi_vendor_cmd",
 	"wifi_subscribe_frame",
 	"wifi_unsubscribe_frame",
+	"wifi_subscribe_frames",
+	"wifi_unsubscribe_frames",
+	"wifi_get_frames_fd",
+	"wifi_get_frames",
 	"wifi_set_4addr",
 	"wifi_get_4addr",
 	"wifi_get_4addr_parent",
@@ -1518,6 +2119,8 @@ const char *libwifi_apis[] = {
 	"wifi_sta_get_stats",
 	"wifi_sta_get_ap_info",
 	"wifi_sta_disconnect_ap",
+	"wifi_get_stas_info",
+	"wifi_get_sta_info_mask",
 
 	"wifi_register_event",
 	"wifi_recv_event",
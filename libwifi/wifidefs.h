@@ -535,23 +535,33 @@ struct wifi_iface {
 #define WIFI_IFACE_MAX_NUM	16
 
 
+/** struct wifi_airtime - airtime used over the last measurement interval */
+struct wifi_airtime {
+	uint32_t tx_airtime;       /**< Tx airtime in msecs per second */
+	uint32_t rx_airtime;       /**< Rx airtime in msecs per second */
+	uint8_t airtime;           /**< total airtime in %-age */
+	uint32_t interval;         /**< measurement interval in msecs */
+	int num_stas;              /**< number of stas accounted */
+};
+
 /*
  * struct wifi_radio_stats - per radio statistics
  */
 struct wifi_radio_stats {
-	unsigned long tx_bytes;
-	unsigned long rx_bytes;
-	unsigned long tx_pkts;
-	unsigned long rx_pkts;
-	uint32_t tx_err_pkts;
-	uint32_t rx_err_pkts;
-	uint32_t tx_dropped_pkts;
-	uint32_t rx_dropped_pkts;
-	uint32_t rx_plcp_err_pkts;
-	uint32_t rx_fcs_err_pkts;
-	uint32_t rx_mac_err_pkts;
-	uint32_t rx_unknown_pkts;
+	uint64_t tx_bytes;
+	uint64_t rx_bytes;
+	uint64_t tx_pkts;
+	uint64_t rx_pkts;
+	uint64_t tx_err_pkts;
+	uint64_t rx_err_pkts;
+	uint64_t tx_dropped_pkts;
+	uint64_t rx_dropped_pkts;
+	uint64_t rx_plcp_err_pkts;
+	uint64_t rx_fcs_err_pkts;
+	uint64_t rx_mac_err_pkts;
+	uint64_t rx_unknown_pkts;
 	int noise;
+	struct wifi_airtime airtime;   /**< airtime used by stas of all BSSes */
 };
 
 /** struct wifi_radio_diagnostic - radio diagnostic data */
@@ -635,6 +645,7 @@ struct wifi_ap_stats {
 	uint64_t tx_bcast_pkts;
 	uint64_t rx_bcast_pkts;
 	uint64_t rx_unknown_pkts;
+	struct wifi_airtime airtime;   /**< airtime used by stas of the BSS */
 };
 
 /*
@@ -743,17 +754,29 @@ struct wps_device {
 struct wifi_sta_stats {
 	uint64_t tx_bytes;
 	uint64_t rx_bytes;
-	uint32_t tx_pkts;
-	uint32_t rx_pkts;
-	uint32_t tx_err_pkts;
-	uint32_t tx_rtx_pkts;
-	uint32_t tx_rtx_fail_pkts;
-	uint32_t tx_retry_pkts;
-	uint32_t tx_mretry_pkts;
-	uint32_t tx_fail_pkts;
+	uint64_t tx_pkts;
+	uint64_t rx_pkts;
+	uint64_t tx_err_pkts;
+	uint64_t tx_rtx_pkts;
+	uint64_t tx_rtx_fail_pkts;
+	uint64_t tx_retry_pkts;
+	uint64_t tx_mretry_pkts;
+	uint64_t tx_fail_pkts;
 	uint64_t rx_fail_pkts;
 };
 
+/* Groups of fields of struct wifi_sta, as selected in the fieldmask of
+ * wifi_get_sta_info_mask(). macaddr is always filled in.
+ */
+#define WIFI_STA_F_RSSI		0x1	/**< rssi_avg, rssi[], noise_avg, noise[] */
+#define WIFI_STA_F_RATE		0x2	/**< rx_rate, tx_rate, est_*_thput */
+#define WIFI_STA_F_STATS	0x4	/**< stats */
+#define WIFI_STA_F_CAPS		0x8	/**< cbitmap, caps, maxrate, rate, oper_std */
+#define WIFI_STA_F_AIRTIME	0x10	/**< *_airtime, airtime, *_duration */
+#define WIFI_STA_F_TIME		0x20	/**< conn_time, idle_time */
+#define WIFI_STA_F_STATUS	0x40	/**< bssid, sbitmap, sec, *_thput */
+#define WIFI_STA_F_ALL		0xffffffff
+
 /*
  * struct wifi_sta - info of a wifi sta from AP's assoclist
  */
@@ -783,6 +806,9 @@ struct wifi_sta {
 	struct wifi_rate rate;          /**< max link rate */
 	uint32_t est_rx_thput;          /**< AP -> this STA expected/estimated throughput in Mbps */
 	uint32_t est_tx_thput;          /**< this STA -> AP expected/estimated throughput in Mbps */
+	uint64_t tx_duration;           /**< total Tx airtime in usecs */
+	uint64_t rx_duration;           /**< total Rx airtime in usecs */
+	uint16_t airtime_weight;        /**< airtime fairness scheduling weight */
 };
 
 /*
@@ -801,6 +827,7 @@ struct wifi_monsta {
 	int8_t rssi_avg;		 /** < average rssi */
 	int last_seen;			 /** < last seen in seconds */
 	struct wifi_caps caps;		 /**< capabilities */
+	uint32_t num_probes;		 /**< probe requests seen; tracked stas only */
 };
 
 /*
@@ -809,11 +836,11 @@ struct wifi_monsta {
 struct wifi_ap_wmm_ac_stats {
 	uint64_t tx_bytes;
 	uint64_t rx_bytes;
-	uint32_t tx_pkts;
-	uint32_t rx_pkts;
-	uint32_t tx_err_pkts;
-	uint32_t rx_err_pkts;
-	uint32_t tx_rtx_pkts;
+	uint64_t tx_pkts;
+	uint64_t rx_pkts;
+	uint64_t tx_err_pkts;
+	uint64_t rx_err_pkts;
+	uint64_t tx_rtx_pkts;
 };
 
 /** enum wmm_ac_type - wmm access categories */
@@ -837,6 +864,73 @@ struct wifi_ap_wmm_ac {
 	struct wifi_ap_wmm_ac_stats stats;
 };
 
+/*
+ * struct wifi_bss_wmm_stats - per WMM_AC statistics of a BSS in a radio
+ */
+struct wifi_bss_wmm_stats {
+	char ifname[16];
+	uint8_t bssid[6];
+	struct wifi_ap_wmm_ac_stats ac[WIFI_NUM_AC];	/**< indexed by enum wmm_ac_type */
+};
+
+#define WIFI_STA_HISTORY_LEN	16
+
+/** struct wifi_sta_sample - link measurements of a sta at a point in time */
+struct wifi_sta_sample {
+	uint64_t tstamp;           /**< CLOCK_MONOTONIC msecs */
+	int8_t rssi;               /**< in dBm */
+	int8_t snr;                /**< in dB; 0 if noise is unknown */
+	uint32_t tx_rate;          /**< AP -> sta rate in Mbps */
+	uint32_t rx_rate;          /**< sta -> AP rate in Mbps */
+};
+
+/**
+ * struct wifi_sta_history - recent link measurements of a sta
+ *
+ * The EWMA smoothed values are updated on every sample with the alpha set
+ * through wifi_sta_history_config().
+ */
+struct wifi_sta_history {
+	uint8_t macaddr[6];
+	int8_t rssi_ewma;          /**< in dBm */
+	int8_t snr_ewma;           /**< in dB */
+	uint32_t tx_rate_ewma;     /**< in Mbps */
+	uint32_t rx_rate_ewma;     /**< in Mbps */
+	uint32_t num_samples;      /**< total samples recorded */
+	int num;                   /**< number of valid entries in sample[] */
+	struct wifi_sta_sample sample[WIFI_STA_HISTORY_LEN]; /**< oldest first */
+};
+
+/** enum wifi_stats_type - type of stats in a struct wifi_stats_snapshot */
+enum wifi_stats_type {
+	WIFI_STATS_RADIO,
+	WIFI_STATS_AP,
+	WIFI_STATS_STA,
+	WIFI_STATS_WMM,
+};
+
+/**
+ * struct wifi_stats_snapshot - timestamped sample of stats counters
+ *
+ * As returned by wifi_stats_delta(), the counters are the per-second rates
+ * over the interval between two samples, and tstamp is the interval.
+ *
+ * A counter which went back between two samples is taken as reset, unless
+ * counter_bits is 32, as set by the snapshots for a driver whose counters
+ * are 32-bit and wrap.
+ */
+struct wifi_stats_snapshot {
+	enum wifi_stats_type type;
+	uint64_t tstamp;                         /**< CLOCK_MONOTONIC msecs */
+	int counter_bits;                        /**< width of driver counters: 32 or 64 */
+	union {
+		struct wifi_radio_stats radio;
+		struct wifi_ap_stats ap;
+		struct wifi_sta_stats sta;
+		struct wifi_bss_wmm_stats wmm;
+	};
+};
+
 /*
  * struct wifi_ap_accounting - accounting server info
  */
@@ -902,6 +996,25 @@ struct wifi_bss_detail {
 	uint8_t ie[1024];
 };
 
+#define WIFI_BSSDB_CHAN_HISTORY	4
+
+/**
+ * struct wifi_bssdb_entry - a neighbor BSS as seen in the scans of all radios
+ *
+ * The RSSI EWMA is updated each time the BSS is seen, with the alpha set
+ * through wifi_bssdb_config().
+ */
+struct wifi_bssdb_entry {
+	struct wifi_bss bss;       /**< as last seen */
+	char ifname[16];           /**< radio which last saw it */
+	uint64_t first_seen;       /**< CLOCK_MONOTONIC msecs */
+	uint64_t last_seen;        /**< CLOCK_MONOTONIC msecs */
+	uint32_t num_seen;         /**< times seen in scan results */
+	int rssi_ewma;             /**< in dBm */
+	int num_channel;           /**< number of valid entries in channel[] */
+	uint8_t channel[WIFI_BSSDB_CHAN_HISTORY]; /**< channels it moved through, latest first */
+};
+
 /*
  * struct wifi_ap - AP structure corresponding to a BSS
  */
@@ -988,6 +1101,31 @@ struct scan_param_ex {
 	bool flush;          /**< clean cfg80211 cache */
 };
 
+/** struct wifi_scan_filter - scan results to get; each criterion applies
+ * only if its flag is set, and a bss must match all of them
+ */
+struct wifi_scan_filter {
+#define WIFI_SCAN_FILTER_SSID		0x1
+#define WIFI_SCAN_FILTER_BSSID		0x2
+#define WIFI_SCAN_FILTER_BAND		0x4
+#define WIFI_SCAN_FILTER_CHANNEL	0x8
+#define WIFI_SCAN_FILTER_RSSI		0x10
+#define WIFI_SCAN_FILTER_AGE		0x20
+#define WIFI_SCAN_FILTER_SECURITY	0x40
+	uint32_t flag;
+	char ssid[33];          /**< ssid */
+#define WIFI_SCAN_FILTER_MAX_BSSID	16
+	uint8_t num_bssid;      /**< number of bssids */
+	uint8_t bssid[WIFI_SCAN_FILTER_MAX_BSSID][6];   /**< any of the bssids */
+	uint32_t band;          /**< any of the bands in enum wifi_band */
+#define WIFI_SCAN_FILTER_MAX_CHANNEL	64
+	uint8_t num_channel;    /**< number of channels */
+	uint8_t channel[WIFI_SCAN_FILTER_MAX_CHANNEL];  /**< any of the channels */
+	int rssi;               /**< min rssi in dBm */
+	uint32_t age;           /**< max msecs since last seen, if reported */
+	uint32_t security;      /**< any of bits of enum wifi_security */
+};
+
 /** struct acs_param - auto channel sel arguments */
 struct acs_param {
 	// TODO
@@ -1221,6 +1359,7 @@ enum wifi_mbo_disallow_assoc_reason {
 #define IE_RRM                       70
 #define IE_EXT_CAP                   127
 #define IE_VHT_CAP                   191
+#define IE_VHT_OPER                  192
 #define IE_VEND_SPEC                 221
 #define IE_EXT                       255
 /* elements id extension */
@@ -1308,6 +1447,362 @@ int wifi_get_supported_opclass(const char *name, int *num_opclass,
 /** Check if given channel is DFS */
 bool wifi_is_dfs_channel(const char *name, int channel, int bandwidth);
 
+/** Get airtime used by the stas of an AP interface over the last interval */
+int wifi_ap_get_airtime(const char *ifname, struct wifi_airtime *a);
+
+/** Get airtime used by the stas of all AP interfaces of a radio */
+int wifi_radio_get_airtime(const char *name, struct wifi_airtime *a);
+
+/** Get timestamped sample of the stats of a radio */
+int wifi_radio_stats_snapshot(const char *name, struct wifi_stats_snapshot *s);
+
+/** Get timestamped sample of the stats of an AP interface */
+int wifi_ap_stats_snapshot(const char *ifname, struct wifi_stats_snapshot *s);
+
+/** Get timestamped sample of the stats of a sta */
+int wifi_sta_stats_snapshot(const char *ifname, uint8_t *addr,
+			    struct wifi_stats_snapshot *s);
+
+/** Get timestamped sample of the per-AC stats of an AP interface of a radio */
+int wifi_wmm_stats_snapshot(const char *name, const char *ifname,
+			    struct wifi_stats_snapshot *s);
+
+/** Get per-second rates of the counters between two samples of same stats */
+int wifi_stats_delta(const struct wifi_stats_snapshot *prev,
+		     const struct wifi_stats_snapshot *cur,
+		     struct wifi_stats_snapshot *rate);
+
+/** Get recent and smoothed link measurements of a sta */
+int wifi_get_sta_history(const char *ifname, uint8_t *addr,
+			 struct wifi_sta_history *h);
+
+/** Set EWMA alpha (in %) and max number of stas tracked for an interface */
+int wifi_sta_history_config(const char *ifname, int alpha, int max_stas);
+
+/** Record a sample of a sta's link measurements, e.g. from an event */
+int wifi_sta_history_add(const char *ifname, struct wifi_sta *sta);
+
+/** Drop history of a sta, e.g. on disassociation; all stas if addr is NULL */
+void wifi_sta_history_del(const char *ifname, uint8_t *addr);
+
+/** Queries that can be coalesced, see wifi_coalesce_config() */
+enum wifi_coalesce_op {
+	WIFI_COALESCE_ASSOCLIST,	/**< wifi_get_assoclist() */
+	WIFI_COALESCE_STA_INFO,		/**< wifi_get_sta_info() */
+	WIFI_COALESCE_STAS_INFO,	/**< wifi_get_stas_info() */
+	WIFI_COALESCE_RADIO_STATS,	/**< wifi_radio_get_stats() */
+	WIFI_COALESCE_AP_STATS,		/**< wifi_ap_get_stats() */
+
+	WIFI_COALESCE_NUM_OPS,
+};
+
+/** Counters of coalesced queries of an op */
+struct wifi_coalesce_stats {
+	uint64_t hit;		/**< got a result shared by another caller */
+	uint64_t wait;		/**< hits which waited for the query in flight */
+	uint64_t miss;		/**< queried the driver */
+};
+
+/** Share results of concurrent identical queries between threads, and
+ * reuse a result for 'ttl' msecs after it is got; off by default.
+ */
+int wifi_coalesce_config(bool enable, uint32_t ttl);
+
+/** Get hit/miss counters of coalesced queries of an op */
+int wifi_get_coalesce_stats(enum wifi_coalesce_op op,
+			    struct wifi_coalesce_stats *s);
+
+/** Counters of the channels and operating class tables cached for a radio */
+struct wifi_opclass_cache_stats {
+	uint64_t hit;		/**< got a cached table */
+	uint64_t miss;		/**< got a table from the driver */
+	uint64_t flush;		/**< tables dropped on events or flush */
+};
+
+/** Cache channels and operating classes of radios until their regulatory,
+ * DFS or channel state changes; on by default.
+ */
+int wifi_opclass_cache_config(bool enable);
+
+/** Drop channels and operating classes cached for a radio; all if NULL */
+void wifi_opclass_cache_flush(const char *name);
+
+/** Get hit/miss counters of the tables cached for a radio */
+int wifi_get_opclass_cache_stats(const char *name,
+				 struct wifi_opclass_cache_stats *s);
+
+/** A channel of a radio, as ranked by wifi_get_best_channels() */
+struct wifi_channel_rank {
+	uint8_t opclass;		/**< global operating class */
+	uint8_t channel;		/**< control channel; center for 80MHz and wider */
+	uint8_t score;			/**< 1-100, higher is better */
+	uint8_t busy;			/**< busy 0-100%, 255 if not known */
+	uint8_t bss_num;		/**< other BSSs on the channel and adjacent ones */
+	int noise;			/**< worst noise of the member channels */
+	bool dfs;			/**< is radar detection required */
+	enum dfs_state dfs_state;	/**< DFS state of the member channels */
+};
+
+/** Get channels of a radio for a band and bandwidth, best first.
+ * Scored as in its preferred operating classes; ones not supported are
+ * left out.
+ */
+int wifi_get_best_channels(const char *name, enum wifi_band band,
+			   enum wifi_bw bw, struct wifi_channel_rank *r,
+			   int *num);
+
+#define WIFI_REG_RULES_MAX		64
+
+/** Flags of a regulatory rule */
+#define WIFI_REG_RULE_DFS		0x1	/**< radar detection required */
+#define WIFI_REG_RULE_NO_IR		0x2	/**< no initiating radiation */
+#define WIFI_REG_RULE_AUTO_BW		0x4	/**< bw may span adjacent rules */
+#define WIFI_REG_RULE_NO_OUTDOOR	0x8	/**< indoor use only */
+
+/** A regulatory rule of a radio, as enforced by its driver */
+struct wifi_reg_rule {
+	uint32_t start_freq;	/**< start of the range in kHz */
+	uint32_t end_freq;	/**< end of the range in kHz */
+	uint32_t max_bw;	/**< max bandwidth in kHz */
+	int max_eirp;		/**< max EIRP in mBm */
+	uint32_t flags;		/**< WIFI_REG_RULE_* */
+	uint32_t cac_time;	/**< DFS CAC time in msecs; 0 = default */
+};
+
+/** Check if a channel of a radio may be used at a bandwidth, as per the
+ * regulatory rules of its driver. Returns 0 if it may, with the flags,
+ * the lowest max EIRP and the longest CAC time of the rules it spans in
+ * 'rule' if not NULL; -ENOENT if it may not, or -ENOTSUP if the driver
+ * has no rules to give.
+ */
+int wifi_regdb_check_channel(const char *name, enum wifi_band band,
+			     uint32_t channel, enum wifi_bw bw,
+			     struct wifi_reg_rule *rule);
+
+/** Get max EIRP in dBm allowed for a channel of a radio at a bandwidth */
+int wifi_regdb_get_max_power(const char *name, enum wifi_band band,
+			     uint32_t channel, enum wifi_bw bw, int *eirp);
+
+/** Get the country code and regulatory rules cached for a radio */
+int wifi_regdb_get_rules(const char *name, char *alpha2,
+			 struct wifi_reg_rule *rules, int *num);
+
+/** Drop regulatory rules cached for a radio; all if NULL */
+void wifi_regdb_flush(const char *name);
+
+/** enum wifi_dfs_event_type - DFS events of a radio */
+enum wifi_dfs_event_type {
+	WIFI_DFS_EVENT_CAC_STARTED,	/**< CAC started */
+	WIFI_DFS_EVENT_CAC_FINISHED,	/**< CAC passed */
+	WIFI_DFS_EVENT_CAC_ABORTED,	/**< CAC stopped before done */
+	WIFI_DFS_EVENT_RADAR,		/**< radar detected; NOP started */
+	WIFI_DFS_EVENT_NOP_FINISHED,	/**< NOP over */
+	WIFI_DFS_EVENT_PRE_CAC_EXPIRED,	/**< CAC done off-channel expired */
+};
+
+/** A DFS event of a radio, as its driver reports it */
+struct wifi_dfs_event {
+	enum wifi_dfs_event_type type;
+	uint32_t channel;		/**< control channel */
+	enum wifi_bw bw;		/**< bandwidth of the channel */
+};
+
+/** Set NOP time in msecs the DFS state of radios counts down from after
+ * radar detected, 30 mins by default.
+ */
+int wifi_dfs_config(uint32_t nop_time);
+
+/** Get DFS state of a channel of a radio at a bandwidth, as tracked from
+ * its DFS events. 'cac_time' and 'nop_time', if not NULL, get the CAC
+ * time and the NOP time left in seconds, the highest of the member
+ * channels.
+ */
+int wifi_dfs_get_state(const char *name, uint32_t channel, enum wifi_bw bw,
+		       enum dfs_state *state, uint32_t *cac_time,
+		       uint32_t *nop_time);
+
+/** Drop DFS state tracked for a radio, to get it from its channels again;
+ * all if NULL
+ */
+void wifi_dfs_flush(const char *name);
+
+/** Queries that can be run by wifi_fanout() */
+enum wifi_fanout_op {
+	WIFI_FANOUT_RADIO_INFO,		/**< wifi_radio_info() */
+	WIFI_FANOUT_RADIO_STATS,	/**< wifi_radio_get_stats() */
+	WIFI_FANOUT_CHANNELS_INFO,	/**< wifi_channels_info() */
+	WIFI_FANOUT_AP_INFO,		/**< wifi_ap_info() */
+	WIFI_FANOUT_AP_STATS,		/**< wifi_ap_get_stats() */
+	WIFI_FANOUT_ASSOCLIST,		/**< wifi_get_assoclist() */
+	WIFI_FANOUT_STA_INFO,		/**< wifi_get_sta_info() */
+	WIFI_FANOUT_STAS_INFO,		/**< wifi_get_stas_info() */
+
+	WIFI_FANOUT_NUM_OPS,
+};
+
+/** A query of a wifi_fanout() batch */
+struct wifi_fanout_req {
+	enum wifi_fanout_op op;
+	char ifname[16];
+	char radio[16];		/**< queries of a radio run in order; ifname if empty */
+	uint8_t addr[6];	/**< sta, for WIFI_FANOUT_STA_INFO */
+	void *out;		/**< result, of the type the op's API returns */
+	int num;		/**< in/out number of entries in 'out' for list ops */
+	int status;		/**< return value of the op, -ETIMEDOUT or -EBUSY */
+};
+
+/** Run a batch of queries concurrently; queries of different radios run in
+ * parallel, those of a radio in order, also across concurrent batches.
+ * Returns when all are done, or with -ETIMEDOUT after 'timeout' msecs (no
+ * limit if 0); see each req->status for its result. Queries of a radio
+ * still running one that timed out before fail with -EBUSY.
+ */
+int wifi_fanout(struct wifi_fanout_req *req, int num, int timeout);
+
+/** Handle of a scan requested by wifi_scan_async() */
+struct wifi_scan_req;
+
+/** Called once when a scan requested by wifi_scan_async() is done, with
+ * status 0 and its results, -ECONNABORTED if the driver aborted it,
+ * -ETIMEDOUT if it didn't finish in time, or the error it failed to start
+ * with. 'bss' is valid during the call only; 'req' is freed after it.
+ */
+typedef void (*wifi_scan_cb_t)(struct wifi_scan_req *req, int status,
+			       struct wifi_bss *bss, int num, void *userdata);
+
+/** Request a scan without waiting for it. Scans of an ifname run one at a
+ * time, in order of request; 'timeout' msecs (none if 0) counts from now.
+ * Returns NULL if the scan can't be started or its events can't be got.
+ */
+struct wifi_scan_req *wifi_scan_async(const char *ifname,
+				      struct scan_param_ex *sp,
+				      uint32_t timeout, wifi_scan_cb_t cb,
+				      void *userdata);
+
+/** Get the fd to poll for wifi_scan_async() scans; call
+ * wifi_scan_async_process() when it is readable.
+ */
+int wifi_scan_async_fd(void);
+
+/** Read scan events, run callbacks of done scans and start queued ones */
+int wifi_scan_async_process(void);
+
+/** Cancel a scan requested by wifi_scan_async(); its callback isn't called */
+int wifi_scan_async_cancel(struct wifi_scan_req *req);
+
+/** Get the merged entry of a neighbor BSS seen by any radio */
+int wifi_bssdb_lookup(uint8_t *bssid, struct wifi_bssdb_entry *e);
+
+/** Get the neighbor BSSs seen on a channel of a band */
+int wifi_bssdb_get_channel(enum wifi_band band, uint8_t channel,
+			   struct wifi_bssdb_entry *e, int *num);
+
+/** Set TTL (in msecs), max number of BSSs and RSSI EWMA alpha (in %) */
+int wifi_bssdb_config(uint32_t ttl, int max_entries, int alpha);
+
+/** Record BSSs seen by a radio, e.g. reported by a neighbor */
+int wifi_bssdb_add(const char *ifname, struct wifi_bss *bss, int num);
+
+/** Drop BSSs last seen by a radio; all BSSs if ifname is NULL */
+void wifi_bssdb_flush(const char *ifname);
+
+/** A scan result of struct wifi_scanres; the rest of struct wifi_bss is
+ * decoded from its IEs only when got by wifi_scanres_get_bss().
+ */
+struct wifi_scanres_bss {
+	uint8_t bssid[6];
+	uint8_t channel;
+#define WIFI_SCANRES_CAP	0x1	/* capability is valid */
+#define WIFI_SCANRES_BSS	0x2	/* a struct wifi_bss, not IEs, in the arena */
+	uint8_t flags;
+	uint16_t band;          /**< enum wifi_band */
+	uint16_t beacon_int;
+	uint16_t capability;    /**< capability information */
+	uint16_t ie_len;
+	int8_t rssi;
+	int8_t noise;
+	uint32_t ie_off;        /**< of its IEs in the arena */
+};
+
+/** Scan results of a radio with their IEs back to back in one arena. Zero
+ * it before the first wifi_get_scanres(); it is reused by the next ones,
+ * and freed by wifi_scanres_free().
+ */
+struct wifi_scanres {
+	int num;                        /**< number of scan results */
+	int max;                        /**< entries allocated */
+	struct wifi_scanres_bss *bss;
+	uint8_t *arena;
+	size_t arena_len;               /**< bytes used */
+	size_t arena_size;              /**< bytes allocated */
+};
+
+/** Get the scan results of a radio matching a filter (all if NULL) in
+ * compact form. Drivers which can't pass the IEs of their scan results
+ * have them kept as struct wifi_bss.
+ */
+int wifi_get_scanres(const char *ifname, struct wifi_scan_filter *f,
+		     struct wifi_scanres *r);
+
+/** Get the IEs of a scan result; NULL if its driver didn't pass them */
+uint8_t *wifi_scanres_get_ies(struct wifi_scanres *r, int i, size_t *len);
+
+/** Get a scan result as struct wifi_bss, decoded from its IEs */
+int wifi_scanres_get_bss(struct wifi_scanres *r, int i, struct wifi_bss *bss);
+
+/** As wifi_scanres_get_bss(), with the IEs that fit in b->ie */
+int wifi_scanres_get_bss_detail(struct wifi_scanres *r, int i,
+				struct wifi_bss_detail *b);
+
+/** Get bytes of memory held by scan results */
+size_t wifi_scanres_size(struct wifi_scanres *r);
+
+/** Free memory of scan results got by wifi_get_scanres() */
+void wifi_scanres_free(struct wifi_scanres *r);
+
+/** struct wifi_frame_sub - management frames of an interface to get with
+ * wifi_get_frames()
+ */
+struct wifi_frame_sub {
+#define WIFI_FRAME_SUB_PROBE_REQ	0x1
+#define WIFI_FRAME_SUB_ACTION		0x2
+	uint32_t flag;
+#define WIFI_FRAME_SUB_MAX_CATEGORY	16
+	uint8_t num_category;   /**< action categories; all if none */
+	uint8_t category[WIFI_FRAME_SUB_MAX_CATEGORY];
+	uint32_t ratelimit;     /**< min msecs between frames of a kind from a sta */
+	bool dedup;             /**< drop a frame with the body of the last of its kind from its sta */
+	int ring_size;          /**< max frames kept till got; default if 0 */
+};
+
+#define WIFI_RX_FRAME_MAX	512
+
+/** struct wifi_rx_frame - a management frame received by an interface */
+struct wifi_rx_frame {
+	uint64_t rx_time;       /**< CLOCK_MONOTONIC msecs when received */
+	int rssi;               /**< signal in dBm; 0 if unknown */
+	uint32_t freq;          /**< MHz */
+	uint16_t len;           /**< bytes in frame, from the 802.11 header */
+	bool truncated;         /**< frame longer than WIFI_RX_FRAME_MAX */
+	uint8_t frame[WIFI_RX_FRAME_MAX];
+};
+
+/** Track unassociated stas of an interface from their probe requests, and
+ * get wifi_get_monitor_sta(s)() from them. Probe requests are recorded by
+ * the driver where it can, leaving wifi_subscribe_frames() of the caller
+ * as is, else are to be added by wifi_monsta_add();
+ * until either, wifi_get_monitor_sta(s)() are still got from the driver.
+ * Sets EWMA alpha of rssi (in %) and max number of stas, the least
+ * recently seen of which makes room for a new one; 0 for defaults.
+ */
+int wifi_monsta_config(const char *ifname, int alpha, int max_stas);
+
+/** Record a probe request from a sta, e.g. from an event */
+int wifi_monsta_add(const char *ifname, uint8_t *macaddr, int8_t rssi);
+
+/** Stop tracking stas of an interface, and drop them */
+void wifi_monsta_stop(const char *ifname);
+
 /** Generate a random wps pin */
 int wifi_generate_wps_pin(unsigned long *pin);
 
@@ -268,6 +268,57 @@
  *	@brief             Trigger radar detection event.
  *	@param[in] name    radio interface name
  *	@param[in] radar   simulated radar parameters
+ *
+ * <b>int (*get_wmm_stats)(const char *name, struct wifi_bss_wmm_stats *bss, int *num)</b>\n
+ *	@brief             Get per-AC statistics of all AP interfaces of the radio.
+ *	@param[in] name    radio interface name
+ *	@param[out] bss    array of per-BSS WMM AC statistics
+ *	@param[in|out] num number of entries in bss array
+ *
+ * <b>int (*iterate_scan_results)(const char *name, struct wifi_scan_filter *f,
+ *				 int (*cb)(struct wifi_bss *bss, void *priv),
+ *				 void *priv)</b>\n
+ *	@brief             Pass each scan result matching a filter to a callback,
+ *	                   until it returns non-zero.
+ *	@param[in] name    radio interface name
+ *	@param[in] f       filter; all scan results if NULL
+ *	@param[in] cb      callback; 'bss' is valid during the call only
+ *	@param[in] priv    argument of the callback
+ *
+ * <b>int (*iterate_scan_ies)(const char *name, struct wifi_scan_filter *f,
+ *			     int (*cb)(struct wifi_bss *bss, uint8_t *ies,
+ *				       size_t ies_len, void *priv),
+ *			     void *priv)</b>\n
+ *	@brief             As iterate_scan_results, passing each scan result
+ *	                   with its IEs, which are left to the callback to
+ *	                   parse; 'bss' has only what isn't got from them,
+ *	                   but for the SSID and security when filtered on.
+ *	@param[in] name    radio interface name
+ *	@param[in] f       filter; all scan results if NULL
+ *	@param[in] cb      callback; 'bss' and 'ies' are valid during the call only
+ *	@param[in] priv    argument of the callback
+ *
+ * <b>int (*get_chan_gen)(const char *name, uint32_t *gen)</b>\n
+ *	@brief             Get a number which changes whenever the radio's
+ *	                   regulatory, DFS or channel state may have changed.
+ *	@param[in] name    radio interface name
+ *	@param[out] gen    generation number
+ *
+ * <b>int (*get_reg_rules)(const char *name, char *alpha2,
+ *				  struct wifi_reg_rule *rules, int *num)</b>\n
+ *	@brief             Get regulatory rules the radio's driver enforces.
+ *	@param[in] name    radio interface name
+ *	@param[out] alpha2 country code of the rules
+ *	@param[out] rules  rules, in order of frequency
+ *	@param[in,out] num max number of rules in, number of rules out
+ *
+ * <b>int (*get_dfs_events)(const char *name, struct wifi_dfs_event *ev,
+ *				   int *num)</b>\n
+ *	@brief             Get DFS events of the radio since the last call,
+ *	                   oldest first; returns -ESTALE if some were lost.
+ *	@param[in] name    radio interface name
+ *	@param[out] ev     events
+ *	@param[in,out] num max number of events in, number of events out
  */
 struct wifi_radio_ops {
 	int (*info)(const char *name, struct wifi_radio *radio);
@@ -327,6 +378,20 @@ struct wifi_radio_ops {
 	int (*get_opclass_preferences)(const char *name, struct wifi_opclass *opclass,
 				       int *num);
 	int (*simulate_radar)(const char *name, struct wifi_radar_args *radar);
+	int (*get_wmm_stats)(const char *name, struct wifi_bss_wmm_stats *bss,
+			     int *num);
+	int (*iterate_scan_results)(const char *name, struct wifi_scan_filter *f,
+				    int (*cb)(struct wifi_bss *bss, void *priv),
+				    void *priv);
+	int (*iterate_scan_ies)(const char *name, struct wifi_scan_filter *f,
+				int (*cb)(struct wifi_bss *bss, uint8_t *ies,
+					  size_t ies_len, void *priv),
+				void *priv);
+	int (*get_chan_gen)(const char *name, uint32_t *gen);
+	int (*get_reg_rules)(const char *name, char *alpha2,
+			     struct wifi_reg_rule *rules, int *num);
+	int (*get_dfs_events)(const char *name, struct wifi_dfs_event *ev,
+			      int *num);
 };
 
 
@@ -434,6 +499,34 @@ struct wifi_radio_ops {
  *	@param[in] type    frame type as in IEEE802.11 Std.
  *	@param[in] stype   frame sub-type as in IEEE802.11 Std.
  *
+ * <b>int (*subscribe_frames)(const char *ifname, struct wifi_frame_sub *sub)</b>\n
+ *	@brief             Keep received management frames in a ring till got
+ *	                   by get_frames; replaces an earlier subscription,
+ *	                   with the same fd to poll.
+ *	@param[in] ifname  interface name
+ *	@param[in] sub     frames to keep
+ *
+ * <b>int (*unsubscribe_frames)(const char *ifname)</b>\n
+ *	@brief             Stop keeping frames, and drop the ones kept.
+ *	@param[in] ifname  interface name
+ *
+ * <b>int (*get_frames_fd)(const char *ifname, int *fd)</b>\n
+ *	@brief             Get fd to poll for frames of a subscription.
+ *	@param[in] ifname  interface name
+ *	@param[out] fd     readable when frames are pending
+ *
+ * <b>int (*get_frames)(const char *ifname, struct wifi_rx_frame *f, int *num)</b>\n
+ *	@brief             Get frames kept, oldest first.
+ *	@param[in] ifname  interface name
+ *	@param[out] f      frames
+ *	@param[in,out] num max number of frames in, number of frames out
+ *
+ * <b>int (*track_probe_req)(const char *ifname, bool enable)</b>\n
+ *	@brief             Record probe requests as received for monitored
+ *	                   stas, apart from any frames subscribed to.
+ *	@param[in] ifname  interface name
+ *	@param[in] enable  enable = 1, else disable.
+ *
  * <b>int (*set_4addr)(const char *ifname, bool enable)</b>\n
  *	@brief             Enable or disable 4-address mode.
  *	@param[in] ifname  interface name
@@ -633,6 +726,19 @@ struct wifi_radio_ops {
  *	@param[in] ifname  interface name
  *	@param[in] reason  disconnection reason code as in IEEE802.11 Std.
  *
+ * <b>int (*get_stas_info)(const char *ifname, struct wifi_sta *stas, int *num)</b>\n
+ *	@brief              Get information of all STAs associated to an AP
+ *	@param[in] ifname   interface name
+ *	@param[out] stas    array of STA information
+ *	@param[in|out] num  number of entries in stas array
+ *
+ * <b>int (*get_sta_info_mask)(const char *ifname, uint8_t *addr, uint32_t mask, struct wifi_sta *info)</b>\n
+ *	@brief              Get selected information of a STA associated to an AP
+ *	@param[in] ifname   interface name
+ *	@param[in] addr     STA macaddress
+ *	@param[in] mask     bitmap of WIFI_STA_F_* field groups to get
+ *	@param[out] info    STA information; other fields may be left unset
+ *
  */
 struct wifi_iface_ops {
 	/*
@@ -660,6 +766,11 @@ struct wifi_iface_ops {
 
 	int (*subscribe_frame)(const char *ifname, uint8_t type, uint8_t stype);
 	int (*unsubscribe_frame)(const char *ifname, uint8_t type, uint8_t stype);
+	int (*subscribe_frames)(const char *ifname, struct wifi_frame_sub *sub);
+	int (*unsubscribe_frames)(const char *ifname);
+	int (*get_frames_fd)(const char *ifname, int *fd);
+	int (*get_frames)(const char *ifname, struct wifi_rx_frame *f, int *num);
+	int (*track_probe_req)(const char *ifname, bool enable);
 	int (*set_4addr)(const char *ifname, bool enable);
 	int (*get_4addr)(const char *ifname, bool *enabled);
 	int (*get_4addr_parent)(const char *ifname, const char *parent);
@@ -715,6 +826,10 @@ struct wifi_iface_ops {
 	int (*sta_get_stats)(const char *ifname, struct wifi_sta_stats *s);
 	int (*sta_get_ap_info)(const char *ifname, struct wifi_bss *info);
 	int (*sta_disconnect_ap)(const char *ifname, uint32_t reason);
+
+	int (*get_stas_info)(const char *ifname, struct wifi_sta *stas, int *num);
+	int (*get_sta_info_mask)(const char *ifname, uint8_t *addr,
+				 uint32_t mask, struct wifi_sta *info);
 };
 
 /** struct wifi_metainfo - meta information about wifi module */
@@ -738,6 +853,7 @@ struct wifi_driver {
 	int (*unregister_event)(const char *ifname, void *evhandle);
 	int (*recv_event)(const char *ifname, void *evhandle);
 	const char *(*get_version)(void);
+	int counter_bits;	/* of the stats counters, if 32; else 64 */
 };
 
 #define RADIO_OP(_p)	radio._p
@@ -771,6 +887,12 @@ struct wifi_driver {
 #define stop_cac		RADIO_OP(stop_cac)
 #define get_opclass_preferences	RADIO_OP(get_opclass_preferences)
 #define simulate_radar		RADIO_OP(simulate_radar)
+#define get_wmm_stats		RADIO_OP(get_wmm_stats)
+#define iterate_scan_results	RADIO_OP(iterate_scan_results)
+#define iterate_scan_ies	RADIO_OP(iterate_scan_ies)
+#define get_chan_gen		RADIO_OP(get_chan_gen)
+#define get_reg_rules		RADIO_OP(get_reg_rules)
+#define get_dfs_events		RADIO_OP(get_dfs_events)
 
 #define get_bssid		IFACE_OP(get_bssid)
 #define get_ssid		IFACE_OP(get_ssid)
@@ -792,6 +914,8 @@ struct wifi_driver {
 #define link_measure		IFACE_OP(link_measure)
 #define mbo_disallow_assoc	IFACE_OP(mbo_disallow_assoc)
 #define ap_set_state		IFACE_OP(ap_set_state)
+#define get_stas_info		IFACE_OP(get_stas_info)
+#define get_sta_info_mask	IFACE_OP(get_sta_info_mask)
 
 
 /* List of the APIs this library provides */
@@ -833,6 +957,15 @@ int wifi_radio_get_stats(const char *ifname, struct wifi_radio_stats *s);
 int wifi_scan(const char *name, struct scan_param *p);
 int wifi_scan_ex(const char *ifname, struct scan_param_ex *sp);
 int wifi_get_scan_results(const char *name, struct wifi_bss *bsss, int *num);
+int wifi_get_scan_results_filtered(const char *name, struct wifi_scan_filter *f,
+				   struct wifi_bss *bsss, int *num);
+int wifi_iterate_scan_results(const char *name, struct wifi_scan_filter *f,
+			      int (*cb)(struct wifi_bss *bss, void *priv),
+			      void *priv);
+int wifi_iterate_scan_ies(const char *name, struct wifi_scan_filter *f,
+			  int (*cb)(struct wifi_bss *bss, uint8_t *ies,
+				    size_t ies_len, void *priv),
+			  void *priv);
 int wifi_get_bss_scan_result(const char *name, uint8_t *bssid,
 			     struct wifi_bss_detail *b);
 
@@ -857,6 +990,12 @@ int wifi_stop_cac(const char *name);
 int wifi_get_opclass_preferences(const char *name, struct wifi_opclass *opclass,
 				 int *num);
 int wifi_simulate_radar(const char *name, struct wifi_radar_args *radar);
+int wifi_radio_get_wmm_stats(const char *name, struct wifi_bss_wmm_stats *bss,
+			     int *num);
+int wifi_get_chan_gen(const char *name, uint32_t *gen);
+int wifi_get_reg_rules(const char *name, char *alpha2,
+		       struct wifi_reg_rule *rules, int *num);
+int wifi_get_dfs_events(const char *name, struct wifi_dfs_event *ev, int *num);
 
 /** WiFi interface APIs */
 int wifi_start_wps(const char *ifname, struct wps_param wps);
@@ -881,6 +1020,10 @@ int wifi_vendor_cmd(const char *ifname, uint32_t vid, uint32_t subcmd,
 
 int wifi_subscribe_frame(const char *ifname, uint8_t type, uint8_t stype);
 int wifi_unsubscribe_frame(const char *ifname, uint8_t type, uint8_t stype);
+int wifi_subscribe_frames(const char *ifname, struct wifi_frame_sub *sub);
+int wifi_unsubscribe_frames(const char *ifname);
+int wifi_get_frames_fd(const char *ifname, int *fd);
+int wifi_get_frames(const char *ifname, struct wifi_rx_frame *f, int *num);
 int wifi_set_4addr(const char *ifname, bool enable);
 int wifi_get_4addr(const char *ifname, bool *enabled);
 int wifi_get_4addr_parent(const char *ifname, const char *parent);
@@ -932,6 +1075,13 @@ int wifi_sta_get_stats(const char *ifname, struct wifi_sta_stats *s);
 int wifi_sta_get_ap_info(const char *ifname, struct wifi_bss *info);
 int wifi_sta_disconnect_ap(const char *ifname, uint32_t reason);
 
+/* Get info of all STAs associated to an AP interface */
+int wifi_get_stas_info(const char *ifname, struct wifi_sta *stas, int *num);
+
+/* Get only the WIFI_STA_F_* groups of fields in mask of a STA's info */
+int wifi_get_sta_info_mask(const char *ifname, uint8_t *addr, uint32_t mask,
+			   struct wifi_sta *info);
+
 
 /* WiFi events */
 enum wifi_event_type {
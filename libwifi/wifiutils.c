@@ -32,6 +32,7 @@
 
 #include "easy.h"
 #include "wifiutils.h"
+#include "mcsrate.h"
 
 unsigned char microsoft_oui[] = { 0x00, 0x50, 0xf2 };
 
@@ -224,6 +225,107 @@ uint8_t *wifi_find_vsie(uint8_t *ies, size_t len, uint8_t *oui,
 	return NULL;
 }
 
+#define ie_index_isset(map, id)	((map)[(id) / 8] & (1 << ((id) % 8)))
+#define ie_index_set(map, id)	((map)[(id) / 8] |= (1 << ((id) % 8)))
+
+void wifi_ie_index_build(struct wifi_ie_index *idx, uint8_t *ies, size_t len)
+{
+	uint8_t *pos = ies;
+	uint8_t *end;
+	uint16_t off;
+
+	memset(idx->eid_map, 0, sizeof(idx->eid_map));
+	memset(idx->ext_map, 0, sizeof(idx->ext_map));
+	idx->vsie_num = 0;
+	idx->vsie_more = false;
+	idx->ies = ies;
+	idx->len = len;
+
+	if (!ies || len < 2)
+		return;
+
+	/* offsets are 16 bits; no frame has that many */
+	if (len > UINT16_MAX)
+		len = UINT16_MAX;
+
+	end = ies + len;
+	while (end - pos > 1) {
+		if (pos + pos[1] + 2 > end)
+			break;
+
+		off = (uint16_t)(pos - ies);
+		if (!ie_index_isset(idx->eid_map, pos[0])) {
+			ie_index_set(idx->eid_map, pos[0]);
+			idx->eid[pos[0]] = off;
+		}
+
+		if (pos[0] == IE_EXT && pos[1] >= 1 &&
+		    !ie_index_isset(idx->ext_map, pos[2])) {
+			ie_index_set(idx->ext_map, pos[2]);
+			idx->ext[pos[2]] = off;
+		}
+
+		if (pos[0] == IE_VEND_SPEC && pos[1] >= 3) {
+			if (idx->vsie_num < WIFI_IE_INDEX_VSIE_MAX)
+				idx->vsie[idx->vsie_num++] = off;
+			else
+				idx->vsie_more = true;
+		}
+
+		pos += pos[1] + 2;
+	}
+}
+
+uint8_t *wifi_ie_index_find(struct wifi_ie_index *idx, uint8_t eid)
+{
+	if (!idx || !ie_index_isset(idx->eid_map, eid))
+		return NULL;
+
+	return idx->ies + idx->eid[eid];
+}
+
+uint8_t *wifi_ie_index_find_ext(struct wifi_ie_index *idx, uint8_t ext_id)
+{
+	if (!idx || !ie_index_isset(idx->ext_map, ext_id))
+		return NULL;
+
+	return idx->ies + idx->ext[ext_id];
+}
+
+uint8_t *wifi_ie_index_find_vsie(struct wifi_ie_index *idx, uint8_t *oui,
+				 uint8_t type, uint8_t stype)
+{
+	uint16_t last = 0;
+	uint8_t *vsie;
+	int i;
+
+	if (!idx || !oui)
+		return NULL;
+
+	for (i = 0; i < idx->vsie_num; i++) {
+		vsie = idx->ies + idx->vsie[i];
+		last = idx->vsie[i];
+		if (memcmp(&vsie[2], oui, 3))
+			continue;
+
+		if (type != 0xff && (vsie[1] < 4 || vsie[5] != type))
+			continue;
+
+		if (stype == 0xff || (vsie[1] >= 5 && vsie[6] == stype))
+			return vsie;
+	}
+
+	/* more of them than indexed; walk on from the last one */
+	if (idx->vsie_more) {
+		vsie = idx->ies + last;
+		vsie += vsie[1] + 2;
+		return wifi_find_vsie(vsie, idx->len - (vsie - idx->ies), oui,
+				      type, stype);
+	}
+
+	return NULL;
+}
+
 void wifi_cap_set_from_capability_information(uint8_t *bitmap, uint8_t *ie, size_t ie_len)
 {
 	if (!bitmap || !ie || ie_len < 2)
@@ -630,125 +732,113 @@ void wifi_wmm_set_from_ie(struct wifi_ap_wmm_ac *ac, uint8_t *ie, size_t len)
 	}
 }
 
-struct mcs_struct {
-	uint8_t num_bpscs;
-	float coding_rate;
-};
-
-static const struct mcs_struct mcstab[] = {
-	{ 1, 1.0f / 2.0f },
-	{ 2, 1.0f / 2.0f },
-	{ 2, 3.0f / 4.0f },
-	{ 4, 1.0f / 2.0f },
-	{ 4, 3.0f / 4.0f },
-	{ 6, 2.0f / 3.0f },
-	{ 6, 3.0f / 4.0f },
-	{ 6, 5.0f / 6.0f },
-	{ 8, 3.0f / 4.0f },
-	{ 8, 5.0f / 6.0f },
-	{ 10, 3.0f / 4.0f },
-	{ 10, 5.0f / 6.0f },
-};
-
-static int get_num_sd(uint32_t bw)
+/* Index of the symbol time and guard interval in mcsrate_kbps[] */
+static int mcsrate_sym(enum wifi_guard gi)
 {
-	uint32_t num_sd;
-	switch(bw) {
-		case 20:
-			num_sd = 52;
-			break;
-		case 40:
-			num_sd = 108;
-			break;
-		case 80:
-			num_sd = 234;
-			break;
-		case 160:
-			num_sd = 468;
-			break;
-		default:
-			num_sd = 0;
-			break;
+	switch (gi) {
+	case WIFI_SGI:
+		return 0;
+	case WIFI_LGI:
+		return 1;
+	case WIFI_1xLTF_GI800:
+	case WIFI_2xLTF_GI800:
+	case WIFI_4xLTF_GI800:
+		return 2;
+	case WIFI_1xLTF_GI1600:
+	case WIFI_2xLTF_GI1600:
+		return 3;
+	case WIFI_4xLTF_GI3200:
+		return 4;
+	default:
+		return -1;
 	}
-	return num_sd;
 }
 
-static int get_he_num_sd(uint32_t bw)
+static int mcsrate_bw(uint32_t bw)
 {
-	uint32_t num_sd;
-
-	switch(bw) {
-		case 20:
-			num_sd = 234;
-			break;
-		case 40:
-			num_sd = 468;
-			break;
-		case 80:
-			num_sd = 980;
-			break;
-		case 160:
-			num_sd = 1960;
-			break;
-		default:
-			num_sd = 0;
-			break;
+	switch (bw) {
+	case 20:
+		return 0;
+	case 40:
+		return 1;
+	case 80:
+		return 2;
+	case 160:
+		return 3;
+	case 320:
+		return 4;
+	default:
+		return -1;
 	}
-	return num_sd;
 }
 
-unsigned long wifi_mcs2rate(uint32_t mcs,
-                            uint32_t bw,
-                            uint32_t nss,
-                            enum wifi_guard gi)
+static uint32_t mcsrate_get(uint32_t mcs, uint32_t bw, uint32_t nss,
+			    enum wifi_guard gi)
 {
-	int num_sd;
-	float num_cbps;
-	float num_dbps;
-	float rate = 0.0;
-	float duration;
+	int s = mcsrate_sym(gi);
+	int b = mcsrate_bw(bw);
 
-	if (mcs > 11)
+	if (s < 0 || b < 0 || mcs >= MCSRATE_MCS_NUM || nss < 1 ||
+	    nss > MCSRATE_NSS_MAX)
 		return 0;
 
-	switch(gi) {
-		case WIFI_SGI:
-			duration = 3.2f + 0.4f;
-			num_sd = get_num_sd(bw);
-			break;
-		case WIFI_LGI:
-			duration = 3.2f + 0.8f;
-			num_sd = get_num_sd(bw);
-			break;
-		case WIFI_1xLTF_GI800:
-		case WIFI_2xLTF_GI800:
-		case WIFI_4xLTF_GI800:
-			duration = 12.8f + 0.8f;
-			num_sd = get_he_num_sd(bw);
-			break;
-		case WIFI_1xLTF_GI1600:
-		case WIFI_2xLTF_GI1600:
-			duration = 12.8f + 1.6f;
-			num_sd = get_he_num_sd(bw);
-			break;
-		case WIFI_4xLTF_GI3200:
-			duration = 12.8f + 3.2f;
-			num_sd = get_he_num_sd(bw);
-			break;
-		default:
-			duration = 0;
-			num_sd = 0;
-			break;
+	return mcsrate_kbps[s][b][nss - 1][mcs];
+}
+
+uint32_t wifi_mcs2rate_kbps(enum wifi_std std, uint32_t mcs, uint32_t bw,
+			    uint32_t nss, enum wifi_guard gi, bool dcm)
+{
+	bool he_gi = gi != WIFI_SGI && gi != WIFI_LGI;
+	uint32_t mcs_max, bw_max, nss_max;
+
+	switch (std) {
+	case WIFI_N:
+		mcs_max = 7;
+		bw_max = 40;
+		nss_max = 4;
+		break;
+	case WIFI_AC:
+		mcs_max = 9;
+		bw_max = 160;
+		nss_max = 8;
+		break;
+	case WIFI_AX:
+		mcs_max = 11;
+		bw_max = 160;
+		nss_max = 8;
+		break;
+	case WIFI_BE:
+		mcs_max = 13;
+		bw_max = 320;
+		nss_max = 16;
+		break;
+	default:
+		return 0;
 	}
 
-	if (num_sd == 0)
+	if (mcs > mcs_max || bw > bw_max || nss > nss_max)
+		return 0;
+
+	if (he_gi != (std == WIFI_AX || std == WIFI_BE))
+		return 0;
+
+	/* DCM is of HE MCS 0, 1, 3 and 4 with up to two streams */
+	if (dcm) {
+		if (std != WIFI_AX || nss > 2 || mcs == 2 || mcs > 4)
 			return 0;
 
-	num_cbps = (float)num_sd * mcstab[mcs].num_bpscs * (float)nss;
-	num_dbps = num_cbps * mcstab[mcs].coding_rate;
-	rate = num_dbps / duration;
+		return mcsrate_get(mcs, bw, nss, gi) / 2;
+	}
 
-    return (unsigned long)rate;
+	return mcsrate_get(mcs, bw, nss, gi);
+}
+
+unsigned long wifi_mcs2rate(uint32_t mcs,
+                            uint32_t bw,
+                            uint32_t nss,
+                            enum wifi_guard gi)
+{
+	return mcsrate_get(mcs, bw, nss, gi) / 1000;
 }
 
 uint32_t wifi_bw_enum2MHz(enum wifi_bw bw)
@@ -927,17 +1017,28 @@ static int is_wpa_ie(uint8_t *ie, size_t len)
 	return 0;
 }
 
-int wifi_get_bss_security_from_ies(struct wifi_bss *e, uint8_t *ies, size_t len)
+int wifi_get_bss_security_from_ie_index(struct wifi_bss *e,
+					struct wifi_ie_index *idx)
 {
-	uint8_t *ie;
+	uint8_t wpa_oui[3] = {0x00, 0x50, 0xf2};
+	uint8_t *ie[2];
+	int i;
 
 	memset(&e->rsn, 0, sizeof(e->rsn));
 
-	wifi_foreach_ie(ie, ies, len) {
-		if (!is_wpa_ie(ie, len))
+	/* in the order they are in */
+	ie[0] = wifi_ie_index_find_vsie(idx, wpa_oui, 0x01, 0xff);
+	ie[1] = wifi_ie_index_find(idx, IE_RSN);
+	if (ie[0] && ie[1] && ie[1] < ie[0]) {
+		ie[1] = ie[0];
+		ie[0] = wifi_ie_index_find(idx, IE_RSN);
+	}
+
+	for (i = 0; i < 2; i++) {
+		if (!ie[i] || !is_wpa_ie(ie[i], ie[i][1] + 2))
 			continue;
 		/* wpa ie */
-		if (wifi_parse_wpa_ie(ie, len, &e->rsn))
+		if (wifi_parse_wpa_ie(ie[i], idx->len - (ie[i] - idx->ies), &e->rsn))
 				return -1;
 		wifi_rsne_to_security(&e->rsn, &e->security);
 	}
@@ -950,6 +1051,14 @@ int wifi_get_bss_security_from_ies(struct wifi_bss *e, uint8_t *ies, size_t len)
 	return 0;
 }
 
+int wifi_get_bss_security_from_ies(struct wifi_bss *e, uint8_t *ies, size_t len)
+{
+	struct wifi_ie_index idx;
+
+	wifi_ie_index_build(&idx, ies, len);
+	return wifi_get_bss_security_from_ie_index(e, &idx);
+}
+
 static int wifi_is_bg_rate(uint8_t rate, uint8_t* brate, uint8_t* grate)
 {
 	int i;
@@ -977,7 +1086,7 @@ static int wifi_is_bg_rate(uint8_t rate, uint8_t* brate, uint8_t* grate)
 	return 0;
 }
 
-int wifi_oper_stds_set_from_ie(uint8_t *ies, size_t ies_len, uint8_t *std)
+int wifi_oper_stds_set_from_ie_index(struct wifi_ie_index *idx, uint8_t *std)
 {
 	uint8_t *ht_cap, *vht_cap;
 	uint8_t *ds, *supp_rates;
@@ -986,14 +1095,14 @@ int wifi_oper_stds_set_from_ie(uint8_t *ies, size_t ies_len, uint8_t *std)
 	uint8_t brate = 0;
 	uint8_t grate = 0;
 
-	if (!ies || ies_len == 0 || !std)
+	if (!idx || !idx->ies || idx->len == 0 || !std)
 		return -EINVAL;
 
-	ds = wifi_find_ie(ies, ies_len, IE_DS_PARAM);
-	ht_cap = wifi_find_ie(ies, ies_len, IE_HT_CAP);
-	vht_cap = wifi_find_ie(ies, ies_len, IE_VHT_CAP);
-	supp_rates = wifi_find_ie(ies, ies_len, IE_SUPP_RATES);
-	he_cap = wifi_find_ie_ext(ies, ies_len, IE_EXT_HE_CAP);
+	ds = wifi_ie_index_find(idx, IE_DS_PARAM);
+	ht_cap = wifi_ie_index_find(idx, IE_HT_CAP);
+	vht_cap = wifi_ie_index_find(idx, IE_VHT_CAP);
+	supp_rates = wifi_ie_index_find(idx, IE_SUPP_RATES);
+	he_cap = wifi_ie_index_find_ext(idx, IE_EXT_HE_CAP);
 
 	if (supp_rates) {
 		uint8_t b = 0;
@@ -1041,33 +1150,234 @@ int wifi_oper_stds_set_from_ie(uint8_t *ies, size_t ies_len, uint8_t *std)
 	return 0;
 }
 
-int wifi_ssid_advertised_set_from_ie(uint8_t *ies, size_t ies_len, bool *ssid_advertised)
+int wifi_oper_stds_set_from_ie(uint8_t *ies, size_t ies_len, uint8_t *std)
 {
-	uint8_t *ssid_ie;
+	struct wifi_ie_index idx;
 
-	if (!ies || ies_len == 0 || !ssid_advertised)
+	if (!ies || ies_len == 0 || !std)
 		return -EINVAL;
 
+	wifi_ie_index_build(&idx, ies, ies_len);
+	return wifi_oper_stds_set_from_ie_index(&idx, std);
+}
+
+static void ssid_advertised_set(uint8_t *ssid_ie, bool *ssid_advertised)
+{
 	*ssid_advertised = true;
-	ssid_ie = wifi_find_ie(ies, ies_len, IE_SSID);
 	if (ssid_ie && ssid_ie[0] == 0 && ssid_ie[1] == 0) {
 		*ssid_advertised = false;
 	}
-	return 0;
 }
 
-int wifi_apload_set_from_ie(uint8_t *ies, size_t ies_len, struct wifi_ap_load *load)
+int wifi_ssid_advertised_set_from_ie_index(struct wifi_ie_index *idx,
+					   bool *ssid_advertised)
 {
-	uint8_t *bs;
+	if (!idx || !idx->ies || idx->len == 0 || !ssid_advertised)
+		return -EINVAL;
 
-	if (!ies || ies_len == 0 || !load)
+	ssid_advertised_set(wifi_ie_index_find(idx, IE_SSID), ssid_advertised);
+	return 0;
+}
+
+int wifi_ssid_advertised_set_from_ie(uint8_t *ies, size_t ies_len, bool *ssid_advertised)
+{
+	if (!ies || ies_len == 0 || !ssid_advertised)
 		return -EINVAL;
 
-	bs = wifi_find_ie(ies, ies_len, IE_BSS_LOAD);
+	ssid_advertised_set(wifi_find_ie(ies, ies_len, IE_SSID), ssid_advertised);
+	return 0;
+}
+
+static void apload_set(uint8_t *bs, struct wifi_ap_load *load)
+{
 	if (bs && bs[1] == 5) {
 		load->sta_count = (uint16_t)(bs[2] | (bs[3] << 8));
 		load->utilization = bs[4];
 		load->available = (uint16_t)(bs[5] | (bs[6] << 8));
 	}
+}
+
+int wifi_apload_set_from_ie_index(struct wifi_ie_index *idx,
+				  struct wifi_ap_load *load)
+{
+	if (!idx || !idx->ies || idx->len == 0 || !load)
+		return -EINVAL;
+
+	apload_set(wifi_ie_index_find(idx, IE_BSS_LOAD), load);
+	return 0;
+}
+
+int wifi_apload_set_from_ie(uint8_t *ies, size_t ies_len, struct wifi_ap_load *load)
+{
+	if (!ies || ies_len == 0 || !load)
+		return -EINVAL;
+
+	apload_set(wifi_find_ie(ies, ies_len, IE_BSS_LOAD), load);
+	return 0;
+}
+
+/* copy the body of a capabilities element, if it fits */
+static int bss_caps_ie_get(struct wifi_ie_index *idx, uint8_t eid,
+			   void *data, size_t size)
+{
+	uint8_t *ie;
+
+	ie = wifi_ie_index_find(idx, eid);
+	if (!ie)
+		return -ENOENT;
+
+	if (ie[1] > size)
+		return -1;
+
+	memcpy(data, &ie[2], ie[1]);
+	return 0;
+}
+
+static void bss_bw_set(struct wifi_ie_index *idx, enum wifi_bw *bw)
+{
+	uint8_t *p;
+
+	p = wifi_ie_index_find(idx, IE_HT_OPER);
+	if (p) {
+		uint8_t *ht_op;
+		uint8_t off = 0;
+
+		if (p[1] != 22)
+			return;
+
+		ht_op = p + 2 + 1;
+		off = ht_op[0] & 0x3;
+
+		if (off == 0)
+			*bw = BW20;
+		else if (off == 1 || off == 3)
+			*bw = BW40;
+
+		if ((ht_op[0] & bit(2)) == 0)
+			*bw = BW20;
+	}
+
+	p = wifi_ie_index_find(idx, IE_VHT_OPER);
+	if (p) {
+		uint8_t *vht_op;
+		uint8_t w, cfs0, cfs1;
+
+		if (p[1] < 5)
+			return;
+
+		vht_op = p + 2;
+		w = vht_op[0];
+		cfs0 = vht_op[1];
+		cfs1 = vht_op[2];
+
+		if (w == 0)
+			return;
+
+		if (cfs1 == 0) {
+			*bw = BW80;
+		} else {
+			if (cfs1 - cfs0 == 8)
+				*bw = BW160;
+			else if (cfs1 - cfs0 == 16)
+				*bw = BW8080;
+		}
+	}
+}
+
+int wifi_bss_caps_set_from_ie_index(struct wifi_bss *e, struct wifi_ie_index *idx)
+{
+	if (!e || !idx)
+		return -EINVAL;
+
+	apload_set(wifi_ie_index_find(idx, IE_BSS_LOAD), &e->load);
+
+	if (!bss_caps_ie_get(idx, IE_EXT_CAP, &e->caps.ext, sizeof(e->caps.ext)))
+		e->caps.valid |= WIFI_CAP_EXT_VALID;
+
+	if (!bss_caps_ie_get(idx, IE_HT_CAP, &e->caps.ht, sizeof(e->caps.ht)))
+		e->caps.valid |= WIFI_CAP_HT_VALID;
+
+	if (!bss_caps_ie_get(idx, IE_VHT_CAP, &e->caps.vht, sizeof(e->caps.vht)))
+		e->caps.valid |= WIFI_CAP_VHT_VALID;
+
+	if (!bss_caps_ie_get(idx, IE_RRM, &e->caps.rrm, sizeof(e->caps.rrm)))
+		e->caps.valid |= WIFI_CAP_RM_VALID;
+
+	bss_bw_set(idx, &e->curr_bw);
+
+	//TODO: wifi supp standards
+	//TODO: a-only, b-only, g-only etc.
+	if (!!(e->caps.valid & WIFI_CAP_VHT_VALID))
+		e->oper_std = WIFI_N | WIFI_AC;
+	else if (!!(e->caps.valid & WIFI_CAP_HT_VALID))
+		e->oper_std = e->channel > 14 ? (WIFI_A | WIFI_N) :
+						(WIFI_B | WIFI_G | WIFI_N);
+	else
+		e->oper_std = e->channel > 14 ? WIFI_A : (WIFI_B | WIFI_G);
+
 	return 0;
 }
+
+void wifi_bss_set_from_ie_index(struct wifi_bss *e, struct wifi_ie_index *idx)
+{
+	uint8_t *ssid_ie;
+
+	ssid_ie = wifi_ie_index_find(idx, IE_SSID);
+	if (ssid_ie && ssid_ie[1] < sizeof(e->ssid)) {
+		memset(e->ssid, 0, sizeof(e->ssid));
+		memcpy(e->ssid, &ssid_ie[2], ssid_ie[1]);
+	}
+
+	wifi_get_bss_security_from_ie_index(e, idx);
+	wifi_bss_caps_set_from_ie_index(e, idx);
+}
+
+bool wifi_scan_filter_match(const struct wifi_scan_filter *f, uint32_t which,
+			    const struct wifi_bss *bss, int age)
+{
+	uint32_t flag;
+	int i;
+
+	if (!f)
+		return true;
+
+	flag = f->flag & which;
+
+	if ((flag & WIFI_SCAN_FILTER_SSID) &&
+	    strncmp((const char *)bss->ssid, f->ssid, sizeof(bss->ssid)))
+		return false;
+
+	if (flag & WIFI_SCAN_FILTER_BSSID) {
+		for (i = 0; i < f->num_bssid && i < WIFI_SCAN_FILTER_MAX_BSSID; i++) {
+			if (!memcmp(bss->bssid, f->bssid[i], 6))
+				break;
+		}
+
+		if (i == f->num_bssid || i == WIFI_SCAN_FILTER_MAX_BSSID)
+			return false;
+	}
+
+	if ((flag & WIFI_SCAN_FILTER_BAND) && !(bss->band & f->band))
+		return false;
+
+	if (flag & WIFI_SCAN_FILTER_CHANNEL) {
+		for (i = 0; i < f->num_channel && i < WIFI_SCAN_FILTER_MAX_CHANNEL; i++) {
+			if (bss->channel == f->channel[i])
+				break;
+		}
+
+		if (i == f->num_channel || i == WIFI_SCAN_FILTER_MAX_CHANNEL)
+			return false;
+	}
+
+	if ((flag & WIFI_SCAN_FILTER_RSSI) && bss->rssi < f->rssi)
+		return false;
+
+	if ((flag & WIFI_SCAN_FILTER_AGE) && age >= 0 && (uint32_t)age > f->age)
+		return false;
+
+	if ((flag & WIFI_SCAN_FILTER_SECURITY) && !(bss->security & f->security))
+		return false;
+
+	return true;
+}
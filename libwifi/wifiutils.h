@@ -35,6 +35,30 @@ uint8_t *wifi_find_ie_ext(uint8_t *ies, size_t len, uint8_t ext_id);
 uint8_t *wifi_find_vsie(uint8_t *ies, size_t len, uint8_t *oui, uint8_t type,
 						uint8_t stype);
 
+#define WIFI_IE_INDEX_VSIE_MAX	16
+
+/* Offsets of the elements of an IE buffer, got in one walk of it, to find
+ * elements by id, extension id or vendor OUI without walking it again.
+ * As with wifi_find_ie() and co, the first element of an id is found.
+ */
+struct wifi_ie_index {
+	uint8_t *ies;
+	size_t len;
+	uint8_t eid_map[32];			/* bit per element id in */
+	uint8_t ext_map[32];			/* bit per extension id in */
+	uint16_t eid[256];
+	uint16_t ext[256];
+	int vsie_num;
+	uint16_t vsie[WIFI_IE_INDEX_VSIE_MAX];	/* vendor elements in order */
+	bool vsie_more;				/* more than indexed */
+};
+
+void wifi_ie_index_build(struct wifi_ie_index *idx, uint8_t *ies, size_t len);
+uint8_t *wifi_ie_index_find(struct wifi_ie_index *idx, uint8_t eid);
+uint8_t *wifi_ie_index_find_ext(struct wifi_ie_index *idx, uint8_t ext_id);
+uint8_t *wifi_ie_index_find_vsie(struct wifi_ie_index *idx, uint8_t *oui,
+				 uint8_t type, uint8_t stype);
+
 void wifi_cap_set_from_capability_information(uint8_t *bitmap, uint8_t *ie, size_t ie_len);
 void wifi_cap_set_from_ht_capabilities_info(uint8_t *bitmap, uint8_t *ie, size_t ie_len);
 void wifi_cap_set_from_vht_capabilities_info(uint8_t *bitmap, uint8_t *ie, size_t ie_len);
@@ -44,7 +68,17 @@ void wifi_cap_set_from_fast_bss_transition(uint8_t *bitmap, uint8_t *ie, size_t
 void wifi_cap_set_from_ie(uint8_t *caps_bitmap, uint8_t *ie, size_t len);
 void wifi_wmm_set_from_ie(struct wifi_ap_wmm_ac *ac, uint8_t *ie, size_t len);
 
+/* PHY rate in Mbps of a MCS at a bandwidth in MHz (20-320), number of
+ * spatial streams (1-16) and guard interval; 0 if not known.
+ */
 unsigned long wifi_mcs2rate(uint32_t mcs, uint32_t bw, uint32_t nss, enum wifi_guard gi);
+
+/* PHY rate in kbps of a MCS of 802.11n, ac, ax or be; 0 if the standard
+ * has no such MCS, bandwidth, number of streams or guard interval. With
+ * 'dcm' the rate of HE MCS 0, 1, 3 and 4 with dual carrier modulation.
+ */
+uint32_t wifi_mcs2rate_kbps(enum wifi_std std, uint32_t mcs, uint32_t bw,
+			    uint32_t nss, enum wifi_guard gi, bool dcm);
 uint32_t wifi_bw_enum2MHz(enum wifi_bw bw);
 
 
@@ -55,6 +89,125 @@ int wifi_oper_stds_set_from_ie(uint8_t *beacon_ies, size_t beacon_ies_len, uint8
 int wifi_ssid_advertised_set_from_ie(uint8_t *ies, size_t ies_len, bool *ssid_advertised);
 int wifi_apload_set_from_ie(uint8_t *ies, size_t ies_len, struct wifi_ap_load *load);
 
+/* as the above, from an indexed IE buffer */
+int wifi_get_bss_security_from_ie_index(struct wifi_bss *e, struct wifi_ie_index *idx);
+int wifi_oper_stds_set_from_ie_index(struct wifi_ie_index *idx, uint8_t *std);
+int wifi_ssid_advertised_set_from_ie_index(struct wifi_ie_index *idx, bool *ssid_advertised);
+int wifi_apload_set_from_ie_index(struct wifi_ie_index *idx, struct wifi_ap_load *load);
+
+/* BSS load, capabilities, bandwidth and standards of a scanned BSS, on the
+ * channel set in 'e'; the SSID and security are got as the above.
+ */
+int wifi_bss_caps_set_from_ie_index(struct wifi_bss *e, struct wifi_ie_index *idx);
+
+/* all of a scanned BSS got from its IEs: SSID, security and the above */
+void wifi_bss_set_from_ie_index(struct wifi_bss *e, struct wifi_ie_index *idx);
+
+/* check the criteria of a scan filter in 'which' (UINT32_MAX for all);
+ * age is -1 if unknown
+ */
+bool wifi_scan_filter_match(const struct wifi_scan_filter *f, uint32_t which,
+			    const struct wifi_bss *bss, int age);
+
+/* per-sta airtime tracking from the Tx/Rx duration counters */
+void wifi_airtime_update(const char *ifname, struct wifi_sta *sta, uint64_t now);
+void wifi_airtime_expire(const char *ifname, struct wifi_sta *stas, int num);
+void wifi_airtime_get_bss(const char *ifname, struct wifi_airtime *a, uint64_t now);
+void wifi_airtime_flush(void);
+
+/* per-sta rssi/snr/rate history */
+void wifi_sta_history_record(const char *ifname, struct wifi_sta *sta, uint64_t now);
+void wifi_sta_history_expire(const char *ifname, struct wifi_sta *stas, int num);
+
+/* width of the stats counters of a driver */
+int wifi_get_counter_bits(const char *name);
+
+/* unassociated stas tracked from their probe requests */
+bool wifi_monsta_tracked(const char *ifname);
+void wifi_monsta_record_frames(const char *ifname, struct wifi_rx_frame *f, int num);
+int wifi_monsta_get(const char *ifname, uint8_t *sta, struct wifi_monsta *mon);
+int wifi_monsta_get_all(const char *ifname, struct wifi_monsta *stas, int *num);
+int wifi_track_probe_req(const char *ifname, bool enable);
+
+/* neighbor BSSs merged from the scan results of all radios */
+void wifi_bssdb_update(const char *ifname, struct wifi_bss *bss, int num,
+		       bool all, uint64_t now);
+void wifi_bssdb_stale(const char *name);
+bool wifi_bssdb_need_refresh(const char *name, uint64_t now);
+int wifi_bssdb_count(enum wifi_band band, uint8_t channel);
+int wifi_bssdb_count_channels(enum wifi_band band, uint16_t *count);
+
+/* per-radio cache of channels and opclass tables */
+enum opclass_cache_type {
+	OPCLASS_CACHE_CHANNELS,
+	OPCLASS_CACHE_SUPPORTED,
+	OPCLASS_CACHE_PREF,
+
+	OPCLASS_CACHE_NUM,
+};
+
+int wifi_opclass_cache_get(const char *name, enum opclass_cache_type type,
+			   void *out, int *num, size_t size, uint32_t *ticket);
+void wifi_opclass_cache_put(const char *name, enum opclass_cache_type type,
+			    uint32_t ticket, const void *in, int num, int max,
+			    size_t size);
+void wifi_opclass_cache_drop(const char *name, enum opclass_cache_type type);
+
+/* regulatory rules of radios, as got from their drivers */
+int wifi_regdb_check_channels(const char *name, const char *cc,
+			      enum wifi_band band, enum wifi_bw bw,
+			      const uint32_t *chs, int num, bool *valid);
+
+/* DFS state of radios, tracked from their DFS events */
+void wifi_dfs_update_channels(const char *name, struct chan_entry *chan,
+			      int num);
+int wifi_dfs_is_usable(const char *name, uint32_t channel, enum wifi_bw bw,
+		       bool *usable);
+
+/* whether the DFS channels of 'chan' at 'bw' are all usable, i.e. need CAC */
+bool wifi_is_dfs_usable(const char *name, int chan, enum wifi_bw bw);
+
+/* channel scores from per 20MHz channel aggregates of a radio */
+#define CHSCORE_NUM_CHANNELS	256
+#define CHSCORE_NUM_BANDS	4
+
+/* prefix sums by channel number, over channels 1 and 4 apart */
+struct chscore_sum {
+	uint32_t by1[CHSCORE_NUM_CHANNELS + 1];
+	uint32_t by4[4][CHSCORE_NUM_CHANNELS / 4 + 1];
+};
+
+struct chscore {
+	const struct chan_entry *chan;
+	int16_t idx[CHSCORE_NUM_CHANNELS];	/* first entry of channel, or -1 */
+	struct chscore_sum busy, busy_num, busy_bad;
+	struct chscore_sum score, score_num, score_bad;
+	struct chscore_sum bss[CHSCORE_NUM_BANDS];
+	int band_bss[CHSCORE_NUM_BANDS];
+};
+
+void wifi_chscore_init(struct chscore *cs, const struct chan_entry *chan,
+		       int chan_num);
+const struct chan_entry *wifi_chscore_chan(struct chscore *cs, int channel);
+int wifi_chscore_noise(struct chscore *cs, const int *chans);
+uint8_t wifi_chscore_busy(struct chscore *cs, const int *chans);
+uint8_t wifi_chscore_score(struct chscore *cs, const int *chans);
+int wifi_chscore_bss_num(struct chscore *cs, enum wifi_band band,
+			 const int *chans);
+int wifi_chscore_band_bss_num(struct chscore *cs, enum wifi_band band);
+
+/* per-sta capabilities parsed once per association; 'now' in msecs */
+int wifi_sta_caps_get(const char *ifname, struct wifi_sta *sta, uint64_t now);
+void wifi_sta_caps_put(const char *ifname, uint8_t *macaddr, uint32_t conn_time,
+		       struct wifi_sta *caps, uint64_t now);
+void wifi_sta_caps_del(const char *ifname, uint8_t *addr);
+void wifi_sta_caps_expire(const char *ifname, struct wifi_sta *stas, int num);
+
+/* run fn(ctx) to get 'out' and 'num', unless an identical query is in flight */
+int wifi_coalesce(enum wifi_coalesce_op op, const char *ifname,
+		  const void *key, size_t klen, void *out, size_t olen,
+		  int *num, int (*fn)(void *ctx), void *ctx);
+
 #ifndef BIT
 #define BIT(n)	(1U << (n))
 #endif